@@ -0,0 +1,186 @@
+/**
+ * Minimal Benchmark Harness for DSC Library
+ *
+ * Copyright (C) 2025 OmarElprolosy66
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Include this before anything else (it selects the POSIX clock).
+ *
+ * Usage:
+ *   int main(int argc, char** argv) {
+ *       BENCH_INIT(argc, argv, "hash_table");
+ *
+ *       uint64_t start = bench_now_ns();
+ *       for (size_t i = 0; i < n; i++) work(i);
+ *       bench_report("insert_int", n, n, bench_now_ns() - start);
+ *
+ *       bench_latency lat;
+ *       bench_latency_init(&lat, n);
+ *       for (size_t i = 0; i < n; i++) {
+ *           uint64_t t = bench_now_ns();
+ *           work(i);
+ *           bench_latency_add(&lat, bench_now_ns() - t);
+ *       }
+ *       bench_report_latency("insert_spikes", n, &lat);
+ *       return 0;
+ *   }
+ *
+ * Flags understood by every benchmark:
+ *   --json       One JSON object per line instead of CSV rows
+ *   --no-header  Omit the CSV header (used by run_bench.sh to concatenate)
+ *   --quick      Divide every size by 10, for smoke runs
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+/* POSIX clock_gettime, even under a strict -std=c11 build */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+/* Monotonic nanoseconds */
+static inline uint64_t bench_now_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* Results are stored here so the compiler cannot drop the measured work */
+static volatile uint64_t _bench_sink;
+#define BENCH_SINK(x) (_bench_sink += (uint64_t)(x))
+
+static int         _bench_json   = 0;
+static int         _bench_quick  = 0;
+static const char* _bench_suite  = "";
+
+#define BENCH_CSV_HEADER "suite,case,n,ops,total_ms,ns_per_op,mops,p50_ns,p99_ns,p999_ns,max_ns"
+
+static inline void bench_init(int argc, char** argv, const char* suite) {
+    int header = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) _bench_json = 1;
+        else if (strcmp(argv[i], "--no-header") == 0) header = 0;
+        else if (strcmp(argv[i], "--quick") == 0) _bench_quick = 1;
+    }
+    _bench_suite = suite;
+    if (header && !_bench_json) printf("%s\n", BENCH_CSV_HEADER);
+}
+
+#define BENCH_INIT(argc, argv, suite) bench_init((argc), (argv), (suite))
+
+/* Problem size after --quick scaling */
+static inline size_t bench_size(size_t n) {
+    return (_bench_quick && n >= 10) ? n / 10 : n;
+}
+
+/* Per-operation samples for percentile reports */
+typedef struct {
+    uint64_t* samples;
+    size_t    count;
+    size_t    capacity;
+} bench_latency;
+
+static inline void bench_latency_init(bench_latency* lat, size_t capacity) {
+    lat->samples  = (uint64_t*)malloc((capacity ? capacity : 1) * sizeof(uint64_t));
+    lat->count    = 0;
+    lat->capacity = lat->samples ? capacity : 0;
+}
+
+static inline void bench_latency_add(bench_latency* lat, uint64_t ns) {
+    if (lat->count < lat->capacity) lat->samples[lat->count++] = ns;
+}
+
+static inline void bench_latency_free(bench_latency* lat) {
+    free(lat->samples);
+    lat->samples  = NULL;
+    lat->count    = 0;
+    lat->capacity = 0;
+}
+
+static int _bench_cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void _bench_emit(const char* name, size_t n, size_t ops, uint64_t total_ns,
+                        uint64_t p50, uint64_t p99, uint64_t p999, uint64_t max) {
+    double ns_per_op = ops ? (double)total_ns / (double)ops : 0.0;
+    double mops      = total_ns ? (double)ops * 1e3 / (double)total_ns : 0.0;
+    double total_ms  = (double)total_ns / 1e6;
+
+    if (_bench_json) {
+        printf("{\"suite\":\"%s\",\"case\":\"%s\",\"n\":%zu,\"ops\":%zu,\"total_ms\":%.3f,"
+               "\"ns_per_op\":%.2f,\"mops\":%.3f,\"p50_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,\"max_ns\":%llu}\n",
+               _bench_suite, name, n, ops, total_ms, ns_per_op, mops,
+               (unsigned long long)p50, (unsigned long long)p99, (unsigned long long)p999, (unsigned long long)max);
+    } else {
+        printf("%s,%s,%zu,%zu,%.3f,%.2f,%.3f,%llu,%llu,%llu,%llu\n",
+               _bench_suite, name, n, ops, total_ms, ns_per_op, mops,
+               (unsigned long long)p50, (unsigned long long)p99, (unsigned long long)p999, (unsigned long long)max);
+    }
+    fflush(stdout);
+}
+
+/* Throughput row: ops operations on a structure of n items took total_ns */
+static inline void bench_report(const char* name, size_t n, size_t ops, uint64_t total_ns) {
+    _bench_emit(name, n, ops, total_ns, 0, 0, 0, 0);
+}
+
+/* Throughput and percentile row from per-operation samples (sorts them) */
+static inline void bench_report_latency(const char* name, size_t n, bench_latency* lat) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < lat->count; i++) total += lat->samples[i];
+    if (lat->count == 0) {
+        _bench_emit(name, n, 0, 0, 0, 0, 0, 0);
+        return;
+    }
+
+    qsort(lat->samples, lat->count, sizeof(uint64_t), _bench_cmp_u64);
+    size_t last = lat->count - 1;
+    _bench_emit(name, n, lat->count, total,
+                lat->samples[last * 50 / 100], lat->samples[last * 99 / 100],
+                lat->samples[last * 999 / 1000], lat->samples[last]);
+}
+
+/* Deterministic xorshift64* stream, so every run measures the same keys */
+static inline uint64_t bench_rand(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+#endif /* BENCH_H */
@@ -0,0 +1,274 @@
+/**
+ * Hash Table Benchmarks
+ * Insert/get/delete throughput for integer and string keys, hit/miss mixes,
+ * load factors, per-insert latency across resizes, and versioned table
+ * lookups and commits.
+ */
+
+#include "bench.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+
+/* Total operations aimed for per case, so small tables are repeated */
+#define TARGET_OPS 2000000
+
+static int value = 1;   /* Every entry stores &value; objects must be non-NULL */
+
+/* Distinct for every i < 2^32, and spread over all bits */
+static uint32_t int_key(size_t i) {
+    return (uint32_t)(i * 2654435761u);
+}
+
+static size_t reps_for(size_t n) {
+    size_t reps = TARGET_OPS / n;
+    return reps ? reps : 1;
+}
+
+static void fill_int(dsc_hash_table* ht, const uint32_t* keys, size_t n, size_t capacity) {
+    dsc_hash_table_init(ht, capacity, sizeof(uint32_t), dsc_hash_pod, dsc_cmp_pod);
+    for (size_t i = 0; i < n; i++) dsc_hash_table_insert(ht, &keys[i], &value);
+}
+
+/* =========================================================
+   Integer Keys
+   ========================================================= */
+
+static void bench_int_keys(size_t n) {
+    uint32_t* keys   = (uint32_t*)malloc(n * sizeof(uint32_t));
+    uint32_t* misses = (uint32_t*)malloc(n * sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++) {
+        keys[i]   = int_key(i);
+        misses[i] = int_key(i + n);
+    }
+
+    size_t reps = reps_for(n);
+    uint64_t insert_ns = 0, delete_ns = 0, start;
+    dsc_hash_table ht;
+
+    for (size_t r = 0; r < reps; r++) {
+        start = bench_now_ns();
+        fill_int(&ht, keys, n, 16);
+        insert_ns += bench_now_ns() - start;
+
+        start = bench_now_ns();
+        for (size_t i = 0; i < n; i++) BENCH_SINK(dsc_hash_table_delete(&ht, &keys[i]) != NULL);
+        delete_ns += bench_now_ns() - start;
+        dsc_hash_table_destroy(&ht, NULL);
+    }
+    bench_report("insert_int", n, n * reps, insert_ns);
+    bench_report("delete_int", n, n * reps, delete_ns);
+
+    fill_int(&ht, keys, n, 16);
+
+    start = bench_now_ns();
+    for (size_t r = 0; r < reps; r++) {
+        for (size_t i = 0; i < n; i++) BENCH_SINK(dsc_hash_table_get(&ht, &keys[i]) != NULL);
+    }
+    bench_report("get_int_hit", n, n * reps, bench_now_ns() - start);
+
+    start = bench_now_ns();
+    for (size_t r = 0; r < reps; r++) {
+        for (size_t i = 0; i < n; i++) BENCH_SINK(dsc_hash_table_get(&ht, &misses[i]) != NULL);
+    }
+    bench_report("get_int_miss", n, n * reps, bench_now_ns() - start);
+
+    /* Hit ratios: a fixed pseudo-random pattern picks hit or miss per lookup */
+    static const int hit_percent[] = { 90, 50, 10 };
+    for (size_t h = 0; h < sizeof(hit_percent) / sizeof(hit_percent[0]); h++) {
+        const uint32_t** probe = (const uint32_t**)malloc(n * sizeof(uint32_t*));
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (size_t i = 0; i < n; i++) {
+            probe[i] = (bench_rand(&state) % 100 < (uint64_t)hit_percent[h]) ? &keys[i] : &misses[i];
+        }
+
+        start = bench_now_ns();
+        for (size_t r = 0; r < reps; r++) {
+            for (size_t i = 0; i < n; i++) BENCH_SINK(dsc_hash_table_get(&ht, probe[i]) != NULL);
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "get_int_hit%d", hit_percent[h]);
+        bench_report(name, n, n * reps, bench_now_ns() - start);
+        free((void*)probe);
+    }
+    dsc_hash_table_destroy(&ht, NULL);
+
+    /* Load factors: a fixed power-of-two bucket count filled to each ratio */
+    static const int load_percent[] = { 25, 50, 75 };
+    size_t buckets = 1;
+    while (buckets < n) buckets <<= 1;
+    for (size_t l = 0; l < sizeof(load_percent) / sizeof(load_percent[0]); l++) {
+        size_t m = buckets * (size_t)load_percent[l] / 100;
+        if (m > n) m = n;
+        fill_int(&ht, keys, m, buckets);
+
+        size_t lreps = reps_for(m);
+        start = bench_now_ns();
+        for (size_t r = 0; r < lreps; r++) {
+            for (size_t i = 0; i < m; i++) BENCH_SINK(dsc_hash_table_get(&ht, &keys[i]) != NULL);
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "get_int_load%d", load_percent[l]);
+        bench_report(name, m, m * lreps, bench_now_ns() - start);
+        dsc_hash_table_destroy(&ht, NULL);
+    }
+
+    free(keys);
+    free(misses);
+}
+
+/* =========================================================
+   String Keys
+   ========================================================= */
+
+static void bench_str_keys(size_t n) {
+    /* Keys are stored back to back; ptrs[i] points at the i-th */
+    char*  text   = (char*)malloc(n * 2 * 24);
+    char** ptrs   = (char**)malloc(n * sizeof(char*));
+    char** misses = (char**)malloc(n * sizeof(char*));
+    char*  cursor = text;
+    for (size_t i = 0; i < n; i++) {
+        ptrs[i] = cursor;
+        cursor += sprintf(cursor, "user:%08x", (unsigned)int_key(i)) + 1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        misses[i] = cursor;
+        cursor += sprintf(cursor, "user:%08x", (unsigned)int_key(i + n)) + 1;
+    }
+
+    size_t reps = reps_for(n);
+    uint64_t insert_ns = 0, delete_ns = 0, start;
+    dsc_hash_table ht;
+
+    for (size_t r = 0; r < reps; r++) {
+        start = bench_now_ns();
+        dsc_hash_table_init(&ht, 16, 0, dsc_hash_str, dsc_cmp_str);
+        for (size_t i = 0; i < n; i++) dsc_hash_table_insert(&ht, ptrs[i], &value);
+        insert_ns += bench_now_ns() - start;
+
+        if (r + 1 == reps) break;   /* Keep the last table for the lookups */
+        start = bench_now_ns();
+        for (size_t i = 0; i < n; i++) BENCH_SINK(dsc_hash_table_delete(&ht, ptrs[i]) != NULL);
+        delete_ns += bench_now_ns() - start;
+        dsc_hash_table_destroy(&ht, NULL);
+    }
+    bench_report("insert_str", n, n * reps, insert_ns);
+
+    start = bench_now_ns();
+    for (size_t r = 0; r < reps; r++) {
+        for (size_t i = 0; i < n; i++) BENCH_SINK(dsc_hash_table_get(&ht, ptrs[i]) != NULL);
+    }
+    bench_report("get_str_hit", n, n * reps, bench_now_ns() - start);
+
+    /* Same lookups with the length passed in: no strlen per call */
+    start = bench_now_ns();
+    for (size_t r = 0; r < reps; r++) {
+        for (size_t i = 0; i < n; i++) BENCH_SINK(dsc_hash_table_get_len(&ht, ptrs[i], 13) != NULL);
+    }
+    bench_report("get_str_len_hit", n, n * reps, bench_now_ns() - start);
+
+    start = bench_now_ns();
+    for (size_t r = 0; r < reps; r++) {
+        for (size_t i = 0; i < n; i++) BENCH_SINK(dsc_hash_table_get(&ht, misses[i]) != NULL);
+    }
+    bench_report("get_str_miss", n, n * reps, bench_now_ns() - start);
+
+    start = bench_now_ns();
+    for (size_t i = 0; i < n; i++) BENCH_SINK(dsc_hash_table_delete(&ht, ptrs[i]) != NULL);
+    delete_ns += bench_now_ns() - start;
+    bench_report("delete_str", n, n * reps, delete_ns);
+
+    dsc_hash_table_destroy(&ht, NULL);
+    free(text);
+    free(ptrs);
+    free(misses);
+}
+
+/* =========================================================
+   Resize Spikes
+   ========================================================= */
+
+/* Times every insert on its own; the tail percentiles show the resizes */
+static void bench_insert_latency(size_t n, bool incremental) {
+    uint32_t* keys = (uint32_t*)malloc(n * sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++) keys[i] = int_key(i);
+
+    bench_latency lat;
+    bench_latency_init(&lat, n);
+
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 16, sizeof(uint32_t), dsc_hash_pod, dsc_cmp_pod);
+    dsc_hash_table_set_incremental(&ht, incremental);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t t = bench_now_ns();
+        dsc_hash_table_insert(&ht, &keys[i], &value);
+        bench_latency_add(&lat, bench_now_ns() - t);
+    }
+    bench_report_latency(incremental ? "insert_latency_incremental" : "insert_latency", n, &lat);
+
+    bench_latency_free(&lat);
+    dsc_hash_table_destroy(&ht, NULL);
+    free(keys);
+}
+
+/* =========================================================
+   Versioned Table
+   ========================================================= */
+
+/* Lookups in one acquired version, and small commits against n entries */
+static void bench_versioned(size_t n) {
+    uint32_t* keys = (uint32_t*)malloc(n * sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++) keys[i] = int_key(i);
+
+    dsc_versioned_table vt;
+    dsc_versioned_table_init(&vt, 0, sizeof(uint32_t), dsc_hash_pod, dsc_cmp_pod, NULL);
+    dsc_vt_batch batch;
+    dsc_versioned_table_begin(&vt, &batch);
+    for (size_t i = 0; i < n; i++) dsc_versioned_table_put(&batch, &keys[i], &value);
+    dsc_versioned_table_commit(&batch);
+
+    size_t reps = reps_for(n);
+    dsc_vt_version* v = dsc_versioned_table_acquire(&vt);
+    uint64_t start = bench_now_ns();
+    for (size_t r = 0; r < reps; r++) {
+        for (size_t i = 0; i < n; i++) BENCH_SINK(dsc_versioned_table_get(v, &keys[i]) != NULL);
+    }
+    bench_report("vt_get_int_hit", n, n * reps, bench_now_ns() - start);
+    dsc_versioned_table_release(v);
+
+    /* Each commit replaces 10 keys; ops counts commits */
+    static int other = 2;
+    size_t commits = 10000, next = 0;
+    start = bench_now_ns();
+    for (size_t c = 0; c < commits; c++) {
+        dsc_versioned_table_begin(&vt, &batch);
+        for (size_t k = 0; k < 10; k++) {
+            dsc_versioned_table_put(&batch, &keys[next], (c & 1) ? &value : &other);
+            next = (next + 1) % n;
+        }
+        dsc_versioned_table_commit(&batch);
+    }
+    bench_report("vt_commit10", n, commits, bench_now_ns() - start);
+
+    dsc_versioned_table_destroy(&vt);
+    free(keys);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(int argc, char** argv) {
+    BENCH_INIT(argc, argv, "hash_table");
+
+    static const size_t sizes[] = { 1000, 100000, 1000000 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t n = bench_size(sizes[s]);
+        bench_int_keys(n);
+        bench_str_keys(n);
+        bench_insert_latency(n, false);
+        bench_insert_latency(n, true);
+        bench_versioned(n);
+    }
+    return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * List and Stack Benchmarks
+ * Append growth, map/filter/foreach throughput (per item and per span),
+ * and stack push/pop.
+ */
+
+#include "bench.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+
+/* Total items processed per case, so small lists are repeated */
+#define TARGET_OPS 10000000
+
+static size_t reps_for(size_t n) {
+    size_t reps = TARGET_OPS / n;
+    return reps ? reps : 1;
+}
+
+static void fill(dsc_list* list, size_t n) {
+    dsc_list_init(list, sizeof(int), n);
+    for (size_t i = 0; i < n; i++) {
+        int v = (int)i;
+        dsc_list_append(list, &v);
+    }
+}
+
+static void add_one(void* item) {
+    (*(int*)item)++;
+}
+
+static void sum_item(void* item) {
+    BENCH_SINK(*(int*)item);
+}
+
+static int is_even(void* item) {
+    return (*(int*)item & 1) == 0;
+}
+
+static void add_one_span(void* items, size_t count, size_t item_size, void* ctx) {
+    (void)item_size;
+    (void)ctx;
+    int* v = (int*)items;
+    for (size_t i = 0; i < count; i++) v[i]++;
+}
+
+static void keep_even_span(const void* items, size_t count, size_t item_size, unsigned char* keep, void* ctx) {
+    (void)item_size;
+    (void)ctx;
+    const int* v = (const int*)items;
+    for (size_t i = 0; i < count; i++) keep[i] = (v[i] & 1) == 0;
+}
+
+/* =========================================================
+   Append
+   ========================================================= */
+
+static void bench_append(size_t n) {
+    size_t reps = reps_for(n);
+    uint64_t start, grow_ns = 0, reserved_ns = 0, batch_ns = 0;
+    int* batch = (int*)malloc(n * sizeof(int));
+    for (size_t i = 0; i < n; i++) batch[i] = (int)i;
+
+    for (size_t r = 0; r < reps; r++) {
+        dsc_list list;
+
+        /* Grows from empty under the default doubling policy */
+        start = bench_now_ns();
+        dsc_list_init(&list, sizeof(int), 0);
+        for (size_t i = 0; i < n; i++) dsc_list_append(&list, &batch[i]);
+        grow_ns += bench_now_ns() - start;
+        dsc_list_destroy(&list);
+
+        start = bench_now_ns();
+        dsc_list_init(&list, sizeof(int), n);
+        for (size_t i = 0; i < n; i++) dsc_list_append(&list, &batch[i]);
+        reserved_ns += bench_now_ns() - start;
+        dsc_list_destroy(&list);
+
+        start = bench_now_ns();
+        dsc_list_init(&list, sizeof(int), 0);
+        dsc_list_append_n(&list, batch, n);
+        batch_ns += bench_now_ns() - start;
+        dsc_list_destroy(&list);
+    }
+    bench_report("append_grow", n, n * reps, grow_ns);
+    bench_report("append_reserved", n, n * reps, reserved_ns);
+    bench_report("append_n", n, n * reps, batch_ns);
+    free(batch);
+}
+
+/* =========================================================
+   Map / Filter / Foreach
+   ========================================================= */
+
+static void bench_passes(size_t n) {
+    size_t reps = reps_for(n);
+    dsc_list list;
+    fill(&list, n);
+    uint64_t start;
+
+    start = bench_now_ns();
+    for (size_t r = 0; r < reps; r++) dsc_list_map(&list, add_one);
+    bench_report("map", n, n * reps, bench_now_ns() - start);
+
+    start = bench_now_ns();
+    for (size_t r = 0; r < reps; r++) dsc_list_map_span(&list, 0, add_one_span, NULL);
+    bench_report("map_span", n, n * reps, bench_now_ns() - start);
+
+    start = bench_now_ns();
+    for (size_t r = 0; r < reps; r++) dsc_list_foreach(&list, sum_item);
+    bench_report("foreach", n, n * reps, bench_now_ns() - start);
+
+    uint64_t filter_ns = 0, span_ns = 0;
+    for (size_t r = 0; r < reps; r++) {
+        start = bench_now_ns();
+        dsc_list out = dsc_list_filter(&list, is_even);
+        filter_ns += bench_now_ns() - start;
+        BENCH_SINK(out.length);
+        dsc_list_destroy(&out);
+
+        start = bench_now_ns();
+        out = dsc_list_filter_span(&list, 0, keep_even_span, NULL);
+        span_ns += bench_now_ns() - start;
+        BENCH_SINK(out.length);
+        dsc_list_destroy(&out);
+    }
+    bench_report("filter", n, n * reps, filter_ns);
+    bench_report("filter_span", n, n * reps, span_ns);
+
+    dsc_list_destroy(&list);
+}
+
+/* =========================================================
+   Stack
+   ========================================================= */
+
+static void bench_stack(size_t n) {
+    size_t reps = reps_for(n);
+    uint64_t start, push_ns = 0, pop_ns = 0, mixed_ns = 0;
+    dsc_stack stack;
+
+    for (size_t r = 0; r < reps; r++) {
+        dsc_stack_init(&stack, sizeof(int), 0);
+
+        start = bench_now_ns();
+        for (size_t i = 0; i < n; i++) {
+            int v = (int)i;
+            dsc_stack_push(&stack, &v);
+        }
+        push_ns += bench_now_ns() - start;
+
+        int out;
+        start = bench_now_ns();
+        for (size_t i = 0; i < n; i++) BENCH_SINK(*(int*)dsc_stack_pop(&stack, &out));
+        pop_ns += bench_now_ns() - start;
+
+        /* DFS-like churn: two pushes, one pop, at a steady depth */
+        start = bench_now_ns();
+        for (size_t i = 0; i < n; i++) {
+            int v = (int)i;
+            dsc_stack_push(&stack, &v);
+            if (i & 1) BENCH_SINK(*(int*)dsc_stack_pop(&stack, &out));
+        }
+        mixed_ns += bench_now_ns() - start;
+
+        dsc_stack_destroy(&stack);
+    }
+    bench_report("stack_push", n, n * reps, push_ns);
+    bench_report("stack_pop", n, n * reps, pop_ns);
+    bench_report("stack_push_pop", n, n * reps, mixed_ns);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(int argc, char** argv) {
+    BENCH_INIT(argc, argv, "list");
+
+    static const size_t sizes[] = { 1000, 100000, 1000000 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t n = bench_size(sizes[s]);
+        bench_append(n);
+        bench_passes(n);
+        bench_stack(n);
+    }
+    return 0;
+}
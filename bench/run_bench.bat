@@ -0,0 +1,148 @@
+@echo off
+REM Build and run DSC library benchmarks
+REM Usage: run_bench.bat [compiler] [--json] [--quick] [--output file]
+REM   compiler: gcc (default), clang, or cl (MSVC)
+REM   --json:   Write a JSON array instead of CSV
+REM   --quick:  Divide every problem size by 10 (smoke run)
+REM   --output: Results file (default: build\results.csv or build\results.json)
+REM
+REM Examples:
+REM   run_bench.bat                              - Full run, CSV
+REM   run_bench.bat cl --json                    - Full run with MSVC, JSON
+REM   run_bench.bat --quick --output before.csv  - Quick run into before.csv
+REM
+REM Automatically discovers and runs all bench_*.c files. Benchmarks are
+REM built optimized; results go to the console and to the output file.
+
+setlocal enabledelayedexpansion
+
+set "COMPILER="
+set "JSON="
+set "QUICK="
+set "OUTPUT="
+
+REM Parse arguments
+:parse_args
+if "%~1"=="" goto args_done
+if /i "%~1"=="--json" (
+    set "JSON=1"
+    shift
+    goto parse_args
+)
+if /i "%~1"=="--quick" (
+    set "QUICK=--quick"
+    shift
+    goto parse_args
+)
+if /i "%~1"=="--output" (
+    set "OUTPUT=%~f2"
+    shift
+    shift
+    goto parse_args
+)
+if "!COMPILER!"=="" (
+    set "COMPILER=%~1"
+    shift
+    goto parse_args
+)
+shift
+goto parse_args
+
+:args_done
+if "!COMPILER!"=="" set "COMPILER=gcc"
+
+cd /d "%~dp0"
+
+if not exist "build" mkdir build
+
+if "!OUTPUT!"=="" (
+    if "!JSON!"=="1" (
+        set "OUTPUT=build\results.json"
+    ) else (
+        set "OUTPUT=build\results.csv"
+    )
+)
+
+echo ============================================
+echo Building DSC Library Benchmarks
+echo Compiler: !COMPILER!
+echo ============================================
+
+REM Check if any benchmark files exist
+dir /b bench_*.c >nul 2>&1
+if errorlevel 1 (
+    echo No benchmark files found ^(bench_*.c^)
+    exit /b 1
+)
+
+REM Compile all benchmarks
+set BUILD_FAILED=0
+for %%f in (bench_*.c) do (
+    echo Compiling %%f...
+    if "!COMPILER!"=="cl" (
+        cl /nologo /O2 /DNDEBUG /W4 /Fe:build\%%~nf.exe %%f
+    ) else if "!COMPILER!"=="clang" (
+        clang -O2 -DNDEBUG -Wall -Wextra -o build\%%~nf.exe %%f
+    ) else (
+        gcc -O2 -DNDEBUG -Wall -Wextra -o build\%%~nf.exe %%f
+    )
+    if errorlevel 1 set BUILD_FAILED=1
+)
+
+if !BUILD_FAILED! neq 0 (
+    echo.
+    echo Build FAILED!
+    exit /b 1
+)
+
+echo.
+echo ============================================
+echo Running Benchmarks
+echo ============================================
+
+REM Run all benchmarks; the CSV header comes from the first one only
+set "RAW=build\results.raw"
+type nul > "!RAW!"
+set TOTAL_FAILED=0
+set BENCH_COUNT=0
+set FIRST=1
+for %%f in (bench_*.c) do (
+    echo Running %%~nf...
+    set /a BENCH_COUNT+=1
+    if "!JSON!"=="1" (
+        build\%%~nf.exe --json !QUICK! >> "!RAW!"
+    ) else if "!FIRST!"=="1" (
+        build\%%~nf.exe !QUICK! >> "!RAW!"
+    ) else (
+        build\%%~nf.exe --no-header !QUICK! >> "!RAW!"
+    )
+    if errorlevel 1 set /a TOTAL_FAILED+=1
+    set FIRST=0
+)
+
+REM JSON: one object per line becomes a single array
+if "!JSON!"=="1" (
+    set "SEP= "
+    > "!OUTPUT!" (
+        echo [
+        for /f "usebackq delims=" %%l in ("!RAW!") do (
+            echo !SEP!%%l
+            set "SEP=,"
+        )
+        echo ]
+    )
+) else (
+    copy /y "!RAW!" "!OUTPUT!" >nul
+)
+del "!RAW!"
+type "!OUTPUT!"
+
+echo.
+echo ============================================
+if !TOTAL_FAILED! equ 0 (
+    echo Results written to !OUTPUT!
+    exit /b 0
+) else (
+    echo !TOTAL_FAILED! of !BENCH_COUNT! benchmark^(s^) failed!
+    exit /b 1
+)
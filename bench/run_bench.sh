@@ -0,0 +1,134 @@
+#!/bin/bash
+# Build and run DSC library benchmarks
+# Usage: ./run_bench.sh [compiler] [--json] [--quick] [--output file]
+#   compiler: gcc (default), clang
+#   --json:   Write a JSON array instead of CSV
+#   --quick:  Divide every problem size by 10 (smoke run)
+#   --output: Results file (default: build/results.csv or build/results.json)
+#
+# Examples:
+#   ./run_bench.sh                              - Full run, CSV
+#   ./run_bench.sh clang --json                 - Full run with clang, JSON
+#   ./run_bench.sh --quick --output before.csv  - Quick run into before.csv
+#
+# Automatically discovers and runs all bench_*.c files. Benchmarks are
+# built with -O2 -DNDEBUG; results go to stdout and to the output file.
+
+COMPILER=""
+JSON=0
+QUICK=""
+OUTPUT=""
+
+# Parse arguments
+while [[ $# -gt 0 ]]; do
+    case $1 in
+        --json)
+            JSON=1
+            shift
+            ;;
+        --quick)
+            QUICK="--quick"
+            shift
+            ;;
+        --output)
+            OUTPUT="$2"
+            shift 2
+            ;;
+        *)
+            if [[ -z "$COMPILER" ]]; then
+                COMPILER="$1"
+            fi
+            shift
+            ;;
+    esac
+done
+
+# Set defaults
+COMPILER="${COMPILER:-gcc}"
+if [[ -n "$OUTPUT" && "$OUTPUT" != /* ]]; then
+    OUTPUT="$(pwd)/$OUTPUT"
+fi
+
+cd "$(dirname "$0")"
+
+mkdir -p build
+
+if [[ -z "$OUTPUT" ]]; then
+    if [ $JSON -eq 1 ]; then OUTPUT="build/results.json"; else OUTPUT="build/results.csv"; fi
+fi
+
+echo "============================================" >&2
+echo "Building DSC Library Benchmarks" >&2
+echo "Compiler: $COMPILER" >&2
+echo "============================================" >&2
+
+# Find all benchmark files
+BENCH_FILES=(bench_*.c)
+
+if [ ${#BENCH_FILES[@]} -eq 0 ]; then
+    echo "No benchmark files found (bench_*.c)" >&2
+    exit 1
+fi
+
+# Compile all benchmarks
+BUILD_FAILED=0
+for src in "${BENCH_FILES[@]}"; do
+    name="${src%.c}"
+    echo "Compiling $src..." >&2
+    case "$COMPILER" in
+        clang)
+            clang -O2 -DNDEBUG -Wall -Wextra -pthread -o "build/$name" "$src" || BUILD_FAILED=1
+            ;;
+        *)
+            gcc -O2 -DNDEBUG -Wall -Wextra -pthread -o "build/$name" "$src" || BUILD_FAILED=1
+            ;;
+    esac
+done
+
+if [ $BUILD_FAILED -ne 0 ]; then
+    echo "" >&2
+    echo "Build FAILED!" >&2
+    exit 1
+fi
+
+echo "" >&2
+echo "============================================" >&2
+echo "Running Benchmarks" >&2
+echo "============================================" >&2
+
+# Run all benchmarks; the CSV header comes from the first one only
+RAW="build/results.raw"
+: > "$RAW"
+TOTAL_FAILED=0
+FIRST=1
+for src in "${BENCH_FILES[@]}"; do
+    name="${src%.c}"
+    echo "Running $name..." >&2
+    if [ $JSON -eq 1 ]; then
+        ./build/"$name" --json $QUICK >> "$RAW" || TOTAL_FAILED=$((TOTAL_FAILED + 1))
+    elif [ $FIRST -eq 1 ]; then
+        ./build/"$name" $QUICK >> "$RAW" || TOTAL_FAILED=$((TOTAL_FAILED + 1))
+    else
+        ./build/"$name" --no-header $QUICK >> "$RAW" || TOTAL_FAILED=$((TOTAL_FAILED + 1))
+    fi
+    FIRST=0
+done
+
+# JSON: one object per line becomes a single array
+if [ $JSON -eq 1 ]; then
+    { echo "["; sed '$!s/$/,/' "$RAW"; echo "]"; } > "$OUTPUT"
+else
+    cp "$RAW" "$OUTPUT"
+fi
+rm -f "$RAW"
+cat "$OUTPUT"
+
+echo "" >&2
+echo "============================================" >&2
+if [ $TOTAL_FAILED -eq 0 ]; then
+    echo "Results written to $OUTPUT" >&2
+    exit 0
+else
+    echo "$TOTAL_FAILED of ${#BENCH_FILES[@]} benchmark(s) failed!" >&2
+    exit 1
+fi
@@ -16,10 +16,23 @@
  * FEATURES
  * --------
  *   • Hash Table    — O(1) average insert/lookup/delete with automatic resizing with Generic keys (int, string, struct, pointer)
- *   • Dynamic List  — Growable array with map, filter, and foreach operations
- *   • Set           — Hash-based set with automatic duplicate prevention
+ *   • Flat Table    — Open-addressing (Robin Hood) hash table with inline slots
+ *   • Hash Map      — Macro-generated map specialized per key/value type (inlined hash and compare)
+ *   • Concurrent    — Lock-striped hash table for multi-threaded readers and writers
+ *   • Versioned     — Copy-on-write hash table with lock-free readers and batched commits
+ *   • Dynamic List  — Growable array with map, filter, and foreach operations (sequential or parallel), sorting and binary search
+ *   • SoA List      — Struct-of-arrays list with one 64-byte aligned column per field
+ *   • Thread Pool   — Reusable worker pool for chunked parallel loops
+ *   • Set           — Hash-based set with duplicate prevention and set algebra
+ *   • Bitset        — Dense integer-ID set with word-parallel algebra and popcount
+ *   • Bloom Filter  — Blocked Bloom filter, standalone or in front of a table/set
+ *   • Snapshots     — Position-independent hash table/set images, loaded or mapped read-only
  *   • Stack         — LIFO data structure with O(1) push/pop/peek operations
+ *   • Deque         — Segmented, pointer-stable deque with O(1) worst-case push and batch push/pop
+ *   • Queues        — Lock-free MPMC queue and SPSC ring buffer with batch push/pop
  *   • Type-Safe     — Generic macros for compile-time type safety
+ *   • Allocators    — Pluggable allocator interface with a built-in slab/arena
+ *   • Mapped Memory — Reserve-and-commit and file-backed buffers for lists that never copy
  *   • Error System  — Thread-local errno-style error handling
  *   • Zero Dependencies — Only requires standard C library
  *   • Cross-Platform — Windows, Linux, macOS, BSD
@@ -47,6 +60,7 @@
  *   DSC_SHARED          — Build/use as shared library (.dll/.so)
  *   DSC_BUILD           — Define when building shared library
  *   DSC_PREFIX          — Custom function prefix (default: dsc_)
+ *   DSC_STATS           — Count allocations, resizes and rehash time (see hash_table_stats)
  * 
  * EXAMPLE USAGE
  * -------------
@@ -170,7 +184,10 @@ extern "C" {
     X(DSC_ERANGE,    "Index out of range")                      \
     X(DSC_EEMPTY,    "Container is empty")                      \
     X(DSC_EHASHFUNC, "Hash function is NULL or invalid")        \
-    X(DSC_ECMPFUNC,  "Comparison function is NULL or invalid")
+    X(DSC_ECMPFUNC,  "Comparison function is NULL or invalid")  \
+    X(DSC_EFULL,     "Container is full")                       \
+    X(DSC_EIO,       "File could not be read or written")       \
+    X(DSC_ECONFLICT, "Another writer committed first")
 
 /* Generate the enum */
 typedef enum {
@@ -198,42 +215,305 @@ DSC_API void         DSC_FUNC(clear_error)(void);
 /* ---------------------------------------------------------------
    Public API declarations
    --------------------------------------------------------------- */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>     /* DSC_DEFINE_HASH_MAP expands to inline malloc/free calls */
+#include <string.h>
+
+/*
+ * +----------------------------------------------------------------+
+ * |                         ALLOCATOR API                          |
+ * +----------------------------------------------------------------+
+ */
+
+/*
+ * Pluggable allocator for container storage. Pass NULL wherever an
+ * allocator is accepted to use malloc/realloc/free.
+ *
+ * free may be NULL for allocators that reclaim memory in bulk (such as
+ * dsc_arena); containers then skip per-entry frees in clear/destroy.
+ */
+typedef struct _dsc_allocator {
+    void* (*alloc)(void *ctx, size_t size);
+    void* (*realloc)(void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void  (*free)(void *ctx, void *ptr, size_t size);
+    void  *ctx;
+} dsc_allocator;
+
+/*
+ * Slab/arena allocator: carves allocations out of large slabs and
+ * releases them all at once in O(number of slabs). Individual frees are
+ * no-ops. Use &arena.allocator wherever a dsc_allocator is accepted.
+ */
+typedef struct _dsc_arena_slab {
+    struct _dsc_arena_slab *next;
+    size_t                  size;   /* Usable bytes after the header */
+    size_t                  used;
+} dsc_arena_slab;
+
+typedef struct _dsc_arena {
+    dsc_allocator   allocator;
+    dsc_arena_slab  *slabs;         /* Current slab first */
+    size_t          slab_size;
+    void            *last;          /* Most recent allocation, can grow in place */
+} dsc_arena;
+
+DSC_API void      DSC_FUNC(arena_init)(dsc_arena *arena, size_t slab_size);
+DSC_API void*     DSC_FUNC(arena_alloc)(dsc_arena *arena, size_t size);
+DSC_API void      DSC_FUNC(arena_reset)(dsc_arena *arena);
+DSC_API void      DSC_FUNC(arena_destroy)(dsc_arena *arena);
+
+/*
+ * Instrumentation. Define DSC_STATS to have hash tables and lists count
+ * their allocations, resizes and rehash time; the counters are read back
+ * with hash_table_stats, list_stats and stack_stats. It changes the layout
+ * of dsc_hash_table and dsc_list, so define it the same way in every file
+ * that includes dsc.h. Without it those calls still report what can be
+ * measured from the structure itself, the counted fields read as zero and
+ * the hot paths carry no bookkeeping at all.
+ */
+typedef struct _dsc_alloc_stats {
+    uint64_t    allocs;         /* Successful alloc/realloc calls */
+    uint64_t    frees;
+    size_t      bytes;          /* Held right now */
+    size_t      peak_bytes;
+} dsc_alloc_stats;
+
+/*
+ * Virtual-memory backing for one large, growing buffer (typically a
+ * dsc_list). init reserves address space up front and pages are committed
+ * as the buffer grows, so realloc never copies. open does the same over a
+ * file: the buffer lives in the file, follows a small header, and can be
+ * mapped again later without reading or copying anything.
+ *
+ * The first live allocation gets the mapped buffer; any other allocation
+ * made through the same allocator (e.g. the result of list_filter) falls
+ * back to the heap. Define DSC_NO_VMEM to compile this out; it is defined
+ * automatically when the platform headers do not expose anonymous mmap.
+ */
+#if !defined(DSC_NO_VMEM) && !defined(_WIN32)
+    #include <sys/mman.h>
+    #if !defined(MAP_ANONYMOUS) && !defined(MAP_ANON)
+        /* Strict ISO modes hide MAP_ANONYMOUS: use -std=gnu11 or -D_DEFAULT_SOURCE */
+        #define DSC_NO_VMEM
+    #endif
+#endif
+
+#ifndef DSC_NO_VMEM
+
+#define DSC_VMEM_HUGE_PAGES  0x1u   /* Ask for transparent huge pages (anonymous only) */
+
+typedef struct _dsc_vmem {
+    dsc_allocator   allocator;      /* Use &vm.allocator, or dsc_list_init_mapped */
+    unsigned char   *base;          /* Header, then the buffer */
+    size_t          reserved;       /* Address space available from base */
+    size_t          committed;      /* Bytes currently backed from base */
+    size_t          granularity;    /* Commit unit */
+    void            *map_base;      /* Whole reservation (base may be aligned inside it) */
+    size_t          map_size;
+    intptr_t        file;           /* Descriptor or HANDLE, -1 when anonymous */
+    void            *file_map;      /* Windows file-mapping handle */
+    unsigned        flags;
+    bool            in_use;         /* The mapped buffer is handed out */
+} dsc_vmem;
+
+DSC_API void      DSC_FUNC(vmem_init)(dsc_vmem *vm, size_t reserve, unsigned flags);
+DSC_API void      DSC_FUNC(vmem_open)(dsc_vmem *vm, const char *path, size_t reserve, unsigned flags);
+DSC_API void*     DSC_FUNC(vmem_data)(dsc_vmem *vm);
+DSC_API void      DSC_FUNC(vmem_sync)(dsc_vmem *vm);
+DSC_API void      DSC_FUNC(vmem_destroy)(dsc_vmem *vm);
+
+#endif /* DSC_NO_VMEM */
 
 /*
  * +----------------------------------------------------------------+
  * |                         HASHTABLE API                          |
  * +----------------------------------------------------------------+
  */
-#include <stdint.h>
-#include <stdbool.h>
 
 typedef struct _dsc_kvpair {
     void                 *obj;
     struct _dsc_kvpair   *next;
     void                 *key;
     size_t               key_size;
+    uint64_t             hash;      /* Full hash of key, cached at insert time */
 } dsc_kvpair;
 
 typedef uint64_t dsc_hashfunc(const void*, size_t);
 typedef int      dsc_cmpfunc(const void*, size_t, const void*, size_t);
 
+/*
+ * Built-in hash/compare pairs (wyhash-style, 64-bit multiply mixing):
+ *   hash_str/cmp_str  NUL-terminated strings, for key_size 0
+ *   hash_pod/cmp_pod  fixed-size plain-data keys, fast paths for 4/8/16 bytes
+ *   hash_ptr/cmp_ptr  pointer-valued keys, for key_size sizeof(void*)
+ * hash_bytes hashes any len bytes and is the building block for the rest.
+ */
+DSC_API uint64_t  DSC_FUNC(hash_bytes)(const void *key, size_t len);
+DSC_API uint64_t  DSC_FUNC(hash_str)(const void *key, size_t len);
+DSC_API int       DSC_FUNC(cmp_str)(const void *key1, size_t len1, const void *key2, size_t len2);
+DSC_API uint64_t  DSC_FUNC(hash_pod)(const void *key, size_t len);
+DSC_API int       DSC_FUNC(cmp_pod)(const void *key1, size_t len1, const void *key2, size_t len2);
+DSC_API uint64_t  DSC_FUNC(hash_ptr)(const void *key, size_t len);
+DSC_API int       DSC_FUNC(cmp_ptr)(const void *key1, size_t len1, const void *key2, size_t len2);
+
 typedef struct _dsc_hash_table {
     size_t          size;
-    size_t          capacity;
+    size_t          capacity;       /* Number of buckets, always a power of two */
     size_t          key_size;
     dsc_hashfunc    *hf;
     dsc_cmpfunc     *cf;
     dsc_kvpair      **kvpairs;
+    const dsc_allocator *allocator;     /* NULL means malloc/free */
+    /* Incremental rehash state: old_kvpairs is non-NULL while buckets are migrating */
+    dsc_kvpair      **old_kvpairs;
+    size_t          old_capacity;
+    size_t          rehash_index;
+    bool            incremental;
+    size_t          shrink_percent;     /* Low watermark, 0 = never shrink: see hash_table_set_shrink */
+    size_t          min_capacity;       /* Automatic shrinking stops here */
+    struct _dsc_bloom *filter;          /* Optional, not owned: see hash_table_attach_filter */
+#ifdef DSC_STATS
+    dsc_alloc_stats alloc_stats;        /* Nodes and bucket arrays */
+    uint64_t        resizes;
+    uint64_t        rehash_ns;
+#endif
 } dsc_hash_table;
 
 typedef void dsc_cleanupfunc(void*);
 
 DSC_API void      DSC_FUNC(hash_table_init)(dsc_hash_table *ht, size_t capacity, size_t key_size, dsc_hashfunc *hf, dsc_cmpfunc *cf);
+DSC_API void      DSC_FUNC(hash_table_init_with_allocator)(dsc_hash_table *ht, size_t capacity, size_t key_size, dsc_hashfunc *hf, dsc_cmpfunc *cf, const dsc_allocator *allocator);
 DSC_API bool      DSC_FUNC(hash_table_insert)(dsc_hash_table *ht, const void *key, void *obj);
+DSC_API void**    DSC_FUNC(hash_table_upsert)(dsc_hash_table *ht, const void *key, void *obj, bool *inserted);
 DSC_API void*     DSC_FUNC(hash_table_get)(dsc_hash_table *ht, const void *key);
 DSC_API void*     DSC_FUNC(hash_table_delete)(dsc_hash_table *ht, const void *key);
 DSC_API void      DSC_FUNC(hash_table_destroy)(dsc_hash_table *ht, dsc_cleanupfunc *cf);
 DSC_API void      DSC_FUNC(hash_table_clear)(dsc_hash_table *ht, dsc_cleanupfunc *cf);
+DSC_API void      DSC_FUNC(hash_table_set_incremental)(dsc_hash_table *ht, bool enabled);
+DSC_API bool      DSC_FUNC(hash_table_rehash_step)(dsc_hash_table *ht, size_t buckets);
+
+/*
+ * Sizing. reserve grows the bucket array in one step so that count entries
+ * in total fit without another resize. compact rebuilds it at the smallest
+ * size that holds the current entries, finishing any migration first. Both
+ * leave nodes in place (values and upsert slots stay valid) and return
+ * false with DSC_ENOMEM, table unchanged, if the new array cannot be had.
+ *
+ * set_shrink turns on automatic shrinking: once delete, delete_batch or
+ * clear leaves the load factor under low_percent / 100 (at most 50), the
+ * array shrinks to at most half full, like a grow in reverse (incremental
+ * tables migrate step by step). It never goes below min_capacity, which is
+ * the init capacity and is moved to the result of the last reserve or
+ * compact. iter_delete never shrinks, so live iterators stay valid; scan
+ * cursors survive a shrink between calls like they survive a grow.
+ */
+DSC_API bool      DSC_FUNC(hash_table_reserve)(dsc_hash_table *ht, size_t count);
+DSC_API bool      DSC_FUNC(hash_table_compact)(dsc_hash_table *ht);
+DSC_API void      DSC_FUNC(hash_table_set_shrink)(dsc_hash_table *ht, size_t low_percent);
+
+/*
+ * Explicit-length variants, for callers that already know the key length.
+ * In a string table (key_size 0) len is the length without the terminator
+ * and key need not be NUL-terminated, so a slice of a larger buffer works
+ * and no strlen runs; the stored copy is terminated as usual. The table's
+ * hf and cf then receive (key, len + 1) and must not read key[len]; the
+ * built-in hash_str/cmp_str do not. In a fixed-size table len must equal
+ * key_size. Either way a bad len is DSC_EINVAL.
+ */
+DSC_API bool      DSC_FUNC(hash_table_insert_len)(dsc_hash_table *ht, const void *key, size_t len, void *obj);
+DSC_API void*     DSC_FUNC(hash_table_get_len)(dsc_hash_table *ht, const void *key, size_t len);
+DSC_API void*     DSC_FUNC(hash_table_delete_len)(dsc_hash_table *ht, const void *key, size_t len);
+
+/*
+ * Puts a Bloom filter in front of the table: inserts record each key's hash
+ * in it and lookups that the filter rules out return without touching the
+ * buckets. Keys already in the table are added on attach, clear also clears
+ * the filter, and NULL detaches. The filter is not owned; it must outlive
+ * the attachment and should not be shared with another table.
+ */
+DSC_API void      DSC_FUNC(hash_table_attach_filter)(dsc_hash_table *ht, struct _dsc_bloom *filter);
+
+/*
+ * Shape of the table, for spotting weak hash functions and sizing. The
+ * distribution fields come from one walk over every bucket and cost
+ * O(capacity); the table is not modified (no rehash step is taken).
+ * probe lengths count the nodes a successful lookup compares, so a table
+ * with no collisions has max_probe 1 and mean_probe 1.0. resizes,
+ * rehash_ns and alloc count only in DSC_STATS builds; alloc.bytes is not
+ * reduced by clear/destroy under a bulk-release allocator.
+ */
+#define DSC_STATS_HISTOGRAM 8
+
+typedef struct _dsc_table_stats {
+    size_t      size;
+    size_t      capacity;
+    double      load_factor;
+    size_t      max_probe;                      /* Longest chain */
+    double      mean_probe;
+    size_t      histogram[DSC_STATS_HISTOGRAM]; /* Buckets holding i entries; the last slot is "or more" */
+    size_t      node_bytes;                     /* dsc_kvpair headers */
+    size_t      key_bytes;                      /* Key copies stored behind them */
+    size_t      bucket_bytes;                   /* Both bucket arrays */
+    uint64_t    resizes;
+    uint64_t    rehash_ns;                      /* Time spent migrating buckets */
+    dsc_alloc_stats alloc;
+} dsc_table_stats;
+
+DSC_API dsc_table_stats DSC_FUNC(hash_table_stats)(dsc_hash_table *ht);
+
+/*
+ * Batch operations. keys follows the dsc_set_from_array layout: packed keys
+ * of key_size bytes each, or an array of key pointers when key_size is 0.
+ * status (optional) receives one error code per key; the return value is the
+ * number of keys that succeeded. The global error only reports bad arguments.
+ */
+DSC_API size_t    DSC_FUNC(hash_table_insert_batch)(dsc_hash_table *ht, const void *keys, void *const *objs, size_t count, dsc_error_t *status);
+DSC_API size_t    DSC_FUNC(hash_table_get_batch)(dsc_hash_table *ht, const void *keys, void **out, size_t count, dsc_error_t *status);
+DSC_API size_t    DSC_FUNC(hash_table_delete_batch)(dsc_hash_table *ht, const void *keys, void **out, size_t count, dsc_error_t *status);
+
+/*
+ * Unchecked tier. These skip argument validation and never touch
+ * dsc_get_error(): the result is the only report, so a hot loop pays no
+ * thread-local write per call (a __tls_get_addr call in DSC_SHARED builds on
+ * some platforms). The container must be initialized and pointers non-NULL.
+ * get_unchecked returns NULL when the key is absent.
+ */
+DSC_API void*     DSC_FUNC(hash_table_get_unchecked)(dsc_hash_table *ht, const void *key);
+
+/*
+ * In-place iteration. iter_next steps to the next entry and exposes it as
+ * it->kvp (key, key_size, obj and the cached hash, with no copies and no
+ * allocation); obj may be assigned through it. iter_delete unlinks the
+ * current entry and returns its object, and the walk carries on with its
+ * successor. No other call may modify the table while an iterator is in
+ * use: a lookup can advance an incremental rehash and move entries.
+ * iter_next never touches dsc_get_error().
+ */
+typedef struct _dsc_hash_table_iter {
+    dsc_hash_table  *ht;
+    dsc_kvpair      *kvp;       /* Current entry, NULL before the first next and after a delete */
+    dsc_kvpair      **link;     /* Link that points at the current entry */
+    size_t          bucket;     /* Position over both bucket arrays */
+} dsc_hash_table_iter;
+
+/*
+ * Resumable scan in the style of Redis SCAN. Start with cursor 0 and pass
+ * each returned cursor back in until it comes back as 0. Every call visits
+ * whole buckets until about count entries were reported, and the table may
+ * be freely modified between calls: an entry present for the entire scan is
+ * reported at least once even if the table resizes in between, though it
+ * may be reported more than once. The cursor walks bucket indexes in
+ * reversed-bit order, which is what keeps it valid across a resize. fn must
+ * not modify the table; collect the keys and act on them after the call.
+ */
+typedef void dsc_scanfunc(const void *key, size_t key_size, void *obj, uint64_t hash, void *ctx);
+
+DSC_API void      DSC_FUNC(hash_table_iter_begin)(dsc_hash_table *ht, dsc_hash_table_iter *it);
+DSC_API bool      DSC_FUNC(hash_table_iter_next)(dsc_hash_table_iter *it);
+DSC_API void*     DSC_FUNC(hash_table_iter_delete)(dsc_hash_table_iter *it);
+DSC_API size_t    DSC_FUNC(hash_table_scan)(dsc_hash_table *ht, size_t cursor, size_t count, dsc_scanfunc *fn, void *ctx);
 
 #define DSC_DEFINE_HASH_TABLE(K, T, NAME) \
     typedef struct { dsc_hash_table impl; } NAME##_table; \
@@ -243,46 +523,711 @@ DSC_API void      DSC_FUNC(hash_table_clear)(dsc_hash_table *ht, dsc_cleanupfunc
     static inline bool NAME##_table_insert(NAME##_table *t, K *k, T v) { \
         return DSC_FUNC(hash_table_insert)(&t->impl, (const void*)k, (void*)v); \
     } \
+    static inline T* NAME##_table_upsert(NAME##_table *t, K *k, T v, bool *inserted) { \
+        return (T*)DSC_FUNC(hash_table_upsert)(&t->impl, (const void*)k, (void*)v, inserted); \
+    } \
     static inline T NAME##_table_get(NAME##_table *t, K *k) { \
         return (T)DSC_FUNC(hash_table_get)(&t->impl, (const void*)k); \
     } \
+    static inline T NAME##_table_get_unchecked(NAME##_table *t, K *k) { \
+        return (T)DSC_FUNC(hash_table_get_unchecked)(&t->impl, (const void*)k); \
+    } \
     static inline T NAME##_table_delete(NAME##_table *t, K *k) { \
         return (T)DSC_FUNC(hash_table_delete)(&t->impl, (const void*)k); \
     } \
+    static inline bool NAME##_table_reserve(NAME##_table *t, size_t count) { \
+        return DSC_FUNC(hash_table_reserve)(&t->impl, count); \
+    } \
+    static inline bool NAME##_table_compact(NAME##_table *t) { \
+        return DSC_FUNC(hash_table_compact)(&t->impl); \
+    } \
+    static inline void NAME##_table_set_shrink(NAME##_table *t, size_t low_percent) { \
+        DSC_FUNC(hash_table_set_shrink)(&t->impl, low_percent); \
+    } \
+    static inline void NAME##_table_iter_begin(NAME##_table *t, dsc_hash_table_iter *it) { \
+        DSC_FUNC(hash_table_iter_begin)(&t->impl, it); \
+    } \
+    static inline bool NAME##_table_iter_next(dsc_hash_table_iter *it, K **k, T *v) { \
+        if (!DSC_FUNC(hash_table_iter_next)(it)) return false; \
+        if (k != NULL) *k = (K*)it->kvp->key; \
+        if (v != NULL) *v = (T)it->kvp->obj; \
+        return true; \
+    } \
+    static inline T NAME##_table_iter_delete(dsc_hash_table_iter *it) { \
+        return (T)DSC_FUNC(hash_table_iter_delete)(it); \
+    } \
     static inline void NAME##_table_destroy(NAME##_table *t, dsc_cleanupfunc *cf) { \
         DSC_FUNC(hash_table_destroy)(&t->impl, cf); \
     }
 
+/*
+ * +----------------------------------------------------------------+
+ * |                        BLOOM FILTER API                        |
+ * +----------------------------------------------------------------+
+ */
+
+/*
+ * Blocked Bloom filter: every key maps to one 64-byte block and sets k bits
+ * inside it, so a query costs one cache miss at most. The k bit positions
+ * come from a single dsc_hashfunc value by double hashing (h1 + i*h2), which
+ * is what lets a hash table or set feed the filter the hash it already
+ * computed. "No" is exact; "maybe" is wrong with about fp_rate probability
+ * while the filter holds no more than expected_items keys.
+ *
+ * Keys cannot be removed; a deleted key's bits stay set and only raise the
+ * false-positive rate until the filter is cleared and rebuilt.
+ */
+typedef struct _dsc_bloom {
+    uint64_t            *words;
+    size_t              nblocks;        /* 512-bit blocks, always a power of two */
+    unsigned            k;              /* Bits set per key */
+    size_t              count;          /* Keys added, duplicates included */
+    size_t              key_size;       /* 0 = NUL-terminated strings */
+    dsc_hashfunc        *hf;
+    const dsc_allocator *allocator;     /* NULL means malloc/free */
+} dsc_bloom;
+
+DSC_API void      DSC_FUNC(bloom_init)(dsc_bloom *bf, size_t expected_items, double fp_rate, size_t key_size, dsc_hashfunc *hf);
+DSC_API void      DSC_FUNC(bloom_init_with_allocator)(dsc_bloom *bf, size_t expected_items, double fp_rate, size_t key_size, dsc_hashfunc *hf, const dsc_allocator *allocator);
+DSC_API void      DSC_FUNC(bloom_destroy)(dsc_bloom *bf);
+DSC_API void      DSC_FUNC(bloom_clear)(dsc_bloom *bf);
+DSC_API void      DSC_FUNC(bloom_add)(dsc_bloom *bf, const void *key);
+DSC_API bool      DSC_FUNC(bloom_contains)(const dsc_bloom *bf, const void *key);
+DSC_API void      DSC_FUNC(bloom_add_hash)(dsc_bloom *bf, uint64_t hash);
+DSC_API bool      DSC_FUNC(bloom_contains_hash)(const dsc_bloom *bf, uint64_t hash);
+DSC_API double    DSC_FUNC(bloom_fp_rate)(const dsc_bloom *bf);
+
+/*
+ * Batched query, keys laid out like hash_table_get_batch. All keys of a
+ * block are hashed and their filter blocks prefetched before any is tested.
+ * out (optional) receives one "maybe present" flag per key; the return
+ * value is the number of maybes; NULL key pointers are reported absent.
+ */
+DSC_API size_t    DSC_FUNC(bloom_contains_batch)(const dsc_bloom *bf, const void *keys, bool *out, size_t count);
+
+/*
+ * +----------------------------------------------------------------+
+ * |              FLAT (OPEN-ADDRESSING) HASHTABLE API              |
+ * +----------------------------------------------------------------+
+ */
+
+/*
+ * Every entry lives inline in one contiguous slot array:
+ *
+ *     [ hash | obj | key bytes ] [ hash | obj | key bytes ] ...
+ *
+ * Collisions are resolved with Robin Hood linear probing and deletion
+ * uses backward shifting, so there are no tombstones. Fixed-size keys
+ * are copied into the slot itself; variable-length keys (key_size == 0)
+ * keep a pointer to a heap copy in the slot. An empty slot has obj == NULL.
+ */
+typedef struct _dsc_flat_slot {
+    uint64_t  hash;
+    void     *obj;
+} dsc_flat_slot;
+
+typedef struct _dsc_flat_table {
+    size_t          size;
+    size_t          capacity;   /* Number of slots, always a power of two */
+    size_t          key_size;
+    size_t          slot_size;  /* Bytes per slot, header + key area */
+    unsigned        shift;      /* 64 - log2(capacity), for Fibonacci hashing */
+    dsc_hashfunc    *hf;
+    dsc_cmpfunc     *cf;
+    unsigned char   *slots;
+} dsc_flat_table;
+
+DSC_API void      DSC_FUNC(flat_table_init)(dsc_flat_table *ft, size_t capacity, size_t key_size, dsc_hashfunc *hf, dsc_cmpfunc *cf);
+DSC_API bool      DSC_FUNC(flat_table_insert)(dsc_flat_table *ft, const void *key, void *obj);
+DSC_API void*     DSC_FUNC(flat_table_get)(dsc_flat_table *ft, const void *key);
+DSC_API void*     DSC_FUNC(flat_table_get_unchecked)(dsc_flat_table *ft, const void *key);    /* See hash_table_get_unchecked */
+DSC_API void*     DSC_FUNC(flat_table_delete)(dsc_flat_table *ft, const void *key);
+DSC_API void      DSC_FUNC(flat_table_destroy)(dsc_flat_table *ft, dsc_cleanupfunc *cf);
+DSC_API void      DSC_FUNC(flat_table_clear)(dsc_flat_table *ft, dsc_cleanupfunc *cf);
+
+#define DSC_DEFINE_FLAT_TABLE(K, T, NAME) \
+    typedef struct { dsc_flat_table impl; } NAME##_flat_table; \
+    static inline void NAME##_flat_table_init(NAME##_flat_table *t, size_t s, dsc_hashfunc *hf, dsc_cmpfunc *cf) { \
+        DSC_FUNC(flat_table_init)(&t->impl, s, sizeof(K), hf, cf); \
+    } \
+    static inline bool NAME##_flat_table_insert(NAME##_flat_table *t, K *k, T v) { \
+        return DSC_FUNC(flat_table_insert)(&t->impl, (const void*)k, (void*)v); \
+    } \
+    static inline T NAME##_flat_table_get(NAME##_flat_table *t, K *k) { \
+        return (T)DSC_FUNC(flat_table_get)(&t->impl, (const void*)k); \
+    } \
+    static inline T NAME##_flat_table_get_unchecked(NAME##_flat_table *t, K *k) { \
+        return (T)DSC_FUNC(flat_table_get_unchecked)(&t->impl, (const void*)k); \
+    } \
+    static inline T NAME##_flat_table_delete(NAME##_flat_table *t, K *k) { \
+        return (T)DSC_FUNC(flat_table_delete)(&t->impl, (const void*)k); \
+    } \
+    static inline void NAME##_flat_table_destroy(NAME##_flat_table *t, dsc_cleanupfunc *cf) { \
+        DSC_FUNC(flat_table_destroy)(&t->impl, cf); \
+    }
+
+/*
+ * +----------------------------------------------------------------+
+ * |                   SPECIALIZED HASH MAP (MACRO)                 |
+ * +----------------------------------------------------------------+
+ */
+
+/*
+ * DSC_DEFINE_HASH_MAP(K, V, NAME, HASH, EQ) generates NAME_map, an
+ * open-addressing table fully specialized at compile time:
+ *
+ *   - keys and values are stored by value in parallel K[] / V[] arrays
+ *   - HASH(key) -> uint64_t and EQ(a, b) -> nonzero-if-equal are called
+ *     directly (functions or function-like macros), so they inline
+ *   - a one-byte control array (0 = empty, else 0x80 | 7 hash bits) is
+ *     probed first, so most mismatches never touch the key array
+ *
+ * Linear probing with backward-shift deletion, no tombstones, max load 3/4.
+ * Failures are reported through return values only; the generated
+ * functions never touch dsc_get_error().
+ *
+ *   DSC_DEFINE_HASH_MAP(uint64_t, Point, point, dsc_hash_u64, DSC_MAP_EQ)
+ *   point_map m;  point_map_init(&m, 0);
+ *   Point* p = point_map_upsert(&m, 42, NULL);
+ */
+
+#define DSC_MAP_MIN_CAPACITY 8
+#define DSC_MAP_NPOS         ((size_t)-1)
+#define DSC_MAP_EQ(a, b)     ((a) == (b))
+
+/* Ready-made HASH functions for integer keys (splitmix64 finalizer) */
+static inline uint64_t DSC_FUNC(hash_u64)(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static inline uint64_t DSC_FUNC(hash_u32)(uint32_t x) {
+    return DSC_FUNC(hash_u64)((uint64_t)x);
+}
+
+#define DSC_DEFINE_HASH_MAP(K, V, NAME, HASH, EQ) \
+    typedef struct { \
+        size_t         size; \
+        size_t         capacity;   /* Power of two, or 0 before init */ \
+        unsigned       shift;      /* 64 - log2(capacity) */ \
+        unsigned char *ctrl; \
+        K             *keys; \
+        V             *vals; \
+    } NAME##_map; \
+    static inline size_t NAME##_map_home_(const NAME##_map *m, uint64_t h) { \
+        return (size_t)((h * 11400714819323198485ULL) >> m->shift); \
+    } \
+    static inline unsigned char NAME##_map_tag_(uint64_t h) { \
+        return (unsigned char)(0x80 | (h & 0x7f)); \
+    } \
+    static inline bool NAME##_map_alloc_(NAME##_map *m, size_t capacity) { \
+        if (capacity > SIZE_MAX / sizeof(K) || capacity > SIZE_MAX / sizeof(V)) return false; \
+        unsigned char *ctrl = (unsigned char *)calloc(capacity, 1); \
+        K             *keys = (K *)malloc(capacity * sizeof(K)); \
+        V             *vals = (V *)malloc(capacity * sizeof(V)); \
+        if (ctrl == NULL || keys == NULL || vals == NULL) { \
+            free(ctrl); free(keys); free(vals); \
+            return false; \
+        } \
+        unsigned shift = 64; \
+        for (size_t c = capacity; c > 1; c >>= 1) shift--; \
+        m->ctrl = ctrl; m->keys = keys; m->vals = vals; \
+        m->capacity = capacity; m->shift = shift; \
+        return true; \
+    } \
+    static inline bool NAME##_map_init(NAME##_map *m, size_t capacity) { \
+        size_t cap = DSC_MAP_MIN_CAPACITY; \
+        while (cap < capacity && cap <= SIZE_MAX / 2) cap <<= 1; \
+        m->size = 0; m->capacity = 0; m->ctrl = NULL; m->keys = NULL; m->vals = NULL; \
+        return NAME##_map_alloc_(m, cap); \
+    } \
+    static inline void NAME##_map_destroy(NAME##_map *m) { \
+        free(m->ctrl); free(m->keys); free(m->vals); \
+        m->ctrl = NULL; m->keys = NULL; m->vals = NULL; \
+        m->size = 0; m->capacity = 0; \
+    } \
+    static inline void NAME##_map_clear(NAME##_map *m) { \
+        if (m->ctrl != NULL) memset(m->ctrl, 0, m->capacity); \
+        m->size = 0; \
+    } \
+    static inline size_t NAME##_map_find_(const NAME##_map *m, K key, uint64_t h) { \
+        if (m->capacity == 0) return DSC_MAP_NPOS; \
+        size_t        mask = m->capacity - 1; \
+        unsigned char tag  = NAME##_map_tag_(h); \
+        for (size_t i = NAME##_map_home_(m, h);; i = (i + 1) & mask) { \
+            unsigned char c = m->ctrl[i]; \
+            if (c == 0) return DSC_MAP_NPOS; \
+            if (c == tag && EQ(m->keys[i], key)) return i; \
+        } \
+    } \
+    /* Claim the first empty slot from h's home; the key must be absent */ \
+    static inline size_t NAME##_map_claim_(NAME##_map *m, uint64_t h) { \
+        size_t mask = m->capacity - 1; \
+        size_t i    = NAME##_map_home_(m, h); \
+        while (m->ctrl[i] != 0) i = (i + 1) & mask; \
+        m->ctrl[i] = NAME##_map_tag_(h); \
+        return i; \
+    } \
+    static inline bool NAME##_map_grow_(NAME##_map *m) { \
+        NAME##_map old = *m; \
+        if (old.capacity > SIZE_MAX / 2 || !NAME##_map_alloc_(m, old.capacity * 2)) { \
+            *m = old; \
+            return false; \
+        } \
+        for (size_t i = 0; i < old.capacity; i++) { \
+            if (old.ctrl[i] == 0) continue; \
+            size_t j = NAME##_map_claim_(m, HASH(old.keys[i])); \
+            m->keys[j] = old.keys[i]; \
+            m->vals[j] = old.vals[i]; \
+        } \
+        free(old.ctrl); free(old.keys); free(old.vals); \
+        return true; \
+    } \
+    static inline bool NAME##_map_reserve_one_(NAME##_map *m) { \
+        if (m->capacity == 0 && !NAME##_map_init(m, 0)) return false; \
+        if ((m->size + 1) * 4 > m->capacity * 3) return NAME##_map_grow_(m); \
+        return true; \
+    } \
+    static inline V *NAME##_map_get(NAME##_map *m, K key) { \
+        size_t i = NAME##_map_find_(m, key, HASH(key)); \
+        return (i == DSC_MAP_NPOS) ? NULL : &m->vals[i]; \
+    } \
+    static inline bool NAME##_map_contains(NAME##_map *m, K key) { \
+        return NAME##_map_find_(m, key, HASH(key)) != DSC_MAP_NPOS; \
+    } \
+    /* Pointer to key's value, inserting a zeroed value if absent; NULL on ENOMEM */ \
+    static inline V *NAME##_map_upsert(NAME##_map *m, K key, bool *inserted) { \
+        uint64_t h = HASH(key); \
+        size_t   i = NAME##_map_find_(m, key, h); \
+        if (inserted != NULL) *inserted = false; \
+        if (i != DSC_MAP_NPOS) return &m->vals[i]; \
+        if (!NAME##_map_reserve_one_(m)) return NULL; \
+        i = NAME##_map_claim_(m, h); \
+        m->keys[i] = key; \
+        memset(&m->vals[i], 0, sizeof(V)); \
+        m->size++; \
+        if (inserted != NULL) *inserted = true; \
+        return &m->vals[i]; \
+    } \
+    /* false if key already exists (value untouched) or on ENOMEM */ \
+    static inline bool NAME##_map_insert(NAME##_map *m, K key, V val) { \
+        bool inserted; \
+        V   *slot = NAME##_map_upsert(m, key, &inserted); \
+        if (slot == NULL || !inserted) return false; \
+        *slot = val; \
+        return true; \
+    } \
+    /* Insert or overwrite */ \
+    static inline bool NAME##_map_put(NAME##_map *m, K key, V val) { \
+        V *slot = NAME##_map_upsert(m, key, NULL); \
+        if (slot == NULL) return false; \
+        *slot = val; \
+        return true; \
+    } \
+    static inline bool NAME##_map_delete(NAME##_map *m, K key, V *out) { \
+        size_t i = NAME##_map_find_(m, key, HASH(key)); \
+        if (i == DSC_MAP_NPOS) return false; \
+        if (out != NULL) *out = m->vals[i]; \
+        /* Backward shift: pull later entries into the hole unless their home lies in (i, j] */ \
+        size_t mask = m->capacity - 1; \
+        for (size_t j = (i + 1) & mask; m->ctrl[j] != 0; j = (j + 1) & mask) { \
+            size_t k = NAME##_map_home_(m, HASH(m->keys[j])); \
+            bool   stay = (i <= j) ? (i < k && k <= j) : (i < k || k <= j); \
+            if (stay) continue; \
+            m->ctrl[i] = m->ctrl[j]; \
+            m->keys[i] = m->keys[j]; \
+            m->vals[i] = m->vals[j]; \
+            i = j; \
+        } \
+        m->ctrl[i] = 0; \
+        m->size--; \
+        return true; \
+    } \
+    /* Iterate with size_t it = 0; while (NAME_map_next(m, &it, &k, &v)) { ... } */ \
+    static inline bool NAME##_map_next(const NAME##_map *m, size_t *it, K **key, V **val) { \
+        for (size_t i = *it; i < m->capacity; i++) { \
+            if (m->ctrl[i] == 0) continue; \
+            if (key != NULL) *key = &m->keys[i]; \
+            if (val != NULL) *val = &m->vals[i]; \
+            *it = i + 1; \
+            return true; \
+        } \
+        *it = m->capacity; \
+        return false; \
+    }
+
+/*
+ * +----------------------------------------------------------------+
+ * |                  CONCURRENT HASHTABLE API                      |
+ * +----------------------------------------------------------------+
+ */
+
+/*
+ * Define DSC_NO_THREADS to compile out everything that needs OS threads or
+ * locks (pthreads on POSIX, SRW locks on Windows).
+ */
+#if !defined(DSC_NO_THREADS) && !defined(_WIN32)
+    #include <pthread.h>
+    #if !defined(PTHREAD_RWLOCK_INITIALIZER)
+        /* Strict ISO modes hide POSIX rwlocks: use -std=gnu11 or -D_POSIX_C_SOURCE=200809L */
+        #define DSC_NO_THREADS
+    #endif
+#endif
+
+#ifndef DSC_NO_THREADS
+
+#if defined(_WIN32)
+    typedef struct { void *ptr; } dsc_rwlock;   /* Layout of an SRWLOCK */
+#else
+    typedef pthread_rwlock_t dsc_rwlock;
+#endif
+
+/* Number of lock stripes (power of two) */
+#ifndef DSC_CHT_SHARDS
+#define DSC_CHT_SHARDS 64
+#endif
+
+/*
+ * A lock-striped table: the key's hash picks one of DSC_CHT_SHARDS shards,
+ * each an ordinary dsc_hash_table behind its own reader/writer lock. Readers
+ * share a shard; writers only exclude the one shard they touch. Shards grow
+ * independently with incremental rehashing that writers advance, so a resize
+ * never blocks readers of other shards nor stalls one shard for long.
+ * hf and cf must be safe to call from several threads at once.
+ */
+typedef struct _dsc_ht_shard {
+    dsc_rwlock      lock;
+    dsc_hash_table  ht;
+} dsc_ht_shard;
+
+typedef struct _dsc_concurrent_hash_table {
+    dsc_ht_shard    *shards;
+    size_t          shard_count;
+    size_t          key_size;
+    dsc_hashfunc    *hf;
+} dsc_concurrent_hash_table;
+
+DSC_API void      DSC_FUNC(concurrent_hash_table_init)(dsc_concurrent_hash_table *cht, size_t capacity, size_t key_size, dsc_hashfunc *hf, dsc_cmpfunc *cf);
+DSC_API bool      DSC_FUNC(concurrent_hash_table_insert)(dsc_concurrent_hash_table *cht, const void *key, void *obj);
+DSC_API void*     DSC_FUNC(concurrent_hash_table_get)(dsc_concurrent_hash_table *cht, const void *key);
+DSC_API void*     DSC_FUNC(concurrent_hash_table_delete)(dsc_concurrent_hash_table *cht, const void *key);
+DSC_API size_t    DSC_FUNC(concurrent_hash_table_size)(dsc_concurrent_hash_table *cht);
+DSC_API void      DSC_FUNC(concurrent_hash_table_clear)(dsc_concurrent_hash_table *cht, dsc_cleanupfunc *cf);
+DSC_API void      DSC_FUNC(concurrent_hash_table_destroy)(dsc_concurrent_hash_table *cht, dsc_cleanupfunc *cf);
+
+#endif /* DSC_NO_THREADS */
+
+/*
+ * +----------------------------------------------------------------+
+ * |                   VERSIONED HASHTABLE API                      |
+ * +----------------------------------------------------------------+
+ */
+
+/*
+ * A copy-on-write table for read-mostly maps shared between threads. Each
+ * commit produces an immutable version: readers acquire the current one,
+ * look keys up in it without taking any lock, and release it when done.
+ * A writer stages puts and deletes in a batch and commits them as the next
+ * version in one pointer swap.
+ *
+ * Keys are split by hash over chunk_count chunks (a power of two), each a
+ * small open-addressing array of entry pointers. A batch copies only the
+ * chunks it touches; untouched chunks and all entries are shared by
+ * reference between versions. A commit costs one pass over the chunk
+ * pointers plus the size of each touched chunk, so it is cheapest with
+ * chunk_count near 4 * sqrt(expected size); the default 256 suits tables
+ * of up to a few thousand keys.
+ *
+ * Versions, chunks and entries are reference counted with atomics. Each is
+ * freed when the last version holding it is released, on whichever thread
+ * that is; an entry dropped that way is passed to reclaim (if not NULL).
+ *
+ * Neither readers nor writers take a lock. The current pointer carries a
+ * split reference count: acquire bumps a counter packed into the pointer's
+ * low bits (versions are DSC_VT_ALIGN-aligned), which keeps the version
+ * alive while it takes a real reference, then hands the unit back. commit
+ * swaps the pointer with one CAS and moves the units still in flight onto
+ * the old version's count. Up to DSC_VT_ALIGN - 1 acquires can be in that
+ * window at once; more wait for a free unit.
+ *
+ * One batch may be open at a time, so writers must be serialized. hf, cf,
+ * reclaim and the allocator (if any) must be thread-safe. Every acquired
+ * version must be released before destroy.
+ */
+typedef struct _dsc_vt_entry {
+    size_t          refs;
+    uint64_t        hash;
+    void            *obj;
+    size_t          key_size;
+    /* Key bytes follow */
+} dsc_vt_entry;
+
+typedef struct _dsc_vt_chunk {
+    size_t          refs;
+    size_t          count;
+    size_t          capacity;           /* Slots, a power of two, at most half used */
+    /* capacity entry pointers follow, NULL = empty slot */
+} dsc_vt_chunk;
+
+#define DSC_VT_ALIGN 256                /* Version alignment: acquires in flight fit below it */
+
+typedef struct _dsc_vt_version {
+    size_t          refs;
+    size_t          size;               /* Entries in this version */
+    uint64_t        number;             /* 0 for the empty initial version, +1 per commit */
+    const struct _dsc_versioned_table *table;
+    dsc_vt_chunk    **chunks;           /* chunk_count pointers, NULL = empty chunk */
+    void            *block;             /* Allocation the aligned version sits in */
+} dsc_vt_version;
+
+typedef struct _dsc_versioned_table {
+    size_t          current;            /* dsc_vt_version* | acquires in flight in the low bits */
+    size_t          chunk_count;
+    unsigned        chunk_bits;         /* log2(chunk_count) */
+    size_t          key_size;           /* 0 = NUL-terminated strings */
+    dsc_hashfunc    *hf;
+    dsc_cmpfunc     *cf;
+    dsc_cleanupfunc *reclaim;           /* Called on each entry's object when it is freed */
+    const dsc_allocator *allocator;     /* NULL means malloc/free */
+} dsc_versioned_table;
+
+typedef struct _dsc_vt_batch {
+    dsc_versioned_table *table;
+    dsc_vt_version      *base;          /* Version the batch started from */
+    dsc_vt_version      *draft;         /* The next version, private until commit */
+    unsigned char       *owned;         /* owned[i]: draft's chunk i is a private copy */
+} dsc_vt_batch;
+
+/* chunk_count 0 selects 256 */
+DSC_API void            DSC_FUNC(versioned_table_init)(dsc_versioned_table *vt, size_t chunk_count, size_t key_size, dsc_hashfunc *hf, dsc_cmpfunc *cf, dsc_cleanupfunc *reclaim);
+DSC_API void            DSC_FUNC(versioned_table_init_with_allocator)(dsc_versioned_table *vt, size_t chunk_count, size_t key_size, dsc_hashfunc *hf, dsc_cmpfunc *cf, dsc_cleanupfunc *reclaim, const dsc_allocator *allocator);
+DSC_API void            DSC_FUNC(versioned_table_destroy)(dsc_versioned_table *vt);
+
+/* Readers: a version stays valid and unchanged until it is released */
+DSC_API dsc_vt_version* DSC_FUNC(versioned_table_acquire)(dsc_versioned_table *vt);
+DSC_API void            DSC_FUNC(versioned_table_release)(dsc_vt_version *v);
+DSC_API void*           DSC_FUNC(versioned_table_get)(const dsc_vt_version *v, const void *key);
+DSC_API size_t          DSC_FUNC(versioned_table_size)(const dsc_vt_version *v);
+DSC_API void            DSC_FUNC(versioned_table_foreach)(const dsc_vt_version *v, dsc_scanfunc *fn, void *ctx);
+
+/*
+ * Writers. put inserts or replaces (putting the object already stored is a
+ * no-op) and delete fails with DSC_ENOTFOUND. versioned_table_get on
+ * batch->draft reads the batch's own writes. commit publishes the draft; if
+ * another commit got in since begin it fails with DSC_ECONFLICT instead.
+ * Either way, like abort, it ends the batch. Objects only the draft
+ * referenced are then passed to reclaim.
+ *
+ * reclaim runs once per stored object, so an object may be stored under one
+ * key only. Within a batch it may be deleted and put back under the same
+ * key; once a committed version no longer holds it, it is owed to reclaim
+ * and must not be put again.
+ */
+DSC_API bool            DSC_FUNC(versioned_table_begin)(dsc_versioned_table *vt, dsc_vt_batch *batch);
+DSC_API bool            DSC_FUNC(versioned_table_put)(dsc_vt_batch *batch, const void *key, void *obj);
+DSC_API bool            DSC_FUNC(versioned_table_delete)(dsc_vt_batch *batch, const void *key);
+DSC_API bool            DSC_FUNC(versioned_table_commit)(dsc_vt_batch *batch);
+DSC_API void            DSC_FUNC(versioned_table_abort)(dsc_vt_batch *batch);
+
+/*
+ * +----------------------------------------------------------------+
+ * |                        THREAD POOL API                         |
+ * +----------------------------------------------------------------+
+ */
+
+/*
+ * A fixed set of worker threads for data-parallel loops. parallel_for splits
+ * [0, count) into chunks that workers (and the calling thread) claim from a
+ * shared atomic counter, so a thread that finishes early simply takes the
+ * next chunk and uneven callbacks balance out on their own.
+ *
+ * One parallel_for runs at a time per pool: calls from several threads must
+ * be serialized, and a callback must not call back into the same pool.
+ * Under DSC_NO_THREADS the pool has no workers and everything runs inline.
+ */
+typedef void (*dsc_range_func)(void *ctx, size_t begin, size_t end);
+
+typedef struct _dsc_thread_pool {
+    struct _dsc_pool_state *state;  /* NULL when there are no workers */
+    size_t                 thread_count;
+} dsc_thread_pool;
+
+DSC_API void      DSC_FUNC(thread_pool_init)(dsc_thread_pool *pool, size_t thread_count);
+DSC_API void      DSC_FUNC(thread_pool_destroy)(dsc_thread_pool *pool);
+DSC_API void      DSC_FUNC(thread_pool_parallel_for)(dsc_thread_pool *pool, size_t count, size_t chunk, dsc_range_func fn, void *ctx);
+
 /*
  * +----------------------------------------------------------------+
  * |                     LIST (DYNAMIC ARRAY) API                   |
  * +----------------------------------------------------------------+
  */
 
+/*
+ * How a list grows when it runs out of room. Each growth adds
+ * capacity * growth_percent / 100 items (100 doubles, 50 is 1.5x), at
+ * least enough for the pending insert, at least min_capacity in total, and
+ * at most max_step items per growth when max_step is non-zero. Lists share a
+ * policy by pointer, like allocators, so it must outlive them.
+ *
+ * A non-zero shrink_percent (at most 50) is the low watermark: once pop,
+ * erase_range, resize or clear leaves fewer than capacity * shrink_percent
+ * / 100 items, the buffer is cut to twice the length (never below
+ * min_capacity). The gap between the watermark and the half-full result
+ * keeps a list near the boundary from reallocating on every push and pop.
+ */
+typedef struct _dsc_list_growth {
+    size_t growth_percent;
+    size_t min_capacity;
+    size_t max_step;
+    size_t shrink_percent;              /* 0 = never shrink automatically */
+} dsc_list_growth;
+
 typedef struct _dsc_list {
     void*  items;
     size_t item_size;
     size_t length;
     size_t capacity;
+    const dsc_allocator* allocator;     /* NULL means malloc/realloc/free */
+    const dsc_list_growth* growth;      /* NULL means double, starting at 8 */
+#ifdef DSC_STATS
+    dsc_alloc_stats stats;              /* See list_stats */
+#endif
 } dsc_list;
 
 typedef void (*dsc_callback)(void*);
 typedef int  (*dsc_predicate)(void*);
+typedef void (*dsc_callback_ctx)(void* item, void* ctx);
+typedef int  (*dsc_predicate_ctx)(void* item, void* ctx);
+
+/*
+ * Span callbacks see a contiguous run of count items instead of one item per
+ * call, so a loop over the block can be inlined and vectorized inside the
+ * callback. A span predicate writes keep[i] = 0/1 for each item in the block.
+ * A span reducer folds a read-only block into the caller's accumulator acc.
+ */
+typedef void (*dsc_span_callback)(void* items, size_t count, size_t item_size, void* ctx);
+typedef void (*dsc_span_predicate)(const void* items, size_t count, size_t item_size, unsigned char* keep, void* ctx);
+typedef void (*dsc_span_reducer)(void* acc, const void* items, size_t count, size_t item_size, void* ctx);
 
 DSC_API void     DSC_FUNC(list_init)(dsc_list* list, size_t item_size, size_t initial_capacity);
+DSC_API void     DSC_FUNC(list_init_with_allocator)(dsc_list* list, size_t item_size, size_t initial_capacity, const dsc_allocator* allocator);
+#ifndef DSC_NO_VMEM
+DSC_API void     DSC_FUNC(list_init_mapped)(dsc_list* list, size_t item_size, dsc_vmem* vm);
+DSC_API void     DSC_FUNC(list_sync)(dsc_list* list, dsc_vmem* vm);
+#endif
 DSC_API void     DSC_FUNC(list_destroy)(dsc_list* list);
+
+/* bytes is the item buffer's current size; the counters need DSC_STATS (see dsc_alloc_stats) */
+DSC_API dsc_alloc_stats DSC_FUNC(list_stats)(dsc_list* list);
 DSC_API void     DSC_FUNC(list_append)(dsc_list* list, void* item);
 DSC_API void*    DSC_FUNC(list_get)(dsc_list* list, size_t index);
 DSC_API void     DSC_FUNC(list_pop)(dsc_list* list);
 DSC_API void     DSC_FUNC(list_clear)(dsc_list* list);
 DSC_API void     DSC_FUNC(list_resize)(dsc_list* list, size_t new_size);
+DSC_API void     DSC_FUNC(list_set_growth)(dsc_list* list, const dsc_list_growth* growth);
+DSC_API void     DSC_FUNC(list_reserve)(dsc_list* list, size_t capacity);
+DSC_API void     DSC_FUNC(list_shrink_to_fit)(dsc_list* list);
+DSC_API void     DSC_FUNC(list_append_n)(dsc_list* list, const void* items, size_t count);
+DSC_API void     DSC_FUNC(list_insert_range)(dsc_list* list, size_t index, const void* items, size_t count);
+DSC_API void     DSC_FUNC(list_erase_range)(dsc_list* list, size_t index, size_t count);
 DSC_API void     DSC_FUNC(list_map)(dsc_list* list, dsc_callback cf);
 DSC_API void     DSC_FUNC(list_foreach)(dsc_list* list, dsc_callback cf);
 DSC_API dsc_list DSC_FUNC(list_filter)(dsc_list* list, dsc_predicate cf);
 DSC_API void     DSC_FUNC(list_from_array)(dsc_list* list, const void* array, size_t count, size_t item_size);
 
+/*
+ * Unchecked tier, inlined at the call site (see hash_table_get_unchecked).
+ * get_unchecked does no bounds check. append_unchecked copies in place while
+ * there is spare capacity and only calls out to list_append, and reads the
+ * error slot, on the growth path; it returns DSC_EOK or DSC_ENOMEM.
+ */
+static inline void* DSC_FUNC(list_get_unchecked)(const dsc_list* list, size_t index) {
+    return (char*)list->items + index * list->item_size;
+}
+
+static inline dsc_error_t DSC_FUNC(list_append_unchecked)(dsc_list* list, const void* item) {
+    if (list->length < list->capacity) {
+        memcpy((char*)list->items + list->length * list->item_size, item, list->item_size);
+        list->length++;
+        return DSC_EOK;
+    }
+    DSC_FUNC(list_append)(list, (void*)item);
+    return DSC_FUNC(get_error)();
+}
+
+/*
+ * Parallel variants: the list is split into chunks run on pool (NULL = run on
+ * the calling thread). cf is called concurrently with the same ctx, so it
+ * must be thread-safe; the list must not be modified while they run.
+ * filter_parallel keeps the input order.
+ */
+DSC_API void     DSC_FUNC(list_map_parallel)(dsc_list* list, dsc_thread_pool* pool, dsc_callback_ctx cf, void* ctx);
+DSC_API void     DSC_FUNC(list_foreach_parallel)(dsc_list* list, dsc_thread_pool* pool, dsc_callback_ctx cf, void* ctx);
+DSC_API dsc_list DSC_FUNC(list_filter_parallel)(dsc_list* list, dsc_thread_pool* pool, dsc_predicate_ctx cf, void* ctx);
+
+/*
+ * Span variants. span is the block length handed to cf; 0 passes the whole
+ * list in one call to map/foreach and blocks of DSC_LIST_SPAN to filter.
+ * map_span_parallel hands each pool chunk to cf as one span.
+ */
+DSC_API void     DSC_FUNC(list_map_span)(dsc_list* list, size_t span, dsc_span_callback cf, void* ctx);
+DSC_API void     DSC_FUNC(list_foreach_span)(dsc_list* list, size_t span, dsc_span_callback cf, void* ctx);
+DSC_API dsc_list DSC_FUNC(list_filter_span)(dsc_list* list, size_t span, dsc_span_predicate cf, void* ctx);
+DSC_API void     DSC_FUNC(list_map_span_parallel)(dsc_list* list, dsc_thread_pool* pool, dsc_span_callback cf, void* ctx);
+
+/*
+ * Ordering. cmp follows the qsort convention (negative, zero, positive).
+ *
+ * sort is an introsort: median-of-3 quicksort, heapsort once the recursion
+ * gets too deep and insertion sort on short runs. It is in place, not stable
+ * and O(n log n) in the worst case. sort_parallel sorts one run per pool
+ * thread, then merges runs pairwise; each merge is split along its merge path
+ * so every round, the last one included, runs on the whole pool. cmp is called
+ * concurrently, so it must be thread-safe. sort_parallel needs a scratch copy
+ * of the list and falls back to sort for a NULL pool or a short list.
+ *
+ * sort_keys is a stable LSD radix sort on a numeric key stored at key_offset
+ * inside each item (0 for a list of plain numbers), a byte per pass. Passes
+ * where every key has the same byte are skipped, and it needs a scratch copy
+ * of the list. Floats sort by value with -0.0 before +0.0; NaNs go to the
+ * front or the back according to their sign bit.
+ *
+ * lower_bound returns the index of the first item not less than key in a list
+ * sorted by cmp (length when there is none); binary_search returns a matching
+ * item or NULL with DSC_ENOTFOUND. Both call cmp(item, key).
+ * partial_sort moves the k smallest items, in order, to the front; the rest
+ * are left in unspecified order. Use a reversed cmp for the k largest.
+ */
+typedef int (*dsc_compare)(const void* a, const void* b);
+
+typedef enum {
+    DSC_SORT_U32,
+    DSC_SORT_I32,
+    DSC_SORT_U64,
+    DSC_SORT_I64,
+    DSC_SORT_F32,
+    DSC_SORT_F64
+} dsc_sort_key;
+
+DSC_API void     DSC_FUNC(list_sort)(dsc_list* list, dsc_compare cmp);
+DSC_API void     DSC_FUNC(list_sort_parallel)(dsc_list* list, dsc_thread_pool* pool, dsc_compare cmp);
+DSC_API void     DSC_FUNC(list_sort_keys)(dsc_list* list, dsc_sort_key key, size_t key_offset);
+DSC_API size_t   DSC_FUNC(list_lower_bound)(dsc_list* list, const void* key, dsc_compare cmp);
+DSC_API void*    DSC_FUNC(list_binary_search)(dsc_list* list, const void* key, dsc_compare cmp);
+DSC_API void     DSC_FUNC(list_partial_sort)(dsc_list* list, size_t k, dsc_compare cmp);
+
 #define DSC_DEFINE_LIST(T, NAME) \
     typedef struct { dsc_list impl; } NAME##_list; \
+    typedef T NAME##_list_item; \
+    static inline T *NAME##_list_data(NAME##_list *l) { \
+        return (T*)l->impl.items; \
+    } \
+    static inline size_t NAME##_list_length(NAME##_list *l) { \
+        return l->impl.length; \
+    } \
     static inline void NAME##_list_init(NAME##_list *l, size_t initial_capacity) { \
         DSC_FUNC(list_init)(&l->impl, sizeof(T), initial_capacity); \
     } \
@@ -296,6 +1241,12 @@ DSC_API void     DSC_FUNC(list_from_array)(dsc_list* list, const void* array, si
         T* item = (T*)DSC_FUNC(list_get)(&l->impl, index); \
         return (item != NULL) ? *item : (T){0}; \
     } \
+    static inline T NAME##_list_get_unchecked(NAME##_list *l, size_t index) { \
+        return ((T*)l->impl.items)[index]; \
+    } \
+    static inline dsc_error_t NAME##_list_append_unchecked(NAME##_list *l, T item) { \
+        return DSC_FUNC(list_append_unchecked)(&l->impl, &item); \
+    } \
     static inline void NAME##_list_pop(NAME##_list *l) { \
         DSC_FUNC(list_pop)(&l->impl); \
     } \
@@ -305,6 +1256,24 @@ DSC_API void     DSC_FUNC(list_from_array)(dsc_list* list, const void* array, si
     static inline void NAME##_list_resize(NAME##_list *l, size_t new_size) { \
         DSC_FUNC(list_resize)(&l->impl, new_size); \
     } \
+    static inline void NAME##_list_set_growth(NAME##_list *l, const dsc_list_growth *growth) { \
+        DSC_FUNC(list_set_growth)(&l->impl, growth); \
+    } \
+    static inline void NAME##_list_reserve(NAME##_list *l, size_t capacity) { \
+        DSC_FUNC(list_reserve)(&l->impl, capacity); \
+    } \
+    static inline void NAME##_list_shrink_to_fit(NAME##_list *l) { \
+        DSC_FUNC(list_shrink_to_fit)(&l->impl); \
+    } \
+    static inline void NAME##_list_append_n(NAME##_list *l, const T *items, size_t count) { \
+        DSC_FUNC(list_append_n)(&l->impl, items, count); \
+    } \
+    static inline void NAME##_list_insert_range(NAME##_list *l, size_t index, const T *items, size_t count) { \
+        DSC_FUNC(list_insert_range)(&l->impl, index, items, count); \
+    } \
+    static inline void NAME##_list_erase_range(NAME##_list *l, size_t index, size_t count) { \
+        DSC_FUNC(list_erase_range)(&l->impl, index, count); \
+    } \
     static inline void NAME##_list_map(NAME##_list *l, dsc_callback cf) { \
         DSC_FUNC(list_map)(&l->impl, cf); \
     } \
@@ -316,64 +1285,592 @@ DSC_API void     DSC_FUNC(list_from_array)(dsc_list* list, const void* array, si
         dsc_list filtered = DSC_FUNC(list_filter)(&l->impl, cf); \
         result.impl = filtered; \
         return result; \
+    } \
+    static inline void NAME##_list_map_parallel(NAME##_list *l, dsc_thread_pool *pool, dsc_callback_ctx cf, void *ctx) { \
+        DSC_FUNC(list_map_parallel)(&l->impl, pool, cf, ctx); \
+    } \
+    static inline void NAME##_list_foreach_parallel(NAME##_list *l, dsc_thread_pool *pool, dsc_callback_ctx cf, void *ctx) { \
+        DSC_FUNC(list_foreach_parallel)(&l->impl, pool, cf, ctx); \
+    } \
+    static inline NAME##_list NAME##_list_filter_parallel(NAME##_list *l, dsc_thread_pool *pool, dsc_predicate_ctx cf, void *ctx) { \
+        NAME##_list result; \
+        result.impl = DSC_FUNC(list_filter_parallel)(&l->impl, pool, cf, ctx); \
+        return result; \
+    } \
+    static inline void NAME##_list_map_span(NAME##_list *l, size_t span, dsc_span_callback cf, void *ctx) { \
+        DSC_FUNC(list_map_span)(&l->impl, span, cf, ctx); \
+    } \
+    static inline NAME##_list NAME##_list_filter_span(NAME##_list *l, size_t span, dsc_span_predicate cf, void *ctx) { \
+        NAME##_list result; \
+        result.impl = DSC_FUNC(list_filter_span)(&l->impl, span, cf, ctx); \
+        return result; \
+    } \
+    static inline void NAME##_list_sort_keys(NAME##_list *l, dsc_sort_key key, size_t key_offset) { \
+        DSC_FUNC(list_sort_keys)(&l->impl, key, key_offset); \
+    } \
+    static inline void NAME##_list_sort_parallel(NAME##_list *l, dsc_thread_pool *pool, dsc_compare cmp) { \
+        DSC_FUNC(list_sort_parallel)(&l->impl, pool, cmp); \
     }
 
 /*
- * +----------------------------------------------------------------+
- * |                             Set API                            |
- * +----------------------------------------------------------------+
+ * Expression loops over a NAME_list from DSC_DEFINE_LIST(T, NAME), expanded in
+ * place so the compiler sees a plain loop over T* and can unroll and vectorize
+ * it (no call per element). VAR names the current element by value inside
+ * EXPR/COND.
+ *
+ *   DSC_LIST_MAP(int, &nums, x, x * 2);              // nums[i] = nums[i] * 2
+ *   int sum = 0;
+ *   DSC_LIST_REDUCE(int, &nums, sum, x, sum + x);    // sum = fold over nums
+ *   DSC_LIST_FILTER(int, &nums, &evens, x, x % 2 == 0);
+ *
+ * FILTER overwrites OUT (an initialized list other than L), keeping order.
+ * Floating-point reductions only vectorize when the compiler may reassociate
+ * (e.g. -ffast-math), as with any hand-written loop.
  */
-typedef struct _dsc_set {
-    dsc_hash_table* ht;
-} dsc_set;
+#define DSC_LIST_MAP(NAME, L, VAR, EXPR) do { \
+        NAME##_list_item *dsc_p_ = NAME##_list_data(L); \
+        size_t dsc_n_ = NAME##_list_length(L); \
+        for (size_t dsc_i_ = 0; dsc_i_ < dsc_n_; dsc_i_++) { \
+            NAME##_list_item VAR = dsc_p_[dsc_i_]; \
+            dsc_p_[dsc_i_] = (EXPR); \
+        } \
+    } while (0)
+
+#define DSC_LIST_REDUCE(NAME, L, ACC, VAR, EXPR) do { \
+        const NAME##_list_item *dsc_p_ = NAME##_list_data(L); \
+        size_t dsc_n_ = NAME##_list_length(L); \
+        for (size_t dsc_i_ = 0; dsc_i_ < dsc_n_; dsc_i_++) { \
+            NAME##_list_item VAR = dsc_p_[dsc_i_]; \
+            (ACC) = (EXPR); \
+        } \
+    } while (0)
+
+/* Branch-free compaction: every element is written, only kept ones advance */
+#define DSC_LIST_FILTER(NAME, L, OUT, VAR, COND) do { \
+        const NAME##_list_item *dsc_p_ = NAME##_list_data(L); \
+        size_t dsc_n_ = NAME##_list_length(L); \
+        NAME##_list_resize((OUT), dsc_n_); \
+        if (DSC_FUNC(get_error)() == DSC_EOK) { \
+            NAME##_list_item *dsc_d_ = NAME##_list_data(OUT); \
+            size_t dsc_k_ = 0; \
+            for (size_t dsc_i_ = 0; dsc_i_ < dsc_n_; dsc_i_++) { \
+                NAME##_list_item VAR = dsc_p_[dsc_i_]; \
+                dsc_d_[dsc_k_] = VAR; \
+                dsc_k_ += (COND) ? 1 : 0; \
+            } \
+            (OUT)->impl.length = dsc_k_; \
+        } \
+    } while (0)
 
-DSC_API void      DSC_FUNC(set_init)(dsc_set* set, size_t initial_capacity, size_t key_size, dsc_hashfunc* hf, dsc_cmpfunc* cf);
-DSC_API void      DSC_FUNC(set_destroy)(dsc_set* set);
-DSC_API bool      DSC_FUNC(set_add)(dsc_set* set, const void* item);
-DSC_API void      DSC_FUNC(set_remove)(dsc_set* set, const void* item);
-DSC_API void*     DSC_FUNC(set_get)(dsc_set* set, const void* item);
-DSC_API void      DSC_FUNC(set_clear)(dsc_set* set);
-DSC_API void      DSC_FUNC(set_from_array)(dsc_set* set, const void* array, size_t count, size_t item_size, dsc_hashfunc* hf, dsc_cmpfunc* cf);
-DSC_API dsc_list  DSC_FUNC(set_to_list)(dsc_set* set);
-
-#define DSC_DEFINE_SET(T, NAME) \
-    typedef struct { dsc_set impl; } NAME##_set; \
-    static inline void NAME##_set_init(NAME##_set *s, size_t initial_capacity, size_t key_size, dsc_hashfunc* hf, dsc_cmpfunc* cf) { \
-        DSC_FUNC(set_init)(&s->impl, initial_capacity, key_size, hf, cf); \
+/*
+ * Typed ordering for a NAME_list, with the comparison inlined. LESS(a, b) is
+ * an expression on two items by value that is true when a orders before b:
+ *
+ *   DSC_DEFINE_LIST(int, int)
+ *   DSC_DEFINE_LIST_SORT(int, DSC_LESS)               // int_list_sort, ...
+ *
+ *   #define BY_SCORE(a, b) ((a).score > (b).score)    // Descending by field
+ *   DSC_DEFINE_LIST_SORT(player, BY_SCORE)
+ *
+ * Defines NAME_list_sort, NAME_list_partial_sort(l, k), NAME_list_lower_bound
+ * and NAME_list_binary_search (a pointer to the item or NULL), with the same
+ * algorithms as list_sort. Like the unchecked tier they do not validate the
+ * list and never touch dsc_get_error().
+ */
+#define DSC_LESS(a, b) ((a) < (b))
+
+#define DSC_DEFINE_LIST_SORT(NAME, LESS) \
+    static inline void NAME##_list_sort_sift_(NAME##_list_item *a, size_t root, size_t n) { \
+        NAME##_list_item v = a[root]; \
+        for (;;) { \
+            size_t c = 2 * root + 1; \
+            if (c >= n) break; \
+            if (c + 1 < n && LESS(a[c], a[c + 1])) c++; \
+            if (!LESS(v, a[c])) break; \
+            a[root] = a[c]; \
+            root = c; \
+        } \
+        a[root] = v; \
     } \
-    static inline void NAME##_set_destroy(NAME##_set *s) { \
-        DSC_FUNC(set_destroy)(&s->impl); \
+    static inline void NAME##_list_sort_heap_(NAME##_list_item *a, size_t n) { \
+        for (size_t i = n / 2; i-- > 0;) NAME##_list_sort_sift_(a, i, n); \
+        for (size_t i = n; i-- > 1;) { \
+            NAME##_list_item t = a[0]; a[0] = a[i]; a[i] = t; \
+            NAME##_list_sort_sift_(a, 0, i); \
+        } \
     } \
-    static inline bool NAME##_set_add(NAME##_set *s, const void* item) { \
-        return DSC_FUNC(set_add)(&s->impl, item); \
+    static inline void NAME##_list_sort_intro_(NAME##_list_item *a, size_t n, size_t depth) { \
+        while (n > 16) { \
+            if (depth-- == 0) { NAME##_list_sort_heap_(a, n); return; } \
+            size_t m = n / 2; \
+            NAME##_list_item t; \
+            if (LESS(a[m], a[0])) { t = a[m]; a[m] = a[0]; a[0] = t; } \
+            if (LESS(a[n - 1], a[m])) { \
+                t = a[m]; a[m] = a[n - 1]; a[n - 1] = t; \
+                if (LESS(a[m], a[0])) { t = a[m]; a[m] = a[0]; a[0] = t; } \
+            } \
+            NAME##_list_item pivot = a[m]; \
+            size_t i = 0, j = n - 1; \
+            for (;;) { \
+                while (LESS(a[i], pivot)) i++; \
+                while (LESS(pivot, a[j])) j--; \
+                if (i >= j) break; \
+                t = a[i]; a[i] = a[j]; a[j] = t; \
+                i++; j--; \
+            } \
+            size_t left = j + 1; \
+            if (left < n - left) { NAME##_list_sort_intro_(a, left, depth); a += left; n -= left; } \
+            else { NAME##_list_sort_intro_(a + left, n - left, depth); n = left; } \
+        } \
+        for (size_t i = 1; i < n; i++) { \
+            NAME##_list_item v = a[i]; \
+            size_t j = i; \
+            for (; j > 0 && LESS(v, a[j - 1]); j--) a[j] = a[j - 1]; \
+            a[j] = v; \
+        } \
     } \
-    static inline void NAME##_set_remove(NAME##_set *s, const void* item) { \
-        DSC_FUNC(set_remove)(&s->impl, item); \
+    static inline void NAME##_list_sort(NAME##_list *l) { \
+        size_t depth = 0; \
+        for (size_t n = l->impl.length; n > 1; n >>= 1) depth += 2; \
+        NAME##_list_sort_intro_((NAME##_list_item *)l->impl.items, l->impl.length, depth); \
     } \
-    static inline T NAME##_set_get(NAME##_set *s, const void* item) { \
-        return (T)DSC_FUNC(set_get)(&s->impl, item); \
+    static inline void NAME##_list_partial_sort(NAME##_list *l, size_t k) { \
+        NAME##_list_item *a = (NAME##_list_item *)l->impl.items; \
+        size_t n = l->impl.length; \
+        if (k >= n) { NAME##_list_sort(l); return; } \
+        if (k == 0) return; \
+        for (size_t i = k / 2; i-- > 0;) NAME##_list_sort_sift_(a, i, k); \
+        for (size_t i = k; i < n; i++) { \
+            if (LESS(a[i], a[0])) { \
+                NAME##_list_item t = a[0]; a[0] = a[i]; a[i] = t; \
+                NAME##_list_sort_sift_(a, 0, k); \
+            } \
+        } \
+        for (size_t i = k; i-- > 1;) { \
+            NAME##_list_item t = a[0]; a[0] = a[i]; a[i] = t; \
+            NAME##_list_sort_sift_(a, 0, i); \
+        } \
     } \
-    static inline void NAME##_set_clear(NAME##_set *s) { \
-        DSC_FUNC(set_clear)(&s->impl); \
+    static inline size_t NAME##_list_lower_bound(NAME##_list *l, NAME##_list_item key) { \
+        const NAME##_list_item *a = (const NAME##_list_item *)l->impl.items; \
+        size_t lo = 0, n = l->impl.length; \
+        while (n > 0) { \
+            size_t half = n / 2; \
+            if (LESS(a[lo + half], key)) { lo += half + 1; n -= half + 1; } \
+            else n = half; \
+        } \
+        return lo; \
+    } \
+    static inline NAME##_list_item *NAME##_list_binary_search(NAME##_list *l, NAME##_list_item key) { \
+        size_t i = NAME##_list_lower_bound(l, key); \
+        NAME##_list_item *a = (NAME##_list_item *)l->impl.items; \
+        return (i < l->impl.length && !LESS(key, a[i])) ? &a[i] : NULL; \
     }
 
 /*
  * +----------------------------------------------------------------+
- * |                           Stack API                            |
+ * |                  SOA (COLUMNAR) LIST API                       |
  * +----------------------------------------------------------------+
  */
-typedef struct _dsc_stack {
-    dsc_list list;
-} dsc_stack;
 
-DSC_API void      DSC_FUNC(stack_init)(dsc_stack* stack, size_t item_size, size_t initial_capacity);
-DSC_API bool      DSC_FUNC(stack_push)(dsc_stack* stack, void* item);
+/*
+ * Struct-of-arrays list: each field of a record lives in its own dense
+ * column, so a pass that reads one 4-byte field of a 64-byte record streams
+ * 4 bytes per record instead of 64. Records go in and out as ordinary
+ * structs: append and set scatter the fields of a record into the columns,
+ * get gathers them back. A dsc_soa_field says where a field sits in the
+ * record (offsetof and size). All columns share one allocation, each one
+ * starting on a 64-byte boundary; column pointers move when the list grows.
+ *
+ * The column passes hand cf a whole run of one column, using the dsc_list
+ * span callbacks (span 0 = the whole column), so a loop over it vectorizes.
+ * reduce_column folds the column into acc, which the caller initializes;
+ * ctx is passed through, so one reducer can serve several columns.
+ * filter evaluates the predicate on one column and returns a new list with
+ * every column of the kept records, in order.
+ */
+typedef struct _dsc_soa_field {
+    size_t offset;      /* offsetof(record, field) */
+    size_t size;        /* sizeof the field */
+} dsc_soa_field;
+
+typedef struct _dsc_soa_column {
+    void    *data;      /* capacity items of size bytes */
+    size_t  size;
+    size_t  offset;
+} dsc_soa_column;
+
+typedef struct _dsc_soa_list {
+    dsc_soa_column      *columns;
+    size_t              ncolumns;
+    size_t              record_size;
+    size_t              length;
+    size_t              capacity;
+    void                *block;         /* Every column, in one allocation */
+    size_t              block_size;
+    const dsc_allocator *allocator;     /* NULL means malloc/free */
+} dsc_soa_list;
+
+DSC_API void     DSC_FUNC(soa_list_init)(dsc_soa_list* soa, size_t record_size, const dsc_soa_field* fields, size_t nfields, size_t initial_capacity);
+DSC_API void     DSC_FUNC(soa_list_init_with_allocator)(dsc_soa_list* soa, size_t record_size, const dsc_soa_field* fields, size_t nfields, size_t initial_capacity, const dsc_allocator* allocator);
+DSC_API void     DSC_FUNC(soa_list_destroy)(dsc_soa_list* soa);
+DSC_API void     DSC_FUNC(soa_list_clear)(dsc_soa_list* soa);
+DSC_API void     DSC_FUNC(soa_list_reserve)(dsc_soa_list* soa, size_t capacity);
+DSC_API void     DSC_FUNC(soa_list_append)(dsc_soa_list* soa, const void* record);
+DSC_API void     DSC_FUNC(soa_list_append_n)(dsc_soa_list* soa, const void* records, size_t count);
+DSC_API void*    DSC_FUNC(soa_list_get)(dsc_soa_list* soa, size_t index, void* out);    /* Returns out */
+DSC_API void     DSC_FUNC(soa_list_set)(dsc_soa_list* soa, size_t index, const void* record);
+DSC_API void     DSC_FUNC(soa_list_pop)(dsc_soa_list* soa);
+DSC_API void*    DSC_FUNC(soa_list_column)(dsc_soa_list* soa, size_t column);
+DSC_API void     DSC_FUNC(soa_list_map_column)(dsc_soa_list* soa, size_t column, size_t span, dsc_span_callback cf, void* ctx);
+DSC_API void     DSC_FUNC(soa_list_reduce_column)(dsc_soa_list* soa, size_t column, size_t span, dsc_span_reducer cf, void* acc, void* ctx);
+DSC_API dsc_soa_list DSC_FUNC(soa_list_filter)(dsc_soa_list* soa, size_t column, dsc_span_predicate cf, void* ctx);
+
+/* Row-wise interop: to_list gathers every record into a dsc_list of record_size items */
+DSC_API dsc_list DSC_FUNC(soa_list_to_list)(dsc_soa_list* soa);
+DSC_API void     DSC_FUNC(soa_list_from_list)(dsc_soa_list* soa, dsc_list* list, const dsc_soa_field* fields, size_t nfields);
+
+/*
+ * Typed SoA list over a record struct T. FIELDS is an X-macro listing the
+ * members to store as columns, each as X(C, type, member); C is passed
+ * through untouched:
+ *
+ *   typedef struct { float x, y; int id; } particle;
+ *   #define PARTICLE_FIELDS(X, C) X(C, float, x) X(C, float, y) X(C, int, id)
+ *   DSC_DEFINE_SOA_LIST(particle, particle, PARTICLE_FIELDS)
+ *
+ *   float *xs = particle_soa_x(&ps);          // Dense column of x
+ *   particle p = particle_soa_get(&ps, 3);     // Gathered record
+ *
+ * Besides the per-member accessors it defines column indexes
+ * NAME_soa_col_<member> for the map_column/filter calls. Members left out
+ * of FIELDS are not stored and read back as zero.
+ */
+#define DSC_SOA_FIELD_(T, FT, F)    { offsetof(T, F), sizeof(((T*)0)->F) },
+#define DSC_SOA_INDEX_(NAME, FT, F) NAME##_soa_col_##F,
+#define DSC_SOA_ACCESS_(NAME, FT, F) \
+    static inline FT *NAME##_soa_##F(NAME##_soa *s) { \
+        return (FT*)s->impl.columns[NAME##_soa_col_##F].data; \
+    }
+
+#define DSC_DEFINE_SOA_LIST(T, NAME, FIELDS) \
+    typedef struct { dsc_soa_list impl; } NAME##_soa; \
+    enum { FIELDS(DSC_SOA_INDEX_, NAME) NAME##_soa_columns }; \
+    FIELDS(DSC_SOA_ACCESS_, NAME) \
+    static inline void NAME##_soa_init(NAME##_soa *s, size_t initial_capacity) { \
+        static const dsc_soa_field fields[] = { FIELDS(DSC_SOA_FIELD_, T) }; \
+        DSC_FUNC(soa_list_init)(&s->impl, sizeof(T), fields, NAME##_soa_columns, initial_capacity); \
+    } \
+    static inline void NAME##_soa_destroy(NAME##_soa *s) { \
+        DSC_FUNC(soa_list_destroy)(&s->impl); \
+    } \
+    static inline size_t NAME##_soa_length(NAME##_soa *s) { \
+        return s->impl.length; \
+    } \
+    static inline void NAME##_soa_append(NAME##_soa *s, T record) { \
+        DSC_FUNC(soa_list_append)(&s->impl, &record); \
+    } \
+    static inline T NAME##_soa_get(NAME##_soa *s, size_t index) { \
+        T record = {0}; \
+        DSC_FUNC(soa_list_get)(&s->impl, index, &record); \
+        return record; \
+    } \
+    static inline void NAME##_soa_set(NAME##_soa *s, size_t index, T record) { \
+        DSC_FUNC(soa_list_set)(&s->impl, index, &record); \
+    } \
+    static inline NAME##_soa NAME##_soa_filter(NAME##_soa *s, size_t column, dsc_span_predicate cf, void *ctx) { \
+        NAME##_soa result; \
+        result.impl = DSC_FUNC(soa_list_filter)(&s->impl, column, cf, ctx); \
+        return result; \
+    } \
+    static inline void NAME##_soa_from_list(NAME##_soa *s, dsc_list *list) { \
+        static const dsc_soa_field fields[] = { FIELDS(DSC_SOA_FIELD_, T) }; \
+        DSC_FUNC(soa_list_from_list)(&s->impl, list, fields, NAME##_soa_columns); \
+    }
+
+/*
+ * +----------------------------------------------------------------+
+ * |                             Set API                            |
+ * +----------------------------------------------------------------+
+ */
+/*
+ * A set keeps its own key-only chained table, embedded by value: nodes hold
+ * the chain link, the cached hash and the key bytes, and nothing else.
+ */
+typedef struct _dsc_set_node {
+    struct _dsc_set_node    *next;
+    uint64_t                hash;
+    /* Key bytes follow (preceded by a size_t length when key_size is 0) */
+} dsc_set_node;
+
+typedef struct _dsc_set {
+    size_t              size;
+    size_t              capacity;       /* Number of buckets, always a power of two */
+    size_t              key_size;       /* 0 = NUL-terminated strings */
+    dsc_hashfunc        *hf;
+    dsc_cmpfunc         *cf;
+    dsc_set_node        **buckets;
+    const dsc_allocator *allocator;     /* NULL means malloc/free */
+    dsc_bloom           *filter;        /* Optional, not owned: see set_attach_filter */
+    size_t              shrink_percent; /* Low watermark, 0 = never shrink: see set_set_shrink */
+    size_t              min_capacity;   /* Automatic shrinking stops here */
+} dsc_set;
+
+DSC_API void      DSC_FUNC(set_init)(dsc_set* set, size_t initial_capacity, size_t key_size, dsc_hashfunc* hf, dsc_cmpfunc* cf);
+DSC_API void      DSC_FUNC(set_init_with_allocator)(dsc_set* set, size_t initial_capacity, size_t key_size, dsc_hashfunc* hf, dsc_cmpfunc* cf, const dsc_allocator* allocator);
+DSC_API void      DSC_FUNC(set_destroy)(dsc_set* set);
+DSC_API bool      DSC_FUNC(set_add)(dsc_set* set, const void* item);
+DSC_API void      DSC_FUNC(set_remove)(dsc_set* set, const void* item);
+DSC_API void*     DSC_FUNC(set_get)(dsc_set* set, const void* item);
+DSC_API void      DSC_FUNC(set_clear)(dsc_set* set);
+DSC_API void      DSC_FUNC(set_from_array)(dsc_set* set, const void* array, size_t count, size_t item_size, dsc_hashfunc* hf, dsc_cmpfunc* cf);
+DSC_API dsc_list  DSC_FUNC(set_to_list)(dsc_set* set);
+DSC_API void      DSC_FUNC(set_attach_filter)(dsc_set* set, dsc_bloom* filter);    /* Same contract as hash_table_attach_filter */
+DSC_API bool      DSC_FUNC(set_contains_unchecked)(dsc_set* set, const void* item);    /* See hash_table_get_unchecked */
+
+/*
+ * Same contracts as hash_table_iter_* and hash_table_scan. The iterator
+ * exposes the set's own copy of the key; scan passes a NULL obj.
+ */
+typedef struct _dsc_set_iter {
+    dsc_set         *set;
+    const void      *key;       /* Current key, NULL before the first next and after a remove */
+    size_t          key_size;
+    uint64_t        hash;
+    dsc_set_node    **link;
+    size_t          bucket;
+} dsc_set_iter;
+
+DSC_API void      DSC_FUNC(set_iter_begin)(dsc_set* set, dsc_set_iter* it);
+DSC_API bool      DSC_FUNC(set_iter_next)(dsc_set_iter* it);
+DSC_API void      DSC_FUNC(set_iter_remove)(dsc_set_iter* it);
+DSC_API size_t    DSC_FUNC(set_scan)(dsc_set* set, size_t cursor, size_t count, dsc_scanfunc* fn, void* ctx);
+
+/*
+ * Sizing, as for the hash table (see hash_table_reserve). The watermark
+ * applies to remove, clear and the in-place intersect/difference;
+ * iter_remove never shrinks.
+ */
+DSC_API bool      DSC_FUNC(set_reserve)(dsc_set* set, size_t count);
+DSC_API bool      DSC_FUNC(set_compact)(dsc_set* set);
+DSC_API void      DSC_FUNC(set_set_shrink)(dsc_set* set, size_t low_percent);
+
+/*
+ * Set algebra. The out-of-place forms initialize out as a new set with a's
+ * key size, functions and allocator; out must not be a or b, and a and b
+ * must have the same key size. Each operation walks the smaller side where
+ * the result allows it and probes the other, reusing cached hashes when
+ * both sets share a hash function. Stored objects are carried over as-is.
+ * difference is a - b; is_subset tests a ⊆ b.
+ */
+DSC_API void      DSC_FUNC(set_union)(dsc_set* out, dsc_set* a, dsc_set* b);
+DSC_API void      DSC_FUNC(set_intersect)(dsc_set* out, dsc_set* a, dsc_set* b);
+DSC_API void      DSC_FUNC(set_difference)(dsc_set* out, dsc_set* a, dsc_set* b);
+DSC_API bool      DSC_FUNC(set_is_subset)(dsc_set* a, dsc_set* b);
+DSC_API void      DSC_FUNC(set_union_inplace)(dsc_set* a, dsc_set* b);
+DSC_API void      DSC_FUNC(set_intersect_inplace)(dsc_set* a, dsc_set* b);
+DSC_API void      DSC_FUNC(set_difference_inplace)(dsc_set* a, dsc_set* b);
+
+#define DSC_DEFINE_SET(T, NAME) \
+    typedef struct { dsc_set impl; } NAME##_set; \
+    static inline void NAME##_set_init(NAME##_set *s, size_t initial_capacity, size_t key_size, dsc_hashfunc* hf, dsc_cmpfunc* cf) { \
+        DSC_FUNC(set_init)(&s->impl, initial_capacity, key_size, hf, cf); \
+    } \
+    static inline void NAME##_set_destroy(NAME##_set *s) { \
+        DSC_FUNC(set_destroy)(&s->impl); \
+    } \
+    static inline bool NAME##_set_add(NAME##_set *s, const void* item) { \
+        return DSC_FUNC(set_add)(&s->impl, item); \
+    } \
+    static inline void NAME##_set_remove(NAME##_set *s, const void* item) { \
+        DSC_FUNC(set_remove)(&s->impl, item); \
+    } \
+    static inline T NAME##_set_get(NAME##_set *s, const void* item) { \
+        return (T)DSC_FUNC(set_get)(&s->impl, item); \
+    } \
+    static inline bool NAME##_set_contains_unchecked(NAME##_set *s, const void* item) { \
+        return DSC_FUNC(set_contains_unchecked)(&s->impl, item); \
+    } \
+    static inline void NAME##_set_clear(NAME##_set *s) { \
+        DSC_FUNC(set_clear)(&s->impl); \
+    } \
+    static inline bool NAME##_set_reserve(NAME##_set *s, size_t count) { \
+        return DSC_FUNC(set_reserve)(&s->impl, count); \
+    } \
+    static inline bool NAME##_set_compact(NAME##_set *s) { \
+        return DSC_FUNC(set_compact)(&s->impl); \
+    } \
+    static inline void NAME##_set_set_shrink(NAME##_set *s, size_t low_percent) { \
+        DSC_FUNC(set_set_shrink)(&s->impl, low_percent); \
+    } \
+    static inline void NAME##_set_iter_begin(NAME##_set *s, dsc_set_iter *it) { \
+        DSC_FUNC(set_iter_begin)(&s->impl, it); \
+    } \
+    static inline bool NAME##_set_iter_next(dsc_set_iter *it, const T **key) { \
+        if (!DSC_FUNC(set_iter_next)(it)) return false; \
+        if (key != NULL) *key = (const T*)it->key; \
+        return true; \
+    } \
+    static inline void NAME##_set_union(NAME##_set *out, NAME##_set *a, NAME##_set *b) { \
+        DSC_FUNC(set_union)(&out->impl, &a->impl, &b->impl); \
+    } \
+    static inline void NAME##_set_intersect(NAME##_set *out, NAME##_set *a, NAME##_set *b) { \
+        DSC_FUNC(set_intersect)(&out->impl, &a->impl, &b->impl); \
+    } \
+    static inline void NAME##_set_difference(NAME##_set *out, NAME##_set *a, NAME##_set *b) { \
+        DSC_FUNC(set_difference)(&out->impl, &a->impl, &b->impl); \
+    } \
+    static inline bool NAME##_set_is_subset(NAME##_set *a, NAME##_set *b) { \
+        return DSC_FUNC(set_is_subset)(&a->impl, &b->impl); \
+    } \
+    static inline void NAME##_set_union_inplace(NAME##_set *a, NAME##_set *b) { \
+        DSC_FUNC(set_union_inplace)(&a->impl, &b->impl); \
+    } \
+    static inline void NAME##_set_intersect_inplace(NAME##_set *a, NAME##_set *b) { \
+        DSC_FUNC(set_intersect_inplace)(&a->impl, &b->impl); \
+    } \
+    static inline void NAME##_set_difference_inplace(NAME##_set *a, NAME##_set *b) { \
+        DSC_FUNC(set_difference_inplace)(&a->impl, &b->impl); \
+    }
+
+/*
+ * +----------------------------------------------------------------+
+ * |                           BITSET API                           |
+ * +----------------------------------------------------------------+
+ */
+
+/*
+ * Dense set of integer IDs in 0..nbits-1, one bit per possible ID. Set
+ * algebra runs a word (64 IDs) at a time in loops the compiler vectorizes,
+ * size is a popcount, and bitset_next jumps between set bits with a
+ * count-trailing-zeros. Bits past nbits are always zero.
+ *
+ * Conversions read and write IDs as unsigned integers of item_size bytes
+ * (1, 2, 4 or 8), matching dsc_list items and fixed-size dsc_set keys.
+ */
+#define DSC_BITSET_END SIZE_MAX     /* bitset_next: no more set bits */
+
+typedef struct _dsc_bitset {
+    uint64_t            *words;
+    size_t              nbits;      /* Universe size: valid IDs are 0..nbits-1 */
+    const dsc_allocator *allocator; /* NULL means malloc/free */
+} dsc_bitset;
+
+DSC_API void      DSC_FUNC(bitset_init)(dsc_bitset* bs, size_t nbits);
+DSC_API void      DSC_FUNC(bitset_init_with_allocator)(dsc_bitset* bs, size_t nbits, const dsc_allocator* allocator);
+DSC_API void      DSC_FUNC(bitset_destroy)(dsc_bitset* bs);
+DSC_API void      DSC_FUNC(bitset_resize)(dsc_bitset* bs, size_t nbits);
+DSC_API bool      DSC_FUNC(bitset_add)(dsc_bitset* bs, size_t id);
+DSC_API bool      DSC_FUNC(bitset_remove)(dsc_bitset* bs, size_t id);
+DSC_API bool      DSC_FUNC(bitset_contains)(const dsc_bitset* bs, size_t id);
+DSC_API size_t    DSC_FUNC(bitset_count)(const dsc_bitset* bs);
+DSC_API void      DSC_FUNC(bitset_clear)(dsc_bitset* bs);
+DSC_API size_t    DSC_FUNC(bitset_next)(const dsc_bitset* bs, size_t from);
+
+/* In place: dst &= src, dst |= src (growing dst if needed), dst &= ~src */
+DSC_API void      DSC_FUNC(bitset_and)(dsc_bitset* dst, const dsc_bitset* src);
+DSC_API void      DSC_FUNC(bitset_or)(dsc_bitset* dst, const dsc_bitset* src);
+DSC_API void      DSC_FUNC(bitset_andnot)(dsc_bitset* dst, const dsc_bitset* src);
+DSC_API size_t    DSC_FUNC(bitset_and_count)(const dsc_bitset* a, const dsc_bitset* b);
+DSC_API bool      DSC_FUNC(bitset_is_subset)(const dsc_bitset* a, const dsc_bitset* b);
+
+/* nbits 0 sizes the bitset to the largest ID + 1; larger IDs fail with DSC_ERANGE */
+DSC_API void      DSC_FUNC(bitset_from_list)(dsc_bitset* bs, dsc_list* list, size_t nbits);
+DSC_API void      DSC_FUNC(bitset_from_set)(dsc_bitset* bs, dsc_set* set, size_t nbits);
+DSC_API dsc_list  DSC_FUNC(bitset_to_list)(const dsc_bitset* bs, size_t item_size);
+DSC_API dsc_set   DSC_FUNC(bitset_to_set)(const dsc_bitset* bs, size_t item_size, dsc_hashfunc* hf, dsc_cmpfunc* cf);
+
+/* Visit every set bit in increasing order: DSC_BITSET_FOREACH(&bs, id) { ... } */
+#define DSC_BITSET_FOREACH(BS, VAR) \
+    for (size_t VAR = DSC_FUNC(bitset_next)((BS), 0); VAR != DSC_BITSET_END; VAR = DSC_FUNC(bitset_next)((BS), VAR + 1))
+
+/*
+ * +----------------------------------------------------------------+
+ * |                          SNAPSHOT API                          |
+ * +----------------------------------------------------------------+
+ */
+
+/*
+ * A snapshot is a read-only, position-independent image of a hash table or
+ * set: header, bucket index, one entry per key (cached hash plus key and
+ * value offsets), then the value and key bytes. It is loaded by reading the
+ * file into one buffer or by mapping it read-only; lookups then run on the
+ * image directly, with no inserts and no rehashing.
+ *
+ * value_size is the number of bytes copied from each stored obj pointer
+ * (a NULL obj reads back as NULL). With value_size 0 no values are stored
+ * and snapshot_get returns the key inside the image, like set_get. The
+ * loader must be given the hash function the table was built with.
+ */
+typedef struct _dsc_snapshot {
+    const unsigned char *image;
+    size_t          image_size;
+    size_t          count;          /* Number of keys */
+    size_t          key_size;       /* 0 = NUL-terminated strings */
+    size_t          value_size;
+    size_t          bucket_count;   /* Power of two */
+    dsc_hashfunc    *hf;
+    dsc_cmpfunc     *cf;
+    void            *owned;         /* Heap buffer or mapping, NULL when borrowed */
+    size_t          owned_size;
+    unsigned char   source;         /* How owned must be released */
+} dsc_snapshot;
+
+/* buffer must be 16-byte aligned (malloc'd memory is) and snapshot_size bytes long */
+DSC_API size_t       DSC_FUNC(hash_table_snapshot_size)(dsc_hash_table *ht, size_t value_size);
+DSC_API size_t       DSC_FUNC(hash_table_snapshot_write)(dsc_hash_table *ht, size_t value_size, void *buffer, size_t buffer_size);
+DSC_API bool         DSC_FUNC(hash_table_save)(dsc_hash_table *ht, const char *path, size_t value_size);
+DSC_API size_t       DSC_FUNC(set_snapshot_size)(dsc_set *set);
+DSC_API size_t       DSC_FUNC(set_snapshot_write)(dsc_set *set, void *buffer, size_t buffer_size);
+DSC_API bool         DSC_FUNC(set_save)(dsc_set *set, const char *path);
+
+DSC_API void         DSC_FUNC(snapshot_init)(dsc_snapshot *snap, const void *image, size_t size, dsc_hashfunc *hf, dsc_cmpfunc *cf);
+DSC_API void         DSC_FUNC(snapshot_load)(dsc_snapshot *snap, const char *path, dsc_hashfunc *hf, dsc_cmpfunc *cf);
+DSC_API void         DSC_FUNC(snapshot_map)(dsc_snapshot *snap, const char *path, dsc_hashfunc *hf, dsc_cmpfunc *cf);
+DSC_API const void*  DSC_FUNC(snapshot_get)(const dsc_snapshot *snap, const void *key);
+DSC_API bool         DSC_FUNC(snapshot_contains)(const dsc_snapshot *snap, const void *key);
+DSC_API void         DSC_FUNC(snapshot_destroy)(dsc_snapshot *snap);
+
+/*
+ * +----------------------------------------------------------------+
+ * |                           Stack API                            |
+ * +----------------------------------------------------------------+
+ */
+typedef struct _dsc_stack {
+    dsc_list list;
+} dsc_stack;
+
+DSC_API void      DSC_FUNC(stack_init)(dsc_stack* stack, size_t item_size, size_t initial_capacity);
+DSC_API void      DSC_FUNC(stack_init_with_allocator)(dsc_stack* stack, size_t item_size, size_t initial_capacity, const dsc_allocator* allocator);
+DSC_API bool      DSC_FUNC(stack_push)(dsc_stack* stack, void* item);
 DSC_API void*     DSC_FUNC(stack_pop)(dsc_stack* stack, void *out_item);
 DSC_API void*     DSC_FUNC(stack_peek)(dsc_stack* stack);
 DSC_API size_t    DSC_FUNC(stack_size)(dsc_stack* stack);
 DSC_API bool      DSC_FUNC(stack_is_empty)(dsc_stack* stack);
 DSC_API void      DSC_FUNC(stack_clear)(dsc_stack* stack);
+DSC_API void      DSC_FUNC(stack_shrink_to_fit)(dsc_stack* stack);    /* Or set a shrink watermark on stack.list's growth policy */
 DSC_API void      DSC_FUNC(stack_destroy)(dsc_stack* stack);
+DSC_API dsc_alloc_stats DSC_FUNC(stack_stats)(dsc_stack* stack);   /* See list_stats */
+
+/*
+ * Unchecked tier, inlined at the call site (see hash_table_get_unchecked).
+ * An empty stack is still reported: peek returns NULL and pop DSC_EEMPTY.
+ */
+static inline dsc_error_t DSC_FUNC(stack_push_unchecked)(dsc_stack* stack, const void* item) {
+    return DSC_FUNC(list_append_unchecked)(&stack->list, item);
+}
+
+static inline dsc_error_t DSC_FUNC(stack_pop_unchecked)(dsc_stack* stack, void* out_item) {
+    if (stack->list.length == 0) return DSC_EEMPTY;
+    stack->list.length--;
+    if (out_item != NULL) memcpy(out_item, (char*)stack->list.items + stack->list.length * stack->list.item_size, stack->list.item_size);
+    return DSC_EOK;
+}
+
+static inline void* DSC_FUNC(stack_peek_unchecked)(const dsc_stack* stack) {
+    if (stack->list.length == 0) return NULL;
+    return (char*)stack->list.items + (stack->list.length - 1) * stack->list.item_size;
+}
 
 #define DSC_DEFINE_STACK(T, NAME) \
     typedef struct { dsc_stack impl; } NAME##_stack; \
@@ -389,6 +1886,15 @@ DSC_API void      DSC_FUNC(stack_destroy)(dsc_stack* stack);
     static inline T* NAME##_stack_peek(NAME##_stack *s) { \
         return (T*)DSC_FUNC(stack_peek)(&s->impl); \
     } \
+    static inline dsc_error_t NAME##_stack_push_unchecked(NAME##_stack *s, T item) { \
+        return DSC_FUNC(stack_push_unchecked)(&s->impl, &item); \
+    } \
+    static inline dsc_error_t NAME##_stack_pop_unchecked(NAME##_stack *s, T* out) { \
+        return DSC_FUNC(stack_pop_unchecked)(&s->impl, out); \
+    } \
+    static inline T* NAME##_stack_peek_unchecked(NAME##_stack *s) { \
+        return (T*)DSC_FUNC(stack_peek_unchecked)(&s->impl); \
+    } \
     static inline size_t NAME##_stack_size(NAME##_stack *s) { \
         return DSC_FUNC(stack_size)(&s->impl); \
     } \
@@ -398,10 +1904,221 @@ DSC_API void      DSC_FUNC(stack_destroy)(dsc_stack* stack);
     static inline void NAME##_stack_clear(NAME##_stack *s) { \
         DSC_FUNC(stack_clear)(&s->impl); \
     } \
+    static inline void NAME##_stack_shrink_to_fit(NAME##_stack *s) { \
+        DSC_FUNC(stack_shrink_to_fit)(&s->impl); \
+    } \
     static inline void NAME##_stack_destroy(NAME##_stack *s) { \
         DSC_FUNC(stack_destroy)(&s->impl); \
     }
 
+/*
+ * +----------------------------------------------------------------+
+ * |                           DEQUE API                            |
+ * +----------------------------------------------------------------+
+ */
+
+/*
+ * Segmented double-ended queue: a doubly linked chain of fixed-size blocks.
+ * A push allocates at most one block and never moves existing items, so
+ * pushes are O(1) worst case and element addresses stay valid until the
+ * element is popped. A block is released as soon as it empties; one empty
+ * block is kept as a spare so a size oscillating across a block boundary
+ * does not malloc/free on every step. Use it as a stack (back), a FIFO
+ * queue (push back, pop front) or both.
+ */
+typedef struct _dsc_deque_block {
+    struct _dsc_deque_block *prev;
+    struct _dsc_deque_block *next;
+    /* block_items items follow, 16-byte aligned */
+} dsc_deque_block;
+
+typedef struct _dsc_deque {
+    dsc_deque_block     *head;          /* NULL when empty */
+    dsc_deque_block     *tail;
+    dsc_deque_block     *spare;         /* One cached empty block, or NULL */
+    size_t              head_pos;       /* Index of the first item in head */
+    size_t              tail_pos;       /* One past the last item in tail */
+    size_t              size;
+    size_t              item_size;
+    size_t              block_items;
+    const dsc_allocator *allocator;     /* NULL means malloc/free */
+} dsc_deque;
+
+/* block_items 0 picks about 4 KiB per block */
+DSC_API void      DSC_FUNC(deque_init)(dsc_deque* dq, size_t item_size, size_t block_items);
+DSC_API void      DSC_FUNC(deque_init_with_allocator)(dsc_deque* dq, size_t item_size, size_t block_items, const dsc_allocator* allocator);
+DSC_API void      DSC_FUNC(deque_destroy)(dsc_deque* dq);
+DSC_API void      DSC_FUNC(deque_clear)(dsc_deque* dq);
+DSC_API bool      DSC_FUNC(deque_push_back)(dsc_deque* dq, const void* item);
+DSC_API bool      DSC_FUNC(deque_push_front)(dsc_deque* dq, const void* item);
+DSC_API bool      DSC_FUNC(deque_pop_back)(dsc_deque* dq, void* out_item);
+DSC_API bool      DSC_FUNC(deque_pop_front)(dsc_deque* dq, void* out_item);
+DSC_API void*     DSC_FUNC(deque_peek_back)(dsc_deque* dq);
+DSC_API void*     DSC_FUNC(deque_peek_front)(dsc_deque* dq);
+DSC_API void*     DSC_FUNC(deque_get)(dsc_deque* dq, size_t index);     /* Walks blocks from the nearer end */
+DSC_API size_t    DSC_FUNC(deque_size)(dsc_deque* dq);
+
+/*
+ * Batch forms copy whole block runs with memcpy. push_back_n returns the
+ * number pushed (short only on DSC_ENOMEM). The pop_n forms move
+ * min(count, size) items into out (NULL discards them) in their stored
+ * front-to-back order, so push_back_n then pop_back_n round-trips the
+ * array unchanged.
+ */
+DSC_API size_t    DSC_FUNC(deque_push_back_n)(dsc_deque* dq, const void* items, size_t count);
+DSC_API size_t    DSC_FUNC(deque_pop_back_n)(dsc_deque* dq, void* out_items, size_t count);
+DSC_API size_t    DSC_FUNC(deque_pop_front_n)(dsc_deque* dq, void* out_items, size_t count);
+
+#define DSC_DEFINE_DEQUE(T, NAME) \
+    typedef struct { dsc_deque impl; } NAME##_deque; \
+    static inline void NAME##_deque_init(NAME##_deque *d, size_t block_items) { \
+        DSC_FUNC(deque_init)(&d->impl, sizeof(T), block_items); \
+    } \
+    static inline void NAME##_deque_destroy(NAME##_deque *d) { \
+        DSC_FUNC(deque_destroy)(&d->impl); \
+    } \
+    static inline void NAME##_deque_clear(NAME##_deque *d) { \
+        DSC_FUNC(deque_clear)(&d->impl); \
+    } \
+    static inline bool NAME##_deque_push_back(NAME##_deque *d, T item) { \
+        return DSC_FUNC(deque_push_back)(&d->impl, &item); \
+    } \
+    static inline bool NAME##_deque_push_front(NAME##_deque *d, T item) { \
+        return DSC_FUNC(deque_push_front)(&d->impl, &item); \
+    } \
+    static inline bool NAME##_deque_pop_back(NAME##_deque *d, T *out) { \
+        return DSC_FUNC(deque_pop_back)(&d->impl, out); \
+    } \
+    static inline bool NAME##_deque_pop_front(NAME##_deque *d, T *out) { \
+        return DSC_FUNC(deque_pop_front)(&d->impl, out); \
+    } \
+    static inline T* NAME##_deque_peek_back(NAME##_deque *d) { \
+        return (T*)DSC_FUNC(deque_peek_back)(&d->impl); \
+    } \
+    static inline T* NAME##_deque_peek_front(NAME##_deque *d) { \
+        return (T*)DSC_FUNC(deque_peek_front)(&d->impl); \
+    } \
+    static inline T* NAME##_deque_get(NAME##_deque *d, size_t index) { \
+        return (T*)DSC_FUNC(deque_get)(&d->impl, index); \
+    } \
+    static inline size_t NAME##_deque_size(NAME##_deque *d) { \
+        return d->impl.size; \
+    } \
+    static inline size_t NAME##_deque_push_back_n(NAME##_deque *d, const T *items, size_t count) { \
+        return DSC_FUNC(deque_push_back_n)(&d->impl, items, count); \
+    } \
+    static inline size_t NAME##_deque_pop_back_n(NAME##_deque *d, T *out, size_t count) { \
+        return DSC_FUNC(deque_pop_back_n)(&d->impl, out, count); \
+    } \
+    static inline size_t NAME##_deque_pop_front_n(NAME##_deque *d, T *out, size_t count) { \
+        return DSC_FUNC(deque_pop_front_n)(&d->impl, out, count); \
+    }
+
+/*
+ * +----------------------------------------------------------------+
+ * |                   LOCK-FREE QUEUE API                          |
+ * +----------------------------------------------------------------+
+ */
+
+/*
+ * Bounded queues for passing items between threads without a mutex. Both
+ * store item_size bytes per slot (copied in and out, like dsc_stack), have a
+ * power-of-two capacity fixed at init, and never reallocate.
+ *
+ *   dsc_mpmc_queue  any number of producers and consumers (Vyukov's
+ *                   sequence-numbered ring; one CAS per operation)
+ *   dsc_spsc_ring   exactly one producer thread and one consumer thread;
+ *                   no CAS at all, each side caches the other's index
+ *
+ * push/pop return false with DSC_EFULL/DSC_EEMPTY when they cannot proceed;
+ * successful calls leave dsc_get_error() untouched. The *_n variants move up
+ * to count items with a single claim and return how many actually moved.
+ */
+#define DSC_CACHE_LINE 64
+
+typedef struct _dsc_mpmc_queue {
+    unsigned char   *cells;         /* [ seq | item ] per slot */
+    size_t          cell_size;
+    size_t          item_size;
+    size_t          mask;           /* capacity - 1 */
+    char            pad0[DSC_CACHE_LINE];
+    size_t          enqueue_pos;
+    char            pad1[DSC_CACHE_LINE];
+    size_t          dequeue_pos;
+    char            pad2[DSC_CACHE_LINE];
+} dsc_mpmc_queue;
+
+typedef struct _dsc_spsc_ring {
+    unsigned char   *items;
+    size_t          item_size;
+    size_t          mask;           /* capacity - 1 */
+    char            pad0[DSC_CACHE_LINE];
+    size_t          tail;           /* Producer side */
+    size_t          head_cache;
+    char            pad1[DSC_CACHE_LINE];
+    size_t          head;           /* Consumer side */
+    size_t          tail_cache;
+    char            pad2[DSC_CACHE_LINE];
+} dsc_spsc_ring;
+
+DSC_API void      DSC_FUNC(mpmc_queue_init)(dsc_mpmc_queue *q, size_t item_size, size_t capacity);
+DSC_API void      DSC_FUNC(mpmc_queue_destroy)(dsc_mpmc_queue *q);
+DSC_API bool      DSC_FUNC(mpmc_queue_push)(dsc_mpmc_queue *q, const void *item);
+DSC_API bool      DSC_FUNC(mpmc_queue_pop)(dsc_mpmc_queue *q, void *out_item);
+DSC_API size_t    DSC_FUNC(mpmc_queue_push_n)(dsc_mpmc_queue *q, const void *items, size_t count);
+DSC_API size_t    DSC_FUNC(mpmc_queue_pop_n)(dsc_mpmc_queue *q, void *out_items, size_t count);
+DSC_API size_t    DSC_FUNC(mpmc_queue_size)(dsc_mpmc_queue *q);
+
+DSC_API void      DSC_FUNC(spsc_ring_init)(dsc_spsc_ring *r, size_t item_size, size_t capacity);
+DSC_API void      DSC_FUNC(spsc_ring_destroy)(dsc_spsc_ring *r);
+DSC_API bool      DSC_FUNC(spsc_ring_push)(dsc_spsc_ring *r, const void *item);
+DSC_API bool      DSC_FUNC(spsc_ring_pop)(dsc_spsc_ring *r, void *out_item);
+DSC_API size_t    DSC_FUNC(spsc_ring_push_n)(dsc_spsc_ring *r, const void *items, size_t count);
+DSC_API size_t    DSC_FUNC(spsc_ring_pop_n)(dsc_spsc_ring *r, void *out_items, size_t count);
+DSC_API size_t    DSC_FUNC(spsc_ring_size)(dsc_spsc_ring *r);
+
+#define DSC_DEFINE_MPMC_QUEUE(T, NAME) \
+    typedef struct { dsc_mpmc_queue impl; } NAME##_mpmc_queue; \
+    static inline void NAME##_mpmc_queue_init(NAME##_mpmc_queue *q, size_t cap) { \
+        DSC_FUNC(mpmc_queue_init)(&q->impl, sizeof(T), cap); \
+    } \
+    static inline bool NAME##_mpmc_queue_push(NAME##_mpmc_queue *q, T item) { \
+        return DSC_FUNC(mpmc_queue_push)(&q->impl, &item); \
+    } \
+    static inline bool NAME##_mpmc_queue_pop(NAME##_mpmc_queue *q, T *out) { \
+        return DSC_FUNC(mpmc_queue_pop)(&q->impl, out); \
+    } \
+    static inline size_t NAME##_mpmc_queue_push_n(NAME##_mpmc_queue *q, const T *items, size_t n) { \
+        return DSC_FUNC(mpmc_queue_push_n)(&q->impl, items, n); \
+    } \
+    static inline size_t NAME##_mpmc_queue_pop_n(NAME##_mpmc_queue *q, T *out, size_t n) { \
+        return DSC_FUNC(mpmc_queue_pop_n)(&q->impl, out, n); \
+    } \
+    static inline void NAME##_mpmc_queue_destroy(NAME##_mpmc_queue *q) { \
+        DSC_FUNC(mpmc_queue_destroy)(&q->impl); \
+    }
+
+#define DSC_DEFINE_SPSC_RING(T, NAME) \
+    typedef struct { dsc_spsc_ring impl; } NAME##_spsc_ring; \
+    static inline void NAME##_spsc_ring_init(NAME##_spsc_ring *r, size_t cap) { \
+        DSC_FUNC(spsc_ring_init)(&r->impl, sizeof(T), cap); \
+    } \
+    static inline bool NAME##_spsc_ring_push(NAME##_spsc_ring *r, T item) { \
+        return DSC_FUNC(spsc_ring_push)(&r->impl, &item); \
+    } \
+    static inline bool NAME##_spsc_ring_pop(NAME##_spsc_ring *r, T *out) { \
+        return DSC_FUNC(spsc_ring_pop)(&r->impl, out); \
+    } \
+    static inline size_t NAME##_spsc_ring_push_n(NAME##_spsc_ring *r, const T *items, size_t n) { \
+        return DSC_FUNC(spsc_ring_push_n)(&r->impl, items, n); \
+    } \
+    static inline size_t NAME##_spsc_ring_pop_n(NAME##_spsc_ring *r, T *out, size_t n) { \
+        return DSC_FUNC(spsc_ring_pop_n)(&r->impl, out, n); \
+    } \
+    static inline void NAME##_spsc_ring_destroy(NAME##_spsc_ring *r) { \
+        DSC_FUNC(spsc_ring_destroy)(&r->impl); \
+    }
+
 
 /*
  * +----------------------------------------------------------------+
@@ -412,6 +2129,8 @@ DSC_API void      DSC_FUNC(stack_destroy)(dsc_stack* stack);
 /* Hash Table Utilities */
 DSC_API dsc_list  DSC_FUNC(hash_table_keys)(dsc_hash_table *ht);
 DSC_API dsc_list  DSC_FUNC(hash_table_values)(dsc_hash_table *ht);
+DSC_API dsc_list  DSC_FUNC(flat_table_keys)(dsc_flat_table *ft);
+DSC_API dsc_list  DSC_FUNC(flat_table_values)(dsc_flat_table *ft);
 
 /* List/Set Conversion Utilities */
 DSC_API dsc_set  DSC_FUNC(list_to_set)(dsc_list* list, dsc_hashfunc* hf, dsc_cmpfunc* cf);
@@ -428,6 +2147,7 @@ DSC_API bool     DSC_FUNC(list_has_duplicates)(dsc_list* list, dsc_hashfunc* hf,
 
 #include <string.h>
 #include <stdlib.h>
+#include <stdio.h>      /* Snapshot files */
 #include <assert.h>
 
 /* ---------------------------------------------------------------
@@ -463,797 +2183,7425 @@ const char* DSC_FUNC(strerror)(dsc_error_t err) {
 
 /*
  * +----------------------------------------------------------------+
- * |                   HASHTABLE Implementation                     |
+ * |                   ALLOCATOR Implementation                     |
  * +----------------------------------------------------------------+
  */
-void DSC_FUNC(hash_table_init)(dsc_hash_table *ht, size_t capacity, size_t key_size, dsc_hashfunc *hf, dsc_cmpfunc *cf)
-{
-    dsc_set_error(DSC_EOK);
-
-    if (ht == NULL) {
-        dsc_set_error(DSC_EINVAL);
-        return;
-    }
+static inline void* dsc_mem_alloc(const dsc_allocator *a, size_t size) {
+    return (a != NULL) ? a->alloc(a->ctx, size) : malloc(size);
+}
 
-    if (hf == NULL) {
-        dsc_set_error(DSC_EHASHFUNC);
-        return;
-    }
+static inline void* dsc_mem_calloc(const dsc_allocator *a, size_t count, size_t size) {
+    if (a == NULL) return calloc(count, size);
+    if (size != 0 && count > SIZE_MAX / size) return NULL;
 
-    /* key_size can be 0 for variable-length keys (e.g., strings) */
+    void *ptr = a->alloc(a->ctx, count * size);
+    if (ptr != NULL) memset(ptr, 0, count * size);
+    return ptr;
+}
 
-    if (cf == NULL) {
-        dsc_set_error(DSC_ECMPFUNC);
-        return;
-    }
+static inline void* dsc_mem_realloc(const dsc_allocator *a, void *ptr, size_t old_size, size_t new_size) {
+    return (a != NULL) ? a->realloc(a->ctx, ptr, old_size, new_size) : realloc(ptr, new_size);
+}
 
-    if (capacity == 0) capacity = 1;
+static inline void dsc_mem_free(const dsc_allocator *a, void *ptr, size_t size) {
+    if (a == NULL) free(ptr);
+    else if (a->free != NULL && ptr != NULL) a->free(a->ctx, ptr, size);
+}
 
-    *ht = (dsc_hash_table) {
-        .capacity = capacity,
-        .hf       = hf,
-        .cf       = cf,
-        .key_size = key_size,
-        .size     = 0,
-        .kvpairs  = (dsc_kvpair **)calloc(capacity, sizeof(dsc_kvpair *))
-    };
-    if (ht->kvpairs == NULL) {
-        dsc_set_error(DSC_ENOMEM);
-        ht->capacity = 0;
-        ht->size = 0;
-        ht->kvpairs = NULL;
-        return;
-    }
+/* True when individual frees are required (i.e. not a bulk-release allocator) */
+static inline bool dsc_mem_needs_free(const dsc_allocator *a) {
+    return a == NULL || a->free != NULL;
 }
 
-bool DSC_FUNC(hash_table_insert)(dsc_hash_table *ht, const void *key, void *obj)
-{
-    dsc_set_error(DSC_EOK);
+/* Checked size arithmetic: true when the result does not fit in size_t */
+static inline bool dsc_mul_overflow(size_t a, size_t b, size_t *out) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_mul_overflow(a, b, out);
+#else
+    if (b != 0 && a > SIZE_MAX / b) return true;
+    *out = a * b;
+    return false;
+#endif
+}
 
-    if ((ht == NULL) || (key == NULL) || (obj == NULL)) {
-        dsc_set_error(DSC_EINVAL);
-        return false;
-    }
+static inline bool dsc_add_overflow(size_t a, size_t b, size_t *out) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_add_overflow(a, b, out);
+#else
+    if (a > SIZE_MAX - b) return true;
+    *out = a + b;
+    return false;
+#endif
+}
 
-    if ((float)ht->size / ht->capacity > 0.75) {
-        size_t old_capacity  = ht->capacity;
-        ht->capacity         = ht->capacity * 2;
-        dsc_kvpair **new_kvpairs = (dsc_kvpair **)calloc(ht->capacity, sizeof(dsc_kvpair *));
-        if (new_kvpairs == NULL) {
-            dsc_set_error(DSC_ENOMEM);
-            ht->capacity = old_capacity;
-            return false;
-        }
+/* DSC_STAT(stmt) runs stmt only in DSC_STATS builds and vanishes otherwise */
+#ifdef DSC_STATS
+#include <time.h>
+#define DSC_STAT(stmt) do { stmt; } while (0)
 
-        // Rehash existing key-value pairs
-        for (size_t i = 0; i < old_capacity; i++) {
-            dsc_kvpair *tmp = ht->kvpairs[i];
-            while (tmp != NULL) {
-                dsc_kvpair *next = tmp->next;
+static inline void dsc_stats_resize(dsc_alloc_stats *s, size_t old_bytes, size_t new_bytes) {
+    s->allocs++;
+    s->bytes = s->bytes - old_bytes + new_bytes;
+    if (s->bytes > s->peak_bytes) s->peak_bytes = s->bytes;
+}
 
-                uint32_t new_index = ht->hf(tmp->key, tmp->key_size) % ht->capacity;
-                assert(new_index < ht->capacity); // Ensure the index is within bounds
+static inline void dsc_stats_free(dsc_alloc_stats *s, size_t bytes) {
+    s->frees++;
+    s->bytes -= bytes;
+}
 
-                tmp->next = new_kvpairs[new_index];
-                new_kvpairs[new_index] = tmp;
+/* Wall-clock nanoseconds from C11 timespec_get; only differences are used */
+static inline uint64_t dsc_stats_now_ns(void) {
+    struct timespec ts;
+    if (timespec_get(&ts, TIME_UTC) == 0) return 0;
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#else
+#define DSC_STAT(stmt) ((void)0)
+#endif
 
-                tmp = next;
-            }
-        }
+static const dsc_list_growth dsc_list_default_growth = { 100, 8, 0, 0 };
 
-        free(ht->kvpairs);
-        ht->kvpairs = new_kvpairs;
+/* Reallocate the item buffer to exactly new_capacity items (ENOMEM on overflow) */
+static bool dsc_list_set_capacity(dsc_list* list, size_t new_capacity) {
+    size_t new_bytes;
+    if (dsc_mul_overflow(new_capacity, list->item_size, &new_bytes)) {
+        dsc_set_error(DSC_ENOMEM);
+        return false;
     }
-
-    if (DSC_FUNC(hash_table_get)(ht, key) != NULL) {
-        dsc_set_error(DSC_EEXISTS);
+    void* new_items = dsc_mem_realloc(list->allocator, list->items, list->capacity * list->item_size, new_bytes);
+    if (new_items == NULL) {
+        dsc_set_error(DSC_ENOMEM);
         return false;
     }
-    dsc_set_error(DSC_EOK);
+    DSC_STAT(dsc_stats_resize(&list->stats, list->capacity * list->item_size, new_bytes));
+    list->items    = new_items;
+    list->capacity = new_capacity;
+    return true;
+}
 
-    /* Calculate actual key size (for variable-length keys like strings) */
-    size_t actual_key_size = ht->key_size;
-    if (actual_key_size == 0) {
-        /* Variable-length key - assume null-terminated string */
-        actual_key_size = strlen((const char*)key) + 1;
+/* Capacity to grow to so that at least needed items fit, following the list's policy */
+static size_t dsc_list_next_capacity(const dsc_list* list, size_t needed) {
+    const dsc_list_growth* g = (list->growth != NULL) ? list->growth : &dsc_list_default_growth;
+
+    size_t step;
+    if (dsc_mul_overflow(list->capacity, g->growth_percent, &step)) {
+        step = SIZE_MAX;
+    } else {
+        step /= 100;
     }
+    if (g->max_step != 0 && step > g->max_step) step = g->max_step;
 
-    uint32_t index = ht->hf(key, actual_key_size) % ht->capacity;
+    size_t target;
+    if (dsc_add_overflow(list->capacity, step, &target)) target = SIZE_MAX;
+    if (target < g->min_capacity) target = g->min_capacity;
+    if (target < needed) target = needed;
+    return target;
+}
 
-    dsc_kvpair *kvp = (dsc_kvpair *)malloc(sizeof(dsc_kvpair));
-    if (kvp == NULL) {
-        dsc_set_error(DSC_ENOMEM);
-        return false;
-    }
+/* Make room for at least needed items; every growing path goes through here */
+static bool dsc_list_grow(dsc_list* list, size_t needed) {
+    if (needed <= list->capacity) return true;
 
-    *kvp = (dsc_kvpair) {
-        .key      = malloc(actual_key_size),
-        .obj      = obj,
-        .key_size = actual_key_size
-    };
-    if (kvp->key == NULL) {
-        dsc_set_error(DSC_ENOMEM);
-        free(kvp);
-        return false;
+    size_t target = dsc_list_next_capacity(list, needed);
+    if (dsc_list_set_capacity(list, target)) return true;
+
+    /* The full step may not be affordable even when an exact fit is */
+    if (target > needed && dsc_list_set_capacity(list, needed)) {
+        dsc_set_error(DSC_EOK);
+        return true;
     }
+    return false;
+}
 
-    memcpy(kvp->key, key, actual_key_size);
+/* Give capacity back once the length is under the policy's low watermark */
+static void dsc_list_maybe_shrink(dsc_list* list) {
+    const dsc_list_growth* g = list->growth;
+    if (g == NULL || g->shrink_percent == 0 || list->capacity == 0) return;
+    size_t low;
+    if (dsc_mul_overflow(list->capacity, g->shrink_percent, &low)) {
+        low = list->capacity / 100 * g->shrink_percent;
+    } else {
+        low /= 100;
+    }
+    if (list->length >= low) return;
 
-    kvp->next = ht->kvpairs[index];
-    ht->kvpairs[index] = kvp;
-    ht->size++;
+    size_t target = list->length * 2;
+    if (target < g->min_capacity) target = g->min_capacity;
+    if (target == 0) target = 1;   /* items stays a valid buffer */
 
-    return true;
+    /* The caller's operation already succeeded; a failed shrink just keeps the buffer */
+    if (target < list->capacity && !dsc_list_set_capacity(list, target)) dsc_set_error(DSC_EOK);
 }
 
-/**
- * @brief deallocates the hash table
- * @param ht the hash table pointer
- * @param cf function pointer to a custom cleanup function for deallocating dynamically allocated objects defined by user.
- *  it should be NULL if the objects is statically allocated or the user want to handel the deallocation by himself.
- */
-void DSC_FUNC(hash_table_destroy)(dsc_hash_table *ht, dsc_cleanupfunc *cf)
-{
-    if (ht == NULL) {
-        dsc_set_error(DSC_EINVAL);
-        return;
-    }
-    dsc_set_error(DSC_EOK);
-
-    for (uint32_t i = 0; i < ht->capacity; i++) {
-        while (ht->kvpairs[i] != NULL) {
-            dsc_kvpair *tmp = ht->kvpairs[i];
-            ht->kvpairs[i]  = ht->kvpairs[i]->next;
+/* Append without validation; capacity must already be reserved */
+static inline void dsc_list_push_unchecked(dsc_list* list, const void* item) {
+    memcpy((char*)list->items + list->length * list->item_size, item, list->item_size);
+    list->length++;
+}
 
-            free((void *)tmp->key);
-            tmp->key = NULL;
+#define DSC_ARENA_ALIGN        16
+#define DSC_ARENA_DEFAULT_SLAB (64 * 1024)
+#define DSC_ARENA_ROUND(n)     (((n) + DSC_ARENA_ALIGN - 1) & ~(size_t)(DSC_ARENA_ALIGN - 1))
+#define DSC_ARENA_HEADER       DSC_ARENA_ROUND(sizeof(dsc_arena_slab))
+#define DSC_ARENA_DATA(slab)   ((unsigned char *)(slab) + DSC_ARENA_HEADER)
 
-            if (cf != NULL) cf(tmp->obj);
+static void* dsc_arena_alloc_cb(void *ctx, size_t size) {
+    return DSC_FUNC(arena_alloc)((dsc_arena *)ctx, size);
+}
 
-            free(tmp); tmp = NULL;
+static void* dsc_arena_realloc_cb(void *ctx, void *ptr, size_t old_size, size_t new_size) {
+    dsc_arena *arena = (dsc_arena *)ctx;
+
+    /* The most recent allocation can grow in place while the slab has room */
+    if (ptr != NULL && ptr == arena->last) {
+        dsc_arena_slab *slab  = arena->slabs;
+        size_t          start = (size_t)((unsigned char *)ptr - DSC_ARENA_DATA(slab));
+        if (new_size <= slab->size - start) {
+            slab->used = DSC_ARENA_ROUND(start + new_size);
+            if (slab->used > slab->size) slab->used = slab->size;
+            return ptr;
         }
     }
 
-    free(ht->kvpairs); ht->kvpairs = NULL;
+    void *new_ptr = DSC_FUNC(arena_alloc)(arena, new_size);
+    if (new_ptr != NULL && ptr != NULL) {
+        memcpy(new_ptr, ptr, (old_size < new_size) ? old_size : new_size);
+    }
+    return new_ptr;
 }
 
-void *DSC_FUNC(hash_table_delete)(dsc_hash_table *ht, const void *key)
-{
+void DSC_FUNC(arena_init)(dsc_arena *arena, size_t slab_size) {
     dsc_set_error(DSC_EOK);
 
-    if ((ht == NULL) || (key == NULL)) {
+    if (arena == NULL) {
         dsc_set_error(DSC_EINVAL);
-        return NULL;
-    }
-
-    /* Calculate key size for variable-length keys */
-    size_t key_size = ht->key_size;
-    if (key_size == 0) {
-        key_size = strlen((const char*)key) + 1;
+        return;
     }
 
-    uint32_t index = ht->hf(key, key_size) % ht->capacity;
+    if (slab_size == 0) slab_size = DSC_ARENA_DEFAULT_SLAB;
+
+    *arena = (dsc_arena) {
+        .allocator = {
+            .alloc   = dsc_arena_alloc_cb,
+            .realloc = dsc_arena_realloc_cb,
+            .free    = NULL,    /* Released in bulk by reset/destroy */
+            .ctx     = arena
+        },
+        .slabs     = NULL,
+        .slab_size = slab_size,
+        .last      = NULL
+    };
+}
 
-    dsc_kvpair *tmp  = ht->kvpairs[index];
-    dsc_kvpair *prev = NULL;
-    while (tmp != NULL && ht->cf(tmp->key, tmp->key_size, key, key_size) != 0) {
-        prev = tmp;
-        tmp  = tmp->next;
+void* DSC_FUNC(arena_alloc)(dsc_arena *arena, size_t size) {
+    if (arena == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
     }
 
-    if (tmp  == NULL) {
-        dsc_set_error(DSC_ENOTFOUND);
+    size_t rounded = DSC_ARENA_ROUND(size);
+    if (rounded < size) {  /* Overflow */
+        dsc_set_error(DSC_ENOMEM);
         return NULL;
     }
-    if (prev == NULL) ht->kvpairs[index] = tmp->next;
-    else prev->next = tmp->next;
+    dsc_set_error(DSC_EOK);
 
-    void *result = tmp->obj;
-    free((void *)tmp->key);
-    free(tmp); tmp = NULL;
+    dsc_arena_slab *slab = arena->slabs;
+    if (slab == NULL || slab->size - slab->used < rounded) {
+        /* Oversized requests get a dedicated slab */
+        size_t data_size = (rounded > arena->slab_size) ? rounded : arena->slab_size;
+        if (data_size > SIZE_MAX - DSC_ARENA_HEADER) {
+            dsc_set_error(DSC_ENOMEM);
+            return NULL;
+        }
 
-    ht->size--;
-    return result;
+        slab = (dsc_arena_slab *)malloc(DSC_ARENA_HEADER + data_size);
+        if (slab == NULL) {
+            dsc_set_error(DSC_ENOMEM);
+            return NULL;
+        }
+
+        slab->size   = data_size;
+        slab->used   = 0;
+        slab->next   = arena->slabs;
+        arena->slabs = slab;
+    }
+
+    void *ptr   = DSC_ARENA_DATA(slab) + slab->used;
+    slab->used += rounded;
+    arena->last = ptr;
+    return ptr;
 }
 
-void *DSC_FUNC(hash_table_get)(dsc_hash_table *ht, const void *key)
-{
+void DSC_FUNC(arena_reset)(dsc_arena *arena) {
+    if (arena == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
     dsc_set_error(DSC_EOK);
 
-    if ((ht == NULL) || (key == NULL)) {
-        dsc_set_error(DSC_EINVAL);
-        return NULL;
+    /* Keep the current slab for reuse, release the rest */
+    dsc_arena_slab *keep = arena->slabs;
+    if (keep == NULL) return;
+
+    dsc_arena_slab *slab = keep->next;
+    while (slab != NULL) {
+        dsc_arena_slab *next = slab->next;
+        free(slab);
+        slab = next;
     }
-    if (ht->hf == NULL) {
-        dsc_set_error(DSC_EHASHFUNC);
-        return NULL;
+    keep->next  = NULL;
+    keep->used  = 0;
+    arena->last = NULL;
+}
+
+void DSC_FUNC(arena_destroy)(dsc_arena *arena) {
+    if (arena == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
     }
+    dsc_set_error(DSC_EOK);
 
-    /* Calculate key size for variable-length keys */
-    size_t key_size = ht->key_size;
-    if (key_size == 0) {
-        key_size = strlen((const char*)key) + 1;
+    dsc_arena_slab *slab = arena->slabs;
+    while (slab != NULL) {
+        dsc_arena_slab *next = slab->next;
+        free(slab);
+        slab = next;
     }
+    arena->slabs = NULL;
+    arena->last  = NULL;
+}
 
-    uint32_t index = ht->hf(key, key_size) % ht->capacity;
+/*
+ * +----------------------------------------------------------------+
+ * |                 VIRTUAL MEMORY Implementation                  |
+ * +----------------------------------------------------------------+
+ */
+#ifndef DSC_NO_VMEM
 
-    dsc_kvpair *tmp = ht->kvpairs[index];
-    while (tmp != NULL && ht->cf(tmp->key, tmp->key_size, key, key_size) != 0) {
-        tmp = tmp->next;
-    }
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/stat.h>
+
+    #if defined(MAP_ANONYMOUS)
+        #define DSC_MAP_ANON MAP_ANONYMOUS
+    #else
+        #define DSC_MAP_ANON MAP_ANON
+    #endif
+    #if defined(MAP_NORESERVE)
+        #define DSC_MAP_NORESERVE MAP_NORESERVE
+    #else
+        #define DSC_MAP_NORESERVE 0
+    #endif
+#endif
 
-    if (tmp == NULL) {
-        dsc_set_error(DSC_ENOTFOUND);
-        return NULL;
-    }
+#ifndef DSC_VMEM_DEFAULT_RESERVE
+#define DSC_VMEM_DEFAULT_RESERVE ((sizeof(void *) >= 8) ? ((size_t)1 << 36) : ((size_t)1 << 30))
+#endif
 
-    return tmp->obj;
+#define DSC_VMEM_HEADER     64      /* Keeps the buffer cache-line aligned */
+#define DSC_VMEM_HUGE_SIZE  ((size_t)2 * 1024 * 1024)
+#define DSC_VMEM_MAGIC      "DSCVMEM1"
+
+/* Lives at the start of a file-backed mapping so it can be reopened */
+typedef struct {
+    char        magic[8];
+    uint64_t    elem_size;          /* Item size recorded by dsc_list_sync, 0 = none */
+    uint64_t    used;               /* Live bytes after the header */
+} dsc_vmem_header;
+
+#define DSC_VMEM_HDR(vm)    ((dsc_vmem_header *)(void *)(vm)->base)
+#define DSC_VMEM_DATA(vm)   ((vm)->base + DSC_VMEM_HEADER)
+
+/* Round n up to a power-of-two unit, 0 on overflow */
+static inline size_t dsc_vmem_round(size_t n, size_t unit) {
+    if (n > SIZE_MAX - (unit - 1)) return 0;
+    return (n + unit - 1) & ~(unit - 1);
 }
 
-void DSC_FUNC(hash_table_clear)(dsc_hash_table *ht, dsc_cleanupfunc *cf)
-{
-    if (ht == NULL) {
-        dsc_set_error(DSC_EINVAL);
-        return;
-    }
-    dsc_set_error(DSC_EOK);
+#if defined(_WIN32)
 
-    for (uint32_t i = 0; i < ht->capacity; i++) {
-        while (ht->kvpairs[i] != NULL) {
-            dsc_kvpair *tmp = ht->kvpairs[i];
-            ht->kvpairs[i]  = ht->kvpairs[i]->next;
+static size_t dsc_vmem_page_size(bool for_file) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return for_file ? (size_t)info.dwAllocationGranularity : (size_t)info.dwPageSize;
+}
 
-            free((void *)tmp->key);
-            tmp->key = NULL;
+/* Anonymous: reserve address space. File views are (re)created by commit instead. */
+static bool dsc_vmem_reserve(dsc_vmem *vm, size_t size) {
+    vm->reserved = size;
+    if (vm->file != -1) return true;
 
-            if (cf != NULL) cf(tmp->obj);
+    void *p = VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+    if (p == NULL) return false;
+    vm->map_base = p;
+    vm->map_size = size;
+    vm->base     = (unsigned char *)p;
+    return true;
+}
 
-            free(tmp); tmp = NULL;
+static bool dsc_vmem_commit(dsc_vmem *vm, size_t bytes) {
+    if (bytes <= vm->committed) return true;
+    if (bytes > vm->reserved) return false;
+
+    size_t need = dsc_vmem_round(bytes, vm->granularity);
+    if (need == 0 || need > vm->reserved) need = vm->reserved;
+
+    if (vm->file == -1) {
+        if (VirtualAlloc(vm->base + vm->committed, need - vm->committed, MEM_COMMIT, PAGE_READWRITE) == NULL) return false;
+    } else {
+        /* A larger mapping extends the file; the view may move but nothing is copied */
+        uint64_t size = (uint64_t)need;
+        HANDLE map = CreateFileMappingA((HANDLE)vm->file, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, NULL);
+        if (map == NULL) return false;
+        void *view = MapViewOfFile(map, FILE_MAP_ALL_ACCESS, 0, 0, need);
+        if (view == NULL) {
+            CloseHandle(map);
+            return false;
         }
+        if (vm->map_base != NULL) UnmapViewOfFile(vm->map_base);
+        if (vm->file_map != NULL) CloseHandle((HANDLE)vm->file_map);
+        vm->file_map = map;
+        vm->map_base = view;
+        vm->map_size = need;
+        vm->base     = (unsigned char *)view;
     }
-    ht->size = 0;
+    vm->committed = need;
+    return true;
 }
 
-dsc_list DSC_FUNC(hash_table_keys)(dsc_hash_table *ht) {
-    dsc_list result = {0};
-    
-    if (ht == NULL) {
-        dsc_set_error(DSC_EINVAL);
-        return result;
-    }
-    dsc_set_error(DSC_EOK);
+static bool dsc_vmem_open_file(dsc_vmem *vm, const char *path, size_t *file_size) {
+    HANDLE h = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h == INVALID_HANDLE_VALUE) return false;
 
-    size_t key_size = ht->key_size;
-    if (key_size == 0) {
-        key_size = sizeof(void*); /* For variable-length keys, store pointers */
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(h, &size)) {
+        CloseHandle(h);
+        return false;
     }
+    vm->file   = (intptr_t)h;
+    *file_size = (size_t)size.QuadPart;
+    return true;
+}
 
-    DSC_FUNC(list_init)(&result, key_size, ht->size);
-    if (DSC_FUNC(get_error)() != DSC_EOK) {
-        return result;
+static void dsc_vmem_flush(dsc_vmem *vm) {
+    if (vm->file == -1 || vm->base == NULL) return;
+    FlushViewOfFile(vm->base, vm->committed);
+    FlushFileBuffers((HANDLE)vm->file);
+}
+
+static void dsc_vmem_release(dsc_vmem *vm, size_t keep_bytes) {
+    if (vm->file == -1) {
+        if (vm->map_base != NULL) VirtualFree(vm->map_base, 0, MEM_RELEASE);
+        return;
+    }
+    if (vm->map_base != NULL) UnmapViewOfFile(vm->map_base);
+    if (vm->file_map != NULL) CloseHandle((HANDLE)vm->file_map);
+    if (keep_bytes != 0) {
+        LARGE_INTEGER end;
+        end.QuadPart = (LONGLONG)keep_bytes;
+        if (SetFilePointerEx((HANDLE)vm->file, end, NULL, FILE_BEGIN)) SetEndOfFile((HANDLE)vm->file);
     }
+    CloseHandle((HANDLE)vm->file);
+}
 
-    for (size_t i = 0; i < ht->capacity; i++) {
-        dsc_kvpair *kvp = ht->kvpairs[i];
-        while (kvp != NULL) {
-            if (ht->key_size == 0) {
-                /* Variable-length key: store pointer */
-                DSC_FUNC(list_append)(&result, &kvp->key);
-            } else {
-                /* Fixed-size key: store value */
-                DSC_FUNC(list_append)(&result, kvp->key);
-            }
-            kvp = kvp->next;
-        }
+#else /* POSIX */
+
+static size_t dsc_vmem_page_size(bool for_file) {
+    (void)for_file;
+    long page = sysconf(_SC_PAGESIZE);
+    return (page > 0) ? (size_t)page : 4096;
+}
+
+/* Reserve inaccessible address space; huge-page mode aligns it to 2 MiB */
+static bool dsc_vmem_reserve(dsc_vmem *vm, size_t size) {
+    size_t slack = (vm->granularity > dsc_vmem_page_size(false)) ? vm->granularity : 0;
+    if (size > SIZE_MAX - slack) return false;
+
+    void *p = mmap(NULL, size + slack, PROT_NONE, MAP_PRIVATE | DSC_MAP_ANON | DSC_MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED) return false;
+
+    vm->map_base = p;
+    vm->map_size = size + slack;
+    vm->base     = (unsigned char *)(((uintptr_t)p + vm->granularity - 1) & ~(uintptr_t)(vm->granularity - 1));
+    vm->reserved = size;
+
+#if defined(MADV_HUGEPAGE)
+    if ((vm->flags & DSC_VMEM_HUGE_PAGES) && vm->file == -1) {
+        madvise(vm->base, size, MADV_HUGEPAGE);
     }
-    return result;
+#endif
+    return true;
 }
 
-dsc_list DSC_FUNC(hash_table_values)(dsc_hash_table *ht) {
-    dsc_list result = {0};
-    
-    if (ht == NULL) {
-        dsc_set_error(DSC_EINVAL);
-        return result;
+static bool dsc_vmem_commit(dsc_vmem *vm, size_t bytes) {
+    if (bytes <= vm->committed) return true;
+    if (bytes > vm->reserved) return false;
+
+    size_t need = dsc_vmem_round(bytes, vm->granularity);
+    if (need == 0 || need > vm->reserved) need = vm->reserved;
+
+    unsigned char *at  = vm->base + vm->committed;
+    size_t         len = need - vm->committed;
+    if (vm->file == -1) {
+        if (mprotect(at, len, PROT_READ | PROT_WRITE) != 0) return false;
+    } else {
+        /* Extend the file and map the new tail over the reservation: no copy, no move */
+        if (ftruncate((int)vm->file, (off_t)need) != 0) return false;
+        if (mmap(at, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, (int)vm->file, (off_t)vm->committed) == MAP_FAILED) return false;
     }
-    dsc_set_error(DSC_EOK);
+    vm->committed = need;
+    return true;
+}
 
-    DSC_FUNC(list_init)(&result, sizeof(void*), ht->size);
-    if (DSC_FUNC(get_error)() != DSC_EOK) {
-        return result;
+static bool dsc_vmem_open_file(dsc_vmem *vm, const char *path, size_t *file_size) {
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
     }
+    vm->file   = fd;
+    *file_size = (size_t)st.st_size;
+    return true;
+}
+
+static void dsc_vmem_flush(dsc_vmem *vm) {
+    if (vm->file == -1 || vm->committed == 0) return;
+    msync(vm->base, vm->committed, MS_SYNC);
+}
 
-    for (size_t i = 0; i < ht->capacity; i++) {
-        dsc_kvpair *kvp = ht->kvpairs[i];
-        while (kvp != NULL) {
-            DSC_FUNC(list_append)(&result, &kvp->obj);
-            kvp = kvp->next;
+static void dsc_vmem_release(dsc_vmem *vm, size_t keep_bytes) {
+    if (vm->map_base != NULL) munmap(vm->map_base, vm->map_size);
+    if (vm->file != -1) {
+        if (keep_bytes != 0 && ftruncate((int)vm->file, (off_t)keep_bytes) != 0) {
+            /* Keeping the page-rounded size is harmless */
         }
+        close((int)vm->file);
     }
-    return result;
 }
 
-/*
- * +----------------------------------------------------------------+
- * |              LIST (DYNAMIC ARRAY) Implementation               |
- * +----------------------------------------------------------------+
- */
-void DSC_FUNC(list_init)(dsc_list* list, size_t item_size, size_t initial_capacity) {
-    dsc_set_error(DSC_EOK);
+#endif /* _WIN32 */
 
-    if (list == NULL || item_size == 0) {
-        dsc_set_error(DSC_EINVAL);
-        return;
-    }
+static void* dsc_vmem_alloc_cb(void *ctx, size_t size) {
+    dsc_vmem *vm = (dsc_vmem *)ctx;
 
-    if (initial_capacity == 0) initial_capacity = 256;
-    list->items = calloc(initial_capacity, item_size);
-    if (list->items == NULL) {
-        dsc_set_error(DSC_ENOMEM);
-        list->item_size = 0;
-        list->length    = 0;
-        list->capacity  = 0;
-        return;
-    }
-    list->item_size = item_size;
-    list->length    = 0;
-    list->capacity  = initial_capacity;
+    if (vm->in_use) return malloc(size);
+    if (size > SIZE_MAX - DSC_VMEM_HEADER || !dsc_vmem_commit(vm, DSC_VMEM_HEADER + size)) return NULL;
+    vm->in_use = true;
+    return DSC_VMEM_DATA(vm);
 }
 
-void DSC_FUNC(list_destroy)(dsc_list* list) {
-    if (list == NULL) {
-        dsc_set_error(DSC_EINVAL);
-        return;
-    }
-    dsc_set_error(DSC_EOK);
+static void* dsc_vmem_realloc_cb(void *ctx, void *ptr, size_t old_size, size_t new_size) {
+    dsc_vmem *vm = (dsc_vmem *)ctx;
+    (void)old_size;
 
-    free(list->items);
-    list->items = NULL;
-    list->length = 0;
-    list->capacity = 0;
+    if (ptr == NULL) return dsc_vmem_alloc_cb(ctx, new_size);
+    if (ptr != (void *)DSC_VMEM_DATA(vm)) return realloc(ptr, new_size);
+
+    /* Growing only commits more pages; the contents stay where they are */
+    if (new_size > SIZE_MAX - DSC_VMEM_HEADER || !dsc_vmem_commit(vm, DSC_VMEM_HEADER + new_size)) return NULL;
+    return DSC_VMEM_DATA(vm);
 }
 
-void DSC_FUNC(list_append)(dsc_list* list, void* item) {
-    dsc_set_error(DSC_EOK);
+static void dsc_vmem_free_cb(void *ctx, void *ptr, size_t size) {
+    dsc_vmem *vm = (dsc_vmem *)ctx;
+    (void)size;
 
-    if (list == NULL || item == NULL) {
-        dsc_set_error(DSC_EINVAL);
+    if (ptr == NULL) return;
+    if (ptr != (void *)DSC_VMEM_DATA(vm)) {
+        free(ptr);
         return;
     }
+    /* Pages stay committed (and file contents stay put) until vmem_destroy */
+    vm->in_use = false;
+}
 
-    if (list->length >= list->capacity) {
-        size_t new_capacity = list->capacity * 2;
-        void*  new_items    = realloc(list->items, new_capacity * list->item_size);
-        if (new_items == NULL) {
-            dsc_set_error(DSC_ENOMEM);
-            return;
-        }
-        list->items    = new_items;
-        list->capacity = new_capacity;
+static void dsc_vmem_setup(dsc_vmem *vm, unsigned flags, intptr_t file) {
+    *vm = (dsc_vmem) {
+        .allocator = {
+            .alloc   = dsc_vmem_alloc_cb,
+            .realloc = dsc_vmem_realloc_cb,
+            .free    = dsc_vmem_free_cb,
+            .ctx     = vm
+        },
+        .file  = file,
+        .flags = flags
+    };
+    vm->granularity = dsc_vmem_page_size(file != -1);
+    if ((flags & DSC_VMEM_HUGE_PAGES) && file == -1 && vm->granularity < DSC_VMEM_HUGE_SIZE) {
+        vm->granularity = DSC_VMEM_HUGE_SIZE;
     }
-    memcpy(
-        (char*)list->items + (list->length * list->item_size),
-        item,
-        list->item_size
-    );
-    list->length++;
 }
 
-void* DSC_FUNC(list_get)(dsc_list* list, size_t index) {
+void DSC_FUNC(vmem_init)(dsc_vmem *vm, size_t reserve, unsigned flags) {
     dsc_set_error(DSC_EOK);
 
-    if (list == NULL) {
+    if (vm == NULL) {
         dsc_set_error(DSC_EINVAL);
-        return NULL;
+        return;
     }
-    if (index >= list->length) {
-        dsc_set_error(DSC_ERANGE);
-        return NULL;
+    dsc_vmem_setup(vm, flags, -1);
+
+    if (reserve == 0) reserve = DSC_VMEM_DEFAULT_RESERVE;
+    reserve = dsc_vmem_round(reserve, vm->granularity);
+    if (reserve == 0 || !dsc_vmem_reserve(vm, reserve)) {
+        *vm = (dsc_vmem){0};
+        vm->file = -1;
+        dsc_set_error(DSC_ENOMEM);
     }
-    return (char*)list->items + (index * list->item_size);
 }
 
-void DSC_FUNC(list_pop)(dsc_list* list) {
+void DSC_FUNC(vmem_open)(dsc_vmem *vm, const char *path, size_t reserve, unsigned flags) {
     dsc_set_error(DSC_EOK);
 
-    if (list == NULL) {
+    if (vm == NULL || path == NULL) {
         dsc_set_error(DSC_EINVAL);
         return;
     }
-    if (list->length == 0) {
-        dsc_set_error(DSC_EEMPTY);
+    dsc_vmem_setup(vm, flags, -1);
+
+    size_t file_size = 0;
+    if (!dsc_vmem_open_file(vm, path, &file_size)) {
+        dsc_set_error(DSC_EIO);
         return;
     }
-    list->length--;
-}
+    vm->granularity = dsc_vmem_page_size(true);
 
-void DSC_FUNC(list_clear)(dsc_list* list) {
-    if (list == NULL) {
+    if (file_size != 0 && file_size < DSC_VMEM_HEADER) {
+        dsc_vmem_release(vm, 0);
+        *vm = (dsc_vmem){0};
+        vm->file = -1;
         dsc_set_error(DSC_EINVAL);
         return;
     }
-    dsc_set_error(DSC_EOK);
-    list->length = 0;
-}
 
-void DSC_FUNC(list_resize)(dsc_list* list, size_t new_size) {
-    dsc_set_error(DSC_EOK);
+    if (reserve == 0) reserve = DSC_VMEM_DEFAULT_RESERVE;
+    if (reserve < file_size) reserve = file_size;
+    reserve = dsc_vmem_round(reserve, vm->granularity);
 
-    if (list == NULL) {
-        dsc_set_error(DSC_EINVAL);
+    bool mapped = reserve != 0 && dsc_vmem_reserve(vm, reserve) &&
+                  dsc_vmem_commit(vm, (file_size != 0) ? file_size : DSC_VMEM_HEADER);
+    if (!mapped) {
+        dsc_vmem_release(vm, 0);
+        *vm = (dsc_vmem){0};
+        vm->file = -1;
+        dsc_set_error(DSC_ENOMEM);
         return;
     }
 
-    if (new_size > list->capacity) {
-        void* new_items = realloc(list->items, new_size * list->item_size);
-        if (new_items == NULL) {
-            dsc_set_error(DSC_ENOMEM);
-            return;
-        }
-        list->items    = new_items;
-        list->capacity = new_size;
+    dsc_vmem_header *hdr = DSC_VMEM_HDR(vm);
+    if (file_size == 0) {
+        memcpy(hdr->magic, DSC_VMEM_MAGIC, sizeof(hdr->magic));
+        hdr->elem_size = 0;
+        hdr->used      = 0;
+    } else if (memcmp(hdr->magic, DSC_VMEM_MAGIC, sizeof(hdr->magic)) != 0 ||
+               hdr->used > vm->committed - DSC_VMEM_HEADER) {
+        dsc_vmem_release(vm, 0);
+        *vm = (dsc_vmem){0};
+        vm->file = -1;
+        dsc_set_error(DSC_EINVAL);
     }
-    list->length = new_size;
 }
 
-void DSC_FUNC(list_map)(dsc_list* list, dsc_callback cf) {
-    if (list == NULL || cf == NULL) {
+void* DSC_FUNC(vmem_data)(dsc_vmem *vm) {
+    if (vm == NULL || vm->base == NULL) {
         dsc_set_error(DSC_EINVAL);
-        return;
+        return NULL;
     }
     dsc_set_error(DSC_EOK);
-
-    for (size_t i = 0; i < list->length; i++) {
-        void* item = (char*)list->items + (i * list->item_size);
-        cf(item);
-    }
+    return DSC_VMEM_DATA(vm);
 }
 
-void DSC_FUNC(list_foreach)(dsc_list* list, dsc_callback cf) {
-    if (list == NULL || cf == NULL) {
+void DSC_FUNC(vmem_sync)(dsc_vmem *vm) {
+    if (vm == NULL) {
         dsc_set_error(DSC_EINVAL);
         return;
     }
     dsc_set_error(DSC_EOK);
-
-    for (size_t i = 0; i < list->length; i++) {
-        void* item = (char*)list->items + (i * list->item_size);
-        cf(item);
-    }
+    dsc_vmem_flush(vm);
 }
 
-dsc_list DSC_FUNC(list_filter)(dsc_list* list, dsc_predicate cf) {
-    dsc_list result = {0};
-
-    if (list == NULL || cf == NULL) {
+/* File-backed: flushes, then trims the file to the header plus the last synced data */
+void DSC_FUNC(vmem_destroy)(dsc_vmem *vm) {
+    if (vm == NULL) {
         dsc_set_error(DSC_EINVAL);
-        return result;
+        return;
     }
     dsc_set_error(DSC_EOK);
 
-    DSC_FUNC(list_init)(&result, list->item_size, list->capacity);
-    if (DSC_FUNC(get_error)() != DSC_EOK) {
-        return result;
+    size_t keep = 0;
+    if (vm->file != -1 && vm->committed >= DSC_VMEM_HEADER) {
+        dsc_vmem_flush(vm);
+        keep = DSC_VMEM_HEADER + (size_t)DSC_VMEM_HDR(vm)->used;
     }
-
-    for (size_t i = 0; i < list->length; i++) {
-        void* item = (char*)list->items + (i * list->item_size);
-        if (cf(item)) {
-            DSC_FUNC(list_append)(&result, item);
-        }
+    if (vm->base != NULL || vm->file != -1) {
+        dsc_vmem_release(vm, keep);
     }
-    return result;
+    *vm = (dsc_vmem){0};
+    vm->file = -1;
 }
 
-void DSC_FUNC(list_from_array)(dsc_list* list, const void* array, size_t count, size_t item_size) {
-    dsc_set_error(DSC_EOK);
+#endif /* DSC_NO_VMEM */
 
-    if (list == NULL || array == NULL || item_size == 0) {
-        dsc_set_error(DSC_EINVAL);
+/*
+ * +----------------------------------------------------------------+
+ * |                 Hash Functions Implementation                  |
+ * +----------------------------------------------------------------+
+ */
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__clang__)
+    #include <intrin.h>
+    #pragma intrinsic(_umul128)
+#endif
+
+#define DSC_WY_S0 0xa0761d6478bd642fULL
+#define DSC_WY_S1 0xe7037ed1a0b428dbULL
+#define DSC_WY_S2 0x8ebc6af09c88c6e3ULL
+#define DSC_WY_S3 0x589965cc75374cc3ULL
+
+/* Full 64x64 -> 128 multiply; *a receives the low half, *b the high half */
+static inline void dsc_wy_mum(uint64_t *a, uint64_t *b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64) && !defined(__clang__)
+    *a = _umul128(*a, *b, b);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t  = rl + (rm0 << 32), c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t dsc_wy_mix(uint64_t a, uint64_t b) {
+    dsc_wy_mum(&a, &b);
+    return a ^ b;
+}
+
+/* Unaligned native-endian loads; memcpy compiles to a single move */
+static inline uint64_t dsc_wy_r8(const unsigned char *p) { uint64_t v; memcpy(&v, p, 8); return v; }
+static inline uint64_t dsc_wy_r4(const unsigned char *p) { uint32_t v; memcpy(&v, p, 4); return v; }
+
+uint64_t DSC_FUNC(hash_bytes)(const void *key, size_t len) {
+    const unsigned char *p    = (const unsigned char *)key;
+    uint64_t             seed = dsc_wy_mix(DSC_WY_S0, DSC_WY_S1);
+    uint64_t             a, b;
+
+    if (len <= 16) {
+        if (len >= 4) {
+            /* Two overlapping 4-byte pairs cover every length from 4 to 16 */
+            a = (dsc_wy_r4(p) << 32) | dsc_wy_r4(p + ((len >> 3) << 2));
+            b = (dsc_wy_r4(p + len - 4) << 32) | dsc_wy_r4(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            /* Three independent lanes keep several multipliers busy at once */
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = dsc_wy_mix(dsc_wy_r8(p)      ^ DSC_WY_S1, dsc_wy_r8(p + 8)  ^ seed);
+                see1 = dsc_wy_mix(dsc_wy_r8(p + 16) ^ DSC_WY_S2, dsc_wy_r8(p + 24) ^ see1);
+                see2 = dsc_wy_mix(dsc_wy_r8(p + 32) ^ DSC_WY_S3, dsc_wy_r8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = dsc_wy_mix(dsc_wy_r8(p) ^ DSC_WY_S1, dsc_wy_r8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = dsc_wy_r8(p + i - 16);
+        b = dsc_wy_r8(p + i - 8);
+    }
+
+    a ^= DSC_WY_S1;
+    b ^= seed;
+    dsc_wy_mum(&a, &b);
+    return dsc_wy_mix(a ^ DSC_WY_S0 ^ (uint64_t)len, b ^ DSC_WY_S1);
+}
+
+/* len is the key size the containers pass for strings (strlen + 1), or 0 */
+uint64_t DSC_FUNC(hash_str)(const void *key, size_t len) {
+    size_t n = (len != 0) ? len - 1 : strlen((const char *)key);
+    return DSC_FUNC(hash_bytes)(key, n);
+}
+
+int DSC_FUNC(cmp_str)(const void *key1, size_t len1, const void *key2, size_t len2) {
+    /*
+     * Equal known lengths: one memcmp instead of a byte-at-a-time strcmp.
+     * The terminator is not read, so either key may be an unterminated slice.
+     */
+    if (len1 != 0 && len1 == len2) return memcmp(key1, key2, len1 - 1);
+    return strcmp((const char *)key1, (const char *)key2);
+}
+
+uint64_t DSC_FUNC(hash_pod)(const void *key, size_t len) {
+    const unsigned char *p = (const unsigned char *)key;
+
+    switch (len) {
+        case 4:  return dsc_wy_mix(dsc_wy_r4(p) ^ DSC_WY_S0, DSC_WY_S1 ^ 4);
+        case 8:  return dsc_wy_mix(dsc_wy_r8(p) ^ DSC_WY_S0, DSC_WY_S1 ^ 8);
+        case 16: return dsc_wy_mix(dsc_wy_r8(p) ^ DSC_WY_S0, dsc_wy_r8(p + 8) ^ DSC_WY_S1);
+        default: return DSC_FUNC(hash_bytes)(key, len);
+    }
+}
+
+int DSC_FUNC(cmp_pod)(const void *key1, size_t len1, const void *key2, size_t len2) {
+    const unsigned char *p1 = (const unsigned char *)key1;
+    const unsigned char *p2 = (const unsigned char *)key2;
+
+    if (len1 != len2) return (len1 < len2) ? -1 : 1;
+    switch (len1) {
+        case 4:  return dsc_wy_r4(p1) != dsc_wy_r4(p2);
+        case 8:  return dsc_wy_r8(p1) != dsc_wy_r8(p2);
+        case 16: return (dsc_wy_r8(p1) != dsc_wy_r8(p2)) || (dsc_wy_r8(p1 + 8) != dsc_wy_r8(p2 + 8));
+        default: return memcmp(key1, key2, len1);
+    }
+}
+
+/* key points at the stored pointer, as with any fixed-size key */
+uint64_t DSC_FUNC(hash_ptr)(const void *key, size_t len) {
+    void *ptr;
+    (void)len;
+    memcpy(&ptr, key, sizeof(ptr));
+    return dsc_wy_mix((uint64_t)(uintptr_t)ptr ^ DSC_WY_S0, DSC_WY_S1);
+}
+
+int DSC_FUNC(cmp_ptr)(const void *key1, size_t len1, const void *key2, size_t len2) {
+    uintptr_t p1, p2;
+    (void)len1;
+    (void)len2;
+    memcpy(&p1, key1, sizeof(p1));
+    memcpy(&p2, key2, sizeof(p2));
+    return (p1 > p2) - (p1 < p2);
+}
+
+/*
+ * +----------------------------------------------------------------+
+ * |                   BLOOM FILTER Implementation                  |
+ * +----------------------------------------------------------------+
+ */
+#if defined(__GNUC__) || defined(__clang__)
+    #define DSC_PREFETCH(addr) __builtin_prefetch((addr))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <xmmintrin.h>
+    #define DSC_PREFETCH(addr) _mm_prefetch((const char *)(addr), _MM_HINT_T0)
+#else
+    #define DSC_PREFETCH(addr) ((void)(addr))
+#endif
+
+#define DSC_BLOOM_BLOCK_WORDS 8         /* 512 bits: one cache line */
+#define DSC_BLOOM_MAX_K       16
+
+/* log2(x) for x > 0 by repeated squaring, so sizing does not need libm */
+static double dsc_bloom_log2(double x) {
+    double result = 0.0;
+    while (x >= 2.0) { x /= 2.0; result += 1.0; }
+    while (x < 1.0)  { x *= 2.0; result -= 1.0; }
+
+    double bit = 0.5;
+    for (int i = 0; i < 32; i++, bit /= 2.0) {
+        x *= x;
+        if (x >= 2.0) { x /= 2.0; result += bit; }
+    }
+    return result;
+}
+
+/*
+ * Block index and the two probe seeds. The hash is remixed first so the
+ * block choice does not line up with dsc_ht_bucket's bits for the same key.
+ * Probe i is the top 9 bits of h1 + i*h2 in 64-bit arithmetic: taking high
+ * bits keeps every bit of both seeds in play, where masking the low 9 would
+ * leave only 2^17 distinct probe patterns per block.
+ */
+static inline void dsc_bloom_seeds(const dsc_bloom *bf, uint64_t hash, size_t *block, uint64_t *h1, uint64_t *h2) {
+    uint64_t h = (hash ^ (hash >> 33)) * 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    *block = (size_t)h & (bf->nblocks - 1);
+    *h1    = h * 0xc4ceb9fe1a85ec53ULL;
+    *h2    = ((h >> 29) ^ h) * 0x9e3779b97f4a7c15ULL;
+}
+
+static inline const uint64_t *dsc_bloom_block(const dsc_bloom *bf, size_t block) {
+    return bf->words + block * DSC_BLOOM_BLOCK_WORDS;
+}
+
+static inline bool dsc_bloom_test(const dsc_bloom *bf, uint64_t hash) {
+    size_t   block;
+    uint64_t h1, h2;
+    dsc_bloom_seeds(bf, hash, &block, &h1, &h2);
+
+    const uint64_t *w = dsc_bloom_block(bf, block);
+    for (unsigned i = 0; i < bf->k; i++, h1 += h2) {
+        unsigned bit = (unsigned)(h1 >> 55);
+        if ((w[bit >> 6] & (UINT64_C(1) << (bit & 63))) == 0) return false;
+    }
+    return true;
+}
+
+static inline void dsc_bloom_set(dsc_bloom *bf, uint64_t hash) {
+    size_t   block;
+    uint64_t h1, h2;
+    dsc_bloom_seeds(bf, hash, &block, &h1, &h2);
+
+    uint64_t *w = bf->words + block * DSC_BLOOM_BLOCK_WORDS;
+    for (unsigned i = 0; i < bf->k; i++, h1 += h2) {
+        unsigned bit = (unsigned)(h1 >> 55);
+        w[bit >> 6] |= UINT64_C(1) << (bit & 63);
+    }
+    bf->count++;
+}
+
+void DSC_FUNC(bloom_init)(dsc_bloom *bf, size_t expected_items, double fp_rate, size_t key_size, dsc_hashfunc *hf) {
+    DSC_FUNC(bloom_init_with_allocator)(bf, expected_items, fp_rate, key_size, hf, NULL);
+}
+
+/**
+ * @brief sizes a filter for expected_items keys at the given false-positive rate
+ * @param fp_rate target probability of a false "maybe", in (0, 1)
+ * @param hf hash for bloom_add/bloom_contains; may be NULL when only the
+ *  *_hash functions are used, as with an attached filter
+ */
+void DSC_FUNC(bloom_init_with_allocator)(dsc_bloom *bf, size_t expected_items, double fp_rate, size_t key_size, dsc_hashfunc *hf, const dsc_allocator *allocator) {
+    dsc_set_error(DSC_EOK);
+
+    if (bf == NULL || !(fp_rate > 0.0 && fp_rate < 1.0)) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    *bf = (dsc_bloom){ .key_size = key_size, .hf = hf, .allocator = allocator };
+
+    /*
+     * Optimal classic sizing is m/n = log2(1/p) / ln 2 bits per key with
+     * k = log2(1/p) probes. Confining a key to one block makes block loads
+     * uneven, which hurts more the more bits each key sets, so the blocked
+     * layout gets 5% more bits per probe to hold p.
+     */
+    double log2_inv = dsc_bloom_log2(1.0 / fp_rate);
+    double k        = log2_inv + 0.5;
+    bf->k = (k < 1.0) ? 1 : (k > DSC_BLOOM_MAX_K) ? DSC_BLOOM_MAX_K : (unsigned)k;
+
+    double bits_per_key = log2_inv * 1.4426950408889634 * (1.0 + 0.05 * bf->k);
+    double bits         = bits_per_key * (double)(expected_items != 0 ? expected_items : 1);
+
+    if (bits / 512.0 >= (double)(SIZE_MAX / 2 / (DSC_BLOOM_BLOCK_WORDS * sizeof(uint64_t)))) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    size_t nblocks = 1;
+    while ((double)nblocks * 512.0 < bits) nblocks <<= 1;
+
+    bf->words = (uint64_t *)dsc_mem_calloc(allocator, nblocks * DSC_BLOOM_BLOCK_WORDS, sizeof(uint64_t));
+    if (bf->words == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    bf->nblocks = nblocks;
+}
+
+void DSC_FUNC(bloom_destroy)(dsc_bloom *bf) {
+    if (bf == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (bf->words != NULL) dsc_mem_free(bf->allocator, bf->words, bf->nblocks * DSC_BLOOM_BLOCK_WORDS * sizeof(uint64_t));
+    bf->words   = NULL;
+    bf->nblocks = 0;
+    bf->count   = 0;
+}
+
+void DSC_FUNC(bloom_clear)(dsc_bloom *bf) {
+    if (bf == NULL || bf->words == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    memset(bf->words, 0, bf->nblocks * DSC_BLOOM_BLOCK_WORDS * sizeof(uint64_t));
+    bf->count = 0;
+}
+
+static inline size_t dsc_bloom_key_len(const dsc_bloom *bf, const void *key) {
+    return (bf->key_size != 0) ? bf->key_size : strlen((const char *)key) + 1;
+}
+
+void DSC_FUNC(bloom_add)(dsc_bloom *bf, const void *key) {
+    dsc_set_error(DSC_EOK);
+
+    if (bf == NULL || bf->words == NULL || key == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (bf->hf == NULL) {
+        dsc_set_error(DSC_EHASHFUNC);
+        return;
+    }
+    dsc_bloom_set(bf, bf->hf(key, dsc_bloom_key_len(bf, key)));
+}
+
+bool DSC_FUNC(bloom_contains)(const dsc_bloom *bf, const void *key) {
+    dsc_set_error(DSC_EOK);
+
+    if (bf == NULL || bf->words == NULL || key == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    if (bf->hf == NULL) {
+        dsc_set_error(DSC_EHASHFUNC);
+        return false;
+    }
+    return dsc_bloom_test(bf, bf->hf(key, dsc_bloom_key_len(bf, key)));
+}
+
+void DSC_FUNC(bloom_add_hash)(dsc_bloom *bf, uint64_t hash) {
+    dsc_set_error(DSC_EOK);
+
+    if (bf == NULL || bf->words == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_bloom_set(bf, hash);
+}
+
+bool DSC_FUNC(bloom_contains_hash)(const dsc_bloom *bf, uint64_t hash) {
+    dsc_set_error(DSC_EOK);
+
+    if (bf == NULL || bf->words == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    return dsc_bloom_test(bf, hash);
+}
+
+/* Estimated from the fraction of set bits: fill^k */
+double DSC_FUNC(bloom_fp_rate)(const dsc_bloom *bf) {
+    dsc_set_error(DSC_EOK);
+
+    if (bf == NULL || bf->words == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0.0;
+    }
+
+    size_t words = bf->nblocks * DSC_BLOOM_BLOCK_WORDS;
+    size_t ones  = 0;
+    for (size_t i = 0; i < words; i++) {
+        uint64_t w = bf->words[i];
+        for (; w != 0; w &= w - 1) ones++;
+    }
+
+    double fill = (double)ones / (double)(words * 64);
+    double rate = 1.0;
+    for (unsigned i = 0; i < bf->k; i++) rate *= fill;
+    return rate;
+}
+
+/* Keys hashed and prefetched together by bloom_contains_batch */
+#define DSC_BLOOM_BATCH 16
+
+size_t DSC_FUNC(bloom_contains_batch)(const dsc_bloom *bf, const void *keys, bool *out, size_t count) {
+    if (bf == NULL || bf->words == NULL || (count > 0 && keys == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    if (bf->hf == NULL) {
+        dsc_set_error(DSC_EHASHFUNC);
+        return 0;
+    }
+    dsc_set_error(DSC_EOK);
+
+    const void *bkey[DSC_BLOOM_BATCH];
+    uint64_t    bhash[DSC_BLOOM_BATCH];
+    size_t      maybe = 0;
+
+    for (size_t base = 0; base < count; base += DSC_BLOOM_BATCH) {
+        size_t n = (count - base < DSC_BLOOM_BATCH) ? count - base : DSC_BLOOM_BATCH;
+
+        for (size_t j = 0; j < n; j++) {
+            const void *key = (bf->key_size == 0) ? ((const void *const *)keys)[base + j]
+                                                  : (const void *)((const char *)keys + (base + j) * bf->key_size);
+            size_t   block;
+            uint64_t h1, h2;
+            bkey[j] = key;
+            if (key == NULL) continue;
+
+            bhash[j] = bf->hf(key, dsc_bloom_key_len(bf, key));
+            dsc_bloom_seeds(bf, bhash[j], &block, &h1, &h2);
+            DSC_PREFETCH(dsc_bloom_block(bf, block));
+        }
+
+        for (size_t j = 0; j < n; j++) {
+            bool hit = (bkey[j] != NULL) && dsc_bloom_test(bf, bhash[j]);
+            if (out != NULL) out[base + j] = hit;
+            maybe += hit;
+        }
+    }
+    return maybe;
+}
+
+/*
+ * +----------------------------------------------------------------+
+ * |                   HASHTABLE Implementation                     |
+ * +----------------------------------------------------------------+
+ */
+/* Buckets migrated per insert/get/delete while an incremental rehash runs */
+#define DSC_HT_REHASH_STEP 4
+
+/* Keys hashed and prefetched together by the batch API */
+#define DSC_HT_BATCH 16
+
+static inline size_t dsc_ht_key_size(const dsc_hash_table *ht, const void *key) {
+    /* Variable-length key - assume null-terminated string */
+    return (ht->key_size != 0) ? ht->key_size : strlen((const char*)key) + 1;
+}
+
+/* Stored key size for a caller-supplied length, or 0 when len does not fit the table */
+static inline size_t dsc_ht_len_size(const dsc_hash_table *ht, size_t len) {
+    if (ht->key_size != 0) return (len == ht->key_size) ? len : 0;
+    return (len < SIZE_MAX - sizeof(dsc_kvpair)) ? len + 1 : 0;
+}
+
+/*
+ * capacity is a power of two, so the bucket is a mask instead of a 64-bit
+ * division. The multiply and fold first push entropy from every hash bit
+ * into the low bits, so weak user hashes (identity, djb2) still spread.
+ */
+static inline size_t dsc_ht_bucket(uint64_t hash, size_t capacity) {
+    uint64_t h = hash * 0x9e3779b97f4a7c15ULL;
+    return (size_t)(h ^ (h >> 32)) & (capacity - 1);
+}
+
+/* Smallest power of two >= n, or 0 if that does not fit in size_t */
+static inline size_t dsc_ht_round_pow2(size_t n) {
+    size_t cap = 1;
+    while (cap < n) {
+        if (cap > SIZE_MAX / 2) return 0;
+        cap <<= 1;
+    }
+    return cap;
+}
+
+/*
+ * Move up to `steps` buckets from the old array into the new one. Empty
+ * buckets are cheap but still bounded, so a sparse old array cannot turn
+ * one step into a full scan.
+ */
+static void dsc_ht_migrate(dsc_hash_table *ht, size_t steps) {
+    if (steps > ht->old_capacity) steps = ht->old_capacity;
+    size_t empty_visits = steps * 10;
+
+    while (steps > 0 && ht->old_kvpairs != NULL) {
+        if (ht->rehash_index >= ht->old_capacity) {
+            DSC_STAT(dsc_stats_free(&ht->alloc_stats, ht->old_capacity * sizeof(dsc_kvpair *)));
+            dsc_mem_free(ht->allocator, ht->old_kvpairs, ht->old_capacity * sizeof(dsc_kvpair *));
+            ht->old_kvpairs  = NULL;
+            ht->old_capacity = 0;
+            ht->rehash_index = 0;
+            return;
+        }
+
+        dsc_kvpair *tmp = ht->old_kvpairs[ht->rehash_index];
+        if (tmp == NULL) {
+            ht->rehash_index++;
+            if (--empty_visits == 0) return;
+            continue;
+        }
+
+        // Redistribute by the cached hash, hf is never called again
+        while (tmp != NULL) {
+            dsc_kvpair *next = tmp->next;
+
+            size_t new_index = dsc_ht_bucket(tmp->hash, ht->capacity);
+            assert(new_index < ht->capacity); // Ensure the index is within bounds
+
+            tmp->next = ht->kvpairs[new_index];
+            ht->kvpairs[new_index] = tmp;
+
+            tmp = next;
+        }
+        ht->old_kvpairs[ht->rehash_index++] = NULL;
+        steps--;
+    }
+
+    if (ht->old_kvpairs != NULL && ht->rehash_index >= ht->old_capacity) {
+        DSC_STAT(dsc_stats_free(&ht->alloc_stats, ht->old_capacity * sizeof(dsc_kvpair *)));
+        dsc_mem_free(ht->allocator, ht->old_kvpairs, ht->old_capacity * sizeof(dsc_kvpair *));
+        ht->old_kvpairs  = NULL;
+        ht->old_capacity = 0;
+        ht->rehash_index = 0;
+    }
+}
+
+static inline void dsc_ht_rehash_step(dsc_hash_table *ht, size_t steps) {
+#ifdef DSC_STATS
+    uint64_t start = dsc_stats_now_ns();
+    dsc_ht_migrate(ht, steps);
+    ht->rehash_ns += dsc_stats_now_ns() - start;
+#else
+    dsc_ht_migrate(ht, steps);
+#endif
+}
+
+static inline void dsc_ht_rehash_finish(dsc_hash_table *ht) {
+    if (ht->old_kvpairs != NULL) dsc_ht_rehash_step(ht, ht->old_capacity);
+}
+
+/*
+ * Swap in a bucket array of new_capacity buckets (a power of two, larger or
+ * smaller) and migrate into it: all at once, or step by step when incremental.
+ */
+static bool dsc_ht_resize(dsc_hash_table *ht, size_t new_capacity) {
+    /* A second resize cannot start until the previous one has drained */
+    dsc_ht_rehash_finish(ht);
+
+    dsc_kvpair **new_kvpairs = (dsc_kvpair **)dsc_mem_calloc(ht->allocator, new_capacity, sizeof(dsc_kvpair *));
+    if (new_kvpairs == NULL) {
+        return false;
+    }
+    DSC_STAT(dsc_stats_resize(&ht->alloc_stats, 0, new_capacity * sizeof(dsc_kvpair *)));
+    DSC_STAT(ht->resizes++);
+
+    ht->old_kvpairs  = ht->kvpairs;
+    ht->old_capacity = ht->capacity;
+    ht->rehash_index = 0;
+    ht->kvpairs      = new_kvpairs;
+    ht->capacity     = new_capacity;
+
+    if (!ht->incremental) dsc_ht_rehash_finish(ht);
+    return true;
+}
+
+/* Double the bucket array */
+static inline bool dsc_ht_grow(dsc_hash_table *ht) {
+    if (ht->capacity > SIZE_MAX / 2 / sizeof(dsc_kvpair *)) return false;
+    return dsc_ht_resize(ht, ht->capacity * 2);
+}
+
+/* Fewest buckets (a power of two) that hold count entries under the 0.75 load factor, or 0 */
+static inline size_t dsc_ht_fit_capacity(size_t count) {
+    if (count > SIZE_MAX / 2) return 0;
+    return dsc_ht_round_pow2(count + (count + 2) / 3);
+}
+
+/*
+ * Shrink once the load factor drops under the low watermark. The new array
+ * is at most half full, well clear of the 0.75 grow trigger, so a table
+ * hovering near either threshold does not flip back and forth. A running
+ * migration is left to drain first, and a failed allocation keeps the
+ * current array: the caller's delete has already succeeded either way.
+ */
+static void dsc_ht_maybe_shrink(dsc_hash_table *ht) {
+    if (ht->shrink_percent == 0 || ht->old_kvpairs != NULL || ht->capacity <= ht->min_capacity) return;
+    if ((float)ht->size / ht->capacity * 100 >= ht->shrink_percent) return;
+
+    size_t target = dsc_ht_round_pow2(ht->size * 2);
+    if (target < ht->min_capacity) target = ht->min_capacity;
+    if (target < ht->capacity) dsc_ht_resize(ht, target);
+}
+
+/* Grow once the 0.75 load factor is crossed */
+static inline bool dsc_ht_maybe_grow(dsc_hash_table *ht) {
+    if ((float)ht->size / ht->capacity <= 0.75) return true;
+    return dsc_ht_grow(ht);
+}
+
+/* Grow until `incoming` more entries fit under the load factor */
+static bool dsc_ht_reserve(dsc_hash_table *ht, size_t incoming) {
+    while ((float)(ht->size + incoming) / ht->capacity > 0.75) {
+        if (!dsc_ht_grow(ht)) return false;
+    }
+    return true;
+}
+
+/*
+ * Find the link (bucket head or a node's next field) that points at the
+ * node holding key, looking in the old array too while a rehash is running.
+ * Returns NULL when the key is absent.
+ */
+static dsc_kvpair **dsc_ht_find_link(dsc_hash_table *ht, const void *key, size_t key_size, uint64_t hash) {
+    /* A filter "no" is exact: skip the bucket array entirely */
+    if (ht->filter != NULL && !dsc_bloom_test(ht->filter, hash)) return NULL;
+
+    dsc_kvpair **link = &ht->kvpairs[dsc_ht_bucket(hash, ht->capacity)];
+
+    for (int pass = 0; pass < 2; pass++) {
+        /* Compare cached hashes and lengths first; cf only runs when both match */
+        while (*link != NULL) {
+            dsc_kvpair *tmp = *link;
+            if (tmp->hash == hash && tmp->key_size == key_size && ht->cf(tmp->key, tmp->key_size, key, key_size) == 0) {
+                return link;
+            }
+            link = &tmp->next;
+        }
+
+        if (ht->old_kvpairs == NULL) break;
+        link = &ht->old_kvpairs[dsc_ht_bucket(hash, ht->old_capacity)];
+    }
+    return NULL;
+}
+
+/* Walk every node in both bucket arrays; bucket is a cursor over the pair */
+static dsc_kvpair *dsc_ht_next_node(const dsc_hash_table *ht, size_t *bucket, const dsc_kvpair *node) {
+    if (node != NULL && node->next != NULL) return node->next;
+
+    size_t total = ht->capacity + ((ht->old_kvpairs != NULL) ? ht->old_capacity : 0);
+    for (size_t b = (node == NULL) ? *bucket : *bucket + 1; b < total; b++) {
+        dsc_kvpair *head = (b < ht->capacity) ? ht->kvpairs[b] : ht->old_kvpairs[b - ht->capacity];
+        if (head != NULL) {
+            *bucket = b;
+            return head;
+        }
+    }
+    *bucket = total;
+    return NULL;
+}
+
+/* Nodes and their key bytes share one allocation: [ dsc_kvpair | key ] */
+static inline size_t dsc_ht_node_size(size_t key_size) {
+    return sizeof(dsc_kvpair) + key_size;
+}
+
+/* Allocate a node for a key known to be absent and link it into the new array */
+static dsc_kvpair *dsc_ht_link_new(dsc_hash_table *ht, const void *key, size_t key_size, uint64_t hash, void *obj) {
+    /* One allocation holds the node and its key copy */
+    dsc_kvpair *kvp = (dsc_kvpair *)dsc_mem_alloc(ht->allocator, dsc_ht_node_size(key_size));
+    if (kvp == NULL) return NULL;
+    DSC_STAT(dsc_stats_resize(&ht->alloc_stats, 0, dsc_ht_node_size(key_size)));
+
+    *kvp = (dsc_kvpair) {
+        .key      = (void *)(kvp + 1),
+        .obj      = obj,
+        .key_size = key_size,
+        .hash     = hash
+    };
+
+    /* String keys may come from an unterminated slice (insert_len) */
+    if (ht->key_size == 0) {
+        memcpy(kvp->key, key, key_size - 1);
+        ((char *)kvp->key)[key_size - 1] = '\0';
+    } else {
+        memcpy(kvp->key, key, key_size);
+    }
+
+    /* New entries always go into the new array */
+    size_t index = dsc_ht_bucket(hash, ht->capacity);
+    kvp->next = ht->kvpairs[index];
+    ht->kvpairs[index] = kvp;
+    ht->size++;
+
+    if (ht->filter != NULL) dsc_bloom_set(ht->filter, hash);
+
+    return kvp;
+}
+
+/* Remove the node *link points at and return its object */
+static void *dsc_ht_unlink(dsc_hash_table *ht, dsc_kvpair **link) {
+    dsc_kvpair *tmp = *link;
+    *link = tmp->next;
+
+    void *result = tmp->obj;
+    DSC_STAT(dsc_stats_free(&ht->alloc_stats, dsc_ht_node_size(tmp->key_size)));
+    dsc_mem_free(ht->allocator, tmp, dsc_ht_node_size(tmp->key_size)); tmp = NULL;
+
+    ht->size--;
+    return result;
+}
+
+static void dsc_ht_free_chains(dsc_hash_table *ht, dsc_kvpair **kvpairs, size_t capacity, dsc_cleanupfunc *cf) {
+    /* Bulk-release allocators with no cleanup: nothing to visit per node */
+    if (cf == NULL && !dsc_mem_needs_free(ht->allocator)) {
+        memset(kvpairs, 0, capacity * sizeof(dsc_kvpair *));
+        return;
+    }
+
+    for (size_t i = 0; i < capacity; i++) {
+        while (kvpairs[i] != NULL) {
+            dsc_kvpair *tmp = kvpairs[i];
+            kvpairs[i]      = kvpairs[i]->next;
+
+            if (cf != NULL) cf(tmp->obj);
+
+            DSC_STAT(dsc_stats_free(&ht->alloc_stats, dsc_ht_node_size(tmp->key_size)));
+            dsc_mem_free(ht->allocator, tmp, dsc_ht_node_size(tmp->key_size)); tmp = NULL;
+        }
+    }
+}
+
+void DSC_FUNC(hash_table_init)(dsc_hash_table *ht, size_t capacity, size_t key_size, dsc_hashfunc *hf, dsc_cmpfunc *cf)
+{
+    DSC_FUNC(hash_table_init_with_allocator)(ht, capacity, key_size, hf, cf, NULL);
+}
+
+void DSC_FUNC(hash_table_init_with_allocator)(dsc_hash_table *ht, size_t capacity, size_t key_size, dsc_hashfunc *hf, dsc_cmpfunc *cf, const dsc_allocator *allocator)
+{
+    dsc_set_error(DSC_EOK);
+
+    if (ht == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    if (hf == NULL) {
+        dsc_set_error(DSC_EHASHFUNC);
+        return;
+    }
+
+    /* key_size can be 0 for variable-length keys (e.g., strings) */
+
+    if (cf == NULL) {
+        dsc_set_error(DSC_ECMPFUNC);
+        return;
+    }
+
+    if (capacity == 0) capacity = 1;
+
+    capacity = dsc_ht_round_pow2(capacity);
+    if (capacity == 0) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+
+    *ht = (dsc_hash_table) {
+        .size     = 0,
+        .capacity = capacity,
+        .min_capacity = capacity,
+        .key_size = key_size,
+        .hf       = hf,
+        .cf        = cf,
+        .allocator = allocator,
+        .kvpairs   = (dsc_kvpair **)dsc_mem_calloc(allocator, capacity, sizeof(dsc_kvpair *))
+    };
+    if (ht->kvpairs == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        ht->capacity = 0;
+        ht->size = 0;
+        ht->kvpairs = NULL;
+        return;
+    }
+    DSC_STAT(dsc_stats_resize(&ht->alloc_stats, 0, capacity * sizeof(dsc_kvpair *)));
+}
+
+void DSC_FUNC(hash_table_set_incremental)(dsc_hash_table *ht, bool enabled)
+{
+    if (ht == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    ht->incremental = enabled;
+    if (!enabled) dsc_ht_rehash_finish(ht);
+}
+
+void DSC_FUNC(hash_table_set_shrink)(dsc_hash_table *ht, size_t low_percent)
+{
+    if (ht == NULL || low_percent > 50) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    ht->shrink_percent = low_percent;
+}
+
+bool DSC_FUNC(hash_table_reserve)(dsc_hash_table *ht, size_t count)
+{
+    if (ht == NULL || ht->kvpairs == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    dsc_set_error(DSC_EOK);
+
+    size_t target = dsc_ht_fit_capacity(count);
+    if (target == 0) {
+        dsc_set_error(DSC_ENOMEM);
+        return false;
+    }
+    if (target > ht->capacity && !dsc_ht_resize(ht, target)) {
+        dsc_set_error(DSC_ENOMEM);
+        return false;
+    }
+    if (ht->min_capacity < target) ht->min_capacity = target;
+    return true;
+}
+
+bool DSC_FUNC(hash_table_compact)(dsc_hash_table *ht)
+{
+    if (ht == NULL || ht->kvpairs == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    dsc_set_error(DSC_EOK);
+
+    dsc_ht_rehash_finish(ht);
+
+    /* size < SIZE_MAX / 2 always: every entry is a separate allocation */
+    size_t target = dsc_ht_fit_capacity(ht->size);
+    if (target < ht->capacity) {
+        if (!dsc_ht_resize(ht, target)) {
+            dsc_set_error(DSC_ENOMEM);
+            return false;
+        }
+        dsc_ht_rehash_finish(ht);
+    }
+    ht->min_capacity = ht->capacity;
+    return true;
+}
+
+bool DSC_FUNC(hash_table_rehash_step)(dsc_hash_table *ht, size_t buckets)
+{
+    if (ht == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    dsc_set_error(DSC_EOK);
+
+    dsc_ht_rehash_step(ht, buckets);
+    return ht->old_kvpairs != NULL;
+}
+
+/* insert once the arguments are checked and the key's stored size is known */
+static bool dsc_ht_insert_sized(dsc_hash_table *ht, const void *key, size_t actual_key_size, void *obj)
+{
+    if (ht->old_kvpairs != NULL) dsc_ht_rehash_step(ht, DSC_HT_REHASH_STEP);
+
+    if (!dsc_ht_maybe_grow(ht)) {
+        dsc_set_error(DSC_ENOMEM);
+        return false;
+    }
+
+    uint64_t hash = ht->hf(key, actual_key_size);
+
+    /* One hash, one chain walk: the duplicate check and the link share it */
+    if (dsc_ht_find_link(ht, key, actual_key_size, hash) != NULL) {
+        dsc_set_error(DSC_EEXISTS);
+        return false;
+    }
+
+    if (dsc_ht_link_new(ht, key, actual_key_size, hash, obj) == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return false;
+    }
+
+    return true;
+}
+
+bool DSC_FUNC(hash_table_insert)(dsc_hash_table *ht, const void *key, void *obj)
+{
+    dsc_set_error(DSC_EOK);
+
+    if ((ht == NULL) || (key == NULL) || (obj == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+
+    /* Calculate actual key size (for variable-length keys like strings) */
+    return dsc_ht_insert_sized(ht, key, dsc_ht_key_size(ht, key), obj);
+}
+
+bool DSC_FUNC(hash_table_insert_len)(dsc_hash_table *ht, const void *key, size_t len, void *obj)
+{
+    dsc_set_error(DSC_EOK);
+
+    size_t key_size = (ht != NULL) ? dsc_ht_len_size(ht, len) : 0;
+    if ((key_size == 0) || (key == NULL) || (obj == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+
+    return dsc_ht_insert_sized(ht, key, key_size, obj);
+}
+
+/**
+ * @brief finds key, inserting it with obj when it is absent, in a single probe
+ * @param obj object stored for a new entry (must not be NULL); ignored if the key exists
+ * @param inserted optional, set to true when a new entry was created
+ * @return pointer to the entry's object slot, valid until the entry is deleted.
+ *  Assign through it to replace the object in place (never store NULL).
+ *  Returns NULL on error.
+ */
+void **DSC_FUNC(hash_table_upsert)(dsc_hash_table *ht, const void *key, void *obj, bool *inserted)
+{
+    dsc_set_error(DSC_EOK);
+    if (inserted != NULL) *inserted = false;
+
+    if ((ht == NULL) || (key == NULL) || (obj == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+
+    if (ht->old_kvpairs != NULL) dsc_ht_rehash_step(ht, DSC_HT_REHASH_STEP);
+
+    size_t   key_size = dsc_ht_key_size(ht, key);
+    uint64_t hash     = ht->hf(key, key_size);
+
+    dsc_kvpair **link = dsc_ht_find_link(ht, key, key_size, hash);
+    if (link != NULL) return &(*link)->obj;
+
+    /* Only a real insert can push the table over its load factor */
+    if (!dsc_ht_maybe_grow(ht)) {
+        dsc_set_error(DSC_ENOMEM);
+        return NULL;
+    }
+
+    dsc_kvpair *kvp = dsc_ht_link_new(ht, key, key_size, hash, obj);
+    if (kvp == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return NULL;
+    }
+
+    if (inserted != NULL) *inserted = true;
+    return &kvp->obj;
+}
+
+/**
+ * @brief deallocates the hash table
+ * @param ht the hash table pointer
+ * @param cf function pointer to a custom cleanup function for deallocating dynamically allocated objects defined by user.
+ *  it should be NULL if the objects is statically allocated or the user want to handel the deallocation by himself.
+ */
+void DSC_FUNC(hash_table_destroy)(dsc_hash_table *ht, dsc_cleanupfunc *cf)
+{
+    if (ht == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (ht->kvpairs != NULL) dsc_ht_free_chains(ht, ht->kvpairs, ht->capacity, cf);
+    if (ht->old_kvpairs != NULL) dsc_ht_free_chains(ht, ht->old_kvpairs, ht->old_capacity, cf);
+
+    if (ht->kvpairs != NULL) DSC_STAT(dsc_stats_free(&ht->alloc_stats, ht->capacity * sizeof(dsc_kvpair *)));
+    if (ht->old_kvpairs != NULL) DSC_STAT(dsc_stats_free(&ht->alloc_stats, ht->old_capacity * sizeof(dsc_kvpair *)));
+    dsc_mem_free(ht->allocator, ht->kvpairs, ht->capacity * sizeof(dsc_kvpair *)); ht->kvpairs = NULL;
+    dsc_mem_free(ht->allocator, ht->old_kvpairs, ht->old_capacity * sizeof(dsc_kvpair *)); ht->old_kvpairs = NULL;
+    ht->old_capacity = 0;
+    ht->rehash_index = 0;
+    ht->filter       = NULL;
+}
+
+static void *dsc_ht_delete_sized(dsc_hash_table *ht, const void *key, size_t key_size)
+{
+    if (ht->old_kvpairs != NULL) dsc_ht_rehash_step(ht, DSC_HT_REHASH_STEP);
+
+    dsc_kvpair **link = dsc_ht_find_link(ht, key, key_size, ht->hf(key, key_size));
+    if (link == NULL) {
+        dsc_set_error(DSC_ENOTFOUND);
+        return NULL;
+    }
+
+    void *result = dsc_ht_unlink(ht, link);
+    dsc_ht_maybe_shrink(ht);
+    return result;
+}
+
+void *DSC_FUNC(hash_table_delete)(dsc_hash_table *ht, const void *key)
+{
+    dsc_set_error(DSC_EOK);
+
+    if ((ht == NULL) || (key == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+
+    /* Calculate key size for variable-length keys */
+    return dsc_ht_delete_sized(ht, key, dsc_ht_key_size(ht, key));
+}
+
+void *DSC_FUNC(hash_table_delete_len)(dsc_hash_table *ht, const void *key, size_t len)
+{
+    dsc_set_error(DSC_EOK);
+
+    size_t key_size = (ht != NULL) ? dsc_ht_len_size(ht, len) : 0;
+    if ((key_size == 0) || (key == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+
+    return dsc_ht_delete_sized(ht, key, key_size);
+}
+
+static void *dsc_ht_get_sized(dsc_hash_table *ht, const void *key, size_t key_size)
+{
+    if (ht->old_kvpairs != NULL) dsc_ht_rehash_step(ht, DSC_HT_REHASH_STEP);
+
+    dsc_kvpair **link = dsc_ht_find_link(ht, key, key_size, ht->hf(key, key_size));
+    if (link == NULL) {
+        dsc_set_error(DSC_ENOTFOUND);
+        return NULL;
+    }
+
+    return (*link)->obj;
+}
+
+void *DSC_FUNC(hash_table_get)(dsc_hash_table *ht, const void *key)
+{
+    dsc_set_error(DSC_EOK);
+
+    if ((ht == NULL) || (key == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+    if (ht->hf == NULL) {
+        dsc_set_error(DSC_EHASHFUNC);
+        return NULL;
+    }
+
+    /* Calculate key size for variable-length keys */
+    return dsc_ht_get_sized(ht, key, dsc_ht_key_size(ht, key));
+}
+
+void *DSC_FUNC(hash_table_get_len)(dsc_hash_table *ht, const void *key, size_t len)
+{
+    dsc_set_error(DSC_EOK);
+
+    size_t key_size = (ht != NULL) ? dsc_ht_len_size(ht, len) : 0;
+    if ((key_size == 0) || (key == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+    if (ht->hf == NULL) {
+        dsc_set_error(DSC_EHASHFUNC);
+        return NULL;
+    }
+
+    return dsc_ht_get_sized(ht, key, key_size);
+}
+
+void *DSC_FUNC(hash_table_get_unchecked)(dsc_hash_table *ht, const void *key)
+{
+    if (ht->old_kvpairs != NULL) dsc_ht_rehash_step(ht, DSC_HT_REHASH_STEP);
+
+    size_t       key_size = dsc_ht_key_size(ht, key);
+    dsc_kvpair **link     = dsc_ht_find_link(ht, key, key_size, ht->hf(key, key_size));
+    return (link != NULL) ? (*link)->obj : NULL;
+}
+
+void DSC_FUNC(hash_table_clear)(dsc_hash_table *ht, dsc_cleanupfunc *cf)
+{
+    if (ht == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (ht->kvpairs != NULL) dsc_ht_free_chains(ht, ht->kvpairs, ht->capacity, cf);
+    if (ht->old_kvpairs != NULL) {
+        dsc_ht_free_chains(ht, ht->old_kvpairs, ht->old_capacity, cf);
+        DSC_STAT(dsc_stats_free(&ht->alloc_stats, ht->old_capacity * sizeof(dsc_kvpair *)));
+        dsc_mem_free(ht->allocator, ht->old_kvpairs, ht->old_capacity * sizeof(dsc_kvpair *));
+        ht->old_kvpairs  = NULL;
+        ht->old_capacity = 0;
+        ht->rehash_index = 0;
+    }
+    ht->size = 0;
+    dsc_ht_maybe_shrink(ht);
+
+    if (ht->filter != NULL) DSC_FUNC(bloom_clear)(ht->filter);
+}
+
+void DSC_FUNC(hash_table_attach_filter)(dsc_hash_table *ht, dsc_bloom *filter)
+{
+    if ((ht == NULL) || (filter != NULL && filter->words == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    ht->filter = filter;
+    if (filter == NULL) return;
+
+    /* Both bucket arrays while a rehash is in flight */
+    size_t bucket = 0;
+    for (dsc_kvpair *kvp = dsc_ht_next_node(ht, &bucket, NULL); kvp != NULL; kvp = dsc_ht_next_node(ht, &bucket, kvp)) {
+        dsc_bloom_set(filter, kvp->hash);
+    }
+}
+
+dsc_table_stats DSC_FUNC(hash_table_stats)(dsc_hash_table *ht)
+{
+    dsc_table_stats stats = {0};
+
+    if (ht == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return stats;
+    }
+    dsc_set_error(DSC_EOK);
+
+    stats.size        = ht->size;
+    stats.capacity    = ht->capacity;
+    stats.load_factor = (ht->capacity != 0) ? (double)ht->size / (double)ht->capacity : 0.0;
+
+    /* The i-th node of a chain takes i compares to find */
+    uint64_t probes = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        dsc_kvpair **kvpairs  = (pass == 0) ? ht->kvpairs : ht->old_kvpairs;
+        size_t       capacity = (pass == 0) ? ht->capacity : ht->old_capacity;
+        if (kvpairs == NULL) continue;
+
+        stats.bucket_bytes += capacity * sizeof(dsc_kvpair *);
+        for (size_t b = 0; b < capacity; b++) {
+            size_t chain = 0;
+            for (const dsc_kvpair *kvp = kvpairs[b]; kvp != NULL; kvp = kvp->next) {
+                chain++;
+                stats.key_bytes += kvp->key_size;
+            }
+            probes += (uint64_t)chain * (chain + 1) / 2;
+            if (chain > stats.max_probe) stats.max_probe = chain;
+            stats.histogram[(chain < DSC_STATS_HISTOGRAM) ? chain : DSC_STATS_HISTOGRAM - 1]++;
+        }
+    }
+    stats.node_bytes = ht->size * sizeof(dsc_kvpair);
+    stats.mean_probe = (ht->size != 0) ? (double)probes / (double)ht->size : 0.0;
+
+#ifdef DSC_STATS
+    stats.resizes   = ht->resizes;
+    stats.rehash_ns = ht->rehash_ns;
+    stats.alloc     = ht->alloc_stats;
+#endif
+    return stats;
+}
+
+/* Head link of bucket b, counting the old array after the new one */
+static inline dsc_kvpair **dsc_ht_bucket_link(const dsc_hash_table *ht, size_t b) {
+    return (b < ht->capacity) ? &ht->kvpairs[b] : &ht->old_kvpairs[b - ht->capacity];
+}
+
+void DSC_FUNC(hash_table_iter_begin)(dsc_hash_table *ht, dsc_hash_table_iter *it)
+{
+    if (it == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    *it = (dsc_hash_table_iter){0};
+
+    if (ht == NULL || ht->kvpairs == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    it->ht = ht;
+}
+
+bool DSC_FUNC(hash_table_iter_next)(dsc_hash_table_iter *it)
+{
+    if (it == NULL || it->ht == NULL) return false;
+
+    const dsc_hash_table *ht = it->ht;
+    size_t total = ht->capacity + ((ht->old_kvpairs != NULL) ? ht->old_capacity : 0);
+
+    /* After a delete, *link already holds the successor */
+    if (it->link == NULL) {
+        if (it->bucket >= total) return false;
+        it->link = dsc_ht_bucket_link(ht, it->bucket);
+    } else if (it->kvp != NULL) {
+        it->link = &it->kvp->next;
+    }
+
+    while (*it->link == NULL) {
+        if (++it->bucket >= total) {
+            it->kvp = NULL;
+            return false;
+        }
+        it->link = dsc_ht_bucket_link(ht, it->bucket);
+    }
+
+    it->kvp = *it->link;
+    return true;
+}
+
+void *DSC_FUNC(hash_table_iter_delete)(dsc_hash_table_iter *it)
+{
+    if (it == NULL || it->kvp == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+    dsc_set_error(DSC_EOK);
+
+    it->kvp = NULL;
+    return dsc_ht_unlink(it->ht, it->link);
+}
+
+/* Reverse the bits of v (the cursor is incremented from the high bit down) */
+static inline size_t dsc_ht_rev(size_t v) {
+    size_t s    = sizeof(v) * 8;
+    size_t mask = ~(size_t)0;
+    while ((s >>= 1) > 0) {
+        mask ^= (mask << s);
+        v = ((v >> s) & mask) | ((v << s) & ~mask);
+    }
+    return v;
+}
+
+/* Next cursor for a table of mask + 1 buckets */
+static inline size_t dsc_ht_scan_advance(size_t v, size_t mask) {
+    v |= ~mask;
+    return dsc_ht_rev(dsc_ht_rev(v) + 1);
+}
+
+/* Upper bound on buckets one scan call may visit, so sparse tables stay bounded */
+static inline size_t dsc_ht_scan_budget(size_t count) {
+    if (count == 0) count = 1;
+    return (count > SIZE_MAX / 10) ? SIZE_MAX : count * 10;
+}
+
+static size_t dsc_ht_scan_bucket(const dsc_kvpair *kvp, dsc_scanfunc *fn, void *ctx) {
+    size_t n = 0;
+    for (; kvp != NULL; kvp = kvp->next, n++) fn(kvp->key, kvp->key_size, kvp->obj, kvp->hash, ctx);
+    return n;
+}
+
+size_t DSC_FUNC(hash_table_scan)(dsc_hash_table *ht, size_t cursor, size_t count, dsc_scanfunc *fn, void *ctx)
+{
+    if (ht == NULL || ht->kvpairs == NULL || fn == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    dsc_set_error(DSC_EOK);
+
+    size_t reported = 0;
+    size_t budget   = dsc_ht_scan_budget(count);
+    size_t v        = cursor;
+
+    do {
+        if (ht->old_kvpairs == NULL) {
+            size_t m0 = ht->capacity - 1;
+            reported += dsc_ht_scan_bucket(ht->kvpairs[v & m0], fn, ctx);
+            v = dsc_ht_scan_advance(v, m0);
+        } else {
+            /* Mid-rehash: the small array's bucket, then every bucket of the
+               large array it expands into (bucket indexes share their low bits) */
+            dsc_kvpair **small = ht->old_kvpairs, **large = ht->kvpairs;
+            size_t m0 = ht->old_capacity - 1, m1 = ht->capacity - 1;
+            if (m0 > m1) {
+                small = ht->kvpairs; large = ht->old_kvpairs;
+                m0 = ht->capacity - 1; m1 = ht->old_capacity - 1;
+            }
+
+            reported += dsc_ht_scan_bucket(small[v & m0], fn, ctx);
+            do {
+                reported += dsc_ht_scan_bucket(large[v & m1], fn, ctx);
+                v = dsc_ht_scan_advance(v, m1);
+            } while ((v & (m0 ^ m1)) != 0);
+        }
+    } while (v != 0 && reported < count && --budget > 0);
+
+    return v;
+}
+
+typedef enum {
+    DSC_HT_OP_INSERT,
+    DSC_HT_OP_GET,
+    DSC_HT_OP_DELETE
+} dsc_ht_op;
+
+/* Key i of a batch laid out like dsc_set_from_array input */
+static inline const void *dsc_ht_batch_key(const dsc_hash_table *ht, const void *keys, size_t i) {
+    return (ht->key_size == 0) ? ((const void *const *)keys)[i] : (const void *)((const char *)keys + i * ht->key_size);
+}
+
+/*
+ * Shared batch engine. Each block of DSC_HT_BATCH keys is processed in three
+ * passes: hash everything and prefetch the bucket slots, prefetch the chain
+ * heads those slots point at, then resolve the keys in order. By the time a
+ * key is resolved its memory has been in flight for the whole block.
+ * objs == NULL on insert stores each key pointer as its own object (sets).
+ */
+static size_t dsc_ht_batch(dsc_hash_table *ht, dsc_ht_op op, const void *keys, void *const *objs,
+                           void **out, size_t count, dsc_error_t *status)
+{
+    const void *bkey[DSC_HT_BATCH];
+    size_t      bsize[DSC_HT_BATCH];
+    uint64_t    bhash[DSC_HT_BATCH];
+    size_t      done = 0;
+
+    for (size_t base = 0; base < count; base += DSC_HT_BATCH) {
+        size_t n = (count - base < DSC_HT_BATCH) ? count - base : DSC_HT_BATCH;
+
+        if (ht->old_kvpairs != NULL) dsc_ht_rehash_step(ht, DSC_HT_REHASH_STEP);
+
+        /* Grow before hashing so the prefetched slots stay valid */
+        if (op == DSC_HT_OP_INSERT && !dsc_ht_reserve(ht, n)) {
+            for (size_t i = base; i < count; i++) {
+                if (status != NULL) status[i] = DSC_ENOMEM;
+                if (out != NULL) out[i] = NULL;
+            }
+            break;
+        }
+
+        for (size_t j = 0; j < n; j++) {
+            bkey[j] = dsc_ht_batch_key(ht, keys, base + j);
+            if (bkey[j] == NULL) continue;
+
+            bsize[j] = dsc_ht_key_size(ht, bkey[j]);
+            bhash[j] = ht->hf(bkey[j], bsize[j]);
+            DSC_PREFETCH(&ht->kvpairs[dsc_ht_bucket(bhash[j], ht->capacity)]);
+        }
+
+        for (size_t j = 0; j < n; j++) {
+            if (bkey[j] != NULL) DSC_PREFETCH(ht->kvpairs[dsc_ht_bucket(bhash[j], ht->capacity)]);
+        }
+
+        /* Resolve in order so repeated keys behave like sequential calls */
+        for (size_t j = 0; j < n; j++) {
+            size_t      i      = base + j;
+            void       *result = NULL;
+            dsc_error_t err    = DSC_EOK;
+
+            if (bkey[j] == NULL) {
+                err = DSC_EINVAL;
+            } else if (op == DSC_HT_OP_INSERT) {
+                void *obj = (objs != NULL) ? objs[i] : (void *)bkey[j];
+                if (obj == NULL) {
+                    err = DSC_EINVAL;
+                } else if (dsc_ht_find_link(ht, bkey[j], bsize[j], bhash[j]) != NULL) {
+                    err = DSC_EEXISTS;
+                } else if (dsc_ht_link_new(ht, bkey[j], bsize[j], bhash[j], obj) == NULL) {
+                    err = DSC_ENOMEM;
+                }
+            } else {
+                dsc_kvpair **link = dsc_ht_find_link(ht, bkey[j], bsize[j], bhash[j]);
+                if (link == NULL) {
+                    err = DSC_ENOTFOUND;
+                } else if (op == DSC_HT_OP_GET) {
+                    result = (*link)->obj;
+                } else {
+                    result = dsc_ht_unlink(ht, link);
+                }
+            }
+
+            if (status != NULL) status[i] = err;
+            if (out != NULL) out[i] = result;
+            if (err == DSC_EOK) done++;
+        }
+    }
+
+    /* Once per batch, after every key has been resolved against the same array */
+    if (op == DSC_HT_OP_DELETE) dsc_ht_maybe_shrink(ht);
+    return done;
+}
+
+/**
+ * @brief inserts count keys with their objects in one pass
+ * @param keys packed keys, or an array of key pointers when key_size is 0
+ * @param objs one object per key, none of them NULL
+ * @param status optional per-key result (DSC_EOK, DSC_EEXISTS, DSC_EINVAL, DSC_ENOMEM)
+ * @return number of keys inserted
+ */
+size_t DSC_FUNC(hash_table_insert_batch)(dsc_hash_table *ht, const void *keys, void *const *objs, size_t count, dsc_error_t *status)
+{
+    if ((ht == NULL) || (count > 0 && (keys == NULL || objs == NULL))) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    dsc_set_error(DSC_EOK);
+
+    return dsc_ht_batch(ht, DSC_HT_OP_INSERT, keys, objs, NULL, count, status);
+}
+
+/**
+ * @brief looks up count keys in one pass
+ * @param out optional, receives each key's object or NULL when it is absent
+ * @param status optional per-key result (DSC_EOK, DSC_ENOTFOUND, DSC_EINVAL)
+ * @return number of keys found
+ */
+size_t DSC_FUNC(hash_table_get_batch)(dsc_hash_table *ht, const void *keys, void **out, size_t count, dsc_error_t *status)
+{
+    if ((ht == NULL) || (count > 0 && keys == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    dsc_set_error(DSC_EOK);
+
+    return dsc_ht_batch(ht, DSC_HT_OP_GET, keys, NULL, out, count, status);
+}
+
+/**
+ * @brief deletes count keys in one pass
+ * @param out optional, receives each removed object or NULL when the key was absent
+ * @param status optional per-key result (DSC_EOK, DSC_ENOTFOUND, DSC_EINVAL)
+ * @return number of keys deleted
+ */
+size_t DSC_FUNC(hash_table_delete_batch)(dsc_hash_table *ht, const void *keys, void **out, size_t count, dsc_error_t *status)
+{
+    if ((ht == NULL) || (count > 0 && keys == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    dsc_set_error(DSC_EOK);
+
+    return dsc_ht_batch(ht, DSC_HT_OP_DELETE, keys, NULL, out, count, status);
+}
+
+dsc_list DSC_FUNC(hash_table_keys)(dsc_hash_table *ht) {
+    dsc_list result = {0};
+    
+    if (ht == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return result;
+    }
+    dsc_set_error(DSC_EOK);
+
+    size_t key_size = ht->key_size;
+    if (key_size == 0) {
+        key_size = sizeof(void*); /* For variable-length keys, store pointers */
+    }
+
+    DSC_FUNC(list_init)(&result, key_size, ht->size);
+    if (DSC_FUNC(get_error)() != DSC_EOK) {
+        return result;
+    }
+
+    /* list_init reserved ht->size slots, so every push fits */
+    size_t bucket = 0;
+    for (dsc_kvpair *kvp = dsc_ht_next_node(ht, &bucket, NULL); kvp != NULL; kvp = dsc_ht_next_node(ht, &bucket, kvp)) {
+        if (ht->key_size == 0) {
+            /* Variable-length key: store pointer */
+            dsc_list_push_unchecked(&result, &kvp->key);
+        } else {
+            /* Fixed-size key: store value */
+            dsc_list_push_unchecked(&result, kvp->key);
+        }
+    }
+    return result;
+}
+
+dsc_list DSC_FUNC(hash_table_values)(dsc_hash_table *ht) {
+    dsc_list result = {0};
+    
+    if (ht == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return result;
+    }
+    dsc_set_error(DSC_EOK);
+
+    DSC_FUNC(list_init)(&result, sizeof(void*), ht->size);
+    if (DSC_FUNC(get_error)() != DSC_EOK) {
+        return result;
+    }
+
+    size_t bucket = 0;
+    for (dsc_kvpair *kvp = dsc_ht_next_node(ht, &bucket, NULL); kvp != NULL; kvp = dsc_ht_next_node(ht, &bucket, kvp)) {
+        dsc_list_push_unchecked(&result, &kvp->obj);
+    }
+    return result;
+}
+
+/*
+ * +----------------------------------------------------------------+
+ * |               CONCURRENT HASHTABLE Implementation              |
+ * +----------------------------------------------------------------+
+ */
+#ifndef DSC_NO_THREADS
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+
+    static inline bool dsc_rwlock_init(dsc_rwlock *l)     { InitializeSRWLock((PSRWLOCK)l); return true; }
+    static inline void dsc_rwlock_destroy(dsc_rwlock *l)  { (void)l; }
+    static inline void dsc_rwlock_rdlock(dsc_rwlock *l)   { AcquireSRWLockShared((PSRWLOCK)l); }
+    static inline void dsc_rwlock_rdunlock(dsc_rwlock *l) { ReleaseSRWLockShared((PSRWLOCK)l); }
+    static inline void dsc_rwlock_wrlock(dsc_rwlock *l)   { AcquireSRWLockExclusive((PSRWLOCK)l); }
+    static inline void dsc_rwlock_wrunlock(dsc_rwlock *l) { ReleaseSRWLockExclusive((PSRWLOCK)l); }
+#else
+    static inline bool dsc_rwlock_init(dsc_rwlock *l)     { return pthread_rwlock_init(l, NULL) == 0; }
+    static inline void dsc_rwlock_destroy(dsc_rwlock *l)  { pthread_rwlock_destroy(l); }
+    static inline void dsc_rwlock_rdlock(dsc_rwlock *l)   { pthread_rwlock_rdlock(l); }
+    static inline void dsc_rwlock_rdunlock(dsc_rwlock *l) { pthread_rwlock_unlock(l); }
+    static inline void dsc_rwlock_wrlock(dsc_rwlock *l)   { pthread_rwlock_wrlock(l); }
+    static inline void dsc_rwlock_wrunlock(dsc_rwlock *l) { pthread_rwlock_unlock(l); }
+#endif
+
+/* Shard from the high half of the mixed hash; buckets inside a shard use the low half */
+static inline dsc_ht_shard *dsc_cht_shard(const dsc_concurrent_hash_table *cht, uint64_t hash) {
+    uint64_t h = hash * 0x9e3779b97f4a7c15ULL;
+    return &cht->shards[(size_t)(h >> 32) & (cht->shard_count - 1)];
+}
+
+static inline size_t dsc_cht_key_size(const dsc_concurrent_hash_table *cht, const void *key) {
+    return (cht->key_size != 0) ? cht->key_size : strlen((const char*)key) + 1;
+}
+
+void DSC_FUNC(concurrent_hash_table_init)(dsc_concurrent_hash_table *cht, size_t capacity, size_t key_size, dsc_hashfunc *hf, dsc_cmpfunc *cf)
+{
+    dsc_set_error(DSC_EOK);
+
+    if (cht == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    *cht = (dsc_concurrent_hash_table){0};
+
+    if (hf == NULL) {
+        dsc_set_error(DSC_EHASHFUNC);
+        return;
+    }
+    if (cf == NULL) {
+        dsc_set_error(DSC_ECMPFUNC);
+        return;
+    }
+
+    dsc_ht_shard *shards = (dsc_ht_shard *)calloc(DSC_CHT_SHARDS, sizeof(dsc_ht_shard));
+    if (shards == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+
+    size_t per_shard = (capacity + DSC_CHT_SHARDS - 1) / DSC_CHT_SHARDS;
+    for (size_t i = 0; i < DSC_CHT_SHARDS; i++) {
+        DSC_FUNC(hash_table_init)(&shards[i].ht, per_shard, key_size, hf, cf);
+        bool ok = DSC_FUNC(get_error)() == DSC_EOK;
+        if (ok && !dsc_rwlock_init(&shards[i].lock)) {
+            DSC_FUNC(hash_table_destroy)(&shards[i].ht, NULL);
+            ok = false;
+        }
+        if (!ok) {
+            while (i-- > 0) {
+                DSC_FUNC(hash_table_destroy)(&shards[i].ht, NULL);
+                dsc_rwlock_destroy(&shards[i].lock);
+            }
+            free(shards);
+            dsc_set_error(DSC_ENOMEM);
+            return;
+        }
+        /* Writers share the cost of a resize instead of one paying for all of it */
+        shards[i].ht.incremental = true;
+    }
+
+    cht->shards      = shards;
+    cht->shard_count = DSC_CHT_SHARDS;
+    cht->key_size    = key_size;
+    cht->hf          = hf;
+    dsc_set_error(DSC_EOK);
+}
+
+bool DSC_FUNC(concurrent_hash_table_insert)(dsc_concurrent_hash_table *cht, const void *key, void *obj)
+{
+    if ((cht == NULL) || (cht->shards == NULL) || (key == NULL) || (obj == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+
+    /* Hash outside the lock: only the probe and the link are serialized */
+    size_t       key_size = dsc_cht_key_size(cht, key);
+    uint64_t     hash     = cht->hf(key, key_size);
+    dsc_ht_shard *shard   = dsc_cht_shard(cht, hash);
+    dsc_error_t  err      = DSC_EOK;
+
+    dsc_rwlock_wrlock(&shard->lock);
+    dsc_hash_table *ht = &shard->ht;
+    if (ht->old_kvpairs != NULL) dsc_ht_rehash_step(ht, DSC_HT_REHASH_STEP);
+
+    if (!dsc_ht_maybe_grow(ht)) {
+        err = DSC_ENOMEM;
+    } else if (dsc_ht_find_link(ht, key, key_size, hash) != NULL) {
+        err = DSC_EEXISTS;
+    } else if (dsc_ht_link_new(ht, key, key_size, hash, obj) == NULL) {
+        err = DSC_ENOMEM;
+    }
+    dsc_rwlock_wrunlock(&shard->lock);
+
+    dsc_set_error(err);
+    return err == DSC_EOK;
+}
+
+void *DSC_FUNC(concurrent_hash_table_get)(dsc_concurrent_hash_table *cht, const void *key)
+{
+    if ((cht == NULL) || (cht->shards == NULL) || (key == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+
+    size_t       key_size = dsc_cht_key_size(cht, key);
+    uint64_t     hash     = cht->hf(key, key_size);
+    dsc_ht_shard *shard   = dsc_cht_shard(cht, hash);
+    void         *result  = NULL;
+
+    /* Readers never advance a pending rehash: lookups check both arrays read-only */
+    dsc_rwlock_rdlock(&shard->lock);
+    dsc_kvpair **link = dsc_ht_find_link(&shard->ht, key, key_size, hash);
+    if (link != NULL) result = (*link)->obj;
+    dsc_rwlock_rdunlock(&shard->lock);
+
+    dsc_set_error((result != NULL) ? DSC_EOK : DSC_ENOTFOUND);
+    return result;
+}
+
+void *DSC_FUNC(concurrent_hash_table_delete)(dsc_concurrent_hash_table *cht, const void *key)
+{
+    if ((cht == NULL) || (cht->shards == NULL) || (key == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+
+    size_t       key_size = dsc_cht_key_size(cht, key);
+    uint64_t     hash     = cht->hf(key, key_size);
+    dsc_ht_shard *shard   = dsc_cht_shard(cht, hash);
+    void         *result  = NULL;
+
+    dsc_rwlock_wrlock(&shard->lock);
+    dsc_hash_table *ht = &shard->ht;
+    if (ht->old_kvpairs != NULL) dsc_ht_rehash_step(ht, DSC_HT_REHASH_STEP);
+
+    dsc_kvpair **link = dsc_ht_find_link(ht, key, key_size, hash);
+    if (link != NULL) result = dsc_ht_unlink(ht, link);
+    dsc_rwlock_wrunlock(&shard->lock);
+
+    dsc_set_error((result != NULL) ? DSC_EOK : DSC_ENOTFOUND);
+    return result;
+}
+
+/* Sum of the shard sizes; each shard is read consistently, the total is a snapshot */
+size_t DSC_FUNC(concurrent_hash_table_size)(dsc_concurrent_hash_table *cht)
+{
+    if ((cht == NULL) || (cht->shards == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    dsc_set_error(DSC_EOK);
+
+    size_t total = 0;
+    for (size_t i = 0; i < cht->shard_count; i++) {
+        dsc_rwlock_rdlock(&cht->shards[i].lock);
+        total += cht->shards[i].ht.size;
+        dsc_rwlock_rdunlock(&cht->shards[i].lock);
+    }
+    return total;
+}
+
+void DSC_FUNC(concurrent_hash_table_clear)(dsc_concurrent_hash_table *cht, dsc_cleanupfunc *cf)
+{
+    if ((cht == NULL) || (cht->shards == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    for (size_t i = 0; i < cht->shard_count; i++) {
+        dsc_rwlock_wrlock(&cht->shards[i].lock);
+        DSC_FUNC(hash_table_clear)(&cht->shards[i].ht, cf);
+        dsc_rwlock_wrunlock(&cht->shards[i].lock);
+    }
+    dsc_set_error(DSC_EOK);
+}
+
+/**
+ * @brief deallocates the table; no other thread may be using it
+ * @param cf optional cleanup function called on each stored object, as in dsc_hash_table_destroy
+ */
+void DSC_FUNC(concurrent_hash_table_destroy)(dsc_concurrent_hash_table *cht, dsc_cleanupfunc *cf)
+{
+    if (cht == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    if (cht->shards != NULL) {
+        for (size_t i = 0; i < cht->shard_count; i++) {
+            DSC_FUNC(hash_table_destroy)(&cht->shards[i].ht, cf);
+            dsc_rwlock_destroy(&cht->shards[i].lock);
+        }
+        free(cht->shards);
+    }
+    cht->shards      = NULL;
+    cht->shard_count = 0;
+    dsc_set_error(DSC_EOK);
+}
+
+#endif /* DSC_NO_THREADS */
+
+/*
+ * +----------------------------------------------------------------+
+ * |          FLAT (OPEN-ADDRESSING) HASHTABLE Implementation       |
+ * +----------------------------------------------------------------+
+ */
+
+/* Key area of a slot when key_size == 0: the key lives on the heap */
+typedef struct _dsc_flat_varkey {
+    void   *key;
+    size_t  key_size;
+} dsc_flat_varkey;
+
+#define DSC_FLAT_MIN_CAPACITY 8
+
+#define DSC_FLAT_SLOT(ft, i)   ((dsc_flat_slot *)((ft)->slots + (i) * (ft)->slot_size))
+#define DSC_FLAT_KEY(slot)     ((unsigned char *)(slot) + sizeof(dsc_flat_slot))
+
+/* Fibonacci hashing: spreads weak user hashes over the power-of-two range */
+static inline size_t dsc_flat_home(const dsc_flat_table *ft, uint64_t hash) {
+    return (size_t)((hash * 11400714819323198485ULL) >> ft->shift);
+}
+
+static inline size_t dsc_flat_dist(const dsc_flat_table *ft, const dsc_flat_slot *slot, size_t pos) {
+    return (pos - dsc_flat_home(ft, slot->hash)) & (ft->capacity - 1);
+}
+
+static inline const void *dsc_flat_slot_key(const dsc_flat_table *ft, const dsc_flat_slot *slot, size_t *key_size) {
+    if (ft->key_size == 0) {
+        const dsc_flat_varkey *vk = (const dsc_flat_varkey *)DSC_FLAT_KEY(slot);
+        *key_size = vk->key_size;
+        return vk->key;
+    }
+    *key_size = ft->key_size;
+    return DSC_FLAT_KEY(slot);
+}
+
+static bool dsc_flat_alloc_slots(dsc_flat_table *ft, size_t capacity) {
+    /* Two spare slots at the end serve as scratch space for Robin Hood swaps */
+    unsigned char *slots = (unsigned char *)calloc(capacity + 2, ft->slot_size);
+    if (slots == NULL) return false;
+
+    unsigned shift = 64;
+    for (size_t c = capacity; c > 1; c >>= 1) shift--;
+
+    ft->slots    = slots;
+    ft->capacity = capacity;
+    ft->shift    = shift;
+    return true;
+}
+
+/*
+ * Place an already-built slot (hash, obj and key area filled in) without
+ * checking for duplicates. Used by insert after the lookup phase and by
+ * resize, which never needs to call hf or cf again.
+ */
+static void dsc_flat_place(dsc_flat_table *ft, dsc_flat_slot *entry, size_t pos, size_t dist) {
+    size_t         mask = ft->capacity - 1;
+    dsc_flat_slot *tmp  = DSC_FLAT_SLOT(ft, ft->capacity + 1);
+
+    for (;;) {
+        dsc_flat_slot *slot = DSC_FLAT_SLOT(ft, pos);
+        if (slot->obj == NULL) {
+            memcpy(slot, entry, ft->slot_size);
+            return;
+        }
+        size_t slot_dist = dsc_flat_dist(ft, slot, pos);
+        if (slot_dist < dist) {
+            /* Rob the richer entry and carry it forward */
+            memcpy(tmp, slot, ft->slot_size);
+            memcpy(slot, entry, ft->slot_size);
+            memcpy(entry, tmp, ft->slot_size);
+            dist = slot_dist;
+        }
+        pos = (pos + 1) & mask;
+        dist++;
+    }
+}
+
+static bool dsc_flat_grow(dsc_flat_table *ft) {
+    unsigned char *old_slots    = ft->slots;
+    size_t         old_capacity = ft->capacity;
+    unsigned       old_shift    = ft->shift;
+
+    if (!dsc_flat_alloc_slots(ft, old_capacity * 2)) {
+        ft->slots    = old_slots;
+        ft->capacity = old_capacity;
+        ft->shift    = old_shift;
+        return false;
+    }
+
+    dsc_flat_slot *entry = DSC_FLAT_SLOT(ft, ft->capacity);
+    for (size_t i = 0; i < old_capacity; i++) {
+        dsc_flat_slot *slot = (dsc_flat_slot *)(old_slots + i * ft->slot_size);
+        if (slot->obj == NULL) continue;
+
+        memcpy(entry, slot, ft->slot_size);
+        dsc_flat_place(ft, entry, dsc_flat_home(ft, entry->hash), 0);
+    }
+
+    free(old_slots);
+    return true;
+}
+
+/* Returns the slot index holding key, or ft->capacity if it is absent */
+static size_t dsc_flat_find(dsc_flat_table *ft, const void *key, size_t key_size, uint64_t hash) {
+    size_t mask = ft->capacity - 1;
+    size_t pos  = dsc_flat_home(ft, hash);
+
+    for (size_t dist = 0; ; dist++) {
+        dsc_flat_slot *slot = DSC_FLAT_SLOT(ft, pos);
+        if (slot->obj == NULL || dsc_flat_dist(ft, slot, pos) < dist) {
+            return ft->capacity;
+        }
+        if (slot->hash == hash) {
+            size_t      slot_key_size;
+            const void *slot_key = dsc_flat_slot_key(ft, slot, &slot_key_size);
+            if (ft->cf(slot_key, slot_key_size, key, key_size) == 0) {
+                return pos;
+            }
+        }
+        pos = (pos + 1) & mask;
+    }
+}
+
+void DSC_FUNC(flat_table_init)(dsc_flat_table *ft, size_t capacity, size_t key_size, dsc_hashfunc *hf, dsc_cmpfunc *cf)
+{
+    dsc_set_error(DSC_EOK);
+
+    if (ft == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    if (hf == NULL) {
+        dsc_set_error(DSC_EHASHFUNC);
+        return;
+    }
+
+    if (cf == NULL) {
+        dsc_set_error(DSC_ECMPFUNC);
+        return;
+    }
+
+    size_t key_area = (key_size != 0) ? key_size : sizeof(dsc_flat_varkey);
+    key_area = (key_area + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+    size_t slot_size = sizeof(dsc_flat_slot) + key_area;
+    size_t slots     = dsc_ht_round_pow2((capacity > DSC_FLAT_MIN_CAPACITY) ? capacity : DSC_FLAT_MIN_CAPACITY);
+    if (slots == 0 || slots > SIZE_MAX / slot_size - 2) {
+        *ft = (dsc_flat_table){0};
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+
+    *ft = (dsc_flat_table) {
+        .hf        = hf,
+        .cf        = cf,
+        .key_size  = key_size,
+        .slot_size = slot_size,
+        .size      = 0
+    };
+    if (!dsc_flat_alloc_slots(ft, slots)) {
+        dsc_set_error(DSC_ENOMEM);
+        ft->capacity = 0;
+        ft->slots    = NULL;
+        return;
+    }
+}
+
+bool DSC_FUNC(flat_table_insert)(dsc_flat_table *ft, const void *key, void *obj)
+{
+    dsc_set_error(DSC_EOK);
+
+    if ((ft == NULL) || (key == NULL) || (obj == NULL) || (ft->slots == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+
+    /* Keep the load factor at or below 7/8 */
+    if (ft->size + 1 > ft->capacity - ft->capacity / 8) {
+        if (!dsc_flat_grow(ft)) {
+            dsc_set_error(DSC_ENOMEM);
+            return false;
+        }
+    }
+
+    size_t key_size = ft->key_size;
+    if (key_size == 0) {
+        key_size = strlen((const char*)key) + 1;
+    }
+
+    uint64_t hash = ft->hf(key, key_size);
+    if (dsc_flat_find(ft, key, key_size, hash) != ft->capacity) {
+        dsc_set_error(DSC_EEXISTS);
+        return false;
+    }
+
+    dsc_flat_slot *entry = DSC_FLAT_SLOT(ft, ft->capacity);
+    memset(entry, 0, ft->slot_size);
+    entry->hash = hash;
+    entry->obj  = obj;
+
+    if (ft->key_size == 0) {
+        dsc_flat_varkey *vk = (dsc_flat_varkey *)DSC_FLAT_KEY(entry);
+        vk->key = malloc(key_size);
+        if (vk->key == NULL) {
+            dsc_set_error(DSC_ENOMEM);
+            return false;
+        }
+        memcpy(vk->key, key, key_size);
+        vk->key_size = key_size;
+    } else {
+        memcpy(DSC_FLAT_KEY(entry), key, key_size);
+    }
+
+    dsc_flat_place(ft, entry, dsc_flat_home(ft, hash), 0);
+    ft->size++;
+    return true;
+}
+
+void *DSC_FUNC(flat_table_get)(dsc_flat_table *ft, const void *key)
+{
+    dsc_set_error(DSC_EOK);
+
+    if ((ft == NULL) || (key == NULL) || (ft->slots == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+
+    size_t key_size = ft->key_size;
+    if (key_size == 0) {
+        key_size = strlen((const char*)key) + 1;
+    }
+
+    size_t pos = dsc_flat_find(ft, key, key_size, ft->hf(key, key_size));
+    if (pos == ft->capacity) {
+        dsc_set_error(DSC_ENOTFOUND);
+        return NULL;
+    }
+    return DSC_FLAT_SLOT(ft, pos)->obj;
+}
+
+void *DSC_FUNC(flat_table_get_unchecked)(dsc_flat_table *ft, const void *key)
+{
+    size_t key_size = (ft->key_size != 0) ? ft->key_size : strlen((const char*)key) + 1;
+    size_t pos      = dsc_flat_find(ft, key, key_size, ft->hf(key, key_size));
+    return (pos != ft->capacity) ? DSC_FLAT_SLOT(ft, pos)->obj : NULL;
+}
+
+void *DSC_FUNC(flat_table_delete)(dsc_flat_table *ft, const void *key)
+{
+    dsc_set_error(DSC_EOK);
+
+    if ((ft == NULL) || (key == NULL) || (ft->slots == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+
+    size_t key_size = ft->key_size;
+    if (key_size == 0) {
+        key_size = strlen((const char*)key) + 1;
+    }
+
+    size_t pos = dsc_flat_find(ft, key, key_size, ft->hf(key, key_size));
+    if (pos == ft->capacity) {
+        dsc_set_error(DSC_ENOTFOUND);
+        return NULL;
+    }
+
+    dsc_flat_slot *slot   = DSC_FLAT_SLOT(ft, pos);
+    void          *result = slot->obj;
+    if (ft->key_size == 0) {
+        free(((dsc_flat_varkey *)DSC_FLAT_KEY(slot))->key);
+    }
+
+    /* Backward-shift deletion: pull following displaced entries one step home */
+    size_t mask = ft->capacity - 1;
+    size_t next = (pos + 1) & mask;
+    for (;;) {
+        dsc_flat_slot *next_slot = DSC_FLAT_SLOT(ft, next);
+        if (next_slot->obj == NULL || dsc_flat_dist(ft, next_slot, next) == 0) break;
+
+        memcpy(DSC_FLAT_SLOT(ft, pos), next_slot, ft->slot_size);
+        pos  = next;
+        next = (next + 1) & mask;
+    }
+    memset(DSC_FLAT_SLOT(ft, pos), 0, ft->slot_size);
+
+    ft->size--;
+    return result;
+}
+
+void DSC_FUNC(flat_table_clear)(dsc_flat_table *ft, dsc_cleanupfunc *cf)
+{
+    if (ft == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    for (size_t i = 0; i < ft->capacity; i++) {
+        dsc_flat_slot *slot = DSC_FLAT_SLOT(ft, i);
+        if (slot->obj == NULL) continue;
+
+        if (ft->key_size == 0) free(((dsc_flat_varkey *)DSC_FLAT_KEY(slot))->key);
+        if (cf != NULL) cf(slot->obj);
+    }
+    if (ft->slots != NULL) memset(ft->slots, 0, ft->capacity * ft->slot_size);
+    ft->size = 0;
+}
+
+void DSC_FUNC(flat_table_destroy)(dsc_flat_table *ft, dsc_cleanupfunc *cf)
+{
+    if (ft == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    DSC_FUNC(flat_table_clear)(ft, cf);
+
+    free(ft->slots); ft->slots = NULL;
+    ft->capacity = 0;
+}
+
+dsc_list DSC_FUNC(flat_table_keys)(dsc_flat_table *ft) {
+    dsc_list result = {0};
+
+    if (ft == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return result;
+    }
+    dsc_set_error(DSC_EOK);
+
+    /* For variable-length keys, store pointers (same as hash_table_keys) */
+    size_t key_size = (ft->key_size != 0) ? ft->key_size : sizeof(void*);
+
+    DSC_FUNC(list_init)(&result, key_size, ft->size);
+    if (DSC_FUNC(get_error)() != DSC_EOK) {
+        return result;
+    }
+
+    for (size_t i = 0; i < ft->capacity; i++) {
+        dsc_flat_slot *slot = DSC_FLAT_SLOT(ft, i);
+        if (slot->obj == NULL) continue;
+
+        if (ft->key_size == 0) {
+            dsc_list_push_unchecked(&result, &((dsc_flat_varkey *)DSC_FLAT_KEY(slot))->key);
+        } else {
+            dsc_list_push_unchecked(&result, DSC_FLAT_KEY(slot));
+        }
+    }
+    return result;
+}
+
+dsc_list DSC_FUNC(flat_table_values)(dsc_flat_table *ft) {
+    dsc_list result = {0};
+
+    if (ft == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return result;
+    }
+    dsc_set_error(DSC_EOK);
+
+    DSC_FUNC(list_init)(&result, sizeof(void*), ft->size);
+    if (DSC_FUNC(get_error)() != DSC_EOK) {
+        return result;
+    }
+
+    for (size_t i = 0; i < ft->capacity; i++) {
+        dsc_flat_slot *slot = DSC_FLAT_SLOT(ft, i);
+        if (slot->obj == NULL) continue;
+        dsc_list_push_unchecked(&result, &slot->obj);
+    }
+    return result;
+}
+
+/*
+ * +----------------------------------------------------------------+
+ * |              LIST (DYNAMIC ARRAY) Implementation               |
+ * +----------------------------------------------------------------+
+ */
+void DSC_FUNC(list_init)(dsc_list* list, size_t item_size, size_t initial_capacity) {
+    DSC_FUNC(list_init_with_allocator)(list, item_size, initial_capacity, NULL);
+}
+
+void DSC_FUNC(list_init_with_allocator)(dsc_list* list, size_t item_size, size_t initial_capacity, const dsc_allocator* allocator) {
+    dsc_set_error(DSC_EOK);
+
+    if (list == NULL || item_size == 0) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    /* Capacity 0 allocates nothing until the first insert; items are never zeroed */
+    list->allocator = allocator;
+    list->growth    = NULL;
+    list->items     = NULL;
+    list->item_size = item_size;
+    list->length    = 0;
+    list->capacity  = 0;
+    DSC_STAT(list->stats = (dsc_alloc_stats){0});
+    if (initial_capacity != 0 && !dsc_list_set_capacity(list, initial_capacity)) {
+        list->item_size = 0;
+    }
+}
+
+#ifndef DSC_NO_VMEM
+/* A vmem that already holds synced list data (a reopened file) is adopted in place */
+void DSC_FUNC(list_init_mapped)(dsc_list* list, size_t item_size, dsc_vmem* vm) {
+    dsc_set_error(DSC_EOK);
+
+    if (list == NULL || vm == NULL || vm->base == NULL || item_size == 0) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    DSC_FUNC(list_init_with_allocator)(list, item_size, 0, &vm->allocator);
+    if (vm->committed < DSC_VMEM_HEADER) return;
+
+    dsc_vmem_header *hdr = DSC_VMEM_HDR(vm);
+    if (hdr->elem_size == 0) return;
+    if (hdr->elem_size != item_size || vm->in_use) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    vm->in_use      = true;
+    list->items     = DSC_VMEM_DATA(vm);
+    list->length    = (size_t)hdr->used / item_size;
+    list->capacity  = (vm->committed - DSC_VMEM_HEADER) / item_size;
+}
+
+/* Record the list's length in the mapping header and flush it to the file */
+void DSC_FUNC(list_sync)(dsc_list* list, dsc_vmem* vm) {
+    dsc_set_error(DSC_EOK);
+
+    if (list == NULL || vm == NULL ||
+        (list->items != NULL && list->items != (void *)DSC_VMEM_DATA(vm))) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (vm->committed < DSC_VMEM_HEADER) return;
+
+    dsc_vmem_header *hdr = DSC_VMEM_HDR(vm);
+    hdr->elem_size = list->item_size;
+    hdr->used      = (uint64_t)(list->length * list->item_size);
+    dsc_vmem_flush(vm);
+}
+#endif /* DSC_NO_VMEM */
+
+void DSC_FUNC(list_set_growth)(dsc_list* list, const dsc_list_growth* growth) {
+    if (list == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (growth != NULL && growth->shrink_percent > 50) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+    list->growth = growth;
+}
+
+void DSC_FUNC(list_destroy)(dsc_list* list) {
+    if (list == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (list->items != NULL) DSC_STAT(dsc_stats_free(&list->stats, list->capacity * list->item_size));
+    dsc_mem_free(list->allocator, list->items, list->capacity * list->item_size);
+    list->items = NULL;
+    list->length = 0;
+    list->capacity = 0;
+}
+
+dsc_alloc_stats DSC_FUNC(list_stats)(dsc_list* list) {
+    dsc_alloc_stats stats = {0};
+
+    if (list == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return stats;
+    }
+    dsc_set_error(DSC_EOK);
+
+#ifdef DSC_STATS
+    stats = list->stats;
+#endif
+    /* Also right for a mapped list, whose buffer was adopted rather than allocated */
+    stats.bytes = list->capacity * list->item_size;
+    if (stats.peak_bytes < stats.bytes) stats.peak_bytes = stats.bytes;
+    return stats;
+}
+
+void DSC_FUNC(list_append)(dsc_list* list, void* item) {
+    dsc_set_error(DSC_EOK);
+
+    if (list == NULL || item == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    if (!dsc_list_grow(list, list->length + 1)) {
+        return;
+    }
+    dsc_list_push_unchecked(list, item);
+}
+
+void DSC_FUNC(list_append_n)(dsc_list* list, const void* items, size_t count) {
+    dsc_set_error(DSC_EOK);
+
+    if (list == NULL || (items == NULL && count != 0)) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (count == 0) return;
+
+    size_t needed;
+    if (dsc_add_overflow(list->length, count, &needed)) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    if (!dsc_list_grow(list, needed)) {
+        return;
+    }
+    memcpy((char*)list->items + list->length * list->item_size, items, count * list->item_size);
+    list->length += count;
+}
+
+void DSC_FUNC(list_insert_range)(dsc_list* list, size_t index, const void* items, size_t count) {
+    dsc_set_error(DSC_EOK);
+
+    if (list == NULL || (items == NULL && count != 0)) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (index > list->length) {
+        dsc_set_error(DSC_ERANGE);
+        return;
+    }
+    if (count == 0) return;
+
+    size_t needed;
+    if (dsc_add_overflow(list->length, count, &needed)) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    if (!dsc_list_grow(list, needed)) {
+        return;
+    }
+    char* at = (char*)list->items + index * list->item_size;
+    memmove(at + count * list->item_size, at, (list->length - index) * list->item_size);
+    memcpy(at, items, count * list->item_size);
+    list->length += count;
+}
+
+void DSC_FUNC(list_erase_range)(dsc_list* list, size_t index, size_t count) {
+    dsc_set_error(DSC_EOK);
+
+    if (list == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (index > list->length || count > list->length - index) {
+        dsc_set_error(DSC_ERANGE);
+        return;
+    }
+    if (count == 0) return;
+
+    char* at = (char*)list->items + index * list->item_size;
+    memmove(at, at + count * list->item_size, (list->length - index - count) * list->item_size);
+    list->length -= count;
+    dsc_list_maybe_shrink(list);
+}
+
+void DSC_FUNC(list_reserve)(dsc_list* list, size_t capacity) {
+    dsc_set_error(DSC_EOK);
+
+    if (list == NULL || list->item_size == 0) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (capacity > list->capacity) {
+        dsc_list_set_capacity(list, capacity);
+    }
+}
+
+void DSC_FUNC(list_shrink_to_fit)(dsc_list* list) {
+    dsc_set_error(DSC_EOK);
+
+    if (list == NULL || list->item_size == 0) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    /* Keep one slot so items stays a valid buffer */
+    size_t target = (list->length != 0) ? list->length : 1;
+    if (target < list->capacity) {
+        dsc_list_set_capacity(list, target);
+    }
+}
+
+void* DSC_FUNC(list_get)(dsc_list* list, size_t index) {
+    dsc_set_error(DSC_EOK);
+
+    if (list == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+    if (index >= list->length) {
+        dsc_set_error(DSC_ERANGE);
+        return NULL;
+    }
+    return (char*)list->items + (index * list->item_size);
+}
+
+void DSC_FUNC(list_pop)(dsc_list* list) {
+    dsc_set_error(DSC_EOK);
+
+    if (list == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (list->length == 0) {
+        dsc_set_error(DSC_EEMPTY);
+        return;
+    }
+    list->length--;
+    dsc_list_maybe_shrink(list);
+}
+
+void DSC_FUNC(list_clear)(dsc_list* list) {
+    if (list == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+    list->length = 0;
+    dsc_list_maybe_shrink(list);
+}
+
+void DSC_FUNC(list_resize)(dsc_list* list, size_t new_size) {
+    dsc_set_error(DSC_EOK);
+
+    if (list == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    if (new_size > list->capacity && !dsc_list_set_capacity(list, new_size)) {
+        return;
+    }
+    /* Storage is not zeroed on allocation, so growing must clear the new items */
+    if (new_size > list->length) {
+        memset((char*)list->items + list->length * list->item_size, 0,
+               (new_size - list->length) * list->item_size);
+    }
+    list->length = new_size;
+    dsc_list_maybe_shrink(list);
+}
+
+void DSC_FUNC(list_map)(dsc_list* list, dsc_callback cf) {
+    if (list == NULL || cf == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    for (size_t i = 0; i < list->length; i++) {
+        void* item = (char*)list->items + (i * list->item_size);
+        cf(item);
+    }
+}
+
+void DSC_FUNC(list_foreach)(dsc_list* list, dsc_callback cf) {
+    if (list == NULL || cf == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    for (size_t i = 0; i < list->length; i++) {
+        void* item = (char*)list->items + (i * list->item_size);
+        cf(item);
+    }
+}
+
+dsc_list DSC_FUNC(list_filter)(dsc_list* list, dsc_predicate cf) {
+    dsc_list result = {0};
+
+    if (list == NULL || cf == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return result;
+    }
+    dsc_set_error(DSC_EOK);
+
+    DSC_FUNC(list_init_with_allocator)(&result, list->item_size, list->capacity, list->allocator);
+    if (DSC_FUNC(get_error)() != DSC_EOK) {
+        return result;
+    }
+    result.growth = list->growth;
+
+    for (size_t i = 0; i < list->length; i++) {
+        void* item = (char*)list->items + (i * list->item_size);
+        if (cf(item)) {
+            dsc_list_push_unchecked(&result, item);   /* result has list->capacity slots */
+        }
+    }
+    return result;
+}
+
+/* Smallest chunk worth handing to another thread */
+#ifndef DSC_POOL_MIN_CHUNK
+#define DSC_POOL_MIN_CHUNK 1024
+#endif
+
+/* Default chunk size: about 8 chunks per thread, so stragglers balance out */
+static size_t dsc_pool_chunk(const dsc_thread_pool *pool, size_t count) {
+    size_t threads = ((pool != NULL) ? pool->thread_count : 0) + 1;
+    size_t chunk   = count / (threads * 8);
+    return (chunk < DSC_POOL_MIN_CHUNK) ? DSC_POOL_MIN_CHUNK : chunk;
+}
+
+typedef struct {
+    dsc_list            *list;
+    dsc_list            *out;
+    dsc_callback_ctx    cb;
+    dsc_predicate_ctx   pred;
+    void                *ctx;
+    unsigned char       *keep;      /* filter: predicate result per item */
+    size_t              *offsets;   /* filter: kept count, then output start, per chunk */
+    size_t              chunk;
+} dsc_list_job;
+
+static void dsc_list_map_range(void *arg, size_t begin, size_t end) {
+    dsc_list_job *job  = (dsc_list_job *)arg;
+    char         *item = (char *)job->list->items + begin * job->list->item_size;
+    for (size_t i = begin; i < end; i++, item += job->list->item_size) {
+        job->cb(item, job->ctx);
+    }
+}
+
+static void dsc_list_filter_count(void *arg, size_t first, size_t last) {
+    dsc_list_job *job = (dsc_list_job *)arg;
+    for (size_t c = first; c < last; c++) {
+        size_t begin = c * job->chunk;
+        size_t end   = (begin + job->chunk < job->list->length) ? begin + job->chunk : job->list->length;
+        size_t kept  = 0;
+        char   *item = (char *)job->list->items + begin * job->list->item_size;
+        for (size_t i = begin; i < end; i++, item += job->list->item_size) {
+            job->keep[i] = job->pred(item, job->ctx) ? 1 : 0;
+            kept += job->keep[i];
+        }
+        job->offsets[c] = kept;
+    }
+}
+
+static void dsc_list_filter_scatter(void *arg, size_t first, size_t last) {
+    dsc_list_job *job  = (dsc_list_job *)arg;
+    size_t       size  = job->list->item_size;
+    for (size_t c = first; c < last; c++) {
+        size_t begin = c * job->chunk;
+        size_t end   = (begin + job->chunk < job->list->length) ? begin + job->chunk : job->list->length;
+        char   *dst  = (char *)job->out->items + job->offsets[c] * size;
+        char   *src  = (char *)job->list->items + begin * size;
+        for (size_t i = begin; i < end; i++, src += size) {
+            if (job->keep[i]) {
+                memcpy(dst, src, size);
+                dst += size;
+            }
+        }
+    }
+}
+
+void DSC_FUNC(list_map_parallel)(dsc_list* list, dsc_thread_pool* pool, dsc_callback_ctx cf, void* ctx) {
+    if (list == NULL || cf == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    dsc_list_job job = { list, NULL, cf, NULL, ctx, NULL, NULL, 0 };
+    DSC_FUNC(thread_pool_parallel_for)(pool, list->length, 0, dsc_list_map_range, &job);
+}
+
+void DSC_FUNC(list_foreach_parallel)(dsc_list* list, dsc_thread_pool* pool, dsc_callback_ctx cf, void* ctx) {
+    DSC_FUNC(list_map_parallel)(list, pool, cf, ctx);
+}
+
+/*
+ * Two passes over fixed chunks: each chunk evaluates the predicate and counts
+ * its survivors, a prefix sum turns the counts into output offsets, then each
+ * chunk copies its survivors to its own slice of the result. No locks, and the
+ * predicate runs exactly once per item.
+ */
+dsc_list DSC_FUNC(list_filter_parallel)(dsc_list* list, dsc_thread_pool* pool, dsc_predicate_ctx cf, void* ctx) {
+    dsc_list result = {0};
+
+    if (list == NULL || cf == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return result;
+    }
+    dsc_set_error(DSC_EOK);
+
+    size_t n       = list->length;
+    size_t chunk   = dsc_pool_chunk(pool, n);
+    size_t nchunks = (n + chunk - 1) / chunk;
+
+    dsc_list_job job = { list, &result, NULL, cf, ctx, NULL, NULL, chunk };
+    job.keep    = (unsigned char *)dsc_mem_alloc(list->allocator, n + 1);
+    job.offsets = (size_t *)dsc_mem_alloc(list->allocator, (nchunks + 1) * sizeof(size_t));
+    if (job.keep == NULL || job.offsets == NULL) {
+        dsc_mem_free(list->allocator, job.keep, n + 1);
+        dsc_mem_free(list->allocator, job.offsets, (nchunks + 1) * sizeof(size_t));
+        dsc_set_error(DSC_ENOMEM);
+        return result;
+    }
+
+    DSC_FUNC(thread_pool_parallel_for)(pool, nchunks, 1, dsc_list_filter_count, &job);
+
+    size_t total = 0;
+    for (size_t c = 0; c < nchunks; c++) {
+        size_t kept     = job.offsets[c];
+        job.offsets[c]  = total;
+        total          += kept;
+    }
+
+    DSC_FUNC(list_init_with_allocator)(&result, list->item_size, total, list->allocator);
+    if (DSC_FUNC(get_error)() == DSC_EOK && total != 0) {
+        DSC_FUNC(thread_pool_parallel_for)(pool, nchunks, 1, dsc_list_filter_scatter, &job);
+        result.length = total;
+    }
+    result.growth = list->growth;
+
+    dsc_mem_free(list->allocator, job.keep, n + 1);
+    dsc_mem_free(list->allocator, job.offsets, (nchunks + 1) * sizeof(size_t));
+    return result;
+}
+
+/* Block length for filter_span with span 0; also sizes its on-stack keep mask */
+#ifndef DSC_LIST_SPAN
+#define DSC_LIST_SPAN 1024
+#endif
+
+void DSC_FUNC(list_map_span)(dsc_list* list, size_t span, dsc_span_callback cf, void* ctx) {
+    if (list == NULL || cf == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (span == 0) span = list->length;
+    for (size_t i = 0; i < list->length; i += span) {
+        size_t count = (list->length - i < span) ? list->length - i : span;
+        cf((char*)list->items + i * list->item_size, count, list->item_size, ctx);
+    }
+}
+
+void DSC_FUNC(list_foreach_span)(dsc_list* list, size_t span, dsc_span_callback cf, void* ctx) {
+    DSC_FUNC(list_map_span)(list, span, cf, ctx);
+}
+
+dsc_list DSC_FUNC(list_filter_span)(dsc_list* list, size_t span, dsc_span_predicate cf, void* ctx) {
+    dsc_list result = {0};
+
+    if (list == NULL || cf == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return result;
+    }
+    dsc_set_error(DSC_EOK);
+
+    DSC_FUNC(list_init_with_allocator)(&result, list->item_size, list->length, list->allocator);
+    if (DSC_FUNC(get_error)() != DSC_EOK) {
+        return result;
+    }
+    result.growth = list->growth;
+
+    if (span == 0 || span > DSC_LIST_SPAN) span = DSC_LIST_SPAN;
+    unsigned char keep[DSC_LIST_SPAN];
+    size_t        size = list->item_size;
+    char          *dst = (char*)result.items;
+
+    for (size_t i = 0; i < list->length; i += span) {
+        size_t count = (list->length - i < span) ? list->length - i : span;
+        const char *src = (const char*)list->items + i * size;
+        cf(src, count, size, keep, ctx);
+        for (size_t j = 0; j < count; j++) {
+            if (keep[j]) {
+                memcpy(dst, src + j * size, size);
+                dst += size;
+            }
+        }
+    }
+    result.length = (size_t)(dst - (char*)result.items) / size;
+    return result;
+}
+
+typedef struct {
+    dsc_list            *list;
+    dsc_span_callback   cb;
+    void                *ctx;
+} dsc_list_span_job;
+
+static void dsc_list_span_range(void *arg, size_t begin, size_t end) {
+    dsc_list_span_job *job = (dsc_list_span_job *)arg;
+    job->cb((char *)job->list->items + begin * job->list->item_size, end - begin, job->list->item_size, job->ctx);
+}
+
+void DSC_FUNC(list_map_span_parallel)(dsc_list* list, dsc_thread_pool* pool, dsc_span_callback cf, void* ctx) {
+    if (list == NULL || cf == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    dsc_list_span_job job = { list, cf, ctx };
+    DSC_FUNC(thread_pool_parallel_for)(pool, list->length, 0, dsc_list_span_range, &job);
+}
+
+/* Runs at or below this length are finished by insertion sort */
+#define DSC_SORT_INSERTION 16
+
+/* Items up to this size sort with on-stack scratch; larger ones allocate it */
+#define DSC_SORT_LOCAL 64
+
+/* Aligned for any item type whose size fits the buffer */
+typedef union {
+    long double     ld;
+    void            *p;
+    uint64_t        u;
+    unsigned char   bytes[2 * DSC_SORT_LOCAL];
+} dsc_sort_local;
+
+/* Generic sort state: pivot and tmp each hold one item */
+typedef struct {
+    size_t          size;
+    dsc_compare     cmp;
+    unsigned char   *pivot;
+    unsigned char   *tmp;
+} dsc_sort_ctx;
+
+static inline void dsc_sort_swap(const dsc_sort_ctx *s, char *a, char *b) {
+    /* Fixed-size copies for the common widths compile to plain loads and stores */
+    if (s->size == 4) {
+        uint32_t t; memcpy(&t, a, 4); memcpy(a, b, 4); memcpy(b, &t, 4);
+        return;
+    }
+    if (s->size == 8) {
+        uint64_t t; memcpy(&t, a, 8); memcpy(a, b, 8); memcpy(b, &t, 8);
+        return;
+    }
+    memcpy(s->tmp, a, s->size);
+    memcpy(a, b, s->size);
+    memcpy(b, s->tmp, s->size);
+}
+
+/* 2 * floor(log2(n)): the quicksort depth after which heapsort takes over */
+static inline size_t dsc_sort_depth(size_t n) {
+    size_t depth = 0;
+    for (; n > 1; n >>= 1) depth += 2;
+    return depth;
+}
+
+static void dsc_sort_insertion(const dsc_sort_ctx *s, char *a, size_t n) {
+    size_t size = s->size;
+    for (size_t i = 1; i < n; i++) {
+        char *cur = a + i * size;
+        if (s->cmp(cur, cur - size) >= 0) continue;
+
+        /* Find the slot first, then shift the run in one memmove */
+        memcpy(s->tmp, cur, size);
+        size_t j = i - 1;
+        while (j > 0 && s->cmp(s->tmp, a + (j - 1) * size) < 0) j--;
+        memmove(a + (j + 1) * size, a + j * size, (i - j) * size);
+        memcpy(a + j * size, s->tmp, size);
+    }
+}
+
+/* Max-heap sift-down of a[root] within a[0, n) */
+static void dsc_sort_sift(const dsc_sort_ctx *s, char *a, size_t root, size_t n) {
+    size_t size = s->size;
+    for (;;) {
+        size_t child = 2 * root + 1;
+        if (child >= n) return;
+        if (child + 1 < n && s->cmp(a + child * size, a + (child + 1) * size) < 0) child++;
+        if (s->cmp(a + root * size, a + child * size) >= 0) return;
+        dsc_sort_swap(s, a + root * size, a + child * size);
+        root = child;
+    }
+}
+
+/* Pop the max of the heap a[0, n) to the back until it is sorted */
+static void dsc_sort_heap_down(const dsc_sort_ctx *s, char *a, size_t n) {
+    for (size_t i = n; i-- > 1;) {
+        dsc_sort_swap(s, a, a + i * s->size);
+        dsc_sort_sift(s, a, 0, i);
+    }
+}
+
+static void dsc_sort_intro(const dsc_sort_ctx *s, char *a, size_t n, size_t depth) {
+    size_t size = s->size;
+    while (n > DSC_SORT_INSERTION) {
+        if (depth-- == 0) {
+            for (size_t i = n / 2; i-- > 0;) dsc_sort_sift(s, a, i, n);
+            dsc_sort_heap_down(s, a, n);
+            return;
+        }
+
+        /* Median of three; a[0] <= pivot <= a[n-1] bounds both scans below */
+        char *lo = a, *mid = a + (n / 2) * size, *hi = a + (n - 1) * size;
+        if (s->cmp(mid, lo) < 0) dsc_sort_swap(s, mid, lo);
+        if (s->cmp(hi, mid) < 0) {
+            dsc_sort_swap(s, hi, mid);
+            if (s->cmp(mid, lo) < 0) dsc_sort_swap(s, mid, lo);
+        }
+        memcpy(s->pivot, mid, size);
+
+        /* Hoare partition: [0, j] <= pivot <= [j + 1, n) */
+        size_t i = 0, j = n - 1;
+        for (;;) {
+            while (s->cmp(a + i * size, s->pivot) < 0) i++;
+            while (s->cmp(s->pivot, a + j * size) < 0) j--;
+            if (i >= j) break;
+            dsc_sort_swap(s, a + i * size, a + j * size);
+            i++;
+            j--;
+        }
+
+        /* Recurse into the smaller side so the stack stays O(log n) */
+        size_t left = j + 1;
+        if (left < n - left) {
+            dsc_sort_intro(s, a, left, depth);
+            a += left * size;
+            n -= left;
+        } else {
+            dsc_sort_intro(s, a + left * size, n - left, depth);
+            n = left;
+        }
+    }
+    dsc_sort_insertion(s, a, n);
+}
+
+/* Point ctx's scratch at local, or allocate it for large items */
+static bool dsc_sort_begin(dsc_sort_ctx *s, const dsc_list *list, dsc_compare cmp, dsc_sort_local *local) {
+    s->size = list->item_size;
+    s->cmp  = cmp;
+    unsigned char *scratch = local->bytes;
+    if (list->item_size > DSC_SORT_LOCAL) {
+        scratch = (unsigned char *)dsc_mem_alloc(list->allocator, 2 * list->item_size);
+        if (scratch == NULL) return false;
+    }
+    s->pivot = scratch;
+    s->tmp   = scratch + list->item_size;
+    return true;
+}
+
+static void dsc_sort_end(dsc_sort_ctx *s, const dsc_list *list, dsc_sort_local *local) {
+    if (s->pivot != local->bytes) dsc_mem_free(list->allocator, s->pivot, 2 * list->item_size);
+}
+
+void DSC_FUNC(list_sort)(dsc_list* list, dsc_compare cmp) {
+    if (list == NULL || cmp == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (list->length < 2) return;
+
+    dsc_sort_ctx   s;
+    dsc_sort_local local;
+    if (!dsc_sort_begin(&s, list, cmp, &local)) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    dsc_sort_intro(&s, (char *)list->items, list->length, dsc_sort_depth(list->length));
+    dsc_sort_end(&s, list, &local);
+}
+
+typedef struct {
+    char            *src;
+    char            *dst;
+    unsigned char   *scratch;   /* Two items of pivot/tmp space per run */
+    size_t          size;
+    size_t          n;
+    size_t          width;      /* Run length this round */
+    size_t          segments;   /* Merge-path slices per pair of runs */
+    dsc_compare     cmp;
+} dsc_sort_job;
+
+static void dsc_sort_runs(void *arg, size_t first, size_t last) {
+    dsc_sort_job *job = (dsc_sort_job *)arg;
+    for (size_t r = first; r < last; r++) {
+        size_t begin = r * job->width;
+        if (begin >= job->n) break;
+        size_t len = (job->n - begin < job->width) ? job->n - begin : job->width;
+
+        dsc_sort_ctx s = { job->size, job->cmp, job->scratch + r * 2 * job->size, job->scratch + (r * 2 + 1) * job->size };
+        dsc_sort_intro(&s, job->src + begin * job->size, len, dsc_sort_depth(len));
+    }
+}
+
+/*
+ * Merge-path split: how many of the first d outputs of merging a (na items)
+ * with b come from a. Ties go to a, which keeps the merge stable.
+ */
+static size_t dsc_sort_corank(const dsc_sort_job *job, const char *a, size_t na, const char *b, size_t nb, size_t d) {
+    size_t lo = (d > nb) ? d - nb : 0;
+    size_t hi = (d < na) ? d : na;
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        if (job->cmp(b + (d - i - 1) * job->size, a + i * job->size) >= 0) lo = i + 1;
+        else hi = i;
+    }
+    return lo;
+}
+
+static void dsc_sort_merge(void *arg, size_t first, size_t last) {
+    dsc_sort_job *job  = (dsc_sort_job *)arg;
+    size_t       size  = job->size;
+    for (size_t t = first; t < last; t++) {
+        size_t begin = (t / job->segments) * 2 * job->width;
+        size_t seg   = t % job->segments;
+        if (begin >= job->n) break;
+
+        size_t na = (job->n - begin < job->width) ? job->n - begin : job->width;
+        size_t nb = (job->n - begin - na < job->width) ? job->n - begin - na : job->width;
+        const char *a = job->src + begin * size;
+        const char *b = a + na * size;
+
+        size_t d0 = (na + nb) * seg / job->segments;
+        size_t d1 = (na + nb) * (seg + 1) / job->segments;
+        size_t i  = dsc_sort_corank(job, a, na, b, nb, d0);
+        size_t i1 = dsc_sort_corank(job, a, na, b, nb, d1);
+        size_t j  = d0 - i, j1 = d1 - i1;
+
+        char *out = job->dst + (begin + d0) * size;
+        while (i < i1 && j < j1) {
+            const char *take = (job->cmp(b + j * size, a + i * size) < 0) ? b + (j++) * size : a + (i++) * size;
+            memcpy(out, take, size);
+            out += size;
+        }
+        memcpy(out, a + i * size, (i1 - i) * size);
+        out += (i1 - i) * size;
+        memcpy(out, b + j * size, (j1 - j) * size);
+    }
+}
+
+void DSC_FUNC(list_sort_parallel)(dsc_list* list, dsc_thread_pool* pool, dsc_compare cmp) {
+    if (list == NULL || cmp == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    size_t n       = list->length;
+    size_t threads = ((pool != NULL) ? pool->thread_count : 0) + 1;
+    if (threads < 2 || n < 2 * DSC_POOL_MIN_CHUNK) {
+        DSC_FUNC(list_sort)(list, cmp);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    /* A power-of-two run count makes every merge round pair runs evenly */
+    size_t runs = 2;
+    while (runs < threads && n / (runs * 2) >= DSC_POOL_MIN_CHUNK) runs *= 2;
+
+    size_t size = list->item_size, bytes;
+    if (dsc_add_overflow(n, 2 * runs, &bytes) || dsc_mul_overflow(bytes, size, &bytes)) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    char *buffer = (char *)dsc_mem_alloc(list->allocator, bytes);
+    if (buffer == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+
+    dsc_sort_job job = { (char *)list->items, buffer, (unsigned char *)buffer + n * size, size, n, (n + runs - 1) / runs, 1, cmp };
+    DSC_FUNC(thread_pool_parallel_for)(pool, runs, 1, dsc_sort_runs, &job);
+
+    /* Each round halves the run count; slice the merges so there is always work for every thread */
+    for (; job.width < n; job.width *= 2) {
+        size_t pairs = (n + 2 * job.width - 1) / (2 * job.width);
+        job.segments = (threads * 4 + pairs - 1) / pairs;
+        DSC_FUNC(thread_pool_parallel_for)(pool, pairs * job.segments, 1, dsc_sort_merge, &job);
+
+        char *t = job.src; job.src = job.dst; job.dst = t;
+    }
+
+    if (job.src != (char *)list->items) memcpy(list->items, job.src, n * size);
+    dsc_mem_free(list->allocator, buffer, bytes);
+}
+
+/* Key of an item, remapped so unsigned order matches numeric order */
+static inline uint64_t dsc_radix_key(const unsigned char *item, dsc_sort_key key) {
+    uint32_t u32;
+    uint64_t u64;
+    switch (key) {
+    case DSC_SORT_U32: memcpy(&u32, item, 4); return u32;
+    case DSC_SORT_I32: memcpy(&u32, item, 4); return u32 ^ 0x80000000u;
+    case DSC_SORT_F32: memcpy(&u32, item, 4); return (u32 & 0x80000000u) ? (uint32_t)~u32 : (u32 | 0x80000000u);
+    case DSC_SORT_U64: memcpy(&u64, item, 8); return u64;
+    case DSC_SORT_I64: memcpy(&u64, item, 8); return u64 ^ 0x8000000000000000ULL;
+    case DSC_SORT_F64: memcpy(&u64, item, 8); return (u64 & 0x8000000000000000ULL) ? ~u64 : (u64 | 0x8000000000000000ULL);
+    }
+    return 0;
+}
+
+/* Short lists skip the histograms and the scratch copy */
+#define DSC_SORT_RADIX_MIN 64
+
+void DSC_FUNC(list_sort_keys)(dsc_list* list, dsc_sort_key key, size_t key_offset) {
+    size_t width = (key == DSC_SORT_U64 || key == DSC_SORT_I64 || key == DSC_SORT_F64) ? 8 : 4;
+    if (list == NULL || (int)key < (int)DSC_SORT_U32 || (int)key > (int)DSC_SORT_F64 ||
+        key_offset > list->item_size || list->item_size - key_offset < width) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    size_t         n    = list->length;
+    size_t         size = list->item_size;
+    unsigned char  *items = (unsigned char *)list->items;
+    if (n < 2) return;
+
+    if (n < DSC_SORT_RADIX_MIN && size <= DSC_SORT_LOCAL) {
+        /* Stable insertion sort on the remapped keys */
+        dsc_sort_local tmp;
+        for (size_t i = 1; i < n; i++) {
+            uint64_t k = dsc_radix_key(items + i * size + key_offset, key);
+            size_t   j = i;
+            while (j > 0 && dsc_radix_key(items + (j - 1) * size + key_offset, key) > k) j--;
+            if (j == i) continue;
+            memcpy(tmp.bytes, items + i * size, size);
+            memmove(items + (j + 1) * size, items + j * size, (i - j) * size);
+            memcpy(items + j * size, tmp.bytes, size);
+        }
+        return;
+    }
+
+    size_t bytes;
+    if (dsc_mul_overflow(n, size, &bytes)) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    unsigned char *scratch = (unsigned char *)dsc_mem_alloc(list->allocator, bytes);
+    if (scratch == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+
+    /* One read pass builds the histogram of every digit */
+    size_t counts[8][256];
+    memset(counts, 0, sizeof(counts));
+    for (size_t i = 0; i < n; i++) {
+        uint64_t k = dsc_radix_key(items + i * size + key_offset, key);
+        for (size_t p = 0; p < width; p++) counts[p][(k >> (p * 8)) & 0xff]++;
+    }
+
+    uint64_t      first = dsc_radix_key(items + key_offset, key);
+    unsigned char *src  = items, *dst = scratch;
+    for (size_t p = 0; p < width; p++) {
+        /* Every key shares this byte: the pass would not move anything */
+        if (counts[p][(first >> (p * 8)) & 0xff] == n) continue;
+
+        size_t offset = 0;
+        for (size_t d = 0; d < 256; d++) {
+            size_t c    = counts[p][d];
+            counts[p][d] = offset;
+            offset      += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            const unsigned char *item = src + i * size;
+            size_t d = (size_t)(dsc_radix_key(item + key_offset, key) >> (p * 8)) & 0xff;
+            memcpy(dst + (counts[p][d]++) * size, item, size);
+        }
+        unsigned char *t = src; src = dst; dst = t;
+    }
+
+    if (src != items) memcpy(items, src, bytes);
+    dsc_mem_free(list->allocator, scratch, bytes);
+}
+
+size_t DSC_FUNC(list_lower_bound)(dsc_list* list, const void* key, dsc_compare cmp) {
+    if (list == NULL || key == NULL || cmp == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    dsc_set_error(DSC_EOK);
+
+    const char *items = (const char *)list->items;
+    size_t lo = 0, n = list->length;
+    while (n > 0) {
+        size_t half = n / 2;
+        if (cmp(items + (lo + half) * list->item_size, key) < 0) {
+            lo += half + 1;
+            n  -= half + 1;
+        } else {
+            n = half;
+        }
+    }
+    return lo;
+}
+
+void* DSC_FUNC(list_binary_search)(dsc_list* list, const void* key, dsc_compare cmp) {
+    size_t i = DSC_FUNC(list_lower_bound)(list, key, cmp);
+    if (DSC_FUNC(get_error)() != DSC_EOK) return NULL;
+
+    char *item = (char *)list->items + i * list->item_size;
+    if (i == list->length || cmp(item, key) != 0) {
+        dsc_set_error(DSC_ENOTFOUND);
+        return NULL;
+    }
+    return item;
+}
+
+/* Heap select: keep the k smallest in a max-heap at the front, then sort it */
+void DSC_FUNC(list_partial_sort)(dsc_list* list, size_t k, dsc_compare cmp) {
+    if (list == NULL || cmp == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (k >= list->length) {
+        DSC_FUNC(list_sort)(list, cmp);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (k == 0) return;
+
+    dsc_sort_ctx   s;
+    dsc_sort_local local;
+    if (!dsc_sort_begin(&s, list, cmp, &local)) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+
+    char *a = (char *)list->items;
+    for (size_t i = k / 2; i-- > 0;) dsc_sort_sift(&s, a, i, k);
+    for (size_t i = k; i < list->length; i++) {
+        char *item = a + i * s.size;
+        if (cmp(item, a) < 0) {
+            dsc_sort_swap(&s, item, a);
+            dsc_sort_sift(&s, a, 0, k);
+        }
+    }
+    dsc_sort_heap_down(&s, a, k);
+    dsc_sort_end(&s, list, &local);
+}
+
+void DSC_FUNC(list_from_array)(dsc_list* list, const void* array, size_t count, size_t item_size) {
+    dsc_set_error(DSC_EOK);
+
+    if (list == NULL || array == NULL || item_size == 0) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    DSC_FUNC(list_init)(list, item_size, count);
+    if (DSC_FUNC(get_error)() != DSC_EOK) {
+        return;
+    }
+    DSC_FUNC(list_append_n)(list, array, count);
+}
+
+dsc_set DSC_FUNC(list_to_set)(dsc_list* list, dsc_hashfunc* hf, dsc_cmpfunc* cf) {
+    dsc_set result = {0};
+    
+    if (list == NULL || hf == NULL || cf == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return result;
+    }
+    dsc_set_error(DSC_EOK);
+
+    DSC_FUNC(set_init)(&result, list->length, list->item_size, hf, cf);
+    if (DSC_FUNC(get_error)() != DSC_EOK) {
+        return result;
+    }
+
+    for (size_t i = 0; i < list->length; i++) {
+        void* item = (char*)list->items + (i * list->item_size);
+        DSC_FUNC(set_add)(&result, item);
+    }
+    return result;
+}
+
+bool DSC_FUNC(list_has_duplicates)(dsc_list* list, dsc_hashfunc* hf, dsc_cmpfunc* cf) {
+    if (list == NULL || hf == NULL || cf == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    dsc_set_error(DSC_EOK);
+
+    dsc_set temp_set;
+    DSC_FUNC(set_init)(&temp_set, list->length, list->item_size, hf, cf);
+    if (DSC_FUNC(get_error)() != DSC_EOK) {
+        return false;
+    }
+
+    bool has_duplicates = false;
+    for (size_t i = 0; i < list->length; i++) {
+        void* item = (char*)list->items + (i * list->item_size);
+        if (!DSC_FUNC(set_add)(&temp_set, item)) {
+            /* If add fails due to existing item, we found a duplicate */
+            if (DSC_FUNC(get_error)() == DSC_EEXISTS) {
+                has_duplicates = true;
+                break;
+            }
+        }
+    }
+
+    DSC_FUNC(set_destroy)(&temp_set);
+    dsc_set_error(DSC_EOK);
+    return has_duplicates;
+}
+
+/*
+ * +----------------------------------------------------------------+
+ * |                 SOA (COLUMNAR) LIST Implementation             |
+ * +----------------------------------------------------------------+
+ */
+
+/* Column starts are kept on cache-line boundaries inside the block */
+#define DSC_SOA_ALIGN 64
+
+static inline size_t dsc_soa_round(size_t n) {
+    return (n + DSC_SOA_ALIGN - 1) & ~(size_t)(DSC_SOA_ALIGN - 1);
+}
+
+/* Bytes for a block of capacity rows, or 0 on overflow */
+static size_t dsc_soa_block_size(const dsc_soa_list *soa, size_t capacity) {
+    size_t total = DSC_SOA_ALIGN;   /* Slack to align the first column */
+    for (size_t c = 0; c < soa->ncolumns; c++) {
+        size_t bytes;
+        if (dsc_mul_overflow(capacity, soa->columns[c].size, &bytes) || bytes > SIZE_MAX - DSC_SOA_ALIGN ||
+            dsc_add_overflow(total, dsc_soa_round(bytes), &total)) {
+            return 0;
+        }
+    }
+    return total;
+}
+
+/* Move every column into a new block of capacity rows */
+static bool dsc_soa_regrow(dsc_soa_list *soa, size_t capacity) {
+    size_t bytes = dsc_soa_block_size(soa, capacity);
+    if (bytes == 0) return false;
+
+    void *block = dsc_mem_alloc(soa->allocator, bytes);
+    if (block == NULL) return false;
+
+    char *data = (char *)(((uintptr_t)block + DSC_SOA_ALIGN - 1) & ~(uintptr_t)(DSC_SOA_ALIGN - 1));
+    for (size_t c = 0; c < soa->ncolumns; c++) {
+        dsc_soa_column *col = &soa->columns[c];
+        if (soa->length != 0) memcpy(data, col->data, soa->length * col->size);
+        col->data = data;
+        data += dsc_soa_round(capacity * col->size);
+    }
+
+    dsc_mem_free(soa->allocator, soa->block, soa->block_size);
+    soa->block      = block;
+    soa->block_size = bytes;
+    soa->capacity   = capacity;
+    return true;
+}
+
+/* Room for `incoming` more rows, doubling like dsc_list */
+static bool dsc_soa_reserve_more(dsc_soa_list *soa, size_t incoming) {
+    size_t need;
+    if (dsc_add_overflow(soa->length, incoming, &need)) return false;
+    if (need <= soa->capacity) return true;
+
+    size_t capacity = (soa->capacity < 8) ? 8 : soa->capacity;
+    while (capacity < need) {
+        if (capacity > SIZE_MAX / 2) {
+            capacity = need;
+            break;
+        }
+        capacity *= 2;
+    }
+    return dsc_soa_regrow(soa, capacity);
+}
+
+static void dsc_soa_scatter(dsc_soa_list *soa, size_t index, const void *record) {
+    for (size_t c = 0; c < soa->ncolumns; c++) {
+        const dsc_soa_column *col = &soa->columns[c];
+        memcpy((char *)col->data + index * col->size, (const char *)record + col->offset, col->size);
+    }
+}
+
+static void dsc_soa_gather(const dsc_soa_list *soa, size_t index, void *record) {
+    for (size_t c = 0; c < soa->ncolumns; c++) {
+        const dsc_soa_column *col = &soa->columns[c];
+        memcpy((char *)record + col->offset, (const char *)col->data + index * col->size, col->size);
+    }
+}
+
+void DSC_FUNC(soa_list_init)(dsc_soa_list* soa, size_t record_size, const dsc_soa_field* fields, size_t nfields, size_t initial_capacity) {
+    DSC_FUNC(soa_list_init_with_allocator)(soa, record_size, fields, nfields, initial_capacity, NULL);
+}
+
+void DSC_FUNC(soa_list_init_with_allocator)(dsc_soa_list* soa, size_t record_size, const dsc_soa_field* fields, size_t nfields, size_t initial_capacity, const dsc_allocator* allocator) {
+    if (soa == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    *soa = (dsc_soa_list){0};
+
+    if (fields == NULL || nfields == 0 || record_size == 0) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    for (size_t c = 0; c < nfields; c++) {
+        if (fields[c].size == 0 || fields[c].offset > record_size || record_size - fields[c].offset < fields[c].size) {
+            dsc_set_error(DSC_EINVAL);
+            return;
+        }
+    }
+
+    dsc_soa_column *columns = (dsc_soa_column *)dsc_mem_alloc(allocator, nfields * sizeof(dsc_soa_column));
+    if (columns == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    for (size_t c = 0; c < nfields; c++) {
+        columns[c] = (dsc_soa_column){ NULL, fields[c].size, fields[c].offset };
+    }
+
+    *soa = (dsc_soa_list) {
+        .columns     = columns,
+        .ncolumns    = nfields,
+        .record_size = record_size,
+        .allocator   = allocator
+    };
+
+    if (initial_capacity != 0 && !dsc_soa_regrow(soa, initial_capacity)) {
+        dsc_mem_free(allocator, columns, nfields * sizeof(dsc_soa_column));
+        *soa = (dsc_soa_list){0};
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+}
+
+void DSC_FUNC(soa_list_destroy)(dsc_soa_list* soa) {
+    if (soa == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    dsc_mem_free(soa->allocator, soa->block, soa->block_size);
+    dsc_mem_free(soa->allocator, soa->columns, soa->ncolumns * sizeof(dsc_soa_column));
+    *soa = (dsc_soa_list){0};
+}
+
+void DSC_FUNC(soa_list_clear)(dsc_soa_list* soa) {
+    if (soa == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    soa->length = 0;
+}
+
+void DSC_FUNC(soa_list_reserve)(dsc_soa_list* soa, size_t capacity) {
+    if (soa == NULL || soa->columns == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (capacity > soa->capacity && !dsc_soa_regrow(soa, capacity)) {
+        dsc_set_error(DSC_ENOMEM);
+    }
+}
+
+void DSC_FUNC(soa_list_append)(dsc_soa_list* soa, const void* record) {
+    DSC_FUNC(soa_list_append_n)(soa, record, 1);
+}
+
+/* Scatters column by column, so each column is written as one sequential run */
+void DSC_FUNC(soa_list_append_n)(dsc_soa_list* soa, const void* records, size_t count) {
+    if (soa == NULL || soa->columns == NULL || (records == NULL && count != 0)) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (!dsc_soa_reserve_more(soa, count)) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+
+    for (size_t c = 0; c < soa->ncolumns; c++) {
+        const dsc_soa_column *col = &soa->columns[c];
+        char       *dst = (char *)col->data + soa->length * col->size;
+        const char *src = (const char *)records + col->offset;
+        for (size_t i = 0; i < count; i++, dst += col->size, src += soa->record_size) {
+            memcpy(dst, src, col->size);
+        }
+    }
+    soa->length += count;
+}
+
+void* DSC_FUNC(soa_list_get)(dsc_soa_list* soa, size_t index, void* out) {
+    if (soa == NULL || out == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+    if (index >= soa->length) {
+        dsc_set_error(DSC_ERANGE);
+        return NULL;
+    }
+    dsc_set_error(DSC_EOK);
+
+    dsc_soa_gather(soa, index, out);
+    return out;
+}
+
+void DSC_FUNC(soa_list_set)(dsc_soa_list* soa, size_t index, const void* record) {
+    if (soa == NULL || record == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (index >= soa->length) {
+        dsc_set_error(DSC_ERANGE);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    dsc_soa_scatter(soa, index, record);
+}
+
+void DSC_FUNC(soa_list_pop)(dsc_soa_list* soa) {
+    if (soa == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (soa->length == 0) {
+        dsc_set_error(DSC_EEMPTY);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    soa->length--;
+}
+
+void* DSC_FUNC(soa_list_column)(dsc_soa_list* soa, size_t column) {
+    if (soa == NULL || column >= soa->ncolumns) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+    dsc_set_error(DSC_EOK);
+
+    return soa->columns[column].data;
+}
+
+void DSC_FUNC(soa_list_map_column)(dsc_soa_list* soa, size_t column, size_t span, dsc_span_callback cf, void* ctx) {
+    if (soa == NULL || column >= soa->ncolumns || cf == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    const dsc_soa_column *col = &soa->columns[column];
+    if (span == 0) span = soa->length;
+    for (size_t i = 0; i < soa->length; i += span) {
+        size_t count = (soa->length - i < span) ? soa->length - i : span;
+        cf((char *)col->data + i * col->size, count, col->size, ctx);
+    }
+}
+
+void DSC_FUNC(soa_list_reduce_column)(dsc_soa_list* soa, size_t column, size_t span, dsc_span_reducer cf, void* acc, void* ctx) {
+    if (soa == NULL || column >= soa->ncolumns || cf == NULL || acc == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    const dsc_soa_column *col = &soa->columns[column];
+    if (span == 0) span = soa->length;
+    for (size_t i = 0; i < soa->length; i += span) {
+        size_t count = (soa->length - i < span) ? soa->length - i : span;
+        cf(acc, (const char *)col->data + i * col->size, count, col->size, ctx);
+    }
+}
+
+/*
+ * The predicate only ever sees the tested column. Its keep mask is built a
+ * block at a time, then each column is compacted in its own sequential pass.
+ */
+dsc_soa_list DSC_FUNC(soa_list_filter)(dsc_soa_list* soa, size_t column, dsc_span_predicate cf, void* ctx) {
+    dsc_soa_list result = {0};
+
+    if (soa == NULL || column >= soa->ncolumns || cf == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return result;
+    }
+
+    size_t n = soa->length;
+    unsigned char *keep = (unsigned char *)dsc_mem_alloc(soa->allocator, n + 1);
+    if (keep == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return result;
+    }
+
+    const dsc_soa_column *tested = &soa->columns[column];
+    size_t kept = 0;
+    for (size_t i = 0; i < n; i += DSC_LIST_SPAN) {
+        size_t count = (n - i < DSC_LIST_SPAN) ? n - i : DSC_LIST_SPAN;
+        cf((const char *)tested->data + i * tested->size, count, tested->size, keep + i, ctx);
+        for (size_t j = 0; j < count; j++) kept += (keep[i + j] != 0);
+    }
+
+    /* Same layout as the source: rebuild the field list from its columns */
+    dsc_soa_field local[8];
+    dsc_soa_field *fields = local;
+    if (soa->ncolumns > 8) {
+        fields = (dsc_soa_field *)dsc_mem_alloc(soa->allocator, soa->ncolumns * sizeof(dsc_soa_field));
+        if (fields == NULL) {
+            dsc_mem_free(soa->allocator, keep, n + 1);
+            dsc_set_error(DSC_ENOMEM);
+            return result;
+        }
+    }
+    for (size_t c = 0; c < soa->ncolumns; c++) {
+        fields[c] = (dsc_soa_field){ soa->columns[c].offset, soa->columns[c].size };
+    }
+    DSC_FUNC(soa_list_init_with_allocator)(&result, soa->record_size, fields, soa->ncolumns, kept, soa->allocator);
+    if (fields != local) dsc_mem_free(soa->allocator, fields, soa->ncolumns * sizeof(dsc_soa_field));
+
+    if (DSC_FUNC(get_error)() == DSC_EOK) {
+        for (size_t c = 0; c < soa->ncolumns; c++) {
+            size_t     size = soa->columns[c].size;
+            const char *src = (const char *)soa->columns[c].data;
+            char       *dst = (char *)result.columns[c].data;
+            for (size_t i = 0; i < n; i++, src += size) {
+                if (keep[i]) {
+                    memcpy(dst, src, size);
+                    dst += size;
+                }
+            }
+        }
+        result.length = kept;
+    }
+
+    dsc_mem_free(soa->allocator, keep, n + 1);
+    return result;
+}
+
+dsc_list DSC_FUNC(soa_list_to_list)(dsc_soa_list* soa) {
+    dsc_list result = {0};
+
+    if (soa == NULL || soa->columns == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return result;
+    }
+
+    DSC_FUNC(list_init_with_allocator)(&result, soa->record_size, soa->length, soa->allocator);
+    if (DSC_FUNC(get_error)() != DSC_EOK) {
+        return result;
+    }
+
+    /* Bytes not covered by a column read back as zero */
+    if (soa->length != 0) memset(result.items, 0, soa->length * soa->record_size);
+    for (size_t c = 0; c < soa->ncolumns; c++) {
+        const dsc_soa_column *col = &soa->columns[c];
+        const char *src = (const char *)col->data;
+        char       *dst = (char *)result.items + col->offset;
+        for (size_t i = 0; i < soa->length; i++, src += col->size, dst += soa->record_size) {
+            memcpy(dst, src, col->size);
+        }
+    }
+    result.length = soa->length;
+    return result;
+}
+
+void DSC_FUNC(soa_list_from_list)(dsc_soa_list* soa, dsc_list* list, const dsc_soa_field* fields, size_t nfields) {
+    if (soa == NULL || list == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    DSC_FUNC(soa_list_init_with_allocator)(soa, list->item_size, fields, nfields, list->length, list->allocator);
+    if (DSC_FUNC(get_error)() != DSC_EOK) {
+        return;
+    }
+    DSC_FUNC(soa_list_append_n)(soa, list->items, list->length);
+}
+
+/*
+ * +----------------------------------------------------------------+
+ * |                     Set Implementation                         |
+ * +----------------------------------------------------------------+
+ */
+
+/*
+ * Nodes hold no value, only [ dsc_set_node | key ]. Variable-length sets
+ * (key_size 0) store the key length in front of the key bytes.
+ */
+static inline size_t dsc_set_node_header(const dsc_set *set) {
+    return sizeof(dsc_set_node) + ((set->key_size == 0) ? sizeof(size_t) : 0);
+}
+
+static inline void *dsc_set_node_key(const dsc_set *set, const dsc_set_node *node) {
+    return (unsigned char *)(uintptr_t)(node + 1) + ((set->key_size == 0) ? sizeof(size_t) : 0);
+}
+
+static inline size_t dsc_set_node_len(const dsc_set *set, const dsc_set_node *node) {
+    return (set->key_size != 0) ? set->key_size : *(const size_t *)(const void *)(node + 1);
+}
+
+static inline size_t dsc_set_item_len(const dsc_set *set, const void *item) {
+    return (set->key_size != 0) ? set->key_size : strlen((const char *)item) + 1;
+}
+
+static dsc_set_node **dsc_set_find_link(const dsc_set *set, const void *key, size_t len, uint64_t hash) {
+    if (set->filter != NULL && !dsc_bloom_test(set->filter, hash)) return NULL;
+
+    dsc_set_node **link = &set->buckets[dsc_ht_bucket(hash, set->capacity)];
+
+    /* Cached hashes first; cf only runs on a full hash match */
+    while (*link != NULL) {
+        dsc_set_node *node = *link;
+        if (node->hash == hash && set->cf(dsc_set_node_key(set, node), dsc_set_node_len(set, node), key, len) == 0) {
+            return link;
+        }
+        link = &node->next;
+    }
+    return NULL;
+}
+
+/* Walk every node; bucket is the cursor */
+static dsc_set_node *dsc_set_next_node(const dsc_set *set, size_t *bucket, const dsc_set_node *node) {
+    if (node != NULL && node->next != NULL) return node->next;
+
+    for (size_t b = (node == NULL) ? *bucket : *bucket + 1; b < set->capacity; b++) {
+        if (set->buckets[b] != NULL) {
+            *bucket = b;
+            return set->buckets[b];
+        }
+    }
+    *bucket = set->capacity;
+    return NULL;
+}
+
+/* Relink every node into a new bucket array using the cached hashes */
+static bool dsc_set_resize(dsc_set *set, size_t capacity) {
+    dsc_set_node **buckets = (dsc_set_node **)dsc_mem_calloc(set->allocator, capacity, sizeof(dsc_set_node *));
+    if (buckets == NULL) return false;
+
+    for (size_t b = 0; b < set->capacity; b++) {
+        dsc_set_node *node = set->buckets[b];
+        while (node != NULL) {
+            dsc_set_node *next  = node->next;
+            size_t        index = dsc_ht_bucket(node->hash, capacity);
+            node->next      = buckets[index];
+            buckets[index]  = node;
+            node = next;
+        }
+    }
+
+    dsc_mem_free(set->allocator, set->buckets, set->capacity * sizeof(dsc_set_node *));
+    set->buckets  = buckets;
+    set->capacity = capacity;
+    return true;
+}
+
+/* Same trigger as the hash table: grow once the load factor is crossed */
+static inline bool dsc_set_maybe_grow(dsc_set *set) {
+    if ((float)set->size / set->capacity <= 0.75) return true;
+    if (set->capacity > SIZE_MAX / 2 / sizeof(dsc_set_node *)) return false;
+    return dsc_set_resize(set, set->capacity * 2);
+}
+
+/* Same hysteresis as dsc_ht_maybe_shrink: at most half full afterwards */
+static void dsc_set_maybe_shrink(dsc_set *set) {
+    if (set->shrink_percent == 0 || set->capacity <= set->min_capacity) return;
+    if ((float)set->size / set->capacity * 100 >= set->shrink_percent) return;
+
+    size_t target = dsc_ht_round_pow2(set->size * 2);
+    if (target < set->min_capacity) target = set->min_capacity;
+    if (target < set->capacity) dsc_set_resize(set, target);
+}
+
+/* Allocate and link a node for a key known to be absent */
+static dsc_set_node *dsc_set_link_new(dsc_set *set, const void *key, size_t len, uint64_t hash) {
+    size_t bytes;
+    if (dsc_add_overflow(dsc_set_node_header(set), len, &bytes)) return NULL;
+
+    dsc_set_node *node = (dsc_set_node *)dsc_mem_alloc(set->allocator, bytes);
+    if (node == NULL) return NULL;
+
+    node->hash = hash;
+    if (set->key_size == 0) *(size_t *)(void *)(node + 1) = len;
+    memcpy(dsc_set_node_key(set, node), key, len);
+
+    size_t index = dsc_ht_bucket(hash, set->capacity);
+    node->next = set->buckets[index];
+    set->buckets[index] = node;
+    set->size++;
+
+    if (set->filter != NULL) dsc_bloom_set(set->filter, hash);
+    return node;
+}
+
+static void dsc_set_unlink(dsc_set *set, dsc_set_node **link) {
+    dsc_set_node *node = *link;
+    *link = node->next;
+
+    dsc_mem_free(set->allocator, node, dsc_set_node_header(set) + dsc_set_node_len(set, node));
+    set->size--;
+}
+
+static void dsc_set_free_nodes(dsc_set *set) {
+    /* Bulk-release allocators: nothing to visit per node */
+    if (dsc_mem_needs_free(set->allocator)) {
+        for (size_t b = 0; b < set->capacity; b++) {
+            dsc_set_node **link = &set->buckets[b];
+            while (*link != NULL) dsc_set_unlink(set, link);
+        }
+    }
+    memset(set->buckets, 0, set->capacity * sizeof(dsc_set_node *));
+    set->size = 0;
+}
+
+void DSC_FUNC(set_init)(dsc_set* set, size_t initial_capacity, size_t key_size, dsc_hashfunc* hf, dsc_cmpfunc* cf) {
+    DSC_FUNC(set_init_with_allocator)(set, initial_capacity, key_size, hf, cf, NULL);
+}
+
+void DSC_FUNC(set_init_with_allocator)(dsc_set* set, size_t initial_capacity, size_t key_size, dsc_hashfunc* hf, dsc_cmpfunc* cf, const dsc_allocator* allocator) {
+    dsc_set_error(DSC_EOK);
+
+    if (set == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    *set = (dsc_set){0};
+
+    if (hf == NULL) {
+        dsc_set_error(DSC_EHASHFUNC);
+        return;
+    }
+    if (cf == NULL) {
+        dsc_set_error(DSC_ECMPFUNC);
+        return;
+    }
+
+    size_t capacity = dsc_ht_round_pow2((initial_capacity != 0) ? initial_capacity : 1);
+    dsc_set_node **buckets = (capacity != 0) ? (dsc_set_node **)dsc_mem_calloc(allocator, capacity, sizeof(dsc_set_node *)) : NULL;
+    if (buckets == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+
+    *set = (dsc_set) {
+        .capacity  = capacity,
+        .min_capacity = capacity,
+        .key_size  = key_size,
+        .hf        = hf,
+        .cf        = cf,
+        .buckets   = buckets,
+        .allocator = allocator
+    };
+}
+
+void DSC_FUNC(set_destroy)(dsc_set* set) {
+    if (set == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (set->buckets != NULL) {
+        dsc_set_free_nodes(set);
+        dsc_mem_free(set->allocator, set->buckets, set->capacity * sizeof(dsc_set_node *));
+    }
+    *set = (dsc_set){0};
+}
+
+bool DSC_FUNC(set_add)(dsc_set* set, const void* item) {
+    dsc_set_error(DSC_EOK);
+
+    if (set == NULL || set->buckets == NULL || item == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+
+    if (!dsc_set_maybe_grow(set)) {
+        dsc_set_error(DSC_ENOMEM);
+        return false;
+    }
+
+    size_t   len  = dsc_set_item_len(set, item);
+    uint64_t hash = set->hf(item, len);
+    if (dsc_set_find_link(set, item, len, hash) != NULL) {
+        dsc_set_error(DSC_EEXISTS);
+        return false;
+    }
+
+    if (dsc_set_link_new(set, item, len, hash) == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return false;
+    }
+    return true;
+}
+
+void DSC_FUNC(set_remove)(dsc_set* set, const void* item) {
+    dsc_set_error(DSC_EOK);
+
+    if (set == NULL || set->buckets == NULL || item == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    size_t len = dsc_set_item_len(set, item);
+    dsc_set_node **link = dsc_set_find_link(set, item, len, set->hf(item, len));
+    if (link == NULL) {
+        dsc_set_error(DSC_ENOTFOUND);
+        return;
+    }
+    dsc_set_unlink(set, link);
+    dsc_set_maybe_shrink(set);
+}
+
+/* Returns the set's own copy of the item, valid until it is removed */
+void* DSC_FUNC(set_get)(dsc_set* set, const void* item) {
+    dsc_set_error(DSC_EOK);
+
+    if (set == NULL || set->buckets == NULL || item == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+
+    size_t len = dsc_set_item_len(set, item);
+    dsc_set_node **link = dsc_set_find_link(set, item, len, set->hf(item, len));
+    if (link == NULL) {
+        dsc_set_error(DSC_ENOTFOUND);
+        return NULL;
+    }
+    return dsc_set_node_key(set, *link);
+}
+
+bool DSC_FUNC(set_contains_unchecked)(dsc_set* set, const void* item) {
+    size_t len = dsc_set_item_len(set, item);
+    return dsc_set_find_link(set, item, len, set->hf(item, len)) != NULL;
+}
+
+void DSC_FUNC(set_clear)(dsc_set* set) {
+    if (set == NULL || set->buckets == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    dsc_set_free_nodes(set);
+    dsc_set_maybe_shrink(set);
+    if (set->filter != NULL) DSC_FUNC(bloom_clear)(set->filter);
+}
+
+void DSC_FUNC(set_set_shrink)(dsc_set* set, size_t low_percent) {
+    if (set == NULL || low_percent > 50) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    set->shrink_percent = low_percent;
+}
+
+bool DSC_FUNC(set_reserve)(dsc_set* set, size_t count) {
+    if (set == NULL || set->buckets == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    dsc_set_error(DSC_EOK);
+
+    size_t target = dsc_ht_fit_capacity(count);
+    if (target == 0 || (target > set->capacity && !dsc_set_resize(set, target))) {
+        dsc_set_error(DSC_ENOMEM);
+        return false;
+    }
+    if (set->min_capacity < target) set->min_capacity = target;
+    return true;
+}
+
+bool DSC_FUNC(set_compact)(dsc_set* set) {
+    if (set == NULL || set->buckets == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    dsc_set_error(DSC_EOK);
+
+    size_t target = dsc_ht_fit_capacity(set->size);
+    if (target < set->capacity && !dsc_set_resize(set, target)) {
+        dsc_set_error(DSC_ENOMEM);
+        return false;
+    }
+    set->min_capacity = set->capacity;
+    return true;
+}
+
+void DSC_FUNC(set_attach_filter)(dsc_set* set, dsc_bloom* filter) {
+    if (set == NULL || set->buckets == NULL || (filter != NULL && filter->words == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    set->filter = filter;
+    if (filter == NULL) return;
+
+    size_t bucket = 0;
+    for (dsc_set_node *node = dsc_set_next_node(set, &bucket, NULL); node != NULL; node = dsc_set_next_node(set, &bucket, node)) {
+        dsc_bloom_set(filter, node->hash);
+    }
+}
+
+void DSC_FUNC(set_from_array)(dsc_set* set, const void* array, size_t count, size_t item_size, dsc_hashfunc* hf, dsc_cmpfunc* cf) {
+    dsc_set_error(DSC_EOK);
+
+    if (set == NULL || array == NULL || hf == NULL || cf == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    DSC_FUNC(set_init)(set, count + count / 3 + 1, item_size, hf, cf);
+    if (DSC_FUNC(get_error)() != DSC_EOK) {
+        return;
+    }
+
+    /* Same layout as the batch API: packed keys, or key pointers when item_size is 0.
+       Blocks of DSC_HT_BATCH go through the same passes as dsc_ht_batch: hash and
+       prefetch the bucket slots, prefetch the chain heads, then resolve in order.
+       The set was sized for count, so no resize moves the slots mid-block.
+       Duplicates are simply skipped. */
+    const void *bkey[DSC_HT_BATCH];
+    size_t      blen[DSC_HT_BATCH];
+    uint64_t    bhash[DSC_HT_BATCH];
+
+    for (size_t base = 0; base < count; base += DSC_HT_BATCH) {
+        size_t n = (count - base < DSC_HT_BATCH) ? count - base : DSC_HT_BATCH;
+
+        for (size_t j = 0; j < n; j++) {
+            size_t i = base + j;
+            bkey[j] = (item_size != 0) ? (const void *)((const unsigned char *)array + i * item_size)
+                                       : ((const void *const *)array)[i];
+            if (bkey[j] == NULL) continue;
+
+            blen[j]  = dsc_set_item_len(set, bkey[j]);
+            bhash[j] = hf(bkey[j], blen[j]);
+            DSC_PREFETCH(&set->buckets[dsc_ht_bucket(bhash[j], set->capacity)]);
+        }
+
+        for (size_t j = 0; j < n; j++) {
+            if (bkey[j] != NULL) DSC_PREFETCH(set->buckets[dsc_ht_bucket(bhash[j], set->capacity)]);
+        }
+
+        for (size_t j = 0; j < n; j++) {
+            if (bkey[j] == NULL) continue;
+            if (dsc_set_find_link(set, bkey[j], blen[j], bhash[j]) != NULL) continue;
+            if (!dsc_set_maybe_grow(set) || dsc_set_link_new(set, bkey[j], blen[j], bhash[j]) == NULL) {
+                dsc_set_error(DSC_ENOMEM);
+                return;
+            }
+        }
+    }
+}
+
+dsc_list DSC_FUNC(set_to_list)(dsc_set* set) {
+    dsc_list result = {0};
+
+    if (set == NULL || set->buckets == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return result;
+    }
+    dsc_set_error(DSC_EOK);
+
+    DSC_FUNC(list_init)(&result, set->key_size ? set->key_size : sizeof(void*), set->size);
+    if (DSC_FUNC(get_error)() != DSC_EOK) {
+        return result;
+    }
+
+    /* Variable-length keys are returned as pointers into the set, like hash_table_keys */
+    size_t bucket = 0;
+    for (dsc_set_node* node = dsc_set_next_node(set, &bucket, NULL); node != NULL; node = dsc_set_next_node(set, &bucket, node)) {
+        void *key = dsc_set_node_key(set, node);
+        dsc_list_push_unchecked(&result, (set->key_size != 0) ? key : (void*)&key);
+    }
+
+    return result;
+}
+
+void DSC_FUNC(set_iter_begin)(dsc_set* set, dsc_set_iter* it) {
+    if (it == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    *it = (dsc_set_iter){0};
+
+    if (set == NULL || set->buckets == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    it->set = set;
+}
+
+bool DSC_FUNC(set_iter_next)(dsc_set_iter* it) {
+    if (it == NULL || it->set == NULL) return false;
+
+    const dsc_set *set = it->set;
+
+    /* After a remove, *link already holds the successor */
+    if (it->link == NULL) {
+        if (it->bucket >= set->capacity) return false;
+        it->link = &set->buckets[it->bucket];
+    } else if (it->key != NULL) {
+        it->link = &(*it->link)->next;
+    }
+
+    while (*it->link == NULL) {
+        if (++it->bucket >= set->capacity) {
+            it->key = NULL;
+            return false;
+        }
+        it->link = &set->buckets[it->bucket];
+    }
+
+    dsc_set_node *node = *it->link;
+    it->key      = dsc_set_node_key(set, node);
+    it->key_size = dsc_set_node_len(set, node);
+    it->hash     = node->hash;
+    return true;
+}
+
+void DSC_FUNC(set_iter_remove)(dsc_set_iter* it) {
+    if (it == NULL || it->key == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    it->key = NULL;
+    dsc_set_unlink(it->set, it->link);
+}
+
+size_t DSC_FUNC(set_scan)(dsc_set* set, size_t cursor, size_t count, dsc_scanfunc* fn, void* ctx) {
+    if (set == NULL || set->buckets == NULL || fn == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    dsc_set_error(DSC_EOK);
+
+    size_t reported = 0;
+    size_t budget   = dsc_ht_scan_budget(count);
+    size_t mask     = set->capacity - 1;
+    size_t v        = cursor;
+
+    /* The set resizes in one step, so there is only ever one bucket array */
+    do {
+        for (const dsc_set_node *node = set->buckets[v & mask]; node != NULL; node = node->next, reported++) {
+            fn(dsc_set_node_key(set, node), dsc_set_node_len(set, node), NULL, node->hash, ctx);
+        }
+        v = dsc_ht_scan_advance(v, mask);
+    } while (v != 0 && reported < count && --budget > 0);
+
+    return v;
+}
+
+/* Hash of src's node as dst would compute it; free when both share hf */
+static inline uint64_t dsc_set_node_hash(const dsc_set *dst, const dsc_set *src, const dsc_set_node *node) {
+    return (dst->hf == src->hf) ? node->hash : dst->hf(dsc_set_node_key(src, node), dsc_set_node_len(src, node));
+}
+
+static inline dsc_set_node **dsc_set_probe(const dsc_set *set, const dsc_set *src, const dsc_set_node *node) {
+    return dsc_set_find_link(set, dsc_set_node_key(src, node), dsc_set_node_len(src, node), dsc_set_node_hash(set, src, node));
+}
+
+/* Copy src's node into dst unless it is already there */
+static bool dsc_set_add_node(dsc_set *dst, const dsc_set *src, const dsc_set_node *node, bool check) {
+    uint64_t hash = dsc_set_node_hash(dst, src, node);
+    const void *key = dsc_set_node_key(src, node);
+    size_t len = dsc_set_node_len(src, node);
+
+    if (check && dsc_set_find_link(dst, key, len, hash) != NULL) return true;
+    if (!dsc_set_maybe_grow(dst)) return false;
+    return dsc_set_link_new(dst, key, len, hash) != NULL;
+}
+
+/* Delete every node of set whose presence in other equals drop_if_found */
+static void dsc_set_prune(dsc_set *set, const dsc_set *other, bool drop_if_found) {
+    for (size_t b = 0; b < set->capacity; b++) {
+        dsc_set_node **link = &set->buckets[b];
+        while (*link != NULL) {
+            if ((dsc_set_probe(other, set, *link) != NULL) == drop_if_found) {
+                dsc_set_unlink(set, link);
+            } else {
+                link = &(*link)->next;
+            }
+        }
+    }
+    dsc_set_maybe_shrink(set);
+}
+
+static bool dsc_set_check_pair(dsc_set *a, dsc_set *b) {
+    if (a == NULL || b == NULL || a->buckets == NULL || b->buckets == NULL || a->key_size != b->key_size) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    return true;
+}
+
+/* Start out as an empty set like a, sized for about count items */
+static bool dsc_set_init_like(dsc_set *out, dsc_set *a, dsc_set *b, size_t count) {
+    if (out == NULL || out == a || out == b) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    DSC_FUNC(set_init_with_allocator)(out, count + count / 3 + 1, a->key_size, a->hf, a->cf, a->allocator);
+    return DSC_FUNC(get_error)() == DSC_EOK;
+}
+
+static void dsc_set_fail(dsc_set *out) {
+    DSC_FUNC(set_destroy)(out);
+    dsc_set_error(DSC_ENOMEM);
+}
+
+void DSC_FUNC(set_union)(dsc_set* out, dsc_set* a, dsc_set* b) {
+    dsc_set_error(DSC_EOK);
+
+    if (!dsc_set_check_pair(a, b)) return;
+
+    /* Bulk-copy the larger side without duplicate checks, then add the rest */
+    dsc_set *large = (a->size >= b->size) ? a : b;
+    dsc_set *small = (large == a) ? b : a;
+    if (!dsc_set_init_like(out, a, b, large->size)) return;
+
+    size_t bucket = 0;
+    for (dsc_set_node *node = dsc_set_next_node(large, &bucket, NULL); node != NULL; node = dsc_set_next_node(large, &bucket, node)) {
+        if (!dsc_set_add_node(out, large, node, false)) {
+            dsc_set_fail(out);
+            return;
+        }
+    }
+    if (small == large) return;
+
+    bucket = 0;
+    for (dsc_set_node *node = dsc_set_next_node(small, &bucket, NULL); node != NULL; node = dsc_set_next_node(small, &bucket, node)) {
+        if (!dsc_set_add_node(out, small, node, true)) {
+            dsc_set_fail(out);
+            return;
+        }
+    }
+}
+
+void DSC_FUNC(set_intersect)(dsc_set* out, dsc_set* a, dsc_set* b) {
+    dsc_set_error(DSC_EOK);
+
+    if (!dsc_set_check_pair(a, b)) return;
+
+    dsc_set *small = (a->size <= b->size) ? a : b;
+    dsc_set *large = (small == a) ? b : a;
+    if (!dsc_set_init_like(out, a, b, small->size)) return;
+
+    size_t bucket = 0;
+    for (dsc_set_node *node = dsc_set_next_node(small, &bucket, NULL); node != NULL; node = dsc_set_next_node(small, &bucket, node)) {
+        if (small != large && dsc_set_probe(large, small, node) == NULL) continue;
+        if (!dsc_set_add_node(out, small, node, false)) {
+            dsc_set_fail(out);
+            return;
+        }
+    }
+}
+
+void DSC_FUNC(set_difference)(dsc_set* out, dsc_set* a, dsc_set* b) {
+    dsc_set_error(DSC_EOK);
+
+    if (!dsc_set_check_pair(a, b)) return;
+    if (!dsc_set_init_like(out, a, b, a->size)) return;
+    if (a == b) return;
+
+    /* The result is a subset of a, so a is walked whatever the sizes */
+    size_t bucket = 0;
+    for (dsc_set_node *node = dsc_set_next_node(a, &bucket, NULL); node != NULL; node = dsc_set_next_node(a, &bucket, node)) {
+        if (b->size != 0 && dsc_set_probe(b, a, node) != NULL) continue;
+        if (!dsc_set_add_node(out, a, node, false)) {
+            dsc_set_fail(out);
+            return;
+        }
+    }
+}
+
+bool DSC_FUNC(set_is_subset)(dsc_set* a, dsc_set* b) {
+    dsc_set_error(DSC_EOK);
+
+    if (!dsc_set_check_pair(a, b)) return false;
+    if (a->size > b->size) return false;
+    if (a == b) return true;
+
+    size_t bucket = 0;
+    for (dsc_set_node *node = dsc_set_next_node(a, &bucket, NULL); node != NULL; node = dsc_set_next_node(a, &bucket, node)) {
+        if (dsc_set_probe(b, a, node) == NULL) return false;
+    }
+    return true;
+}
+
+/* On DSC_ENOMEM, a keeps the items added before the failure */
+void DSC_FUNC(set_union_inplace)(dsc_set* a, dsc_set* b) {
+    dsc_set_error(DSC_EOK);
+
+    if (!dsc_set_check_pair(a, b) || a == b) return;
+
+    size_t bucket = 0;
+    for (dsc_set_node *node = dsc_set_next_node(b, &bucket, NULL); node != NULL; node = dsc_set_next_node(b, &bucket, node)) {
+        if (!dsc_set_add_node(a, b, node, true)) {
+            dsc_set_error(DSC_ENOMEM);
+            return;
+        }
+    }
+}
+
+void DSC_FUNC(set_intersect_inplace)(dsc_set* a, dsc_set* b) {
+    dsc_set_error(DSC_EOK);
+
+    if (!dsc_set_check_pair(a, b) || a == b) return;
+
+    if (b->size == 0) {
+        dsc_set_free_nodes(a);
+        dsc_set_maybe_shrink(a);
+        return;
+    }
+    dsc_set_prune(a, b, false);
+}
+
+void DSC_FUNC(set_difference_inplace)(dsc_set* a, dsc_set* b) {
+    dsc_set_error(DSC_EOK);
+
+    if (!dsc_set_check_pair(a, b)) return;
+
+    if (a == b) {
+        dsc_set_free_nodes(a);
+        return;
+    }
+    if (b->size >= a->size) {
+        dsc_set_prune(a, b, true);
+        return;
+    }
+
+    /* b is smaller: walk it and delete its items from a */
+    size_t bucket = 0;
+    for (dsc_set_node *node = dsc_set_next_node(b, &bucket, NULL); node != NULL; node = dsc_set_next_node(b, &bucket, node)) {
+        dsc_set_node **link = dsc_set_probe(a, b, node);
+        if (link != NULL) dsc_set_unlink(a, link);
+    }
+    dsc_set_maybe_shrink(a);
+}
+
+/*
+ * +----------------------------------------------------------------+
+ * |                      BITSET Implementation                     |
+ * +----------------------------------------------------------------+
+ */
+
+static inline size_t dsc_bs_words(size_t nbits) {
+    return nbits / 64 + ((nbits % 64) != 0);
+}
+
+static inline size_t dsc_popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (size_t)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/* x must be non-zero */
+static inline unsigned dsc_ctz64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(x);
+#else
+    static const unsigned char debruijn[64] = {
+         0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+    };
+    return debruijn[((x & (0 - x)) * 0x03f79d71b4cb0a89ULL) >> 58];
+#endif
+}
+
+/* Unsigned integer of width 1/2/4/8 bytes; false for any other width */
+static inline bool dsc_bs_load_id(const void *p, size_t width, uint64_t *out) {
+    switch (width) {
+        case 1: { uint8_t  v; memcpy(&v, p, 1); *out = v; return true; }
+        case 2: { uint16_t v; memcpy(&v, p, 2); *out = v; return true; }
+        case 4: { uint32_t v; memcpy(&v, p, 4); *out = v; return true; }
+        case 8: { uint64_t v; memcpy(&v, p, 8); *out = v; return true; }
+        default: return false;
+    }
+}
+
+static inline void dsc_bs_store_id(void *p, size_t width, uint64_t id) {
+    switch (width) {
+        case 1: { uint8_t  v = (uint8_t)id;  memcpy(p, &v, 1); break; }
+        case 2: { uint16_t v = (uint16_t)id; memcpy(p, &v, 2); break; }
+        case 4: { uint32_t v = (uint32_t)id; memcpy(p, &v, 4); break; }
+        default: memcpy(p, &id, 8); break;
+    }
+}
+
+static inline bool dsc_bs_width_ok(size_t width) {
+    return width == 1 || width == 2 || width == 4 || width == 8;
+}
+
+/* Keep the bits past nbits in the last word at zero */
+static inline void dsc_bs_trim(dsc_bitset *bs) {
+    if (bs->nbits % 64 != 0) bs->words[bs->nbits / 64] &= (UINT64_C(1) << (bs->nbits % 64)) - 1;
+}
+
+void DSC_FUNC(bitset_init)(dsc_bitset* bs, size_t nbits) {
+    DSC_FUNC(bitset_init_with_allocator)(bs, nbits, NULL);
+}
+
+void DSC_FUNC(bitset_init_with_allocator)(dsc_bitset* bs, size_t nbits, const dsc_allocator* allocator) {
+    dsc_set_error(DSC_EOK);
+
+    if (bs == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    *bs = (dsc_bitset){ .allocator = allocator };
+
+    size_t words = dsc_bs_words(nbits);
+    if (words == 0) return;
+
+    bs->words = (uint64_t *)dsc_mem_calloc(allocator, words, sizeof(uint64_t));
+    if (bs->words == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    bs->nbits = nbits;
+}
+
+void DSC_FUNC(bitset_destroy)(dsc_bitset* bs) {
+    if (bs == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (bs->words != NULL) dsc_mem_free(bs->allocator, bs->words, dsc_bs_words(bs->nbits) * sizeof(uint64_t));
+    bs->words = NULL;
+    bs->nbits = 0;
+}
+
+/* Growing adds zero bits; shrinking drops IDs >= nbits */
+void DSC_FUNC(bitset_resize)(dsc_bitset* bs, size_t nbits) {
+    dsc_set_error(DSC_EOK);
+
+    if (bs == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    size_t old_words = dsc_bs_words(bs->nbits);
+    size_t new_words = dsc_bs_words(nbits);
+    if (new_words != old_words) {
+        if (new_words == 0) {
+            dsc_mem_free(bs->allocator, bs->words, old_words * sizeof(uint64_t));
+            bs->words = NULL;
+        } else {
+            size_t bytes;
+            if (dsc_mul_overflow(new_words, sizeof(uint64_t), &bytes)) {
+                dsc_set_error(DSC_ENOMEM);
+                return;
+            }
+            uint64_t *words = (uint64_t *)dsc_mem_realloc(bs->allocator, bs->words, old_words * sizeof(uint64_t), bytes);
+            if (words == NULL) {
+                dsc_set_error(DSC_ENOMEM);
+                return;
+            }
+            if (new_words > old_words) memset(words + old_words, 0, (new_words - old_words) * sizeof(uint64_t));
+            bs->words = words;
+        }
+    }
+    bs->nbits = nbits;
+    if (bs->words != NULL) dsc_bs_trim(bs);
+}
+
+/* Returns true if id was not in the set yet */
+bool DSC_FUNC(bitset_add)(dsc_bitset* bs, size_t id) {
+    dsc_set_error(DSC_EOK);
+
+    if (bs == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    if (id >= bs->nbits) {
+        dsc_set_error(DSC_ERANGE);
+        return false;
+    }
+
+    uint64_t  mask = UINT64_C(1) << (id % 64);
+    uint64_t *word = &bs->words[id / 64];
+    bool added = (*word & mask) == 0;
+    *word |= mask;
+    return added;
+}
+
+/* Returns true if id was in the set */
+bool DSC_FUNC(bitset_remove)(dsc_bitset* bs, size_t id) {
+    dsc_set_error(DSC_EOK);
+
+    if (bs == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    if (id >= bs->nbits) return false;
+
+    uint64_t  mask = UINT64_C(1) << (id % 64);
+    uint64_t *word = &bs->words[id / 64];
+    bool removed = (*word & mask) != 0;
+    *word &= ~mask;
+    return removed;
+}
+
+/* IDs outside the universe are simply absent */
+bool DSC_FUNC(bitset_contains)(const dsc_bitset* bs, size_t id) {
+    dsc_set_error(DSC_EOK);
+
+    if (bs == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    return id < bs->nbits && ((bs->words[id / 64] >> (id % 64)) & 1) != 0;
+}
+
+size_t DSC_FUNC(bitset_count)(const dsc_bitset* bs) {
+    dsc_set_error(DSC_EOK);
+
+    if (bs == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+
+    size_t count = 0;
+    size_t words = dsc_bs_words(bs->nbits);
+    for (size_t i = 0; i < words; i++) count += dsc_popcount64(bs->words[i]);
+    return count;
+}
+
+void DSC_FUNC(bitset_clear)(dsc_bitset* bs) {
+    if (bs == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (bs->words != NULL) memset(bs->words, 0, dsc_bs_words(bs->nbits) * sizeof(uint64_t));
+}
+
+/* First set bit at or after from, or DSC_BITSET_END */
+size_t DSC_FUNC(bitset_next)(const dsc_bitset* bs, size_t from) {
+    if (bs == NULL || from >= bs->nbits) return DSC_BITSET_END;
+
+    size_t   words = dsc_bs_words(bs->nbits);
+    size_t   i     = from / 64;
+    uint64_t w     = bs->words[i] & (~UINT64_C(0) << (from % 64));
+
+    while (w == 0) {
+        if (++i >= words) return DSC_BITSET_END;
+        w = bs->words[i];
+    }
+    return i * 64 + dsc_ctz64(w);
+}
+
+/*
+ * The word loops below have no loop-carried dependency, so GCC/Clang/MSVC
+ * turn them into SSE/AVX/NEON code at -O2/-O3 without any intrinsics.
+ */
+static void dsc_bs_and_words(uint64_t *dst, const uint64_t *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] &= src[i];
+}
+
+static void dsc_bs_or_words(uint64_t *dst, const uint64_t *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] |= src[i];
+}
+
+static void dsc_bs_andnot_words(uint64_t *dst, const uint64_t *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] &= ~src[i];
+}
+
+static inline size_t dsc_bs_min_words(const dsc_bitset *a, const dsc_bitset *b) {
+    size_t wa = dsc_bs_words(a->nbits), wb = dsc_bs_words(b->nbits);
+    return (wa < wb) ? wa : wb;
+}
+
+void DSC_FUNC(bitset_and)(dsc_bitset* dst, const dsc_bitset* src) {
+    dsc_set_error(DSC_EOK);
+
+    if (dst == NULL || src == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (dst == src) return;
+
+    /* Words src does not have are ANDed with zero */
+    size_t n     = dsc_bs_min_words(dst, src);
+    size_t words = dsc_bs_words(dst->nbits);
+    dsc_bs_and_words(dst->words, src->words, n);
+    if (words > n) memset(dst->words + n, 0, (words - n) * sizeof(uint64_t));
+}
+
+void DSC_FUNC(bitset_or)(dsc_bitset* dst, const dsc_bitset* src) {
+    dsc_set_error(DSC_EOK);
+
+    if (dst == NULL || src == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (dst == src) return;
+
+    if (src->nbits > dst->nbits) {
+        DSC_FUNC(bitset_resize)(dst, src->nbits);
+        if (DSC_FUNC(get_error)() != DSC_EOK) return;
+    }
+    dsc_bs_or_words(dst->words, src->words, dsc_bs_words(src->nbits));
+}
+
+void DSC_FUNC(bitset_andnot)(dsc_bitset* dst, const dsc_bitset* src) {
+    dsc_set_error(DSC_EOK);
+
+    if (dst == NULL || src == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (dst == src) {
+        DSC_FUNC(bitset_clear)(dst);
+        return;
+    }
+    dsc_bs_andnot_words(dst->words, src->words, dsc_bs_min_words(dst, src));
+}
+
+/* |a ∩ b| without building the intersection */
+size_t DSC_FUNC(bitset_and_count)(const dsc_bitset* a, const dsc_bitset* b) {
+    dsc_set_error(DSC_EOK);
+
+    if (a == NULL || b == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+
+    size_t count = 0;
+    size_t n     = dsc_bs_min_words(a, b);
+    for (size_t i = 0; i < n; i++) count += dsc_popcount64(a->words[i] & b->words[i]);
+    return count;
+}
+
+bool DSC_FUNC(bitset_is_subset)(const dsc_bitset* a, const dsc_bitset* b) {
+    dsc_set_error(DSC_EOK);
+
+    if (a == NULL || b == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+
+    size_t n     = dsc_bs_min_words(a, b);
+    size_t words = dsc_bs_words(a->nbits);
+    uint64_t extra = 0;
+    for (size_t i = 0; i < n; i++) extra |= a->words[i] & ~b->words[i];
+    for (size_t i = n; i < words; i++) extra |= a->words[i];
+    return extra == 0;
+}
+
+/* Shared by the from_* conversions: ids are count items of width bytes, stride apart */
+static void dsc_bs_from_ids(dsc_bitset *bs, const unsigned char *ids, size_t count, size_t width,
+                            size_t stride, size_t nbits, const dsc_allocator *allocator) {
+    uint64_t id = 0;
+
+    if (nbits == 0) {
+        uint64_t max = 0;
+        for (size_t i = 0; i < count; i++) {
+            dsc_bs_load_id(ids + i * stride, width, &id);
+            if (id > max) max = id;
+        }
+        if (count != 0 && max >= SIZE_MAX) {
+            dsc_set_error(DSC_ERANGE);
+            return;
+        }
+        nbits = (count != 0) ? (size_t)max + 1 : 0;
+    }
+
+    DSC_FUNC(bitset_init_with_allocator)(bs, nbits, allocator);
+    if (DSC_FUNC(get_error)() != DSC_EOK) return;
+
+    for (size_t i = 0; i < count; i++) {
+        dsc_bs_load_id(ids + i * stride, width, &id);
+        if (id >= nbits) {
+            DSC_FUNC(bitset_destroy)(bs);
+            dsc_set_error(DSC_ERANGE);
+            return;
+        }
+        bs->words[id / 64] |= UINT64_C(1) << (id % 64);
+    }
+}
+
+void DSC_FUNC(bitset_from_list)(dsc_bitset* bs, dsc_list* list, size_t nbits) {
+    dsc_set_error(DSC_EOK);
+
+    if (bs == NULL || list == NULL || !dsc_bs_width_ok(list->item_size)) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    *bs = (dsc_bitset){0};
+    dsc_bs_from_ids(bs, (const unsigned char *)list->items, list->length, list->item_size, list->item_size, nbits, list->allocator);
+}
+
+void DSC_FUNC(bitset_from_set)(dsc_bitset* bs, dsc_set* set, size_t nbits) {
+    dsc_set_error(DSC_EOK);
+
+    if (bs == NULL || set == NULL || set->buckets == NULL || !dsc_bs_width_ok(set->key_size)) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    *bs = (dsc_bitset){0};
+
+    /* Two walks over the nodes, one for the widest ID and one for the bits;
+       the words are the only allocation and come from the set's allocator */
+    size_t        bucket = 0;
+    uint64_t      id     = 0;
+    dsc_set_node *node;
+
+    if (nbits == 0) {
+        uint64_t max = 0;
+        for (node = dsc_set_next_node(set, &bucket, NULL); node != NULL; node = dsc_set_next_node(set, &bucket, node)) {
+            dsc_bs_load_id(dsc_set_node_key(set, node), set->key_size, &id);
+            if (id > max) max = id;
+        }
+        if (set->size != 0 && max >= SIZE_MAX) {
+            dsc_set_error(DSC_ERANGE);
+            return;
+        }
+        nbits = (set->size != 0) ? (size_t)max + 1 : 0;
+    }
+
+    DSC_FUNC(bitset_init_with_allocator)(bs, nbits, set->allocator);
+    if (DSC_FUNC(get_error)() != DSC_EOK) return;
+
+    bucket = 0;
+    for (node = dsc_set_next_node(set, &bucket, NULL); node != NULL; node = dsc_set_next_node(set, &bucket, node)) {
+        dsc_bs_load_id(dsc_set_node_key(set, node), set->key_size, &id);
+        if (id >= nbits) {
+            DSC_FUNC(bitset_destroy)(bs);
+            dsc_set_error(DSC_ERANGE);
+            return;
+        }
+        bs->words[id / 64] |= UINT64_C(1) << (id % 64);
+    }
+}
+
+dsc_list DSC_FUNC(bitset_to_list)(const dsc_bitset* bs, size_t item_size) {
+    dsc_list result = {0};
+
+    if (bs == NULL || !dsc_bs_width_ok(item_size)) {
+        dsc_set_error(DSC_EINVAL);
+        return result;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (item_size < 8 && bs->nbits > (UINT64_C(1) << (item_size * 8))) {
+        dsc_set_error(DSC_ERANGE);
+        return result;
+    }
+
+    DSC_FUNC(list_init_with_allocator)(&result, item_size, DSC_FUNC(bitset_count)(bs), bs->allocator);
+    if (DSC_FUNC(get_error)() != DSC_EOK) return result;
+
+    size_t words = dsc_bs_words(bs->nbits);
+    for (size_t i = 0; i < words; i++) {
+        for (uint64_t w = bs->words[i]; w != 0; w &= w - 1) {
+            dsc_bs_store_id((unsigned char *)result.items + result.length * item_size, item_size, i * 64 + dsc_ctz64(w));
+            result.length++;
+        }
+    }
+    return result;
+}
+
+dsc_set DSC_FUNC(bitset_to_set)(const dsc_bitset* bs, size_t item_size, dsc_hashfunc* hf, dsc_cmpfunc* cf) {
+    dsc_set result = {0};
+
+    if (bs == NULL || hf == NULL || cf == NULL || !dsc_bs_width_ok(item_size)) {
+        dsc_set_error(DSC_EINVAL);
+        return result;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (item_size < 8 && bs->nbits > (UINT64_C(1) << (item_size * 8))) {
+        dsc_set_error(DSC_ERANGE);
+        return result;
+    }
+
+    size_t count = DSC_FUNC(bitset_count)(bs);
+    DSC_FUNC(set_init_with_allocator)(&result, count + count / 3 + 1, item_size, hf, cf, bs->allocator);
+    if (DSC_FUNC(get_error)() != DSC_EOK) return result;
+
+    /* Every ID is distinct, so nodes are linked without a duplicate probe */
+    unsigned char key[8];
+    size_t words = dsc_bs_words(bs->nbits);
+    for (size_t i = 0; i < words; i++) {
+        for (uint64_t w = bs->words[i]; w != 0; w &= w - 1) {
+            dsc_bs_store_id(key, item_size, i * 64 + dsc_ctz64(w));
+            if (!dsc_set_maybe_grow(&result) || dsc_set_link_new(&result, key, item_size, hf(key, item_size)) == NULL) {
+                DSC_FUNC(set_destroy)(&result);
+                dsc_set_error(DSC_ENOMEM);
+                return result;
+            }
+        }
+    }
+    return result;
+}
+
+/*
+ * +----------------------------------------------------------------+
+ * |                     SNAPSHOT Implementation                    |
+ * +----------------------------------------------------------------+
+ */
+
+/*
+ * Image layout, all offsets relative to the start of the image:
+ *   [ header | uint64 bucket_start[bucket_count + 1] | entry[count] | values | keys ]
+ * Entries are grouped by bucket, so bucket b owns entries
+ * bucket_start[b] .. bucket_start[b + 1]. Values sit at a fixed 16-byte
+ * aligned stride in entry order; keys are packed at 8-byte alignment.
+ */
+#define DSC_SNAPSHOT_MAGIC      "DSCSNAP1"
+#define DSC_SNAPSHOT_VERSION    1u
+#define DSC_SNAPSHOT_ENDIAN     0x01020304u
+
+enum { DSC_SNAPSHOT_BORROWED, DSC_SNAPSHOT_HEAP, DSC_SNAPSHOT_MAPPED };
+
+typedef struct {
+    char        magic[8];
+    uint32_t    version;
+    uint32_t    endian;             /* Reads back differently on a foreign byte order */
+    uint64_t    count;
+    uint64_t    bucket_count;
+    uint64_t    key_size;
+    uint64_t    value_size;
+    uint64_t    image_size;
+    uint64_t    reserved;
+} dsc_snapshot_header;
+
+typedef struct {
+    uint64_t    hash;
+    uint64_t    key_off;
+    uint64_t    key_len;
+    uint64_t    value_off;          /* 0 = NULL value (or no values stored) */
+} dsc_snapshot_entry;
+
+typedef struct {
+    size_t      bucket_count;
+    size_t      entries_off;
+    size_t      values_off;
+    size_t      value_stride;
+    size_t      keys_off;
+    size_t      size;
+} dsc_snapshot_layout;
+
+/* Round up to a power-of-two alignment, false on overflow */
+static inline bool dsc_snap_align(size_t n, size_t align, size_t *out) {
+    if (dsc_add_overflow(n, align - 1, out)) return false;
+    *out &= ~(align - 1);
+    return true;
+}
+
+/* Everything but the key bytes depends only on the counts */
+static bool dsc_snap_fixed_layout(size_t count, size_t bucket_count, size_t value_size, dsc_snapshot_layout *lay) {
+    size_t bytes;
+
+    lay->bucket_count = bucket_count;
+    if (!dsc_snap_align(value_size, 16, &lay->value_stride)) return false;
+
+    if (dsc_add_overflow(bucket_count, 1, &bytes) || dsc_mul_overflow(bytes, sizeof(uint64_t), &bytes) ||
+        dsc_add_overflow(sizeof(dsc_snapshot_header), bytes, &lay->entries_off)) return false;
+
+    if (dsc_mul_overflow(count, sizeof(dsc_snapshot_entry), &bytes) ||
+        dsc_add_overflow(lay->entries_off, bytes, &bytes) ||
+        !dsc_snap_align(bytes, 16, &lay->values_off)) return false;
+
+    if (dsc_mul_overflow(count, lay->value_stride, &bytes) ||
+        dsc_add_overflow(lay->values_off, bytes, &lay->keys_off)) return false;
+
+    lay->size = lay->keys_off;
+    return true;
+}
+
+/* Tables and sets feed the writer through one cursor */
+typedef struct {
+    const dsc_hash_table    *ht;            /* Exactly one of ht and set is set */
+    const dsc_set           *set;
+    size_t                  count;
+    size_t                  key_size;
+    size_t                  bucket;
+    const void              *node;
+} dsc_snapshot_cursor;
+
+typedef struct {
+    const void  *key;
+    size_t      key_size;
+    uint64_t    hash;
+    const void  *obj;                       /* Always NULL for sets */
+} dsc_snapshot_item;
+
+static dsc_snapshot_cursor dsc_snap_cursor(const dsc_hash_table *ht, const dsc_set *set) {
+    dsc_snapshot_cursor c = { ht, set, 0, 0, 0, NULL };
+    c.count    = (ht != NULL) ? ht->size : set->size;
+    c.key_size = (ht != NULL) ? ht->key_size : set->key_size;
+    return c;
+}
+
+static bool dsc_snap_next(dsc_snapshot_cursor *c, dsc_snapshot_item *item) {
+    if (c->ht != NULL) {
+        const dsc_kvpair *n = dsc_ht_next_node(c->ht, &c->bucket, (const dsc_kvpair *)c->node);
+        if (n == NULL) return false;
+        *item   = (dsc_snapshot_item){ n->key, n->key_size, n->hash, n->obj };
+        c->node = n;
+        return true;
+    }
+    const dsc_set_node *n = dsc_set_next_node(c->set, &c->bucket, (const dsc_set_node *)c->node);
+    if (n == NULL) return false;
+    *item   = (dsc_snapshot_item){ dsc_set_node_key(c->set, n), dsc_set_node_len(c->set, n), n->hash, NULL };
+    c->node = n;
+    return true;
+}
+
+static inline void dsc_snap_rewind(dsc_snapshot_cursor *c) {
+    c->bucket = 0;
+    c->node   = NULL;
+}
+
+static bool dsc_snap_plan(dsc_snapshot_cursor *c, size_t value_size, dsc_snapshot_layout *lay) {
+    size_t bucket_count = dsc_ht_round_pow2((c->count != 0) ? c->count : 1);
+    if (bucket_count == 0 || !dsc_snap_fixed_layout(c->count, bucket_count, value_size, lay)) return false;
+
+    dsc_snapshot_item item;
+    dsc_snap_rewind(c);
+    while (dsc_snap_next(c, &item)) {
+        size_t key_bytes;
+        if (!dsc_snap_align(item.key_size, 8, &key_bytes) || dsc_add_overflow(lay->size, key_bytes, &lay->size)) return false;
+    }
+    return true;
+}
+
+static size_t dsc_snap_size(dsc_snapshot_cursor *c, size_t value_size) {
+    dsc_snapshot_layout lay;
+    if (!dsc_snap_plan(c, value_size, &lay)) {
+        dsc_set_error(DSC_ENOMEM);
+        return 0;
+    }
+    return lay.size;
+}
+
+static size_t dsc_snap_write(dsc_snapshot_cursor *c, size_t value_size, void *buffer, size_t buffer_size) {
+    if (buffer == NULL || ((uintptr_t)buffer & 15) != 0) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+
+    dsc_snapshot_layout lay;
+    if (!dsc_snap_plan(c, value_size, &lay)) {
+        dsc_set_error(DSC_ENOMEM);
+        return 0;
+    }
+    if (buffer_size < lay.size) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+
+    unsigned char *image = (unsigned char *)buffer;
+    memset(image, 0, lay.size);
+
+    dsc_snapshot_header *hdr = (dsc_snapshot_header *)(void *)image;
+    memcpy(hdr->magic, DSC_SNAPSHOT_MAGIC, sizeof(hdr->magic));
+    hdr->version      = DSC_SNAPSHOT_VERSION;
+    hdr->endian       = DSC_SNAPSHOT_ENDIAN;
+    hdr->count        = c->count;
+    hdr->bucket_count = lay.bucket_count;
+    hdr->key_size     = c->key_size;
+    hdr->value_size   = value_size;
+    hdr->image_size   = lay.size;
+
+    uint64_t           *starts  = (uint64_t *)(void *)(image + sizeof(dsc_snapshot_header));
+    dsc_snapshot_entry *entries = (dsc_snapshot_entry *)(void *)(image + lay.entries_off);
+    dsc_snapshot_item   item;
+
+    /* Pass 1: per-bucket counts, then prefix sums give each bucket's first entry */
+    dsc_snap_rewind(c);
+    while (dsc_snap_next(c, &item)) {
+        starts[dsc_ht_bucket(item.hash, lay.bucket_count) + 1]++;
+    }
+    for (size_t b = 1; b <= lay.bucket_count; b++) starts[b] += starts[b - 1];
+
+    /* Pass 2: place entries, using starts[b] as bucket b's cursor */
+    size_t key_off = lay.keys_off;
+    dsc_snap_rewind(c);
+    while (dsc_snap_next(c, &item)) {
+        size_t i = (size_t)starts[dsc_ht_bucket(item.hash, lay.bucket_count)]++;
+        dsc_snapshot_entry *e = &entries[i];
+
+        e->hash    = item.hash;
+        e->key_off = key_off;
+        e->key_len = item.key_size;
+        memcpy(image + key_off, item.key, item.key_size);
+        key_off += (item.key_size + 7) & ~(size_t)7;
+
+        if (value_size != 0 && item.obj != NULL) {
+            e->value_off = lay.values_off + i * lay.value_stride;
+            memcpy(image + e->value_off, item.obj, value_size);
+        }
+    }
+
+    /* Each cursor now points at the next bucket's start: shift back by one */
+    for (size_t b = lay.bucket_count; b > 0; b--) starts[b] = starts[b - 1];
+    starts[0] = 0;
+
+    return lay.size;
+}
+
+static bool dsc_snap_save(dsc_snapshot_cursor *c, const char *path, size_t value_size) {
+    size_t size = dsc_snap_size(c, value_size);
+    if (size == 0) return false;
+
+    void *buffer = malloc(size);
+    if (buffer == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return false;
+    }
+    dsc_snap_write(c, value_size, buffer, size);
+
+    FILE *f  = fopen(path, "wb");
+    bool  ok = f != NULL && fwrite(buffer, 1, size, f) == size;
+    if (f != NULL && fclose(f) != 0) ok = false;
+    free(buffer);
+
+    if (!ok) {
+        dsc_set_error(DSC_EIO);
+        return false;
+    }
+    return true;
+}
+
+size_t DSC_FUNC(hash_table_snapshot_size)(dsc_hash_table *ht, size_t value_size) {
+    dsc_set_error(DSC_EOK);
+
+    if (ht == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    dsc_snapshot_cursor c = dsc_snap_cursor(ht, NULL);
+    return dsc_snap_size(&c, value_size);
+}
+
+size_t DSC_FUNC(hash_table_snapshot_write)(dsc_hash_table *ht, size_t value_size, void *buffer, size_t buffer_size) {
+    dsc_set_error(DSC_EOK);
+
+    if (ht == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    dsc_snapshot_cursor c = dsc_snap_cursor(ht, NULL);
+    return dsc_snap_write(&c, value_size, buffer, buffer_size);
+}
+
+bool DSC_FUNC(hash_table_save)(dsc_hash_table *ht, const char *path, size_t value_size) {
+    dsc_set_error(DSC_EOK);
+
+    if (ht == NULL || path == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    dsc_snapshot_cursor c = dsc_snap_cursor(ht, NULL);
+    return dsc_snap_save(&c, path, value_size);
+}
+
+size_t DSC_FUNC(set_snapshot_size)(dsc_set *set) {
+    dsc_set_error(DSC_EOK);
+
+    if (set == NULL || set->buckets == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    dsc_snapshot_cursor c = dsc_snap_cursor(NULL, set);
+    return dsc_snap_size(&c, 0);
+}
+
+size_t DSC_FUNC(set_snapshot_write)(dsc_set *set, void *buffer, size_t buffer_size) {
+    dsc_set_error(DSC_EOK);
+
+    if (set == NULL || set->buckets == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    dsc_snapshot_cursor c = dsc_snap_cursor(NULL, set);
+    return dsc_snap_write(&c, 0, buffer, buffer_size);
+}
+
+bool DSC_FUNC(set_save)(dsc_set *set, const char *path) {
+    dsc_set_error(DSC_EOK);
+
+    if (set == NULL || set->buckets == NULL || path == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    dsc_snapshot_cursor c = dsc_snap_cursor(NULL, set);
+    return dsc_snap_save(&c, path, 0);
+}
+
+/* Validate the header and bucket index; per-entry offsets are checked on lookup */
+static dsc_error_t dsc_snap_attach(dsc_snapshot *snap, const void *image, size_t size, dsc_hashfunc *hf, dsc_cmpfunc *cf) {
+    const dsc_snapshot_header *hdr = (const dsc_snapshot_header *)image;
+
+    if (size < sizeof(dsc_snapshot_header) || ((uintptr_t)image & 7) != 0 ||
+        memcmp(hdr->magic, DSC_SNAPSHOT_MAGIC, sizeof(hdr->magic)) != 0 ||
+        hdr->version != DSC_SNAPSHOT_VERSION || hdr->endian != DSC_SNAPSHOT_ENDIAN ||
+        hdr->image_size > size || hdr->count > SIZE_MAX || hdr->key_size > SIZE_MAX ||
+        hdr->value_size > SIZE_MAX || hdr->bucket_count == 0 || hdr->bucket_count > SIZE_MAX ||
+        (hdr->bucket_count & (hdr->bucket_count - 1)) != 0) {
+        return DSC_EINVAL;
+    }
+
+    dsc_snapshot_layout lay;
+    if (!dsc_snap_fixed_layout((size_t)hdr->count, (size_t)hdr->bucket_count, (size_t)hdr->value_size, &lay) ||
+        lay.size > hdr->image_size) {
+        return DSC_EINVAL;
+    }
+
+    const unsigned char *base   = (const unsigned char *)image;
+    const uint64_t      *starts = (const uint64_t *)(const void *)(base + sizeof(dsc_snapshot_header));
+    if (starts[0] != 0 || starts[hdr->bucket_count] != hdr->count) return DSC_EINVAL;
+
+    /* Rehash one stored key to catch a loader using a different hash function */
+    if (hdr->count != 0) {
+        const dsc_snapshot_entry *e = (const dsc_snapshot_entry *)(const void *)(base + lay.entries_off);
+        if (e->key_off > hdr->image_size || e->key_len > hdr->image_size - e->key_off) return DSC_EINVAL;
+        if (hf(base + e->key_off, (size_t)e->key_len) != e->hash) return DSC_EHASHFUNC;
+    }
+
+    snap->image        = base;
+    snap->image_size   = (size_t)hdr->image_size;
+    snap->count        = (size_t)hdr->count;
+    snap->key_size     = (size_t)hdr->key_size;
+    snap->value_size   = (size_t)hdr->value_size;
+    snap->bucket_count = (size_t)hdr->bucket_count;
+    snap->hf           = hf;
+    snap->cf           = cf;
+    return DSC_EOK;
+}
+
+static bool dsc_snap_check_args(dsc_snapshot *snap, const void *source, dsc_hashfunc *hf, dsc_cmpfunc *cf) {
+    if (snap == NULL || source == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    *snap = (dsc_snapshot){0};
+    if (hf == NULL) {
+        dsc_set_error(DSC_EHASHFUNC);
+        return false;
+    }
+    if (cf == NULL) {
+        dsc_set_error(DSC_ECMPFUNC);
+        return false;
+    }
+    return true;
+}
+
+void DSC_FUNC(snapshot_init)(dsc_snapshot *snap, const void *image, size_t size, dsc_hashfunc *hf, dsc_cmpfunc *cf) {
+    dsc_set_error(DSC_EOK);
+
+    if (!dsc_snap_check_args(snap, image, hf, cf)) return;
+
+    dsc_error_t err = dsc_snap_attach(snap, image, size, hf, cf);
+    if (err != DSC_EOK) {
+        *snap = (dsc_snapshot){0};
+        dsc_set_error(err);
+    }
+}
+
+void DSC_FUNC(snapshot_load)(dsc_snapshot *snap, const char *path, dsc_hashfunc *hf, dsc_cmpfunc *cf) {
+    dsc_set_error(DSC_EOK);
+
+    if (!dsc_snap_check_args(snap, path, hf, cf)) return;
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        dsc_set_error(DSC_EIO);
+        return;
+    }
+
+    long   end    = (fseek(f, 0, SEEK_END) == 0) ? ftell(f) : -1;
+    void  *buffer = (end > 0) ? malloc((size_t)end) : NULL;
+    bool   read   = buffer != NULL && fseek(f, 0, SEEK_SET) == 0 &&
+                    fread(buffer, 1, (size_t)end, f) == (size_t)end;
+    fclose(f);
+
+    if (!read) {
+        free(buffer);
+        dsc_set_error((end > 0 && buffer == NULL) ? DSC_ENOMEM : DSC_EIO);
+        return;
+    }
+
+    dsc_error_t err = dsc_snap_attach(snap, buffer, (size_t)end, hf, cf);
+    if (err != DSC_EOK) {
+        free(buffer);
+        *snap = (dsc_snapshot){0};
+        dsc_set_error(err);
+        return;
+    }
+    snap->owned  = buffer;
+    snap->source = DSC_SNAPSHOT_HEAP;
+}
+
+/* Read-only mapping: pages are faulted in as lookups touch them */
+void DSC_FUNC(snapshot_map)(dsc_snapshot *snap, const char *path, dsc_hashfunc *hf, dsc_cmpfunc *cf) {
+#ifdef DSC_NO_VMEM
+    DSC_FUNC(snapshot_load)(snap, path, hf, cf);
+#else
+    dsc_set_error(DSC_EOK);
+
+    if (!dsc_snap_check_args(snap, path, hf, cf)) return;
+
+    void  *view = NULL;
+    size_t size = 0;
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER length;
+        if (GetFileSizeEx(file, &length) && length.QuadPart > 0) {
+            HANDLE map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (map != NULL) {
+                view = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+                size = (size_t)length.QuadPart;
+                CloseHandle(map);       /* The view keeps the mapping alive */
+            }
+        }
+        CloseHandle(file);
+    }
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (view == MAP_FAILED) view = NULL;
+            size = (size_t)st.st_size;
+        }
+        close(fd);                      /* The mapping outlives the descriptor */
+    }
+#endif
+    if (view == NULL) {
+        dsc_set_error(DSC_EIO);
+        return;
+    }
+
+    dsc_error_t err = dsc_snap_attach(snap, view, size, hf, cf);
+    if (err != DSC_EOK) {
+#if defined(_WIN32)
+        UnmapViewOfFile(view);
+#else
+        munmap(view, size);
+#endif
+        *snap = (dsc_snapshot){0};
+        dsc_set_error(err);
+        return;
+    }
+    snap->owned      = view;
+    snap->owned_size = size;
+    snap->source     = DSC_SNAPSHOT_MAPPED;
+#endif /* DSC_NO_VMEM */
+}
+
+/* Entry for key, or NULL; reports corrupt offsets as DSC_EINVAL */
+static const dsc_snapshot_entry *dsc_snap_find(const dsc_snapshot *snap, const void *key) {
+    size_t   key_len = (snap->key_size != 0) ? snap->key_size : strlen((const char *)key) + 1;
+    uint64_t hash    = snap->hf(key, key_len);
+    size_t   b       = dsc_ht_bucket(hash, snap->bucket_count);
+
+    const uint64_t *starts = (const uint64_t *)(const void *)(snap->image + sizeof(dsc_snapshot_header));
+    const dsc_snapshot_entry *entries = (const dsc_snapshot_entry *)(const void *)(starts + snap->bucket_count + 1);
+
+    size_t end = (starts[b + 1] < snap->count) ? (size_t)starts[b + 1] : snap->count;
+    for (size_t i = (size_t)starts[b]; i < end; i++) {
+        const dsc_snapshot_entry *e = &entries[i];
+        if (e->hash != hash) continue;
+
+        if (e->key_off > snap->image_size || e->key_len > snap->image_size - e->key_off ||
+            e->value_off > snap->image_size - snap->value_size) {
+            dsc_set_error(DSC_EINVAL);
+            return NULL;
+        }
+        if (snap->cf(key, key_len, snap->image + e->key_off, (size_t)e->key_len) == 0) return e;
+    }
+    dsc_set_error(DSC_ENOTFOUND);
+    return NULL;
+}
+
+const void *DSC_FUNC(snapshot_get)(const dsc_snapshot *snap, const void *key) {
+    dsc_set_error(DSC_EOK);
+
+    if (snap == NULL || snap->image == NULL || key == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+
+    const dsc_snapshot_entry *e = dsc_snap_find(snap, key);
+    if (e == NULL) return NULL;
+
+    if (snap->value_size == 0) return snap->image + e->key_off;
+    return (e->value_off != 0) ? snap->image + e->value_off : NULL;
+}
+
+bool DSC_FUNC(snapshot_contains)(const dsc_snapshot *snap, const void *key) {
+    dsc_set_error(DSC_EOK);
+
+    if (snap == NULL || snap->image == NULL || key == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    return dsc_snap_find(snap, key) != NULL;
+}
+
+void DSC_FUNC(snapshot_destroy)(dsc_snapshot *snap) {
+    if (snap == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    if (snap->source == DSC_SNAPSHOT_HEAP) {
+        free(snap->owned);
+    }
+#ifndef DSC_NO_VMEM
+    else if (snap->source == DSC_SNAPSHOT_MAPPED) {
+#if defined(_WIN32)
+        UnmapViewOfFile(snap->owned);
+#else
+        munmap(snap->owned, snap->owned_size);
+#endif
+    }
+#endif
+    *snap = (dsc_snapshot){0};
+}
+
+/*
+ * +----------------------------------------------------------------+
+ * |                       Stack Implementation                     |
+ * +----------------------------------------------------------------+
+ */
+
+ void DSC_FUNC(stack_init)(dsc_stack* stack, size_t item_size, size_t initial_capacity) {
+    DSC_FUNC(stack_init_with_allocator)(stack, item_size, initial_capacity, NULL);
+}
+
+void DSC_FUNC(stack_init_with_allocator)(dsc_stack* stack, size_t item_size, size_t initial_capacity, const dsc_allocator* allocator) {
+    if (stack == NULL || item_size == 0) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    DSC_FUNC(list_init_with_allocator)(&stack->list, item_size, initial_capacity, allocator);
+}
+
+bool DSC_FUNC(stack_push)(dsc_stack* stack, void* item) {
+     if (stack == NULL || item == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+
+    dsc_list_append(&stack->list, item);
+
+    return dsc_get_error() == DSC_EOK;
+}
+
+void* DSC_FUNC(stack_pop)(dsc_stack* stack, void *out_item) {
+    if (stack == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+    if (stack->list.length == 0) {
+        dsc_set_error(DSC_EEMPTY);
+        return NULL;
+    }
+
+    void* item = DSC_FUNC(list_get)(&stack->list, stack->list.length - 1);
+
+    memcpy(out_item, item, stack->list.item_size);
+    DSC_FUNC(list_pop)(&stack->list);
+
+    return out_item;
+}
+
+void* DSC_FUNC(stack_peek)(dsc_stack* stack) {
+    if (stack == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+    if (stack->list.length == 0) {
+        dsc_set_error(DSC_EEMPTY);
+        return NULL;
+    }
+    dsc_set_error(DSC_EOK);
+    return dsc_list_get(&stack->list, stack->list.length - 1);
+}
+
+size_t DSC_FUNC(stack_size)(dsc_stack* stack) {
+    if (stack == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    dsc_set_error(DSC_EOK);
+    return stack->list.length;
+}
+
+bool DSC_FUNC(stack_is_empty)(dsc_stack* stack) {
+    if (stack == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return true;
+    }
+    dsc_set_error(DSC_EOK);
+    return stack->list.length == 0;
+}
+
+void DSC_FUNC(stack_clear)(dsc_stack* stack) {
+    if (stack == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_list_clear(&stack->list);
+}
+
+void DSC_FUNC(stack_shrink_to_fit)(dsc_stack* stack) {
+    if (stack == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    DSC_FUNC(list_shrink_to_fit)(&stack->list);
+}
+
+void DSC_FUNC(stack_destroy)(dsc_stack* stack) {
+    if (stack == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_list_destroy(&stack->list);
+}
+
+dsc_alloc_stats DSC_FUNC(stack_stats)(dsc_stack* stack) {
+    if (stack == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return (dsc_alloc_stats){0};
+    }
+    return DSC_FUNC(list_stats)(&stack->list);
+}
+
+/*
+ * +----------------------------------------------------------------+
+ * |                       DEQUE Implementation                     |
+ * +----------------------------------------------------------------+
+ */
+#define DSC_DEQUE_HEADER      (((sizeof(dsc_deque_block)) + 15) & ~(size_t)15)
+#define DSC_DEQUE_BLOCK_BYTES 4096
+#define DSC_DEQUE_DATA(b)     ((unsigned char *)(b) + DSC_DEQUE_HEADER)
+
+static inline size_t dsc_deque_block_size(const dsc_deque *dq) {
+    return DSC_DEQUE_HEADER + dq->block_items * dq->item_size;
+}
+
+static inline unsigned char *dsc_deque_slot(const dsc_deque *dq, dsc_deque_block *b, size_t pos) {
+    return DSC_DEQUE_DATA(b) + pos * dq->item_size;
+}
+
+/* Take the spare block if there is one; O(1), at most one allocation */
+static dsc_deque_block *dsc_deque_take_block(dsc_deque *dq) {
+    dsc_deque_block *b = dq->spare;
+    if (b != NULL) {
+        dq->spare = NULL;
+    } else {
+        b = (dsc_deque_block *)dsc_mem_alloc(dq->allocator, dsc_deque_block_size(dq));
+        if (b == NULL) return NULL;
+    }
+    b->prev = NULL;
+    b->next = NULL;
+    return b;
+}
+
+/* Keep one empty block for the next boundary crossing, free the rest */
+static void dsc_deque_release_block(dsc_deque *dq, dsc_deque_block *b) {
+    if (dq->spare == NULL) {
+        dq->spare = b;
+    } else {
+        dsc_mem_free(dq->allocator, b, dsc_deque_block_size(dq));
+    }
+}
+
+/* Attach a fresh block after tail (or as the only block); tail_pos becomes 0 */
+static bool dsc_deque_grow_back(dsc_deque *dq) {
+    dsc_deque_block *b = dsc_deque_take_block(dq);
+    if (b == NULL) return false;
+
+    if (dq->tail == NULL) {
+        dq->head     = b;
+        dq->head_pos = 0;
+    } else {
+        b->prev        = dq->tail;
+        dq->tail->next = b;
+    }
+    dq->tail     = b;
+    dq->tail_pos = 0;
+    return true;
+}
+
+static bool dsc_deque_grow_front(dsc_deque *dq) {
+    dsc_deque_block *b = dsc_deque_take_block(dq);
+    if (b == NULL) return false;
+
+    if (dq->head == NULL) {
+        dq->tail     = b;
+        dq->tail_pos = dq->block_items;
+    } else {
+        b->next        = dq->head;
+        dq->head->prev = b;
+    }
+    dq->head     = b;
+    dq->head_pos = dq->block_items;
+    return true;
+}
+
+/* After removing items: drop blocks that no longer hold any */
+static void dsc_deque_trim(dsc_deque *dq) {
+    if (dq->size == 0) {
+        if (dq->head != NULL) dsc_deque_release_block(dq, dq->head);
+        dq->head = dq->tail = NULL;
+        dq->head_pos = dq->tail_pos = 0;
+        return;
+    }
+    if (dq->tail_pos == 0) {
+        dsc_deque_block *b = dq->tail;
+        dq->tail       = b->prev;
+        dq->tail->next = NULL;
+        dq->tail_pos   = dq->block_items;
+        dsc_deque_release_block(dq, b);
+    }
+    if (dq->head_pos == dq->block_items) {
+        dsc_deque_block *b = dq->head;
+        dq->head       = b->next;
+        dq->head->prev = NULL;
+        dq->head_pos   = 0;
+        dsc_deque_release_block(dq, b);
+    }
+}
+
+void DSC_FUNC(deque_init)(dsc_deque* dq, size_t item_size, size_t block_items) {
+    DSC_FUNC(deque_init_with_allocator)(dq, item_size, block_items, NULL);
+}
+
+void DSC_FUNC(deque_init_with_allocator)(dsc_deque* dq, size_t item_size, size_t block_items, const dsc_allocator* allocator) {
+    dsc_set_error(DSC_EOK);
+
+    if (dq == NULL || item_size == 0) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+
+    if (block_items == 0) {
+        block_items = (DSC_DEQUE_BLOCK_BYTES - DSC_DEQUE_HEADER) / item_size;
+        if (block_items < 8) block_items = 8;
+    }
+
+    size_t bytes;
+    if (dsc_mul_overflow(block_items, item_size, &bytes) || dsc_add_overflow(bytes, DSC_DEQUE_HEADER, &bytes)) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+
+    *dq = (dsc_deque){
+        .item_size   = item_size,
+        .block_items = block_items,
+        .allocator   = allocator
+    };
+}
+
+void DSC_FUNC(deque_clear)(dsc_deque* dq) {
+    if (dq == NULL || dq->item_size == 0) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    dsc_set_error(DSC_EOK);
+
+    for (dsc_deque_block *b = dq->head; b != NULL; ) {
+        dsc_deque_block *next = b->next;
+        dsc_deque_release_block(dq, b);
+        b = next;
+    }
+    dq->head = dq->tail = NULL;
+    dq->head_pos = dq->tail_pos = 0;
+    dq->size = 0;
+}
+
+void DSC_FUNC(deque_destroy)(dsc_deque* dq) {
+    if (dq == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    if (dq->item_size != 0) DSC_FUNC(deque_clear)(dq);
+    if (dq->spare != NULL) dsc_mem_free(dq->allocator, dq->spare, dsc_deque_block_size(dq));
+    *dq = (dsc_deque){0};
+    dsc_set_error(DSC_EOK);
+}
+
+bool DSC_FUNC(deque_push_back)(dsc_deque* dq, const void* item) {
+    dsc_set_error(DSC_EOK);
+
+    if (dq == NULL || item == NULL || dq->item_size == 0) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    if ((dq->tail == NULL || dq->tail_pos == dq->block_items) && !dsc_deque_grow_back(dq)) {
+        dsc_set_error(DSC_ENOMEM);
+        return false;
+    }
+
+    memcpy(dsc_deque_slot(dq, dq->tail, dq->tail_pos++), item, dq->item_size);
+    dq->size++;
+    return true;
+}
+
+bool DSC_FUNC(deque_push_front)(dsc_deque* dq, const void* item) {
+    dsc_set_error(DSC_EOK);
+
+    if (dq == NULL || item == NULL || dq->item_size == 0) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    if ((dq->head == NULL || dq->head_pos == 0) && !dsc_deque_grow_front(dq)) {
+        dsc_set_error(DSC_ENOMEM);
+        return false;
+    }
+
+    memcpy(dsc_deque_slot(dq, dq->head, --dq->head_pos), item, dq->item_size);
+    dq->size++;
+    return true;
+}
+
+bool DSC_FUNC(deque_pop_back)(dsc_deque* dq, void* out_item) {
+    dsc_set_error(DSC_EOK);
+
+    if (dq == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    if (dq->size == 0) {
+        dsc_set_error(DSC_EEMPTY);
+        return false;
+    }
+
+    dq->tail_pos--;
+    if (out_item != NULL) memcpy(out_item, dsc_deque_slot(dq, dq->tail, dq->tail_pos), dq->item_size);
+    dq->size--;
+    dsc_deque_trim(dq);
+    return true;
+}
+
+bool DSC_FUNC(deque_pop_front)(dsc_deque* dq, void* out_item) {
+    dsc_set_error(DSC_EOK);
+
+    if (dq == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return false;
+    }
+    if (dq->size == 0) {
+        dsc_set_error(DSC_EEMPTY);
+        return false;
+    }
+
+    if (out_item != NULL) memcpy(out_item, dsc_deque_slot(dq, dq->head, dq->head_pos), dq->item_size);
+    dq->head_pos++;
+    dq->size--;
+    dsc_deque_trim(dq);
+    return true;
+}
+
+void* DSC_FUNC(deque_peek_back)(dsc_deque* dq) {
+    if (dq == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+    if (dq->size == 0) {
+        dsc_set_error(DSC_EEMPTY);
+        return NULL;
+    }
+    dsc_set_error(DSC_EOK);
+    return dsc_deque_slot(dq, dq->tail, dq->tail_pos - 1);
+}
+
+void* DSC_FUNC(deque_peek_front)(dsc_deque* dq) {
+    if (dq == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+    if (dq->size == 0) {
+        dsc_set_error(DSC_EEMPTY);
+        return NULL;
+    }
+    dsc_set_error(DSC_EOK);
+    return dsc_deque_slot(dq, dq->head, dq->head_pos);
+}
+
+void* DSC_FUNC(deque_get)(dsc_deque* dq, size_t index) {
+    dsc_set_error(DSC_EOK);
+
+    if (dq == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return NULL;
+    }
+    if (index >= dq->size) {
+        dsc_set_error(DSC_ERANGE);
+        return NULL;
+    }
+
+    if (index < dq->size / 2) {
+        size_t pos = dq->head_pos + index;
+        dsc_deque_block *b = dq->head;
+        for (; pos >= dq->block_items; pos -= dq->block_items) b = b->next;
+        return dsc_deque_slot(dq, b, pos);
+    }
+
+    /* Distance back from the last item */
+    size_t back = dq->size - 1 - index;
+    dsc_deque_block *b = dq->tail;
+    size_t in_tail = dq->tail_pos;
+    while (back >= in_tail) {
+        back   -= in_tail;
+        b       = b->prev;
+        in_tail = dq->block_items;
+    }
+    return dsc_deque_slot(dq, b, in_tail - 1 - back);
+}
+
+size_t DSC_FUNC(deque_size)(dsc_deque* dq) {
+    if (dq == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    dsc_set_error(DSC_EOK);
+    return dq->size;
+}
+
+size_t DSC_FUNC(deque_push_back_n)(dsc_deque* dq, const void* items, size_t count) {
+    dsc_set_error(DSC_EOK);
+
+    if (dq == NULL || dq->item_size == 0 || (count > 0 && items == NULL)) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+
+    const unsigned char *src  = (const unsigned char *)items;
+    size_t               done = 0;
+    while (done < count) {
+        if ((dq->tail == NULL || dq->tail_pos == dq->block_items) && !dsc_deque_grow_back(dq)) {
+            dsc_set_error(DSC_ENOMEM);
+            break;
+        }
+        size_t room = dq->block_items - dq->tail_pos;
+        size_t n    = (count - done < room) ? count - done : room;
+
+        memcpy(dsc_deque_slot(dq, dq->tail, dq->tail_pos), src + done * dq->item_size, n * dq->item_size);
+        dq->tail_pos += n;
+        dq->size     += n;
+        done         += n;
+    }
+    return done;
+}
+
+size_t DSC_FUNC(deque_pop_back_n)(dsc_deque* dq, void* out_items, size_t count) {
+    dsc_set_error(DSC_EOK);
+
+    if (dq == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+
+    size_t total = (count < dq->size) ? count : dq->size;
+    size_t left  = total;
+    while (left > 0) {
+        /* Items of the tail block that belong to this pop */
+        size_t first = (dq->tail == dq->head) ? dq->head_pos : 0;
+        size_t avail = dq->tail_pos - first;
+        size_t n     = (left < avail) ? left : avail;
+
+        dq->tail_pos -= n;
+        left         -= n;
+        if (out_items != NULL) {
+            memcpy((unsigned char *)out_items + left * dq->item_size, dsc_deque_slot(dq, dq->tail, dq->tail_pos), n * dq->item_size);
+        }
+        dq->size -= n;
+        dsc_deque_trim(dq);
+    }
+    return total;
+}
+
+size_t DSC_FUNC(deque_pop_front_n)(dsc_deque* dq, void* out_items, size_t count) {
+    dsc_set_error(DSC_EOK);
+
+    if (dq == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+
+    size_t total = (count < dq->size) ? count : dq->size;
+    size_t done  = 0;
+    while (done < total) {
+        size_t end   = (dq->head == dq->tail) ? dq->tail_pos : dq->block_items;
+        size_t avail = end - dq->head_pos;
+        size_t n     = (total - done < avail) ? total - done : avail;
+
+        if (out_items != NULL) {
+            memcpy((unsigned char *)out_items + done * dq->item_size, dsc_deque_slot(dq, dq->head, dq->head_pos), n * dq->item_size);
+        }
+        dq->head_pos += n;
+        dq->size     -= n;
+        done         += n;
+        dsc_deque_trim(dq);
+    }
+    return total;
+}
+
+/*
+ * +----------------------------------------------------------------+
+ * |                  LOCK-FREE QUEUE Implementation                |
+ * +----------------------------------------------------------------+
+ */
+
+/* size_t atomics: GCC/Clang builtins, Interlocked intrinsics on MSVC */
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+    #if defined(_WIN64)
+        typedef __int64 dsc_msvc_atomic;
+        #define DSC_MSVC_OR        _InterlockedOr64
+        #define DSC_MSVC_XCHG      _InterlockedExchange64
+        #define DSC_MSVC_CAS       _InterlockedCompareExchange64
+        #define DSC_MSVC_XADD      _InterlockedExchangeAdd64
+    #else
+        typedef long dsc_msvc_atomic;
+        #define DSC_MSVC_OR        _InterlockedOr
+        #define DSC_MSVC_XCHG      _InterlockedExchange
+        #define DSC_MSVC_CAS       _InterlockedCompareExchange
+        #define DSC_MSVC_XADD      _InterlockedExchangeAdd
+    #endif
+
+    static inline size_t dsc_atomic_load_relaxed(const size_t *p) { return *(const volatile size_t *)p; }
+    static inline size_t dsc_atomic_load_acquire(const size_t *p) { return (size_t)DSC_MSVC_OR((volatile dsc_msvc_atomic *)p, 0); }
+    static inline void   dsc_atomic_store_release(size_t *p, size_t v) { DSC_MSVC_XCHG((volatile dsc_msvc_atomic *)p, (dsc_msvc_atomic)v); }
+    static inline size_t dsc_atomic_fetch_add(size_t *p, size_t v) { return (size_t)DSC_MSVC_XADD((volatile dsc_msvc_atomic *)p, (dsc_msvc_atomic)v); }
+    static inline bool   dsc_atomic_cas(size_t *p, size_t *expected, size_t desired) {
+        size_t seen = (size_t)DSC_MSVC_CAS((volatile dsc_msvc_atomic *)p, (dsc_msvc_atomic)desired, (dsc_msvc_atomic)*expected);
+        if (seen == *expected) return true;
+        *expected = seen;
+        return false;
+    }
+#else
+    static inline size_t dsc_atomic_load_relaxed(const size_t *p) { return __atomic_load_n(p, __ATOMIC_RELAXED); }
+    static inline size_t dsc_atomic_load_acquire(const size_t *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+    static inline void   dsc_atomic_store_release(size_t *p, size_t v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+    static inline size_t dsc_atomic_fetch_add(size_t *p, size_t v) { return __atomic_fetch_add(p, v, __ATOMIC_ACQ_REL); }
+    /* Weak CAS: may fail spuriously, *expected receives the current value on failure */
+    static inline bool   dsc_atomic_cas(size_t *p, size_t *expected, size_t desired) {
+        return __atomic_compare_exchange_n(p, expected, desired, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+    }
+#endif
+
+#define DSC_QUEUE_DEFAULT_CAPACITY 256
+
+/* Round a requested capacity (0 = default) to a power of two >= 2, 0 on overflow */
+static size_t dsc_queue_capacity(size_t requested) {
+    if (requested == 0) requested = DSC_QUEUE_DEFAULT_CAPACITY;
+    size_t cap = 2;
+    while (cap < requested) {
+        if (cap > SIZE_MAX / 2) return 0;
+        cap <<= 1;
+    }
+    return cap;
+}
+
+/* Copy count items into/out of a ring starting at index idx, wrapping once */
+static inline void dsc_ring_copy_in(unsigned char *ring, size_t mask, size_t item_size, size_t idx, const unsigned char *src, size_t count) {
+    size_t first = mask + 1 - idx;
+    if (first > count) first = count;
+    memcpy(ring + idx * item_size, src, first * item_size);
+    memcpy(ring, src + first * item_size, (count - first) * item_size);
+}
+
+static inline void dsc_ring_copy_out(const unsigned char *ring, size_t mask, size_t item_size, size_t idx, unsigned char *dst, size_t count) {
+    size_t first = mask + 1 - idx;
+    if (first > count) first = count;
+    memcpy(dst, ring + idx * item_size, first * item_size);
+    memcpy(dst + first * item_size, ring, (count - first) * item_size);
+}
+
+/* ---------------------------------------------------------------
+   MPMC queue. Cell i is free for position p when seq == p, and holds
+   the item for position p when seq == p + 1.
+   --------------------------------------------------------------- */
+
+#define DSC_MPMC_CELL(q, pos) ((q)->cells + ((pos) & (q)->mask) * (q)->cell_size)
+#define DSC_MPMC_SEQ(cell)    ((size_t *)(void *)(cell))
+#define DSC_MPMC_DATA(cell)   ((cell) + sizeof(size_t))
+
+void DSC_FUNC(mpmc_queue_init)(dsc_mpmc_queue *q, size_t item_size, size_t capacity) {
+    if (q == NULL || item_size == 0) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    memset(q, 0, sizeof(*q));
+
+    size_t cap = dsc_queue_capacity(capacity);
+    /* Keep every cell's sequence number size_t-aligned */
+    size_t cell_size = (sizeof(size_t) + item_size + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+    if (cap == 0 || cell_size < item_size || cap > SIZE_MAX / cell_size) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+
+    q->cells = (unsigned char *)malloc(cap * cell_size);
+    if (q->cells == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    q->cell_size = cell_size;
+    q->item_size = item_size;
+    q->mask      = cap - 1;
+    for (size_t i = 0; i < cap; i++) *DSC_MPMC_SEQ(q->cells + i * cell_size) = i;
+
+    dsc_set_error(DSC_EOK);
+}
+
+void DSC_FUNC(mpmc_queue_destroy)(dsc_mpmc_queue *q) {
+    if (q == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    free(q->cells); q->cells = NULL;
+    q->mask = 0;
+    dsc_set_error(DSC_EOK);
+}
+
+size_t DSC_FUNC(mpmc_queue_push_n)(dsc_mpmc_queue *q, const void *items, size_t count) {
+    if (q == NULL || q->cells == NULL || (items == NULL && count > 0)) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    if (count == 0) return 0;
+
+    size_t pos = dsc_atomic_load_relaxed(&q->enqueue_pos);
+    for (;;) {
+        /* Count the free cells from pos onward, then claim them all with one CAS */
+        size_t n = 0;
+        while (n < count && n <= q->mask) {
+            if (dsc_atomic_load_acquire(DSC_MPMC_SEQ(DSC_MPMC_CELL(q, pos + n))) != pos + n) break;
+            n++;
+        }
+
+        if (n == 0) {
+            size_t seq = dsc_atomic_load_acquire(DSC_MPMC_SEQ(DSC_MPMC_CELL(q, pos)));
+            if ((ptrdiff_t)(seq - pos) < 0) {
+                /* The cell still holds the previous lap's item */
+                dsc_set_error(DSC_EFULL);
+                return 0;
+            }
+            pos = dsc_atomic_load_relaxed(&q->enqueue_pos);
+            continue;
+        }
+
+        if (dsc_atomic_cas(&q->enqueue_pos, &pos, pos + n)) {
+            const unsigned char *src = (const unsigned char *)items;
+            for (size_t i = 0; i < n; i++) {
+                unsigned char *cell = DSC_MPMC_CELL(q, pos + i);
+                memcpy(DSC_MPMC_DATA(cell), src + i * q->item_size, q->item_size);
+                dsc_atomic_store_release(DSC_MPMC_SEQ(cell), pos + i + 1);
+            }
+            return n;
+        }
+        /* Lost the race: pos now holds the current enqueue position */
+    }
+}
+
+size_t DSC_FUNC(mpmc_queue_pop_n)(dsc_mpmc_queue *q, void *out_items, size_t count) {
+    if (q == NULL || q->cells == NULL || (out_items == NULL && count > 0)) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    if (count == 0) return 0;
+
+    size_t pos = dsc_atomic_load_relaxed(&q->dequeue_pos);
+    for (;;) {
+        size_t n = 0;
+        while (n < count && n <= q->mask) {
+            if (dsc_atomic_load_acquire(DSC_MPMC_SEQ(DSC_MPMC_CELL(q, pos + n))) != pos + n + 1) break;
+            n++;
+        }
+
+        if (n == 0) {
+            size_t seq = dsc_atomic_load_acquire(DSC_MPMC_SEQ(DSC_MPMC_CELL(q, pos)));
+            if ((ptrdiff_t)(seq - (pos + 1)) < 0) {
+                dsc_set_error(DSC_EEMPTY);
+                return 0;
+            }
+            pos = dsc_atomic_load_relaxed(&q->dequeue_pos);
+            continue;
+        }
+
+        if (dsc_atomic_cas(&q->dequeue_pos, &pos, pos + n)) {
+            unsigned char *dst = (unsigned char *)out_items;
+            for (size_t i = 0; i < n; i++) {
+                unsigned char *cell = DSC_MPMC_CELL(q, pos + i);
+                memcpy(dst + i * q->item_size, DSC_MPMC_DATA(cell), q->item_size);
+                /* Free the cell for the producer one lap ahead */
+                dsc_atomic_store_release(DSC_MPMC_SEQ(cell), pos + i + q->mask + 1);
+            }
+            return n;
+        }
+    }
+}
+
+bool DSC_FUNC(mpmc_queue_push)(dsc_mpmc_queue *q, const void *item) {
+    return DSC_FUNC(mpmc_queue_push_n)(q, item, 1) == 1;
+}
+
+bool DSC_FUNC(mpmc_queue_pop)(dsc_mpmc_queue *q, void *out_item) {
+    return DSC_FUNC(mpmc_queue_pop_n)(q, out_item, 1) == 1;
+}
+
+/* Approximate while other threads are active */
+size_t DSC_FUNC(mpmc_queue_size)(dsc_mpmc_queue *q) {
+    if (q == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    size_t head = dsc_atomic_load_acquire(&q->dequeue_pos);
+    size_t tail = dsc_atomic_load_acquire(&q->enqueue_pos);
+    return ((ptrdiff_t)(tail - head) > 0) ? tail - head : 0;
+}
+
+/* ---------------------------------------------------------------
+   SPSC ring. tail is only written by the producer and head only by the
+   consumer; each side re-reads the other's index only when its cached
+   copy says the ring is full (or empty).
+   --------------------------------------------------------------- */
+
+void DSC_FUNC(spsc_ring_init)(dsc_spsc_ring *r, size_t item_size, size_t capacity) {
+    if (r == NULL || item_size == 0) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    memset(r, 0, sizeof(*r));
+
+    size_t cap = dsc_queue_capacity(capacity);
+    if (cap == 0 || cap > SIZE_MAX / item_size) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+
+    r->items = (unsigned char *)malloc(cap * item_size);
+    if (r->items == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    r->item_size = item_size;
+    r->mask      = cap - 1;
+    dsc_set_error(DSC_EOK);
+}
+
+void DSC_FUNC(spsc_ring_destroy)(dsc_spsc_ring *r) {
+    if (r == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    free(r->items); r->items = NULL;
+    r->mask = 0;
+    dsc_set_error(DSC_EOK);
+}
+
+size_t DSC_FUNC(spsc_ring_push_n)(dsc_spsc_ring *r, const void *items, size_t count) {
+    if (r == NULL || r->items == NULL || (items == NULL && count > 0)) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    if (count == 0) return 0;
+
+    size_t tail = r->tail;
+    size_t cap  = r->mask + 1;
+    if (cap - (tail - r->head_cache) < count) {
+        r->head_cache = dsc_atomic_load_acquire(&r->head);
+    }
+
+    size_t n = cap - (tail - r->head_cache);
+    if (n > count) n = count;
+    if (n == 0) {
+        dsc_set_error(DSC_EFULL);
+        return 0;
+    }
+
+    dsc_ring_copy_in(r->items, r->mask, r->item_size, tail & r->mask, (const unsigned char *)items, n);
+    dsc_atomic_store_release(&r->tail, tail + n);
+    return n;
+}
+
+size_t DSC_FUNC(spsc_ring_pop_n)(dsc_spsc_ring *r, void *out_items, size_t count) {
+    if (r == NULL || r->items == NULL || (out_items == NULL && count > 0)) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    if (count == 0) return 0;
+
+    size_t head = r->head;
+    if (r->tail_cache - head < count) {
+        r->tail_cache = dsc_atomic_load_acquire(&r->tail);
+    }
+
+    size_t n = r->tail_cache - head;
+    if (n > count) n = count;
+    if (n == 0) {
+        dsc_set_error(DSC_EEMPTY);
+        return 0;
+    }
+
+    dsc_ring_copy_out(r->items, r->mask, r->item_size, head & r->mask, (unsigned char *)out_items, n);
+    dsc_atomic_store_release(&r->head, head + n);
+    return n;
+}
+
+bool DSC_FUNC(spsc_ring_push)(dsc_spsc_ring *r, const void *item) {
+    return DSC_FUNC(spsc_ring_push_n)(r, item, 1) == 1;
+}
+
+bool DSC_FUNC(spsc_ring_pop)(dsc_spsc_ring *r, void *out_item) {
+    return DSC_FUNC(spsc_ring_pop_n)(r, out_item, 1) == 1;
+}
+
+/* Exact from either side; approximate from a third thread */
+size_t DSC_FUNC(spsc_ring_size)(dsc_spsc_ring *r) {
+    if (r == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
+    }
+    return dsc_atomic_load_acquire(&r->tail) - dsc_atomic_load_acquire(&r->head);
+}
+
+/*
+ * +----------------------------------------------------------------+
+ * |               VERSIONED HASHTABLE Implementation               |
+ * +----------------------------------------------------------------+
+ */
+
+#define DSC_VT_DEFAULT_CHUNKS 256
+#define DSC_VT_CHUNK_MIN      8       /* Slots in a chunk's first array */
+
+#define DSC_VT_PENDING        ((size_t)DSC_VT_ALIGN - 1)
+
+static inline dsc_vt_version *dsc_vt_unpack(size_t word) {
+    return (dsc_vt_version *)(uintptr_t)(word & ~DSC_VT_PENDING);
+}
+
+static inline void dsc_vt_ref(size_t *refs) {
+    dsc_atomic_fetch_add(refs, 1);
+}
+
+/* Drop one reference; true when it was the last */
+static inline bool dsc_vt_unref(size_t *refs) {
+    return dsc_atomic_fetch_add(refs, (size_t)-1) == 1;
+}
+
+static inline dsc_vt_entry **dsc_vt_slots(const dsc_vt_chunk *c) {
+    return (dsc_vt_entry **)(void *)((dsc_vt_chunk *)c + 1);
+}
+
+static inline const void *dsc_vt_entry_key(const dsc_vt_entry *e) {
+    return (const void *)(e + 1);
+}
+
+static inline size_t dsc_vt_chunk_bytes(size_t capacity) {
+    return sizeof(dsc_vt_chunk) + capacity * sizeof(dsc_vt_entry *);
+}
+
+/* Top bits of the mixed hash pick the chunk; dsc_ht_bucket uses the low bits inside it */
+static inline size_t dsc_vt_chunk_index(const dsc_versioned_table *vt, uint64_t hash) {
+    if (vt->chunk_bits == 0) return 0;
+    return (size_t)((hash * 0x9e3779b97f4a7c15ULL) >> (64 - vt->chunk_bits));
+}
+
+static inline size_t dsc_vt_key_size(const dsc_versioned_table *vt, const void *key) {
+    return (vt->key_size != 0) ? vt->key_size : strlen((const char *)key) + 1;
+}
+
+static void dsc_vt_entry_release(const dsc_versioned_table *vt, dsc_vt_entry *e) {
+    if (!dsc_vt_unref(&e->refs)) return;
+    if (vt->reclaim != NULL) vt->reclaim(e->obj);
+    dsc_mem_free(vt->allocator, e, sizeof(dsc_vt_entry) + e->key_size);
+}
+
+static void dsc_vt_chunk_release(const dsc_versioned_table *vt, dsc_vt_chunk *c) {
+    if (c == NULL || !dsc_vt_unref(&c->refs)) return;
+
+    dsc_vt_entry **slots = dsc_vt_slots(c);
+    for (size_t i = 0; i < c->capacity; i++) {
+        if (slots[i] != NULL) dsc_vt_entry_release(vt, slots[i]);
+    }
+    dsc_mem_free(vt->allocator, c, dsc_vt_chunk_bytes(c->capacity));
+}
+
+/* Version, chunk pointers and the slack to align the version */
+static inline size_t dsc_vt_version_bytes(const dsc_versioned_table *vt) {
+    return DSC_VT_ALIGN + sizeof(dsc_vt_version) + vt->chunk_count * sizeof(dsc_vt_chunk *);
+}
+
+static void dsc_vt_version_free(dsc_vt_version *v) {
+    for (size_t i = 0; i < v->table->chunk_count; i++) dsc_vt_chunk_release(v->table, v->chunks[i]);
+    dsc_mem_free(v->table->allocator, v->block, dsc_vt_version_bytes(v->table));
+}
+
+/* A version with every chunk pointer copied from base (or all empty), each one referenced */
+static dsc_vt_version *dsc_vt_version_new(const dsc_versioned_table *vt, const dsc_vt_version *base) {
+    void *block = dsc_mem_calloc(vt->allocator, 1, dsc_vt_version_bytes(vt));
+    if (block == NULL) return NULL;
+
+    uintptr_t at = ((uintptr_t)block + DSC_VT_PENDING) & ~(uintptr_t)DSC_VT_PENDING;
+    dsc_vt_version *v = (dsc_vt_version *)(void *)((unsigned char *)block + (at - (uintptr_t)block));
+    v->refs   = 1;
+    v->table  = vt;
+    v->chunks = (dsc_vt_chunk **)(void *)(v + 1);
+    v->block  = block;
+    if (base != NULL) {
+        v->size   = base->size;
+        v->number = base->number + 1;
+        for (size_t i = 0; i < vt->chunk_count; i++) {
+            v->chunks[i] = base->chunks[i];
+            if (v->chunks[i] != NULL) dsc_vt_ref(&v->chunks[i]->refs);
+        }
+    }
+    return v;
+}
+
+/* Link e into a free slot of c; c must have room */
+static void dsc_vt_chunk_place(dsc_vt_chunk *c, dsc_vt_entry *e) {
+    dsc_vt_entry **slots = dsc_vt_slots(c);
+    size_t mask = c->capacity - 1;
+    size_t i    = dsc_ht_bucket(e->hash, c->capacity);
+    while (slots[i] != NULL) i = (i + 1) & mask;
+    slots[i] = e;
+    c->count++;
+}
+
+/*
+ * New chunk holding c's entries with room for count in total. share adds a
+ * reference to each entry (c stays alive); otherwise they are moved and c
+ * is freed.
+ */
+static dsc_vt_chunk *dsc_vt_chunk_rebuild(const dsc_versioned_table *vt, dsc_vt_chunk *c, size_t count, bool share) {
+    size_t capacity = DSC_VT_CHUNK_MIN;
+    while (capacity / 2 < count) {
+        if (capacity > SIZE_MAX / 4 / sizeof(dsc_vt_entry *)) return NULL;
+        capacity <<= 1;
+    }
+
+    dsc_vt_chunk *n = (dsc_vt_chunk *)dsc_mem_calloc(vt->allocator, 1, dsc_vt_chunk_bytes(capacity));
+    if (n == NULL) return NULL;
+    n->refs     = 1;
+    n->capacity = capacity;
+
+    if (c == NULL) return n;
+    dsc_vt_entry **slots = dsc_vt_slots(c);
+    for (size_t i = 0; i < c->capacity; i++) {
+        if (slots[i] == NULL) continue;
+        if (share) dsc_vt_ref(&slots[i]->refs);
+        dsc_vt_chunk_place(n, slots[i]);
+    }
+    if (!share) dsc_mem_free(vt->allocator, c, dsc_vt_chunk_bytes(c->capacity));
+    return n;
+}
+
+/* Slot holding key in c, or NULL */
+static dsc_vt_entry **dsc_vt_chunk_find(const dsc_versioned_table *vt, const dsc_vt_chunk *c, const void *key, size_t key_size, uint64_t hash) {
+    if (c == NULL) return NULL;
+
+    dsc_vt_entry **slots = dsc_vt_slots(c);
+    size_t mask = c->capacity - 1;
+    for (size_t i = dsc_ht_bucket(hash, c->capacity); slots[i] != NULL; i = (i + 1) & mask) {
+        const dsc_vt_entry *e = slots[i];
+        if (e->hash == hash && e->key_size == key_size && vt->cf(dsc_vt_entry_key(e), e->key_size, key, key_size) == 0) {
+            return &slots[i];
+        }
+    }
+    return NULL;
+}
+
+/* Empty slot i and shift the rest of its probe run back so lookups still reach them */
+static void dsc_vt_chunk_unlink(dsc_vt_chunk *c, size_t i) {
+    dsc_vt_entry **slots = dsc_vt_slots(c);
+    size_t mask = c->capacity - 1;
+
+    slots[i] = NULL;
+    c->count--;
+    for (size_t j = (i + 1) & mask; slots[j] != NULL; j = (j + 1) & mask) {
+        size_t home = dsc_ht_bucket(slots[j]->hash, c->capacity);
+        /* slots[j] may fill the hole unless its home lies cyclically in (i, j] */
+        bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (stays) continue;
+        slots[i] = slots[j];
+        slots[j] = NULL;
+        i = j;
+    }
+}
+
+/* The draft's chunk idx as a private copy with room for count entries */
+static dsc_vt_chunk *dsc_vt_batch_chunk(dsc_vt_batch *batch, size_t idx, size_t count) {
+    const dsc_versioned_table *vt = batch->table;
+    dsc_vt_chunk *c = batch->draft->chunks[idx];
+
+    if (!batch->owned[idx]) {
+        dsc_vt_chunk *n = dsc_vt_chunk_rebuild(vt, c, count, true);
+        if (n == NULL) return NULL;
+        dsc_vt_chunk_release(vt, c);    /* base still holds it */
+        batch->draft->chunks[idx] = n;
+        batch->owned[idx] = 1;
+        return n;
+    }
+
+    if (c->capacity / 2 < count) {
+        dsc_vt_chunk *n = dsc_vt_chunk_rebuild(vt, c, count, false);
+        if (n == NULL) return NULL;
+        batch->draft->chunks[idx] = n;
+        return n;
+    }
+    return c;
+}
+
+static void dsc_vt_batch_end(dsc_vt_batch *batch) {
+    dsc_mem_free(batch->table->allocator, batch->owned, batch->table->chunk_count);
+    *batch = (dsc_vt_batch){0};
+}
+
+void DSC_FUNC(versioned_table_init)(dsc_versioned_table *vt, size_t chunk_count, size_t key_size, dsc_hashfunc *hf, dsc_cmpfunc *cf, dsc_cleanupfunc *reclaim)
+{
+    DSC_FUNC(versioned_table_init_with_allocator)(vt, chunk_count, key_size, hf, cf, reclaim, NULL);
+}
+
+void DSC_FUNC(versioned_table_init_with_allocator)(dsc_versioned_table *vt, size_t chunk_count, size_t key_size, dsc_hashfunc *hf, dsc_cmpfunc *cf, dsc_cleanupfunc *reclaim, const dsc_allocator *allocator)
+{
+    dsc_set_error(DSC_EOK);
+
+    if (vt == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
+    *vt = (dsc_versioned_table){0};
+
+    if (hf == NULL) {
+        dsc_set_error(DSC_EHASHFUNC);
+        return;
+    }
+    if (cf == NULL) {
+        dsc_set_error(DSC_ECMPFUNC);
         return;
     }
 
-    DSC_FUNC(list_init)(list, item_size, count);
-    if (DSC_FUNC(get_error)() != DSC_EOK) {
+    if (chunk_count == 0) chunk_count = DSC_VT_DEFAULT_CHUNKS;
+    chunk_count = dsc_ht_round_pow2(chunk_count);
+    if (chunk_count == 0 || chunk_count > SIZE_MAX / 2 / sizeof(dsc_vt_chunk *)) {
+        dsc_set_error(DSC_ENOMEM);
         return;
     }
 
-    for (size_t i = 0; i < count; i++) {
-        const void* item = (const char*)array + (i * item_size);
-        DSC_FUNC(list_append)(list, (void*)item);
+    unsigned bits = 0;
+    while (((size_t)1 << bits) < chunk_count) bits++;
+
+    *vt = (dsc_versioned_table) {
+        .chunk_count = chunk_count,
+        .chunk_bits  = bits,
+        .key_size    = key_size,
+        .hf          = hf,
+        .cf          = cf,
+        .reclaim     = reclaim,
+        .allocator   = allocator
+    };
+
+    dsc_vt_version *v = dsc_vt_version_new(vt, NULL);
+    if (v == NULL) {
+        *vt = (dsc_versioned_table){0};
+        dsc_set_error(DSC_ENOMEM);
+        return;
     }
+    vt->current = (size_t)(uintptr_t)v;
 }
 
-dsc_set DSC_FUNC(list_to_set)(dsc_list* list, dsc_hashfunc* hf, dsc_cmpfunc* cf) {
-    dsc_set result = {0};
-    
-    if (list == NULL || hf == NULL || cf == NULL) {
+void DSC_FUNC(versioned_table_destroy)(dsc_versioned_table *vt)
+{
+    if (vt == NULL) {
         dsc_set_error(DSC_EINVAL);
-        return result;
+        return;
     }
     dsc_set_error(DSC_EOK);
 
-    DSC_FUNC(set_init)(&result, list->length, list->item_size, hf, cf);
-    if (DSC_FUNC(get_error)() != DSC_EOK) {
-        return result;
-    }
-
-    for (size_t i = 0; i < list->length; i++) {
-        void* item = (char*)list->items + (i * list->item_size);
-        DSC_FUNC(set_add)(&result, item);
-    }
-    return result;
+    if (vt->current != 0) DSC_FUNC(versioned_table_release)(dsc_vt_unpack(vt->current));
+    *vt = (dsc_versioned_table){0};
 }
 
-bool DSC_FUNC(list_has_duplicates)(dsc_list* list, dsc_hashfunc* hf, dsc_cmpfunc* cf) {
-    if (list == NULL || hf == NULL || cf == NULL) {
+dsc_vt_version *DSC_FUNC(versioned_table_acquire)(dsc_versioned_table *vt)
+{
+    /* hf is set only by a successful init; current may be mid-swap */
+    if (vt == NULL || vt->hf == NULL) {
         dsc_set_error(DSC_EINVAL);
-        return false;
+        return NULL;
     }
     dsc_set_error(DSC_EOK);
 
-    dsc_set temp_set;
-    DSC_FUNC(set_init)(&temp_set, list->length, list->item_size, hf, cf);
-    if (DSC_FUNC(get_error)() != DSC_EOK) {
-        return false;
+    /*
+     * Claim an in-flight unit on the current word. While it is there, the
+     * version is either still current (the table holds it) or commit has
+     * already added the unit to its refs, so taking a real reference is safe.
+     */
+    size_t word = dsc_atomic_load_relaxed(&vt->current);
+    for (;;) {
+        if ((word & DSC_VT_PENDING) == DSC_VT_PENDING) {
+            word = dsc_atomic_load_relaxed(&vt->current);
+            continue;
+        }
+        if (dsc_atomic_cas(&vt->current, &word, word + 1)) break;
     }
-
-    bool has_duplicates = false;
-    for (size_t i = 0; i < list->length; i++) {
-        void* item = (char*)list->items + (i * list->item_size);
-        if (!DSC_FUNC(set_add)(&temp_set, item)) {
-            /* If add fails due to existing item, we found a duplicate */
-            if (DSC_FUNC(get_error)() == DSC_EEXISTS) {
-                has_duplicates = true;
-                break;
-            }
+    dsc_vt_version *v = dsc_vt_unpack(word);
+    dsc_vt_ref(&v->refs);
+
+    /* Hand the unit back; once v is swapped out, commit has turned it into a reference to drop */
+    for (;;) {
+        if (dsc_vt_unpack(word) != v) {
+            dsc_vt_unref(&v->refs);     /* Never the last: ours remains */
+            break;
         }
+        if (dsc_atomic_cas(&vt->current, &word, word - 1)) break;
     }
-
-    DSC_FUNC(set_destroy)(&temp_set);
-    dsc_set_error(DSC_EOK);
-    return has_duplicates;
+    return v;
 }
 
-/*
- * +----------------------------------------------------------------+
- * |                     Set Implementation                         |
- * +----------------------------------------------------------------+
- */
-
- void DSC_FUNC(set_init)(dsc_set* set, size_t initial_capacity, size_t key_size, dsc_hashfunc* hf, dsc_cmpfunc* cf) {
+void DSC_FUNC(versioned_table_release)(dsc_vt_version *v)
+{
+    if (v == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
+    }
     dsc_set_error(DSC_EOK);
 
-    if (set == NULL) {
+    if (dsc_vt_unref(&v->refs)) dsc_vt_version_free(v);
+}
+
+void *DSC_FUNC(versioned_table_get)(const dsc_vt_version *v, const void *key)
+{
+    if (v == NULL || key == NULL) {
         dsc_set_error(DSC_EINVAL);
-        return;
+        return NULL;
     }
 
-    set->ht = (dsc_hash_table*)malloc(sizeof(dsc_hash_table));
-    if (set->ht == NULL) {
-        dsc_set_error(DSC_ENOMEM);
-        return;
+    const dsc_versioned_table *vt = v->table;
+    size_t   key_size = dsc_vt_key_size(vt, key);
+    uint64_t hash     = vt->hf(key, key_size);
+
+    dsc_vt_entry **slot = dsc_vt_chunk_find(vt, v->chunks[dsc_vt_chunk_index(vt, hash)], key, key_size, hash);
+    if (slot == NULL) {
+        dsc_set_error(DSC_ENOTFOUND);
+        return NULL;
     }
+    dsc_set_error(DSC_EOK);
+    return (*slot)->obj;
+}
 
-    DSC_FUNC(hash_table_init)(set->ht, initial_capacity, key_size, hf, cf);
-    if (DSC_FUNC(get_error)() != DSC_EOK) {
-        free(set->ht);
-        set->ht = NULL;
-        return;
+size_t DSC_FUNC(versioned_table_size)(const dsc_vt_version *v)
+{
+    if (v == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return 0;
     }
+    dsc_set_error(DSC_EOK);
+    return v->size;
 }
 
-void DSC_FUNC(set_destroy)(dsc_set* set) {
-    if (set == NULL) {
+void DSC_FUNC(versioned_table_foreach)(const dsc_vt_version *v, dsc_scanfunc *fn, void *ctx)
+{
+    if (v == NULL || fn == NULL) {
         dsc_set_error(DSC_EINVAL);
         return;
     }
     dsc_set_error(DSC_EOK);
 
-    if (set->ht != NULL) {
-        DSC_FUNC(hash_table_destroy)(set->ht, NULL);
-        free(set->ht);
-        set->ht = NULL;
+    for (size_t i = 0; i < v->table->chunk_count; i++) {
+        const dsc_vt_chunk *c = v->chunks[i];
+        if (c == NULL) continue;
+
+        dsc_vt_entry **slots = dsc_vt_slots(c);
+        for (size_t j = 0; j < c->capacity; j++) {
+            if (slots[j] != NULL) fn(dsc_vt_entry_key(slots[j]), slots[j]->key_size, slots[j]->obj, slots[j]->hash, ctx);
+        }
     }
 }
 
-bool DSC_FUNC(set_add)(dsc_set* set, const void* item) {
-    dsc_set_error(DSC_EOK);
-
-    if (set == NULL || item == NULL) {
+bool DSC_FUNC(versioned_table_begin)(dsc_versioned_table *vt, dsc_vt_batch *batch)
+{
+    if (batch == NULL) {
         dsc_set_error(DSC_EINVAL);
         return false;
     }
+    *batch = (dsc_vt_batch){0};
 
-    bool res = DSC_FUNC(hash_table_insert)(set->ht, item, (void*)item);
-    if (!res) {
-        // Error already set by hash_table_insert
+    dsc_vt_version *base = DSC_FUNC(versioned_table_acquire)(vt);
+    if (base == NULL) return false;
+
+    dsc_vt_version *draft = dsc_vt_version_new(vt, base);
+    unsigned char  *owned = (unsigned char *)dsc_mem_calloc(vt->allocator, vt->chunk_count, 1);
+    if (draft == NULL || owned == NULL) {
+        if (draft != NULL) dsc_vt_version_free(draft);
+        dsc_mem_free(vt->allocator, owned, vt->chunk_count);
+        DSC_FUNC(versioned_table_release)(base);
+        dsc_set_error(DSC_ENOMEM);
         return false;
     }
+
+    *batch = (dsc_vt_batch) {
+        .table = vt,
+        .base  = base,
+        .draft = draft,
+        .owned = owned
+    };
     return true;
 }
 
-void DSC_FUNC(set_remove)(dsc_set* set, const void* item) {
+bool DSC_FUNC(versioned_table_put)(dsc_vt_batch *batch, const void *key, void *obj)
+{
     dsc_set_error(DSC_EOK);
 
-    if (set == NULL || item == NULL) {
+    if (batch == NULL || batch->draft == NULL || key == NULL || obj == NULL) {
         dsc_set_error(DSC_EINVAL);
-        return;
+        return false;
     }
 
-    void* removed = DSC_FUNC(hash_table_delete)(set->ht, item);
-    if (removed == NULL) {
-        // Error already set by hash_table_delete
-        return;
+    const dsc_versioned_table *vt = batch->table;
+    size_t   key_size = dsc_vt_key_size(vt, key);
+    uint64_t hash     = vt->hf(key, key_size);
+    size_t   idx      = dsc_vt_chunk_index(vt, hash);
+
+    dsc_vt_entry **slot = dsc_vt_chunk_find(vt, batch->draft->chunks[idx], key, key_size, hash);
+    if (slot != NULL && (*slot)->obj == obj) return true;
+
+    /* Putting back what base stored (after a delete, or over another object)
+       shares base's entry, so the object keeps one entry and one reclaim */
+    dsc_vt_entry **prev = dsc_vt_chunk_find(vt, batch->base->chunks[idx], key, key_size, hash);
+    dsc_vt_entry *e     = (prev != NULL && (*prev)->obj == obj) ? *prev : NULL;
+    size_t bytes = 0;
+
+    if (e != NULL) {
+        dsc_vt_ref(&e->refs);
+    } else {
+        if (dsc_add_overflow(sizeof(dsc_vt_entry), key_size, &bytes)) {
+            dsc_set_error(DSC_ENOMEM);
+            return false;
+        }
+        e = (dsc_vt_entry *)dsc_mem_alloc(vt->allocator, bytes);
+        if (e == NULL) {
+            dsc_set_error(DSC_ENOMEM);
+            return false;
+        }
+        *e = (dsc_vt_entry) {
+            .refs     = 1,
+            .hash     = hash,
+            .obj      = obj,
+            .key_size = key_size
+        };
+        memcpy((void *)(e + 1), key, key_size);
+    }
+
+    const dsc_vt_chunk *shared = batch->draft->chunks[idx];
+    size_t count = ((shared != NULL) ? shared->count : 0) + (slot == NULL);
+    dsc_vt_chunk *c = dsc_vt_batch_chunk(batch, idx, count);
+    if (c == NULL) {
+        /* base still holds a shared entry, so dropping it never reclaims */
+        if (bytes == 0) (void)dsc_vt_unref(&e->refs);
+        else dsc_mem_free(vt->allocator, e, bytes);
+        dsc_set_error(DSC_ENOMEM);
+        return false;
+    }
+
+    /* The chunk may have been copied: look the slot up again in the private one */
+    slot = (slot != NULL) ? dsc_vt_chunk_find(vt, c, key, key_size, hash) : NULL;
+    if (slot != NULL) {
+        dsc_vt_entry *old = *slot;
+        *slot = e;
+        dsc_vt_entry_release(vt, old);
+    } else {
+        dsc_vt_chunk_place(c, e);
+        batch->draft->size++;
     }
+    return true;
 }
 
-void* DSC_FUNC(set_get)(dsc_set* set, const void* item) {
+bool DSC_FUNC(versioned_table_delete)(dsc_vt_batch *batch, const void *key)
+{
     dsc_set_error(DSC_EOK);
 
-    if (set == NULL || item == NULL) {
+    if (batch == NULL || batch->draft == NULL || key == NULL) {
         dsc_set_error(DSC_EINVAL);
-        return NULL;
+        return false;
     }
 
-    void* found = DSC_FUNC(hash_table_get)(set->ht, item);
-    if (found == NULL) {
-        // Error already set by hash_table_get
-        return NULL;
+    const dsc_versioned_table *vt = batch->table;
+    size_t   key_size = dsc_vt_key_size(vt, key);
+    uint64_t hash     = vt->hf(key, key_size);
+    size_t   idx      = dsc_vt_chunk_index(vt, hash);
+
+    /* Absent keys never cost a chunk copy */
+    dsc_vt_chunk *c = batch->draft->chunks[idx];
+    if (dsc_vt_chunk_find(vt, c, key, key_size, hash) == NULL) {
+        dsc_set_error(DSC_ENOTFOUND);
+        return false;
     }
-    return found;
-}
 
-void DSC_FUNC(set_clear)(dsc_set* set) {
-    if (set == NULL) {
-        dsc_set_error(DSC_EINVAL);
-        return;
+    c = dsc_vt_batch_chunk(batch, idx, c->count);
+    if (c == NULL) {
+        dsc_set_error(DSC_ENOMEM);
+        return false;
     }
-    dsc_set_error(DSC_EOK);
 
-    DSC_FUNC(hash_table_clear)(set->ht, NULL);
+    dsc_vt_entry **slot = dsc_vt_chunk_find(vt, c, key, key_size, hash);
+    dsc_vt_entry *e = *slot;
+    dsc_vt_chunk_unlink(c, (size_t)(slot - dsc_vt_slots(c)));
+    dsc_vt_entry_release(vt, e);
+    batch->draft->size--;
+    return true;
 }
 
-void DSC_FUNC(set_from_array)(dsc_set* set, const void* array, size_t count, size_t item_size, dsc_hashfunc* hf, dsc_cmpfunc* cf) {
-    dsc_set_error(DSC_EOK);
-
-    if (set == NULL || array == NULL || hf == NULL || cf == NULL) {
+bool DSC_FUNC(versioned_table_commit)(dsc_vt_batch *batch)
+{
+    if (batch == NULL || batch->draft == NULL) {
         dsc_set_error(DSC_EINVAL);
-        return;
+        return false;
     }
 
-    DSC_FUNC(set_init)(set, count, item_size, hf, cf);
-    if (DSC_FUNC(get_error)() != DSC_EOK) {
-        return;
-    }
+    dsc_versioned_table *vt = batch->table;
+    bool published = false;
 
-    for (size_t i = 0; i < count; i++) {
-        const void* item;
-        if (item_size == 0) {
-            /* Variable-length keys: array contains pointers to keys */
-            item = *((const void**)array + i);
-        } else {
-            /* Fixed-size keys: array contains keys directly */
-            item = (const char*)array + (i * item_size);
+    size_t word = dsc_atomic_load_relaxed(&vt->current);
+    while (dsc_vt_unpack(word) == batch->base) {
+        if (dsc_atomic_cas(&vt->current, &word, (size_t)(uintptr_t)batch->draft)) {
+            published = true;
+            break;
         }
-        DSC_FUNC(set_add)(set, item);
     }
-}
 
-dsc_list DSC_FUNC(set_to_list)(dsc_set* set) {
-    dsc_list result = {0};
+    if (published) {
+        /* Acquires still in flight on base now own references to it */
+        dsc_atomic_fetch_add(&batch->base->refs, word & DSC_VT_PENDING);
 
-    if (set == NULL || set->ht == NULL) {
-        dsc_set_error(DSC_EINVAL);
-        return result;
+        /* The table's reference moves to the draft; drop it and the batch's on base */
+        DSC_FUNC(versioned_table_release)(batch->base);
+        DSC_FUNC(versioned_table_release)(batch->base);
+    } else {
+        DSC_FUNC(versioned_table_release)(batch->draft);
+        DSC_FUNC(versioned_table_release)(batch->base);
     }
-    dsc_set_error(DSC_EOK);
+    dsc_vt_batch_end(batch);
 
-    DSC_FUNC(list_init)(&result, set->ht->key_size ? set->ht->key_size : sizeof(void*), set->ht->size);
-    if (DSC_FUNC(get_error)() != DSC_EOK) {
-        return result;
-    }
+    dsc_set_error(published ? DSC_EOK : DSC_ECONFLICT);
+    return published;
+}
 
-    for (size_t i = 0; i < set->ht->capacity; i++) {
-        dsc_kvpair* kvp = set->ht->kvpairs[i];
-        while (kvp != NULL) {
-            DSC_FUNC(list_append)(&result, kvp->key);
-            kvp = kvp->next;
-        }
+void DSC_FUNC(versioned_table_abort)(dsc_vt_batch *batch)
+{
+    if (batch == NULL || batch->draft == NULL) {
+        dsc_set_error(DSC_EINVAL);
+        return;
     }
 
-    return result;
+    DSC_FUNC(versioned_table_release)(batch->draft);
+    DSC_FUNC(versioned_table_release)(batch->base);
+    dsc_vt_batch_end(batch);
+    dsc_set_error(DSC_EOK);
 }
 
 /*
  * +----------------------------------------------------------------+
- * |                       Stack Implementation                     |
+ * |                    THREAD POOL Implementation                  |
  * +----------------------------------------------------------------+
  */
-
- void DSC_FUNC(stack_init)(dsc_stack* stack, size_t item_size, size_t initial_capacity) {
-    if (stack == NULL || item_size == 0) {
-        dsc_set_error(DSC_EINVAL);
-        return;
+#ifndef DSC_NO_THREADS
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+
+    typedef SRWLOCK             dsc_mutex;
+    typedef CONDITION_VARIABLE  dsc_cond;
+    typedef HANDLE              dsc_thread;
+
+    static inline bool dsc_mutex_init(dsc_mutex *m)         { InitializeSRWLock(m); return true; }
+    static inline void dsc_mutex_destroy(dsc_mutex *m)      { (void)m; }
+    static inline void dsc_mutex_lock(dsc_mutex *m)         { AcquireSRWLockExclusive(m); }
+    static inline void dsc_mutex_unlock(dsc_mutex *m)       { ReleaseSRWLockExclusive(m); }
+    static inline bool dsc_cond_init(dsc_cond *c)           { InitializeConditionVariable(c); return true; }
+    static inline void dsc_cond_destroy(dsc_cond *c)        { (void)c; }
+    static inline void dsc_cond_wait(dsc_cond *c, dsc_mutex *m) { SleepConditionVariableSRW(c, m, INFINITE, 0); }
+    static inline void dsc_cond_signal(dsc_cond *c)         { WakeConditionVariable(c); }
+    static inline void dsc_cond_broadcast(dsc_cond *c)      { WakeAllConditionVariable(c); }
+
+    static inline size_t dsc_cpu_count(void) {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return (size_t)info.dwNumberOfProcessors;
     }
+#else
+    #include <unistd.h>
+
+    typedef pthread_mutex_t     dsc_mutex;
+    typedef pthread_cond_t      dsc_cond;
+    typedef pthread_t           dsc_thread;
+
+    static inline bool dsc_mutex_init(dsc_mutex *m)         { return pthread_mutex_init(m, NULL) == 0; }
+    static inline void dsc_mutex_destroy(dsc_mutex *m)      { pthread_mutex_destroy(m); }
+    static inline void dsc_mutex_lock(dsc_mutex *m)         { pthread_mutex_lock(m); }
+    static inline void dsc_mutex_unlock(dsc_mutex *m)       { pthread_mutex_unlock(m); }
+    static inline bool dsc_cond_init(dsc_cond *c)           { return pthread_cond_init(c, NULL) == 0; }
+    static inline void dsc_cond_destroy(dsc_cond *c)        { pthread_cond_destroy(c); }
+    static inline void dsc_cond_wait(dsc_cond *c, dsc_mutex *m) { pthread_cond_wait(c, m); }
+    static inline void dsc_cond_signal(dsc_cond *c)         { pthread_cond_signal(c); }
+    static inline void dsc_cond_broadcast(dsc_cond *c)      { pthread_cond_broadcast(c); }
+
+    static inline size_t dsc_cpu_count(void) {
+    #if defined(_SC_NPROCESSORS_ONLN)
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        return (n > 0) ? (size_t)n : 1;
+    #else
+        return 1;
+    #endif
+    }
+#endif
 
-    dsc_list_init(&stack->list, item_size, initial_capacity);
+struct _dsc_pool_state {
+    dsc_mutex       lock;
+    dsc_cond        work;           /* Workers wait here for a new generation */
+    dsc_cond        done;           /* parallel_for waits here for busy == 0 */
+    dsc_thread      *threads;
+
+    /* Current job, published under lock by bumping generation */
+    dsc_range_func  fn;
+    void            *ctx;
+    size_t          count;
+    size_t          chunk;
+    size_t          generation;
+    size_t          busy;           /* Workers that have not finished this generation */
+    bool            stop;
+
+    char            pad[DSC_CACHE_LINE];
+    size_t          next;           /* Next unclaimed index, atomic */
+};
+
+/* Claim and run chunks until the range is exhausted */
+static void dsc_pool_drain(struct _dsc_pool_state *s) {
+    for (;;) {
+        size_t begin = dsc_atomic_fetch_add(&s->next, s->chunk);
+        if (begin >= s->count) return;
+        size_t end = (s->count - begin > s->chunk) ? begin + s->chunk : s->count;
+        s->fn(s->ctx, begin, end);
+    }
 }
 
-bool DSC_FUNC(stack_push)(dsc_stack* stack, void* item) {
-     if (stack == NULL || item == NULL) {
-        dsc_set_error(DSC_EINVAL);
-        return false;
-    }
+static void dsc_pool_worker(struct _dsc_pool_state *s) {
+    size_t seen = 0;
 
-    dsc_list_append(&stack->list, item);
+    dsc_mutex_lock(&s->lock);
+    for (;;) {
+        while (!s->stop && s->generation == seen) {
+            dsc_cond_wait(&s->work, &s->lock);
+        }
+        if (s->stop) break;
+        seen = s->generation;
+        dsc_mutex_unlock(&s->lock);
 
-    return dsc_get_error() == DSC_EOK;
-}
+        dsc_pool_drain(s);
 
-void* DSC_FUNC(stack_pop)(dsc_stack* stack, void *out_item) {
-    if (stack == NULL) {
-        dsc_set_error(DSC_EINVAL);
-        return NULL;
-    }
-    if (stack->list.length == 0) {
-        dsc_set_error(DSC_EEMPTY);
-        return NULL;
+        dsc_mutex_lock(&s->lock);
+        if (--s->busy == 0) {
+            dsc_cond_signal(&s->done);
+        }
     }
+    dsc_mutex_unlock(&s->lock);
+}
 
-    void* item = DSC_FUNC(list_get)(&stack->list, stack->list.length - 1);
+#if defined(_WIN32)
+static DWORD WINAPI dsc_pool_thread_main(LPVOID arg) {
+    dsc_pool_worker((struct _dsc_pool_state *)arg);
+    return 0;
+}
 
-    memcpy(out_item, item, stack->list.item_size);
-    DSC_FUNC(list_pop)(&stack->list);
+static inline bool dsc_thread_start(dsc_thread *t, struct _dsc_pool_state *s) {
+    *t = CreateThread(NULL, 0, dsc_pool_thread_main, s, 0, NULL);
+    return *t != NULL;
+}
 
-    return out_item;
+static inline void dsc_thread_join(dsc_thread t) {
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+#else
+static void *dsc_pool_thread_main(void *arg) {
+    dsc_pool_worker((struct _dsc_pool_state *)arg);
+    return NULL;
 }
 
-void* DSC_FUNC(stack_peek)(dsc_stack* stack) {
-    if (stack == NULL) {
+static inline bool dsc_thread_start(dsc_thread *t, struct _dsc_pool_state *s) {
+    return pthread_create(t, NULL, dsc_pool_thread_main, s) == 0;
+}
+
+static inline void dsc_thread_join(dsc_thread t) {
+    pthread_join(t, NULL);
+}
+#endif
+
+/* thread_count 0 = one worker per CPU beyond the calling thread */
+void DSC_FUNC(thread_pool_init)(dsc_thread_pool *pool, size_t thread_count) {
+    dsc_set_error(DSC_EOK);
+
+    if (pool == NULL) {
         dsc_set_error(DSC_EINVAL);
-        return NULL;
+        return;
     }
-    if (stack->list.length == 0) {
-        dsc_set_error(DSC_EEMPTY);
-        return NULL;
+    *pool = (dsc_thread_pool){0};
+
+    if (thread_count == 0) thread_count = dsc_cpu_count() - 1;
+    if (thread_count == 0) return;
+
+    struct _dsc_pool_state *s = (struct _dsc_pool_state *)calloc(1, sizeof(*s));
+    dsc_thread *threads = (dsc_thread *)calloc(thread_count, sizeof(dsc_thread));
+    if (s == NULL || threads == NULL) {
+        free(s);
+        free(threads);
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    if (!dsc_mutex_init(&s->lock)) {
+        free(s);
+        free(threads);
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    if (!dsc_cond_init(&s->work) || !dsc_cond_init(&s->done)) {
+        dsc_mutex_destroy(&s->lock);
+        free(s);
+        free(threads);
+        dsc_set_error(DSC_ENOMEM);
+        return;
+    }
+    s->threads = threads;
+    pool->state = s;
+
+    /* Keep however many workers the OS lets us start */
+    for (size_t i = 0; i < thread_count; i++) {
+        if (!dsc_thread_start(&threads[i], s)) break;
+        pool->thread_count++;
+    }
+    if (pool->thread_count == 0) {
+        DSC_FUNC(thread_pool_destroy)(pool);
+        dsc_set_error(DSC_ENOMEM);
     }
-    dsc_set_error(DSC_EOK);
-    return dsc_list_get(&stack->list, stack->list.length - 1);
 }
 
-size_t DSC_FUNC(stack_size)(dsc_stack* stack) {
-    if (stack == NULL) {
+void DSC_FUNC(thread_pool_destroy)(dsc_thread_pool *pool) {
+    if (pool == NULL) {
         dsc_set_error(DSC_EINVAL);
-        return 0;
+        return;
     }
     dsc_set_error(DSC_EOK);
-    return stack->list.length;
+
+    struct _dsc_pool_state *s = pool->state;
+    if (s != NULL) {
+        dsc_mutex_lock(&s->lock);
+        s->stop = true;
+        dsc_cond_broadcast(&s->work);
+        dsc_mutex_unlock(&s->lock);
+
+        for (size_t i = 0; i < pool->thread_count; i++) {
+            dsc_thread_join(s->threads[i]);
+        }
+        dsc_cond_destroy(&s->work);
+        dsc_cond_destroy(&s->done);
+        dsc_mutex_destroy(&s->lock);
+        free(s->threads);
+        free(s);
+    }
+    pool->state        = NULL;
+    pool->thread_count = 0;
 }
 
-bool DSC_FUNC(stack_is_empty)(dsc_stack* stack) {
-    if (stack == NULL) {
+#else /* DSC_NO_THREADS */
+
+void DSC_FUNC(thread_pool_init)(dsc_thread_pool *pool, size_t thread_count) {
+    (void)thread_count;
+    if (pool == NULL) {
         dsc_set_error(DSC_EINVAL);
-        return true;
+        return;
     }
     dsc_set_error(DSC_EOK);
-    return stack->list.length == 0;
+    *pool = (dsc_thread_pool){0};
 }
 
-void DSC_FUNC(stack_clear)(dsc_stack* stack) {
-    if (stack == NULL) {
+void DSC_FUNC(thread_pool_destroy)(dsc_thread_pool *pool) {
+    if (pool == NULL) {
         dsc_set_error(DSC_EINVAL);
         return;
     }
-    dsc_list_clear(&stack->list);
+    dsc_set_error(DSC_EOK);
 }
 
-void DSC_FUNC(stack_destroy)(dsc_stack* stack) {
-    if (stack == NULL) {
+#endif /* DSC_NO_THREADS */
+
+/* chunk 0 = pick one from count and the pool size. Does not touch the error on success. */
+void DSC_FUNC(thread_pool_parallel_for)(dsc_thread_pool *pool, size_t count, size_t chunk, dsc_range_func fn, void *ctx) {
+    if (fn == NULL) {
         dsc_set_error(DSC_EINVAL);
         return;
     }
-    dsc_list_destroy(&stack->list);
+    if (count == 0) return;
+    if (chunk == 0) chunk = dsc_pool_chunk(pool, count);
+
+#ifndef DSC_NO_THREADS
+    struct _dsc_pool_state *s = (pool != NULL) ? pool->state : NULL;
+    if (s != NULL && count > chunk) {
+        dsc_mutex_lock(&s->lock);
+        s->fn    = fn;
+        s->ctx   = ctx;
+        s->count = count;
+        s->chunk = chunk;
+        dsc_atomic_store_release(&s->next, 0);
+        s->busy  = pool->thread_count;
+        s->generation++;
+        dsc_cond_broadcast(&s->work);
+        dsc_mutex_unlock(&s->lock);
+
+        dsc_pool_drain(s);
+
+        dsc_mutex_lock(&s->lock);
+        while (s->busy != 0) {
+            dsc_cond_wait(&s->done, &s->lock);
+        }
+        dsc_mutex_unlock(&s->lock);
+        return;
+    }
+#endif
+    fn(ctx, 0, count);
 }
 
 #endif /* DSC_IMPLEMENTATION */
@@ -66,10 +66,10 @@ for src in "${TEST_FILES[@]}"; do
     echo "Compiling $src..."
     case "$COMPILER" in
         clang)
-            clang -Wall -Wextra -o "build/$name" "$src" || BUILD_FAILED=1
+            clang -Wall -Wextra -pthread -o "build/$name" "$src" || BUILD_FAILED=1
             ;;
         *)
-            gcc -Wall -Wextra -o "build/$name" "$src" || BUILD_FAILED=1
+            gcc -Wall -Wextra -pthread -o "build/$name" "$src" || BUILD_FAILED=1
             ;;
     esac
 done
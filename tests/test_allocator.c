@@ -0,0 +1,273 @@
+/**
+ * Allocator Tests
+ * Tests the pluggable dsc_allocator interface and the dsc_arena backend.
+ */
+
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <string.h>
+
+static int str_cmp(const void* key1, size_t len1, const void* key2, size_t len2) {
+    (void)len1;
+    (void)len2;
+    return strcmp((const char*)key1, (const char*)key2);
+}
+
+static uint64_t str_hash(const void* key, size_t len) {
+    const char* str = (const char*)key;
+    uint64_t hash = 5381;
+    (void)len;
+
+    int c;
+    while ((c = *str++)) {
+        hash = ((hash << 5) + hash) + (uint64_t)c;
+    }
+    return hash;
+}
+
+/* =========================================================
+   Arena Tests
+   ========================================================= */
+
+TEST(arena_alloc_basic) {
+    dsc_arena arena;
+    dsc_arena_init(&arena, 1024);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    char* a = (char*)dsc_arena_alloc(&arena, 10);
+    char* b = (char*)dsc_arena_alloc(&arena, 10);
+    ASSERT_NOT_NULL(a);
+    ASSERT_NOT_NULL(b);
+    ASSERT_TRUE(a != b);
+    ASSERT_EQ(0, ((uintptr_t)a) % 16);
+    ASSERT_EQ(0, ((uintptr_t)b) % 16);
+
+    memset(a, 'x', 10);
+    memset(b, 'y', 10);
+    ASSERT_EQ('x', a[9]);
+
+    dsc_arena_destroy(&arena);
+    ASSERT_NULL(arena.slabs);
+}
+
+TEST(arena_oversized_and_new_slabs) {
+    dsc_arena arena;
+    dsc_arena_init(&arena, 256);
+
+    void* big = dsc_arena_alloc(&arena, 4096);
+    ASSERT_NOT_NULL(big);
+    memset(big, 0, 4096);
+
+    for (int i = 0; i < 100; i++) {
+        ASSERT_NOT_NULL(dsc_arena_alloc(&arena, 64));
+    }
+    ASSERT_NOT_NULL(arena.slabs->next);
+
+    dsc_arena_destroy(&arena);
+}
+
+TEST(arena_reset_reuses_slab) {
+    dsc_arena arena;
+    dsc_arena_init(&arena, 256);
+
+    for (int i = 0; i < 50; i++) dsc_arena_alloc(&arena, 64);
+    dsc_arena_reset(&arena);
+    ASSERT_NOT_NULL(arena.slabs);
+    ASSERT_NULL(arena.slabs->next);
+    ASSERT_EQ(0, arena.slabs->used);
+
+    ASSERT_NOT_NULL(dsc_arena_alloc(&arena, 64));
+    dsc_arena_destroy(&arena);
+}
+
+TEST(arena_alloc_errors) {
+    dsc_arena arena;
+    dsc_arena_init(&arena, 256);
+
+    ASSERT_NULL(dsc_arena_alloc(NULL, 16));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_NOT_NULL(dsc_arena_alloc(&arena, 16));
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    /* Rounding up overflows, then the slab header does */
+    ASSERT_NULL(dsc_arena_alloc(&arena, SIZE_MAX));
+    ASSERT_EQ(DSC_ENOMEM, dsc_get_error());
+    ASSERT_NULL(dsc_arena_alloc(&arena, SIZE_MAX - 16));
+    ASSERT_EQ(DSC_ENOMEM, dsc_get_error());
+
+    dsc_arena_destroy(&arena);
+}
+
+TEST(arena_realloc_grows_in_place) {
+    dsc_arena arena;
+    dsc_arena_init(&arena, 1024);
+
+    void* p = arena.allocator.alloc(arena.allocator.ctx, 32);
+    memset(p, 7, 32);
+    void* q = arena.allocator.realloc(arena.allocator.ctx, p, 32, 64);
+    ASSERT_TRUE(p == q);
+
+    /* Not the latest allocation anymore: must move and copy */
+    arena.allocator.alloc(arena.allocator.ctx, 16);
+    unsigned char* r = (unsigned char*)arena.allocator.realloc(arena.allocator.ctx, q, 64, 128);
+    ASSERT_TRUE(r != q);
+    ASSERT_EQ(7, r[31]);
+
+    dsc_arena_destroy(&arena);
+}
+
+/* =========================================================
+   Container Integration Tests
+   ========================================================= */
+
+TEST(hash_table_with_arena) {
+    dsc_arena arena;
+    dsc_arena_init(&arena, 0);
+
+    dsc_hash_table ht;
+    dsc_hash_table_init_with_allocator(&ht, 4, 0, str_hash, str_cmp, &arena.allocator);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    int values[500];
+    char keys[500][24];
+    for (int i = 0; i < 500; i++) {
+        values[i] = i;
+        snprintf(keys[i], sizeof(keys[i]), "arena%d", i);
+        ASSERT_TRUE(dsc_hash_table_insert(&ht, keys[i], &values[i]));
+    }
+    for (int i = 0; i < 500; i++) {
+        ASSERT_EQ(i, *(int*)dsc_hash_table_get(&ht, keys[i]));
+    }
+    ASSERT_EQ(7, *(int*)dsc_hash_table_delete(&ht, keys[7]));
+
+    dsc_hash_table_clear(&ht, NULL);
+    ASSERT_EQ(0, ht.size);
+    ASSERT_NULL(dsc_hash_table_get(&ht, keys[1]));
+
+    dsc_hash_table_destroy(&ht, NULL);
+    dsc_arena_destroy(&arena);
+}
+
+TEST(hash_table_key_colocated_with_node) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 16, 0, str_hash, str_cmp);
+
+    int v = 1;
+    dsc_hash_table_insert(&ht, "colocated", &v);
+
+    dsc_kvpair* kvp = NULL;
+    for (size_t i = 0; i < ht.capacity && kvp == NULL; i++) kvp = ht.kvpairs[i];
+    ASSERT_NOT_NULL(kvp);
+    ASSERT_TRUE((char*)kvp->key == (char*)(kvp + 1));
+    ASSERT_STR_EQ("colocated", (char*)kvp->key);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_counting_allocator_balanced) {
+    counting_ctx ctx = {0};
+    dsc_allocator alloc = { counting_alloc, counting_realloc, counting_free, &ctx };
+
+    dsc_hash_table ht;
+    dsc_hash_table_init_with_allocator(&ht, 4, 0, str_hash, str_cmp, &alloc);
+
+    int values[100];
+    char keys[100][16];
+    for (int i = 0; i < 100; i++) {
+        values[i] = i;
+        snprintf(keys[i], sizeof(keys[i]), "cnt%d", i);
+        dsc_hash_table_insert(&ht, keys[i], &values[i]);
+    }
+    dsc_hash_table_delete(&ht, keys[0]);
+    dsc_hash_table_destroy(&ht, NULL);
+
+    ASSERT_TRUE(ctx.allocs > 100);
+    ASSERT_EQ(ctx.allocs, ctx.frees);
+}
+
+TEST(list_with_arena) {
+    dsc_arena arena;
+    dsc_arena_init(&arena, 0);
+
+    dsc_list list;
+    dsc_list_init_with_allocator(&list, sizeof(int), 2, &arena.allocator);
+    for (int i = 0; i < 1000; i++) dsc_list_append(&list, &i);
+    ASSERT_EQ(1000, list.length);
+    for (int i = 0; i < 1000; i++) ASSERT_EQ(i, *(int*)dsc_list_get(&list, (size_t)i));
+
+    dsc_list_destroy(&list);
+    dsc_arena_destroy(&arena);
+}
+
+static int is_even(void* item) {
+    return *(int*)item % 2 == 0;
+}
+
+TEST(list_filter_inherits_allocator) {
+    counting_ctx ctx = {0};
+    dsc_allocator alloc = { counting_alloc, counting_realloc, counting_free, &ctx };
+
+    dsc_list list;
+    dsc_list_init_with_allocator(&list, sizeof(int), 4, &alloc);
+    for (int i = 0; i < 10; i++) dsc_list_append(&list, &i);
+
+    dsc_list evens = dsc_list_filter(&list, is_even);
+    ASSERT_EQ(5, evens.length);
+    ASSERT_TRUE(evens.allocator == &alloc);
+
+    dsc_list_destroy(&evens);
+    dsc_list_destroy(&list);
+    ASSERT_EQ(ctx.allocs, ctx.frees);
+}
+
+TEST(set_and_stack_with_allocator) {
+    counting_ctx ctx = {0};
+    dsc_allocator alloc = { counting_alloc, counting_realloc, counting_free, &ctx };
+
+    dsc_set set;
+    dsc_set_init_with_allocator(&set, 8, 0, str_hash, str_cmp, &alloc);
+    ASSERT_TRUE(dsc_set_add(&set, "one"));
+    ASSERT_TRUE(dsc_set_add(&set, "two"));
+    ASSERT_NOT_NULL(dsc_set_get(&set, "one"));
+    dsc_set_destroy(&set);
+
+    dsc_stack stack;
+    dsc_stack_init_with_allocator(&stack, sizeof(int), 2, &alloc);
+    for (int i = 0; i < 20; i++) dsc_stack_push(&stack, &i);
+    int out;
+    ASSERT_NOT_NULL(dsc_stack_pop(&stack, &out));
+    ASSERT_EQ(19, out);
+    dsc_stack_destroy(&stack);
+
+    ASSERT_TRUE(ctx.allocs > 0);
+    ASSERT_EQ(ctx.allocs, ctx.frees);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("Allocator Tests");
+
+    TEST_SECTION("Arena");
+    RUN_TEST(arena_alloc_basic);
+    RUN_TEST(arena_oversized_and_new_slabs);
+    RUN_TEST(arena_reset_reuses_slab);
+    RUN_TEST(arena_alloc_errors);
+    RUN_TEST(arena_realloc_grows_in_place);
+
+    TEST_SECTION("Container Integration");
+    RUN_TEST(hash_table_with_arena);
+    RUN_TEST(hash_table_key_colocated_with_node);
+    RUN_TEST(hash_table_counting_allocator_balanced);
+    RUN_TEST(list_with_arena);
+    RUN_TEST(list_filter_inherits_allocator);
+    RUN_TEST(set_and_stack_with_allocator);
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,287 @@
+/**
+ * Bitset Tests
+ * Tests dsc_bitset membership, algebra, iteration and list/set conversions.
+ */
+
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <string.h>
+
+static uint64_t u32_hash(const void* key, size_t len) {
+    (void)len;
+    uint32_t k;
+    memcpy(&k, key, sizeof(k));
+    return (uint64_t)k * 0x9E3779B97F4A7C15ULL;
+}
+
+static int u32_cmp(const void* key1, size_t len1, const void* key2, size_t len2) {
+    (void)len1;
+    (void)len2;
+    uint32_t a, b;
+    memcpy(&a, key1, sizeof(a));
+    memcpy(&b, key2, sizeof(b));
+    return (a > b) - (a < b);
+}
+
+/* =========================================================
+   Membership Tests
+   ========================================================= */
+
+TEST(bitset_add_contains_remove) {
+    dsc_bitset bs;
+    dsc_bitset_init(&bs, 200);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(0, dsc_bitset_count(&bs));
+
+    ASSERT_TRUE(dsc_bitset_add(&bs, 0));
+    ASSERT_TRUE(dsc_bitset_add(&bs, 63));
+    ASSERT_TRUE(dsc_bitset_add(&bs, 64));
+    ASSERT_TRUE(dsc_bitset_add(&bs, 199));
+    ASSERT_FALSE(dsc_bitset_add(&bs, 63));
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(4, dsc_bitset_count(&bs));
+
+    ASSERT_TRUE(dsc_bitset_contains(&bs, 64));
+    ASSERT_FALSE(dsc_bitset_contains(&bs, 65));
+    ASSERT_FALSE(dsc_bitset_contains(&bs, 100000));
+
+    ASSERT_TRUE(dsc_bitset_remove(&bs, 64));
+    ASSERT_FALSE(dsc_bitset_remove(&bs, 64));
+    ASSERT_FALSE(dsc_bitset_contains(&bs, 64));
+    ASSERT_EQ(3, dsc_bitset_count(&bs));
+
+    dsc_bitset_clear(&bs);
+    ASSERT_EQ(0, dsc_bitset_count(&bs));
+
+    dsc_bitset_destroy(&bs);
+    ASSERT_NULL(bs.words);
+}
+
+TEST(bitset_out_of_range) {
+    dsc_bitset bs;
+    dsc_bitset_init(&bs, 10);
+
+    ASSERT_FALSE(dsc_bitset_add(&bs, 10));
+    ASSERT_EQ(DSC_ERANGE, dsc_get_error());
+    ASSERT_EQ(0, dsc_bitset_count(&bs));
+
+    ASSERT_FALSE(dsc_bitset_add(NULL, 1));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_bitset_destroy(&bs);
+}
+
+TEST(bitset_resize_keeps_and_drops) {
+    dsc_bitset bs;
+    dsc_bitset_init(&bs, 70);
+    dsc_bitset_add(&bs, 5);
+    dsc_bitset_add(&bs, 69);
+
+    dsc_bitset_resize(&bs, 1000);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_TRUE(dsc_bitset_contains(&bs, 69));
+    ASSERT_TRUE(dsc_bitset_add(&bs, 999));
+    ASSERT_EQ(3, dsc_bitset_count(&bs));
+
+    /* Shrinking inside a word must clear the tail bits too */
+    dsc_bitset_resize(&bs, 60);
+    ASSERT_EQ(1, dsc_bitset_count(&bs));
+    dsc_bitset_resize(&bs, 80);
+    ASSERT_FALSE(dsc_bitset_contains(&bs, 69));
+
+    dsc_bitset_destroy(&bs);
+}
+
+TEST(bitset_next_and_foreach) {
+    dsc_bitset bs;
+    dsc_bitset_init(&bs, 1000);
+    size_t ids[] = { 3, 64, 65, 500, 999 };
+    for (int i = 0; i < 5; i++) dsc_bitset_add(&bs, ids[i]);
+
+    int n = 0;
+    DSC_BITSET_FOREACH(&bs, id) {
+        ASSERT_EQ(ids[n], id);
+        n++;
+    }
+    ASSERT_EQ(5, n);
+
+    ASSERT_EQ(64, dsc_bitset_next(&bs, 4));
+    ASSERT_EQ(999, dsc_bitset_next(&bs, 501));
+    ASSERT_TRUE(dsc_bitset_next(&bs, 1000) == DSC_BITSET_END);
+
+    dsc_bitset empty;
+    dsc_bitset_init(&empty, 0);
+    ASSERT_TRUE(dsc_bitset_next(&empty, 0) == DSC_BITSET_END);
+
+    dsc_bitset_destroy(&empty);
+    dsc_bitset_destroy(&bs);
+}
+
+/* =========================================================
+   Algebra Tests
+   ========================================================= */
+
+static void fill_multiples(dsc_bitset* bs, size_t nbits, size_t step) {
+    dsc_bitset_init(bs, nbits);
+    for (size_t i = 0; i < nbits; i += step) dsc_bitset_add(bs, i);
+}
+
+TEST(bitset_and_or_andnot) {
+    dsc_bitset twos, threes, work;
+    fill_multiples(&twos, 600, 2);     /* 300 ids */
+    fill_multiples(&threes, 300, 3);   /* 100 ids */
+
+    fill_multiples(&work, 600, 2);
+    dsc_bitset_and(&work, &threes);
+    ASSERT_EQ(50, dsc_bitset_count(&work));       /* Multiples of 6 below 300 */
+    ASSERT_FALSE(dsc_bitset_contains(&work, 306));
+    ASSERT_EQ(50, dsc_bitset_and_count(&twos, &threes));
+    dsc_bitset_destroy(&work);
+
+    /* OR grows the smaller destination */
+    fill_multiples(&work, 300, 3);
+    dsc_bitset_or(&work, &twos);
+    ASSERT_EQ(600, work.nbits);
+    ASSERT_EQ(350, dsc_bitset_count(&work));
+    dsc_bitset_destroy(&work);
+
+    fill_multiples(&work, 600, 2);
+    dsc_bitset_andnot(&work, &threes);
+    ASSERT_EQ(250, dsc_bitset_count(&work));
+    ASSERT_TRUE(dsc_bitset_contains(&work, 302));
+    ASSERT_FALSE(dsc_bitset_contains(&work, 6));
+    dsc_bitset_destroy(&work);
+
+    dsc_bitset_destroy(&twos);
+    dsc_bitset_destroy(&threes);
+}
+
+TEST(bitset_is_subset) {
+    dsc_bitset small, big;
+    fill_multiples(&small, 100, 4);
+    fill_multiples(&big, 1000, 2);
+
+    ASSERT_TRUE(dsc_bitset_is_subset(&small, &big));
+    ASSERT_FALSE(dsc_bitset_is_subset(&big, &small));
+
+    dsc_bitset_add(&small, 99);
+    ASSERT_FALSE(dsc_bitset_is_subset(&small, &big));
+
+    dsc_bitset_destroy(&small);
+    dsc_bitset_destroy(&big);
+}
+
+/* =========================================================
+   Conversion Tests
+   ========================================================= */
+
+TEST(bitset_list_round_trip) {
+    dsc_list ids;
+    dsc_list_init(&ids, sizeof(uint32_t), 8);
+    uint32_t values[] = { 700, 2, 130, 2, 64 };
+    for (int i = 0; i < 5; i++) dsc_list_append(&ids, &values[i]);
+
+    dsc_bitset bs;
+    dsc_bitset_from_list(&bs, &ids, 0);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(701, bs.nbits);
+    ASSERT_EQ(4, dsc_bitset_count(&bs));
+
+    dsc_list sorted = dsc_bitset_to_list(&bs, sizeof(uint32_t));
+    ASSERT_EQ(4, sorted.length);
+    ASSERT_EQ(2, *(uint32_t*)dsc_list_get(&sorted, 0));
+    ASSERT_EQ(64, *(uint32_t*)dsc_list_get(&sorted, 1));
+    ASSERT_EQ(130, *(uint32_t*)dsc_list_get(&sorted, 2));
+    ASSERT_EQ(700, *(uint32_t*)dsc_list_get(&sorted, 3));
+    dsc_list_destroy(&sorted);
+    dsc_bitset_destroy(&bs);
+
+    dsc_bitset_from_list(&bs, &ids, 100);
+    ASSERT_EQ(DSC_ERANGE, dsc_get_error());
+    ASSERT_NULL(bs.words);
+
+    dsc_list_destroy(&ids);
+}
+
+TEST(bitset_set_round_trip) {
+    dsc_set set;
+    dsc_set_init(&set, 16, sizeof(uint32_t), u32_hash, u32_cmp);
+    for (uint32_t i = 0; i < 500; i += 5) dsc_set_add(&set, &i);
+
+    dsc_bitset bs;
+    dsc_bitset_from_set(&bs, &set, 0);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(100, dsc_bitset_count(&bs));
+    ASSERT_TRUE(dsc_bitset_contains(&bs, 495));
+
+    dsc_set back = dsc_bitset_to_set(&bs, sizeof(uint32_t), u32_hash, u32_cmp);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(100, back.size);
+    uint32_t probe = 250, missing = 251;
+    ASSERT_NOT_NULL(dsc_set_get(&back, &probe));
+    ASSERT_NULL(dsc_set_get(&back, &missing));
+
+    /* IDs that do not fit the requested width are rejected */
+    dsc_list narrow = dsc_bitset_to_list(&bs, sizeof(uint8_t));
+    ASSERT_EQ(DSC_ERANGE, dsc_get_error());
+    ASSERT_NULL(narrow.items);
+
+    dsc_set_destroy(&back);
+    dsc_bitset_destroy(&bs);
+    dsc_set_destroy(&set);
+}
+
+TEST(bitset_from_set_uses_set_allocator) {
+    counting_ctx  ctx   = {0};
+    dsc_allocator alloc = { counting_alloc, counting_realloc, counting_free, &ctx };
+
+    dsc_set set;
+    dsc_set_init_with_allocator(&set, 16, sizeof(uint32_t), u32_hash, u32_cmp, &alloc);
+    for (uint32_t i = 0; i < 300; i += 3) dsc_set_add(&set, &i);
+
+    /* The words are the only allocation: no temporary key list */
+    size_t before = ctx.allocs;
+    dsc_bitset bs;
+    dsc_bitset_from_set(&bs, &set, 0);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(before + 1, ctx.allocs);
+    ASSERT_EQ(298, bs.nbits);
+    ASSERT_EQ(100, dsc_bitset_count(&bs));
+    dsc_bitset_destroy(&bs);
+
+    dsc_bitset_from_set(&bs, &set, 200);
+    ASSERT_EQ(DSC_ERANGE, dsc_get_error());
+    ASSERT_NULL(bs.words);
+
+    dsc_set_destroy(&set);
+    ASSERT_EQ(0, ctx.live);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("Bitset Tests");
+
+    TEST_SECTION("Membership");
+    RUN_TEST(bitset_add_contains_remove);
+    RUN_TEST(bitset_out_of_range);
+    RUN_TEST(bitset_resize_keeps_and_drops);
+    RUN_TEST(bitset_next_and_foreach);
+
+    TEST_SECTION("Algebra");
+    RUN_TEST(bitset_and_or_andnot);
+    RUN_TEST(bitset_is_subset);
+
+    TEST_SECTION("Conversions");
+    RUN_TEST(bitset_list_round_trip);
+    RUN_TEST(bitset_set_round_trip);
+    RUN_TEST(bitset_from_set_uses_set_allocator);
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}
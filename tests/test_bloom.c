@@ -0,0 +1,263 @@
+/**
+ * Bloom Filter Tests
+ * Tests dsc_bloom on its own and attached in front of a hash table or set.
+ */
+
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <string.h>
+
+#define N_KEYS 10000
+
+static void make_key(char* buf, size_t size, const char* prefix, int i) {
+    snprintf(buf, size, "%s-%d", prefix, i);
+}
+
+/* =========================================================
+   Standalone Filter Tests
+   ========================================================= */
+
+TEST(bloom_no_false_negatives) {
+    dsc_bloom bf;
+    dsc_bloom_init(&bf, N_KEYS, 0.01, sizeof(uint64_t), dsc_hash_pod);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_TRUE(bf.k >= 1);
+
+    for (uint64_t i = 0; i < N_KEYS; i++) dsc_bloom_add(&bf, &i);
+    ASSERT_EQ(N_KEYS, bf.count);
+    for (uint64_t i = 0; i < N_KEYS; i++) ASSERT_TRUE(dsc_bloom_contains(&bf, &i));
+
+    dsc_bloom_destroy(&bf);
+    ASSERT_NULL(bf.words);
+}
+
+TEST(bloom_false_positive_rate_near_target) {
+    double rates[] = { 0.1, 0.01, 0.001 };
+    for (int r = 0; r < 3; r++) {
+        dsc_bloom bf;
+        dsc_bloom_init(&bf, N_KEYS, rates[r], sizeof(uint64_t), dsc_hash_pod);
+        for (uint64_t i = 0; i < N_KEYS; i++) dsc_bloom_add(&bf, &i);
+
+        size_t hits = 0, probes = 200000;
+        for (uint64_t i = N_KEYS; i < N_KEYS + probes; i++) hits += dsc_bloom_contains(&bf, &i);
+
+        double measured = (double)hits / (double)probes;
+        ASSERT_TRUE(measured <= rates[r] * 1.5);
+        dsc_bloom_destroy(&bf);
+    }
+}
+
+TEST(bloom_hash_api_and_clear) {
+    dsc_bloom bf;
+    dsc_bloom_init(&bf, 100, 0.01, 0, NULL);
+    ASSERT_EQ(0.0, dsc_bloom_fp_rate(&bf));
+
+    dsc_bloom_add_hash(&bf, 0x1234);
+    ASSERT_TRUE(dsc_bloom_contains_hash(&bf, 0x1234));
+    ASSERT_TRUE(dsc_bloom_fp_rate(&bf) > 0.0);
+
+    /* Key-based calls need a hash function */
+    ASSERT_FALSE(dsc_bloom_contains(&bf, "x"));
+    ASSERT_EQ(DSC_EHASHFUNC, dsc_get_error());
+
+    dsc_bloom_clear(&bf);
+    ASSERT_EQ(0, bf.count);
+    ASSERT_FALSE(dsc_bloom_contains_hash(&bf, 0x1234));
+
+    dsc_bloom_destroy(&bf);
+}
+
+TEST(bloom_invalid_args) {
+    dsc_bloom bf;
+    dsc_bloom_init(&bf, 100, 0.0, 0, dsc_hash_str);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    dsc_bloom_init(&bf, 100, 1.0, 0, dsc_hash_str);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    dsc_bloom_init(NULL, 100, 0.01, 0, dsc_hash_str);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    /* Zero expected items still gives a usable filter */
+    dsc_bloom_init(&bf, 0, 0.01, 0, dsc_hash_str);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    dsc_bloom_add(&bf, "only");
+    ASSERT_TRUE(dsc_bloom_contains(&bf, "only"));
+    dsc_bloom_destroy(&bf);
+}
+
+TEST(bloom_batch_matches_single) {
+    dsc_bloom bf;
+    dsc_bloom_init(&bf, 1000, 0.01, 0, dsc_hash_str);
+
+    static char keys[100][24];
+    const char* ptrs[100];
+    for (int i = 0; i < 100; i++) {
+        make_key(keys[i], sizeof(keys[i]), (i % 2) ? "odd" : "even", i);
+        ptrs[i] = keys[i];
+        if (i % 2 == 0) dsc_bloom_add(&bf, keys[i]);
+    }
+
+    bool out[101];
+    const char* with_null[101];
+    memcpy(with_null, ptrs, sizeof(ptrs));
+    with_null[100] = NULL;
+
+    size_t maybe = dsc_bloom_contains_batch(&bf, with_null, out, 101);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_FALSE(out[100]);
+
+    size_t expected = 0;
+    for (int i = 0; i < 100; i++) {
+        bool single = dsc_bloom_contains(&bf, ptrs[i]);
+        ASSERT_EQ(single, out[i]);
+        if (i % 2 == 0) ASSERT_TRUE(out[i]);
+        expected += single;
+    }
+    ASSERT_EQ(expected, maybe);
+
+    dsc_bloom_destroy(&bf);
+}
+
+/* =========================================================
+   Attached Filter Tests
+   ========================================================= */
+
+TEST(hash_table_filter_short_circuits_misses) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 16, sizeof(int), dsc_hash_pod, dsc_cmp_pod);
+
+    static int values[N_KEYS];
+    for (int i = 0; i < 100; i++) {
+        values[i] = i;
+        dsc_hash_table_insert(&ht, &values[i], &values[i]);
+    }
+
+    /* Existing keys are added on attach, new ones on insert */
+    dsc_bloom bf;
+    dsc_bloom_init(&bf, N_KEYS, 0.01, 0, NULL);
+    dsc_hash_table_attach_filter(&ht, &bf);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(100, bf.count);
+
+    for (int i = 100; i < N_KEYS; i++) {
+        values[i] = i;
+        ASSERT_TRUE(dsc_hash_table_insert(&ht, &values[i], &values[i]));
+    }
+    for (int i = 0; i < N_KEYS; i++) {
+        ASSERT_EQ(i, *(int*)dsc_hash_table_get(&ht, &i));
+    }
+
+    int missing = N_KEYS + 5;
+    ASSERT_NULL(dsc_hash_table_get(&ht, &missing));
+    ASSERT_EQ(DSC_ENOTFOUND, dsc_get_error());
+
+    /* Deleted keys stay in the filter but the chain walk still misses */
+    int gone = 42;
+    ASSERT_NOT_NULL(dsc_hash_table_delete(&ht, &gone));
+    ASSERT_NULL(dsc_hash_table_get(&ht, &gone));
+
+    /* An emptied filter rules everything out: proof lookups consult it */
+    dsc_bloom_clear(&bf);
+    int present = 7;
+    ASSERT_NULL(dsc_hash_table_get(&ht, &present));
+
+    dsc_hash_table_attach_filter(&ht, NULL);
+    ASSERT_NOT_NULL(dsc_hash_table_get(&ht, &present));
+
+    dsc_hash_table_destroy(&ht, NULL);
+    dsc_bloom_destroy(&bf);
+}
+
+TEST(hash_table_filter_clear_and_batch) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 4, 0, dsc_hash_str, dsc_cmp_str);
+
+    dsc_bloom bf;
+    dsc_bloom_init(&bf, 100, 0.01, 0, dsc_hash_str);
+    dsc_hash_table_attach_filter(&ht, &bf);
+
+    static char keys[50][16];
+    const char* ptrs[50];
+    void* objs[50];
+    for (int i = 0; i < 50; i++) {
+        make_key(keys[i], sizeof(keys[i]), "k", i);
+        ptrs[i] = keys[i];
+        objs[i] = keys[i];
+    }
+    ASSERT_EQ(50, dsc_hash_table_insert_batch(&ht, ptrs, objs, 50, NULL));
+
+    /* The attached filter answers key queries with the table's hash */
+    ASSERT_EQ(50, dsc_bloom_contains_batch(&bf, ptrs, NULL, 50));
+    ASSERT_EQ(50, dsc_hash_table_get_batch(&ht, ptrs, NULL, 50, NULL));
+
+    dsc_hash_table_clear(&ht, NULL);
+    ASSERT_EQ(0, bf.count);
+    ASSERT_NULL(dsc_hash_table_get(&ht, "k-1"));
+
+    ASSERT_TRUE(dsc_hash_table_insert(&ht, "again", "again"));
+    ASSERT_NOT_NULL(dsc_hash_table_get(&ht, "again"));
+
+    dsc_hash_table_destroy(&ht, NULL);
+    ASSERT_NULL(ht.filter);
+    dsc_bloom_destroy(&bf);
+}
+
+TEST(set_filter) {
+    dsc_set a, b, out;
+    dsc_set_init(&a, 8, sizeof(int), dsc_hash_pod, dsc_cmp_pod);
+    dsc_set_init(&b, 8, sizeof(int), dsc_hash_pod, dsc_cmp_pod);
+    for (int i = 0; i < 1000; i++) dsc_set_add(&a, &i);
+    for (int i = 500; i < 1500; i++) dsc_set_add(&b, &i);
+
+    dsc_bloom bf;
+    dsc_bloom_init(&bf, 2000, 0.01, 0, NULL);
+    dsc_set_attach_filter(&b, &bf);
+    ASSERT_EQ(1000, bf.count);
+
+    int miss = 100, hit = 700;
+    ASSERT_NULL(dsc_set_get(&b, &miss));
+    ASSERT_NOT_NULL(dsc_set_get(&b, &hit));
+    ASSERT_FALSE(dsc_set_add(&b, &hit));
+    ASSERT_EQ(DSC_EEXISTS, dsc_get_error());
+
+    /* Algebra probing b goes through the filter */
+    dsc_set_intersect(&out, &a, &b);
+    ASSERT_EQ(500, out.size);
+    dsc_set_destroy(&out);
+
+    dsc_set_union_inplace(&b, &a);
+    ASSERT_EQ(1500, b.size);
+    ASSERT_NOT_NULL(dsc_set_get(&b, &miss));
+
+    dsc_set_clear(&b);
+    ASSERT_EQ(0, bf.count);
+
+    dsc_set_destroy(&a);
+    dsc_set_destroy(&b);
+    dsc_bloom_destroy(&bf);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("Bloom Filter Tests");
+
+    TEST_SECTION("Standalone Filter");
+    RUN_TEST(bloom_no_false_negatives);
+    RUN_TEST(bloom_false_positive_rate_near_target);
+    RUN_TEST(bloom_hash_api_and_clear);
+    RUN_TEST(bloom_invalid_args);
+    RUN_TEST(bloom_batch_matches_single);
+
+    TEST_SECTION("Attached Filter");
+    RUN_TEST(hash_table_filter_short_circuits_misses);
+    RUN_TEST(hash_table_filter_clear_and_batch);
+    RUN_TEST(set_filter);
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}
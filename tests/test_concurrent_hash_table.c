@@ -0,0 +1,210 @@
+/**
+ * Concurrent Hash Table Tests
+ * Tests the lock-striped dsc_concurrent_hash_table, single- and multi-threaded.
+ */
+
+#define TEST_THREADS
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <string.h>
+
+#define THREADS        8
+#define KEYS_PER_THREAD 2000
+
+static int int_cmp(const void* key1, size_t len1, const void* key2, size_t len2) {
+    (void)len1;
+    (void)len2;
+    return *(const int*)key1 - *(const int*)key2;
+}
+
+static int cleanup_calls = 0;
+static void count_cleanup(void* obj) {
+    (void)obj;
+    cleanup_calls++;
+}
+
+/* =========================================================
+   Single-Threaded Semantics
+   ========================================================= */
+
+TEST(cht_init_and_errors) {
+    dsc_concurrent_hash_table cht;
+    dsc_concurrent_hash_table_init(&cht, 0, sizeof(int), NULL, int_cmp);
+    ASSERT_EQ(DSC_EHASHFUNC, dsc_get_error());
+    ASSERT_NULL(cht.shards);
+
+    dsc_concurrent_hash_table_init(&cht, 1000, sizeof(int), dsc_hash_pod, int_cmp);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(DSC_CHT_SHARDS, cht.shard_count);
+
+    ASSERT_FALSE(dsc_concurrent_hash_table_insert(&cht, NULL, &cht));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_NULL(dsc_concurrent_hash_table_get(NULL, "x"));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_concurrent_hash_table_destroy(&cht, NULL);
+    ASSERT_NULL(cht.shards);
+}
+
+TEST(cht_insert_get_delete) {
+    dsc_concurrent_hash_table cht;
+    dsc_concurrent_hash_table_init(&cht, 16, 0, dsc_hash_str, dsc_cmp_str);
+
+    int a = 1, b = 2;
+    ASSERT_TRUE(dsc_concurrent_hash_table_insert(&cht, "alpha", &a));
+    ASSERT_TRUE(dsc_concurrent_hash_table_insert(&cht, "beta", &b));
+    ASSERT_FALSE(dsc_concurrent_hash_table_insert(&cht, "alpha", &b));
+    ASSERT_EQ(DSC_EEXISTS, dsc_get_error());
+    ASSERT_EQ(2, dsc_concurrent_hash_table_size(&cht));
+
+    ASSERT_EQ(1, *(int*)dsc_concurrent_hash_table_get(&cht, "alpha"));
+    ASSERT_NULL(dsc_concurrent_hash_table_get(&cht, "gamma"));
+    ASSERT_EQ(DSC_ENOTFOUND, dsc_get_error());
+
+    ASSERT_EQ(2, *(int*)dsc_concurrent_hash_table_delete(&cht, "beta"));
+    ASSERT_NULL(dsc_concurrent_hash_table_delete(&cht, "beta"));
+    ASSERT_EQ(DSC_ENOTFOUND, dsc_get_error());
+    ASSERT_EQ(1, dsc_concurrent_hash_table_size(&cht));
+
+    dsc_concurrent_hash_table_destroy(&cht, NULL);
+}
+
+TEST(cht_grows_and_cleanup_contract) {
+    dsc_concurrent_hash_table cht;
+    dsc_concurrent_hash_table_init(&cht, 0, sizeof(int), dsc_hash_pod, int_cmp);
+
+    static int keys[5000];
+    for (int i = 0; i < 5000; i++) {
+        keys[i] = i;
+        ASSERT_TRUE(dsc_concurrent_hash_table_insert(&cht, &keys[i], &keys[i]));
+    }
+    ASSERT_EQ(5000, dsc_concurrent_hash_table_size(&cht));
+    for (int i = 0; i < 5000; i++) {
+        ASSERT_TRUE(dsc_concurrent_hash_table_get(&cht, &i) == &keys[i]);
+    }
+
+    cleanup_calls = 0;
+    dsc_concurrent_hash_table_clear(&cht, count_cleanup);
+    ASSERT_EQ(5000, cleanup_calls);
+    ASSERT_EQ(0, dsc_concurrent_hash_table_size(&cht));
+
+    for (int i = 0; i < 10; i++) dsc_concurrent_hash_table_insert(&cht, &keys[i], &keys[i]);
+    cleanup_calls = 0;
+    dsc_concurrent_hash_table_destroy(&cht, count_cleanup);
+    ASSERT_EQ(10, cleanup_calls);
+}
+
+/* =========================================================
+   Multi-Threaded Tests
+   ========================================================= */
+
+typedef struct {
+    dsc_concurrent_hash_table* cht;
+    int*                       keys;
+    int                        id;
+    int                        errors;
+} worker_arg;
+
+TEST_THREAD_FN(writer_thread) {
+    worker_arg* w = (worker_arg*)arg;
+    for (int i = 0; i < KEYS_PER_THREAD; i++) {
+        int* key = &w->keys[w->id * KEYS_PER_THREAD + i];
+        if (!dsc_concurrent_hash_table_insert(w->cht, key, key)) w->errors++;
+    }
+    TEST_THREAD_RETURN;
+}
+
+TEST_THREAD_FN(reader_deleter_thread) {
+    worker_arg* w = (worker_arg*)arg;
+    for (int i = 0; i < KEYS_PER_THREAD; i++) {
+        int* key = &w->keys[w->id * KEYS_PER_THREAD + i];
+        if (dsc_concurrent_hash_table_get(w->cht, key) != key) w->errors++;
+        if (i % 2 == 0 && dsc_concurrent_hash_table_delete(w->cht, key) != key) w->errors++;
+    }
+    TEST_THREAD_RETURN;
+}
+
+TEST(cht_parallel_insert_then_read_delete) {
+    static int keys[THREADS * KEYS_PER_THREAD];
+    for (int i = 0; i < THREADS * KEYS_PER_THREAD; i++) keys[i] = i;
+
+    dsc_concurrent_hash_table cht;
+    dsc_concurrent_hash_table_init(&cht, 0, sizeof(int), dsc_hash_pod, int_cmp);
+
+    test_thread threads[THREADS];
+    worker_arg  args[THREADS];
+    for (int t = 0; t < THREADS; t++) {
+        args[t] = (worker_arg){&cht, keys, t, 0};
+        test_thread_start(&threads[t], writer_thread, &args[t]);
+    }
+    for (int t = 0; t < THREADS; t++) test_thread_join(threads[t]);
+    for (int t = 0; t < THREADS; t++) ASSERT_EQ(0, args[t].errors);
+    ASSERT_EQ(THREADS * KEYS_PER_THREAD, dsc_concurrent_hash_table_size(&cht));
+
+    for (int t = 0; t < THREADS; t++) {
+        args[t].errors = 0;
+        test_thread_start(&threads[t], reader_deleter_thread, &args[t]);
+    }
+    for (int t = 0; t < THREADS; t++) test_thread_join(threads[t]);
+    for (int t = 0; t < THREADS; t++) ASSERT_EQ(0, args[t].errors);
+    ASSERT_EQ(THREADS * KEYS_PER_THREAD / 2, dsc_concurrent_hash_table_size(&cht));
+
+    dsc_concurrent_hash_table_destroy(&cht, NULL);
+}
+
+TEST_THREAD_FN(contended_thread) {
+    worker_arg* w = (worker_arg*)arg;
+    /* Every thread races on the same keys: exactly one insert per key wins */
+    for (int i = 0; i < KEYS_PER_THREAD; i++) {
+        if (dsc_concurrent_hash_table_insert(w->cht, &w->keys[i], &w->keys[i])) w->errors++;
+        dsc_concurrent_hash_table_get(w->cht, &w->keys[(i * 7) % KEYS_PER_THREAD]);
+    }
+    TEST_THREAD_RETURN;
+}
+
+TEST(cht_contended_inserts_single_winner) {
+    static int keys[KEYS_PER_THREAD];
+    for (int i = 0; i < KEYS_PER_THREAD; i++) keys[i] = i;
+
+    dsc_concurrent_hash_table cht;
+    dsc_concurrent_hash_table_init(&cht, 0, sizeof(int), dsc_hash_pod, int_cmp);
+
+    test_thread threads[THREADS];
+    worker_arg  args[THREADS];
+    for (int t = 0; t < THREADS; t++) {
+        args[t] = (worker_arg){&cht, keys, t, 0};
+        test_thread_start(&threads[t], contended_thread, &args[t]);
+    }
+    for (int t = 0; t < THREADS; t++) test_thread_join(threads[t]);
+
+    /* errors counts successful inserts here */
+    int wins = 0;
+    for (int t = 0; t < THREADS; t++) wins += args[t].errors;
+    ASSERT_EQ(KEYS_PER_THREAD, wins);
+    ASSERT_EQ(KEYS_PER_THREAD, dsc_concurrent_hash_table_size(&cht));
+
+    dsc_concurrent_hash_table_destroy(&cht, NULL);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("Concurrent Hash Table Tests");
+
+    TEST_SECTION("Single-Threaded");
+    RUN_TEST(cht_init_and_errors);
+    RUN_TEST(cht_insert_get_delete);
+    RUN_TEST(cht_grows_and_cleanup_contract);
+
+    TEST_SECTION("Multi-Threaded");
+    RUN_TEST(cht_parallel_insert_then_read_delete);
+    RUN_TEST(cht_contended_inserts_single_winner);
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,213 @@
+/**
+ * Deque Tests
+ * Tests the segmented dsc_deque: both ends, pointer stability, batches
+ * and block recycling.
+ */
+
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <string.h>
+
+DSC_DEFINE_DEQUE(int, int)
+
+/* =========================================================
+   Basic Tests
+   ========================================================= */
+
+TEST(deque_init_defaults) {
+    dsc_deque dq;
+    dsc_deque_init(&dq, sizeof(int), 0);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_TRUE(dq.block_items * sizeof(int) <= 4096);
+    ASSERT_EQ(0, dsc_deque_size(&dq));
+    ASSERT_NULL(dq.head);
+
+    dsc_deque_init(&dq, 0, 0);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    dsc_deque_destroy(&dq);
+}
+
+TEST(deque_stack_order) {
+    int_deque dq;
+    int_deque_init(&dq, 4);
+
+    for (int i = 0; i < 100; i++) ASSERT_TRUE(int_deque_push_back(&dq, i));
+    ASSERT_EQ(100, int_deque_size(&dq));
+    ASSERT_EQ(99, *int_deque_peek_back(&dq));
+    ASSERT_EQ(0, *int_deque_peek_front(&dq));
+
+    int out;
+    for (int i = 99; i >= 0; i--) {
+        ASSERT_TRUE(int_deque_pop_back(&dq, &out));
+        ASSERT_EQ(i, out);
+    }
+    ASSERT_FALSE(int_deque_pop_back(&dq, &out));
+    ASSERT_EQ(DSC_EEMPTY, dsc_get_error());
+    ASSERT_NULL(int_deque_peek_back(&dq));
+
+    int_deque_destroy(&dq);
+}
+
+TEST(deque_both_ends) {
+    int_deque dq;
+    int_deque_init(&dq, 3);
+
+    /* front: -1..-20, back: 0..19 */
+    for (int i = 0; i < 20; i++) {
+        int_deque_push_back(&dq, i);
+        int_deque_push_front(&dq, -1 - i);
+    }
+    ASSERT_EQ(40, int_deque_size(&dq));
+    for (size_t i = 0; i < 40; i++) {
+        ASSERT_EQ((int)i - 20, *int_deque_get(&dq, i));
+    }
+    ASSERT_NULL(int_deque_get(&dq, 40));
+    ASSERT_EQ(DSC_ERANGE, dsc_get_error());
+
+    /* FIFO from the front */
+    int out;
+    for (int i = -20; i < 20; i++) {
+        ASSERT_TRUE(int_deque_pop_front(&dq, &out));
+        ASSERT_EQ(i, out);
+    }
+    ASSERT_EQ(0, int_deque_size(&dq));
+
+    /* Front pushes on an empty deque, then drain from the back */
+    for (int i = 0; i < 10; i++) int_deque_push_front(&dq, i);
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(int_deque_pop_back(&dq, &out));
+        ASSERT_EQ(i, out);
+    }
+
+    int_deque_destroy(&dq);
+}
+
+TEST(deque_addresses_are_stable) {
+    int_deque dq;
+    int_deque_init(&dq, 8);
+
+    int_deque_push_back(&dq, 7);
+    int* first = int_deque_peek_back(&dq);
+    for (int i = 0; i < 10000; i++) int_deque_push_back(&dq, i);
+    for (int i = 0; i < 10000; i++) int_deque_push_front(&dq, i);
+
+    ASSERT_TRUE(first == int_deque_get(&dq, 10000));
+    ASSERT_EQ(7, *first);
+
+    int_deque_destroy(&dq);
+}
+
+/* =========================================================
+   Batch Tests
+   ========================================================= */
+
+TEST(deque_batch_round_trip) {
+    int_deque dq;
+    int_deque_init(&dq, 16);
+
+    int in[1000], out[1000];
+    for (int i = 0; i < 1000; i++) in[i] = i * 3;
+
+    int_deque_push_back(&dq, -1);
+    ASSERT_EQ(1000, int_deque_push_back_n(&dq, in, 1000));
+    ASSERT_EQ(1001, int_deque_size(&dq));
+
+    /* pop_back_n keeps the stored order */
+    ASSERT_EQ(1000, int_deque_pop_back_n(&dq, out, 1000));
+    ASSERT_TRUE(memcmp(in, out, sizeof(in)) == 0);
+    ASSERT_EQ(-1, *int_deque_peek_back(&dq));
+
+    ASSERT_EQ(1000, int_deque_push_back_n(&dq, in, 1000));
+    ASSERT_EQ(1, int_deque_pop_front_n(&dq, out, 1));
+    ASSERT_EQ(-1, out[0]);
+    ASSERT_EQ(1000, int_deque_pop_front_n(&dq, out, 5000));
+    ASSERT_TRUE(memcmp(in, out, sizeof(in)) == 0);
+    ASSERT_EQ(0, int_deque_size(&dq));
+    ASSERT_NULL(dq.impl.head);
+
+    /* NULL output discards */
+    int_deque_push_back_n(&dq, in, 100);
+    ASSERT_EQ(60, int_deque_pop_back_n(&dq, NULL, 60));
+    ASSERT_EQ(39 * 3, *int_deque_peek_back(&dq));
+
+    int_deque_destroy(&dq);
+}
+
+/* =========================================================
+   Memory Tests
+   ========================================================= */
+
+TEST(deque_spare_block_and_release) {
+    counting_ctx ctx = {0};
+    dsc_allocator alloc = { counting_alloc, counting_realloc, counting_free, &ctx };
+
+    dsc_deque dq;
+    dsc_deque_init_with_allocator(&dq, sizeof(int), 4, &alloc);
+
+    for (int i = 0; i < 4; i++) dsc_deque_push_back(&dq, &i);
+    ASSERT_EQ(1, ctx.live);
+
+    /* Oscillating across a block boundary reuses the spare block */
+    int v = 99;
+    for (int round = 0; round < 100; round++) {
+        dsc_deque_push_back(&dq, &v);
+        dsc_deque_pop_back(&dq, NULL);
+    }
+    ASSERT_EQ(2, ctx.allocs);
+
+    /* Shrinking hands blocks back, keeping only one spare */
+    for (int i = 0; i < 400; i++) dsc_deque_push_back(&dq, &i);
+    ASSERT_TRUE(ctx.live > 100);
+    while (dsc_deque_size(&dq) > 0) dsc_deque_pop_front(&dq, NULL);
+    ASSERT_EQ(1, ctx.live);
+
+    dsc_deque_push_back(&dq, &v);
+    dsc_deque_clear(&dq);
+    ASSERT_EQ(1, ctx.live);
+
+    dsc_deque_destroy(&dq);
+    ASSERT_EQ(0, ctx.live);
+}
+
+TEST(deque_invalid_args) {
+    dsc_deque dq;
+    dsc_deque_init(&dq, sizeof(int), 4);
+
+    ASSERT_FALSE(dsc_deque_push_back(&dq, NULL));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_FALSE(dsc_deque_push_front(NULL, &dq));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_EQ(0, dsc_deque_push_back_n(&dq, NULL, 3));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_NULL(dsc_deque_peek_front(&dq));
+    ASSERT_EQ(DSC_EEMPTY, dsc_get_error());
+
+    dsc_deque_destroy(&dq);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("Deque Tests");
+
+    TEST_SECTION("Basic");
+    RUN_TEST(deque_init_defaults);
+    RUN_TEST(deque_stack_order);
+    RUN_TEST(deque_both_ends);
+    RUN_TEST(deque_addresses_are_stable);
+
+    TEST_SECTION("Batch");
+    RUN_TEST(deque_batch_round_trip);
+
+    TEST_SECTION("Memory");
+    RUN_TEST(deque_spare_block_and_release);
+    RUN_TEST(deque_invalid_args);
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,398 @@
+/**
+ * Flat Hash Table Tests
+ * Tests all edge cases and functionality of the dsc_flat_table API.
+ */
+
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <string.h>
+
+/* String comparison function for variable-length string keys */
+static int str_cmp(const void* key1, size_t len1, const void* key2, size_t len2) {
+    (void)len1;
+    (void)len2;
+    return strcmp((const char*)key1, (const char*)key2);
+}
+
+/* String hash function - djb2 algorithm */
+static uint64_t str_hash(const void* key, size_t len) {
+    const char* str = (const char*)key;
+    uint64_t hash = 5381;
+    (void)len;
+
+    int c;
+    while ((c = *str++)) {
+        hash = ((hash << 5) + hash) + (uint64_t)c;
+    }
+    return hash;
+}
+
+static int int_cmp(const void* key1, size_t len1, const void* key2, size_t len2) {
+    (void)len1;
+    (void)len2;
+    return *(const int*)key1 - *(const int*)key2;
+}
+
+/* Deliberately weak hash: identity, so collisions are easy to provoke */
+static uint64_t int_hash(const void* key, size_t len) {
+    (void)len;
+    return (uint64_t)*(const int*)key;
+}
+
+/* Every key collides: exercises long Robin Hood probe runs */
+static uint64_t const_hash(const void* key, size_t len) {
+    (void)key;
+    (void)len;
+    return 7;
+}
+
+#define STR_KEY_SIZE 0
+
+DSC_DEFINE_FLAT_TABLE(int, int*, int)
+
+/* =========================================================
+   Initialization Tests
+   ========================================================= */
+
+TEST(flat_table_init_basic) {
+    dsc_flat_table ft;
+    dsc_flat_table_init(&ft, 16, STR_KEY_SIZE, str_hash, str_cmp);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(16, ft.capacity);
+    ASSERT_EQ(0, ft.size);
+    ASSERT_NOT_NULL(ft.slots);
+    dsc_flat_table_destroy(&ft, NULL);
+}
+
+TEST(flat_table_init_rounds_capacity) {
+    /* Capacity is rounded up to a power of two, with a small minimum */
+    dsc_flat_table ft;
+    dsc_flat_table_init(&ft, 0, sizeof(int), int_hash, int_cmp);
+    ASSERT_EQ(8, ft.capacity);
+    dsc_flat_table_destroy(&ft, NULL);
+
+    dsc_flat_table_init(&ft, 1000, sizeof(int), int_hash, int_cmp);
+    ASSERT_EQ(1024, ft.capacity);
+    dsc_flat_table_destroy(&ft, NULL);
+
+    /* No power of two fits: fails instead of wrapping to 0 */
+    dsc_flat_table_init(&ft, SIZE_MAX / 2 + 2, sizeof(int), int_hash, int_cmp);
+    ASSERT_EQ(DSC_ENOMEM, dsc_get_error());
+    ASSERT_NULL(ft.slots);
+    ASSERT_EQ(0, ft.capacity);
+    dsc_flat_table_init(&ft, SIZE_MAX / 2 + 1, sizeof(int), int_hash, int_cmp);
+    ASSERT_EQ(DSC_ENOMEM, dsc_get_error());
+    dsc_flat_table_destroy(&ft, NULL);
+}
+
+TEST(flat_table_init_null_funcs) {
+    dsc_flat_table ft;
+    dsc_flat_table_init(&ft, 16, STR_KEY_SIZE, NULL, str_cmp);
+    ASSERT_EQ(DSC_EHASHFUNC, dsc_get_error());
+    dsc_flat_table_init(&ft, 16, STR_KEY_SIZE, str_hash, NULL);
+    ASSERT_EQ(DSC_ECMPFUNC, dsc_get_error());
+    dsc_flat_table_init(NULL, 16, STR_KEY_SIZE, str_hash, str_cmp);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+}
+
+/* =========================================================
+   Insert / Get Tests
+   ========================================================= */
+
+TEST(flat_table_insert_get_strings) {
+    dsc_flat_table ft;
+    dsc_flat_table_init(&ft, 16, STR_KEY_SIZE, str_hash, str_cmp);
+
+    int v1 = 1, v2 = 2;
+    ASSERT_TRUE(dsc_flat_table_insert(&ft, "alpha", &v1));
+    ASSERT_TRUE(dsc_flat_table_insert(&ft, "beta", &v2));
+    ASSERT_EQ(2, ft.size);
+
+    ASSERT_EQ(1, *(int*)dsc_flat_table_get(&ft, "alpha"));
+    ASSERT_EQ(2, *(int*)dsc_flat_table_get(&ft, "beta"));
+    ASSERT_NULL(dsc_flat_table_get(&ft, "gamma"));
+    ASSERT_EQ(DSC_ENOTFOUND, dsc_get_error());
+
+    dsc_flat_table_destroy(&ft, NULL);
+}
+
+TEST(flat_table_insert_duplicate) {
+    dsc_flat_table ft;
+    dsc_flat_table_init(&ft, 16, STR_KEY_SIZE, str_hash, str_cmp);
+
+    int v1 = 1, v2 = 2;
+    ASSERT_TRUE(dsc_flat_table_insert(&ft, "key", &v1));
+    ASSERT_FALSE(dsc_flat_table_insert(&ft, "key", &v2));
+    ASSERT_EQ(DSC_EEXISTS, dsc_get_error());
+    ASSERT_EQ(1, ft.size);
+    ASSERT_EQ(1, *(int*)dsc_flat_table_get(&ft, "key"));
+
+    dsc_flat_table_destroy(&ft, NULL);
+}
+
+TEST(flat_table_insert_invalid_args) {
+    dsc_flat_table ft;
+    dsc_flat_table_init(&ft, 16, STR_KEY_SIZE, str_hash, str_cmp);
+
+    int v = 1;
+    ASSERT_FALSE(dsc_flat_table_insert(NULL, "key", &v));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_FALSE(dsc_flat_table_insert(&ft, NULL, &v));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_FALSE(dsc_flat_table_insert(&ft, "key", NULL));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_flat_table_destroy(&ft, NULL);
+}
+
+TEST(flat_table_key_copied_inline) {
+    /* Fixed-size keys are copied, so the caller's key may change afterwards */
+    dsc_flat_table ft;
+    dsc_flat_table_init(&ft, 16, sizeof(int), int_hash, int_cmp);
+
+    int key = 5, value = 50;
+    ASSERT_TRUE(dsc_flat_table_insert(&ft, &key, &value));
+    key = 6;
+
+    int lookup = 5;
+    ASSERT_EQ(50, *(int*)dsc_flat_table_get(&ft, &lookup));
+    ASSERT_NULL(dsc_flat_table_get(&ft, &key));
+
+    dsc_flat_table_destroy(&ft, NULL);
+}
+
+TEST(flat_table_grows) {
+    dsc_flat_table ft;
+    dsc_flat_table_init(&ft, 8, sizeof(int), int_hash, int_cmp);
+
+    int keys[2000];
+    for (int i = 0; i < 2000; i++) {
+        keys[i] = i;
+        ASSERT_TRUE(dsc_flat_table_insert(&ft, &keys[i], &keys[i]));
+    }
+    ASSERT_EQ(2000, ft.size);
+    ASSERT_TRUE(ft.capacity >= 2000);
+
+    for (int i = 0; i < 2000; i++) {
+        int* v = (int*)dsc_flat_table_get(&ft, &i);
+        ASSERT_NOT_NULL(v);
+        ASSERT_EQ(i, *v);
+    }
+
+    dsc_flat_table_destroy(&ft, NULL);
+}
+
+TEST(flat_table_full_collisions) {
+    dsc_flat_table ft;
+    dsc_flat_table_init(&ft, 8, sizeof(int), const_hash, int_cmp);
+
+    int keys[100];
+    for (int i = 0; i < 100; i++) {
+        keys[i] = i * 3;
+        ASSERT_TRUE(dsc_flat_table_insert(&ft, &keys[i], &keys[i]));
+    }
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(i * 3, *(int*)dsc_flat_table_get(&ft, &keys[i]));
+    }
+    int missing = 1;
+    ASSERT_NULL(dsc_flat_table_get(&ft, &missing));
+
+    dsc_flat_table_destroy(&ft, NULL);
+}
+
+/* =========================================================
+   Delete Tests
+   ========================================================= */
+
+TEST(flat_table_delete_basic) {
+    dsc_flat_table ft;
+    dsc_flat_table_init(&ft, 16, STR_KEY_SIZE, str_hash, str_cmp);
+
+    int v = 42;
+    dsc_flat_table_insert(&ft, "key", &v);
+
+    int* removed = (int*)dsc_flat_table_delete(&ft, "key");
+    ASSERT_NOT_NULL(removed);
+    ASSERT_EQ(42, *removed);
+    ASSERT_EQ(0, ft.size);
+    ASSERT_NULL(dsc_flat_table_get(&ft, "key"));
+
+    ASSERT_NULL(dsc_flat_table_delete(&ft, "key"));
+    ASSERT_EQ(DSC_ENOTFOUND, dsc_get_error());
+
+    dsc_flat_table_destroy(&ft, NULL);
+}
+
+TEST(flat_table_delete_backshift) {
+    /* Deleting from the middle of a collision run must keep the rest reachable */
+    dsc_flat_table ft;
+    dsc_flat_table_init(&ft, 64, sizeof(int), const_hash, int_cmp);
+
+    int keys[20];
+    for (int i = 0; i < 20; i++) {
+        keys[i] = i;
+        dsc_flat_table_insert(&ft, &keys[i], &keys[i]);
+    }
+    for (int i = 0; i < 20; i += 2) {
+        ASSERT_NOT_NULL(dsc_flat_table_delete(&ft, &keys[i]));
+    }
+    ASSERT_EQ(10, ft.size);
+
+    for (int i = 0; i < 20; i++) {
+        if (i % 2 == 0) {
+            ASSERT_NULL(dsc_flat_table_get(&ft, &keys[i]));
+        } else {
+            ASSERT_EQ(i, *(int*)dsc_flat_table_get(&ft, &keys[i]));
+        }
+    }
+
+    dsc_flat_table_destroy(&ft, NULL);
+}
+
+TEST(flat_table_delete_reinsert_cycle) {
+    dsc_flat_table ft;
+    dsc_flat_table_init(&ft, 16, sizeof(int), int_hash, int_cmp);
+
+    int keys[500];
+    for (int i = 0; i < 500; i++) keys[i] = i;
+
+    for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < 500; i++) {
+            ASSERT_TRUE(dsc_flat_table_insert(&ft, &keys[i], &keys[i]));
+        }
+        for (int i = 0; i < 500; i++) {
+            ASSERT_NOT_NULL(dsc_flat_table_delete(&ft, &keys[i]));
+        }
+        ASSERT_EQ(0, ft.size);
+    }
+
+    dsc_flat_table_destroy(&ft, NULL);
+}
+
+/* =========================================================
+   Clear / Destroy / Keys / Values Tests
+   ========================================================= */
+
+static int cleanup_call_count = 0;
+static void test_cleanup(void* obj) {
+    cleanup_call_count++;
+    (void)obj;
+}
+
+TEST(flat_table_clear_with_cleanup) {
+    dsc_flat_table ft;
+    dsc_flat_table_init(&ft, 16, STR_KEY_SIZE, str_hash, str_cmp);
+
+    int v1 = 1, v2 = 2, v3 = 3;
+    dsc_flat_table_insert(&ft, "a", &v1);
+    dsc_flat_table_insert(&ft, "b", &v2);
+    dsc_flat_table_insert(&ft, "c", &v3);
+
+    cleanup_call_count = 0;
+    dsc_flat_table_clear(&ft, test_cleanup);
+    ASSERT_EQ(3, cleanup_call_count);
+    ASSERT_EQ(0, ft.size);
+    ASSERT_NULL(dsc_flat_table_get(&ft, "a"));
+
+    /* Table is reusable after clear */
+    ASSERT_TRUE(dsc_flat_table_insert(&ft, "a", &v1));
+    dsc_flat_table_destroy(&ft, test_cleanup);
+    ASSERT_EQ(4, cleanup_call_count);
+}
+
+TEST(flat_table_keys_values) {
+    dsc_flat_table ft;
+    dsc_flat_table_init(&ft, 16, sizeof(int), int_hash, int_cmp);
+
+    int keys[] = {10, 20, 30};
+    for (int i = 0; i < 3; i++) dsc_flat_table_insert(&ft, &keys[i], &keys[i]);
+
+    dsc_list k = dsc_flat_table_keys(&ft);
+    dsc_list v = dsc_flat_table_values(&ft);
+    ASSERT_EQ(3, k.length);
+    ASSERT_EQ(3, v.length);
+
+    int sum_keys = 0, sum_values = 0;
+    for (size_t i = 0; i < 3; i++) {
+        sum_keys   += *(int*)dsc_list_get(&k, i);
+        sum_values += **(int**)dsc_list_get(&v, i);
+    }
+    ASSERT_EQ(60, sum_keys);
+    ASSERT_EQ(60, sum_values);
+
+    dsc_list_destroy(&k);
+    dsc_list_destroy(&v);
+    dsc_flat_table_destroy(&ft, NULL);
+}
+
+TEST(flat_table_typed_wrapper) {
+    int_flat_table t;
+    int_flat_table_init(&t, 16, int_hash, int_cmp);
+
+    int key = 7, value = 70;
+    ASSERT_TRUE(int_flat_table_insert(&t, &key, &value));
+    ASSERT_EQ(70, *int_flat_table_get(&t, &key));
+    ASSERT_EQ(70, *int_flat_table_delete(&t, &key));
+    ASSERT_NULL(int_flat_table_get(&t, &key));
+
+    int_flat_table_destroy(&t, NULL);
+}
+
+TEST(flat_table_get_unchecked) {
+    int_flat_table t;
+    int_flat_table_init(&t, 8, int_hash, int_cmp);
+
+    static int keys[100];
+    for (int i = 0; i < 100; i++) {
+        keys[i] = i * 3;
+        int_flat_table_insert(&t, &keys[i], &keys[i]);
+    }
+
+    dsc_flat_table_get(NULL, NULL);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    int present = 33, missing = 34;
+    ASSERT_EQ(33, *int_flat_table_get_unchecked(&t, &present));
+    ASSERT_NULL(int_flat_table_get_unchecked(&t, &missing));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    int_flat_table_destroy(&t, NULL);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("Flat Hash Table Tests");
+
+    TEST_SECTION("Initialization");
+    RUN_TEST(flat_table_init_basic);
+    RUN_TEST(flat_table_init_rounds_capacity);
+    RUN_TEST(flat_table_init_null_funcs);
+
+    TEST_SECTION("Insert / Get");
+    RUN_TEST(flat_table_insert_get_strings);
+    RUN_TEST(flat_table_insert_duplicate);
+    RUN_TEST(flat_table_insert_invalid_args);
+    RUN_TEST(flat_table_key_copied_inline);
+    RUN_TEST(flat_table_grows);
+    RUN_TEST(flat_table_full_collisions);
+
+    TEST_SECTION("Delete");
+    RUN_TEST(flat_table_delete_basic);
+    RUN_TEST(flat_table_delete_backshift);
+    RUN_TEST(flat_table_delete_reinsert_cycle);
+
+    TEST_SECTION("Clear / Destroy / Export");
+    RUN_TEST(flat_table_clear_with_cleanup);
+    RUN_TEST(flat_table_keys_values);
+    RUN_TEST(flat_table_typed_wrapper);
+    RUN_TEST(flat_table_get_unchecked);
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}
@@ -29,11 +29,24 @@
  *       TEST_SUMMARY();
  *       return TEST_EXIT_CODE();
  *   }
+ *
+ * Also provides counting_ctx with counting_alloc/realloc/free, the callbacks
+ * of a dsc_allocator that forwards to malloc and counts blocks:
+ *   counting_ctx  ctx   = {0};
+ *   dsc_allocator alloc = { counting_alloc, counting_realloc, counting_free, &ctx };
+ *
+ * Optional helpers, enabled by defining before the include:
+ *   TEST_THREADS            test_thread, TEST_THREAD_FN, test_thread_start/join
+ *                           (POSIX threads even under a strict -std=c11 build)
  */
 
 #ifndef TEST_FRAMEWORK_H
 #define TEST_FRAMEWORK_H
 
+#if defined(TEST_THREADS) && !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -60,6 +73,62 @@
     #define TEST_INIT() ((void)0)
 #endif
 
+/* Counting allocator: forwards to malloc and tracks live blocks */
+typedef struct {
+    int live;       /* Allocated and not yet freed */
+    int allocs;     /* Allocations, including realloc from NULL */
+    int frees;
+} counting_ctx;
+
+static inline void* counting_alloc(void* ctx, size_t size) {
+    ((counting_ctx*)ctx)->live++;
+    ((counting_ctx*)ctx)->allocs++;
+    return malloc(size);
+}
+
+static inline void* counting_realloc(void* ctx, void* ptr, size_t old_size, size_t new_size) {
+    (void)old_size;
+    if (ptr == NULL) {
+        ((counting_ctx*)ctx)->live++;
+        ((counting_ctx*)ctx)->allocs++;
+    }
+    return realloc(ptr, new_size);
+}
+
+static inline void counting_free(void* ctx, void* ptr, size_t size) {
+    (void)size;
+    ((counting_ctx*)ctx)->live--;
+    ((counting_ctx*)ctx)->frees++;
+    free(ptr);
+}
+
+/* Minimal thread shim: Win32 threads or pthreads */
+#ifdef TEST_THREADS
+#ifdef _WIN32
+    typedef HANDLE test_thread;
+    #define TEST_THREAD_FN(name) static DWORD WINAPI name(LPVOID arg)
+    #define TEST_THREAD_RETURN return 0
+    static inline void test_thread_start(test_thread* t, LPTHREAD_START_ROUTINE fn, void* arg) {
+        *t = CreateThread(NULL, 0, fn, arg, 0, NULL);
+    }
+    static inline void test_thread_join(test_thread t) {
+        WaitForSingleObject(t, INFINITE);
+        CloseHandle(t);
+    }
+#else
+    #include <pthread.h>
+    typedef pthread_t test_thread;
+    #define TEST_THREAD_FN(name) static void* name(void* arg)
+    #define TEST_THREAD_RETURN return NULL
+    static inline void test_thread_start(test_thread* t, void* (*fn)(void*), void* arg) {
+        pthread_create(t, NULL, fn, arg);
+    }
+    static inline void test_thread_join(test_thread t) {
+        pthread_join(t, NULL);
+    }
+#endif
+#endif /* TEST_THREADS */
+
 /* ANSI color codes - work on all modern terminals */
 #define COLOR_RED     "\033[31m"
 #define COLOR_GREEN   "\033[32m"
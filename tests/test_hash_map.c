@@ -0,0 +1,246 @@
+/**
+ * Specialized Hash Map Tests
+ * Tests the compile-time specialized DSC_DEFINE_HASH_MAP tables.
+ */
+
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <string.h>
+
+typedef struct {
+    int    x;
+    int    y;
+    double weight;
+} Point;
+
+DSC_DEFINE_HASH_MAP(uint64_t, Point, point, dsc_hash_u64, DSC_MAP_EQ)
+DSC_DEFINE_HASH_MAP(uint32_t, int, counter, dsc_hash_u32, DSC_MAP_EQ)
+
+/* Identity hash: forces long probe runs and exercises backward shifting */
+#define IDENTITY_HASH(k) ((uint64_t)(k))
+DSC_DEFINE_HASH_MAP(uint64_t, uint64_t, ident, IDENTITY_HASH, DSC_MAP_EQ)
+
+/* String keys by pointer, hashed by content */
+static inline uint64_t cstr_hash(const char* s) { return dsc_hash_str(s, 0); }
+#define CSTR_EQ(a, b) (strcmp((a), (b)) == 0)
+DSC_DEFINE_HASH_MAP(const char*, int, word, cstr_hash, CSTR_EQ)
+
+/* =========================================================
+   Basic Tests
+   ========================================================= */
+
+TEST(hash_map_init_rounds_capacity) {
+    point_map m;
+    ASSERT_TRUE(point_map_init(&m, 0));
+    ASSERT_EQ(8, m.capacity);
+    point_map_destroy(&m);
+
+    ASSERT_TRUE(point_map_init(&m, 100));
+    ASSERT_EQ(128, m.capacity);
+    ASSERT_EQ(0, m.size);
+    point_map_destroy(&m);
+    ASSERT_NULL(m.ctrl);
+}
+
+TEST(hash_map_insert_get_by_value) {
+    point_map m;
+    point_map_init(&m, 0);
+
+    Point p = {1, 2, 0.5};
+    ASSERT_TRUE(point_map_insert(&m, 42, p));
+    ASSERT_FALSE(point_map_insert(&m, 42, p));
+    ASSERT_EQ(1, m.size);
+
+    /* Stored by value: changing p does not change the map */
+    p.x = 99;
+    Point* got = point_map_get(&m, 42);
+    ASSERT_NOT_NULL(got);
+    ASSERT_EQ(1, got->x);
+    ASSERT_EQ(2, got->y);
+    ASSERT_NULL(point_map_get(&m, 7));
+    ASSERT_FALSE(point_map_contains(&m, 7));
+    ASSERT_TRUE(point_map_contains(&m, 42));
+
+    point_map_destroy(&m);
+}
+
+TEST(hash_map_upsert_zeroes_and_updates) {
+    counter_map m;
+    counter_map_init(&m, 4);
+
+    uint32_t keys[] = {3, 5, 3, 3, 9, 5};
+    for (int i = 0; i < 6; i++) {
+        bool inserted;
+        int* c = counter_map_upsert(&m, keys[i], &inserted);
+        ASSERT_NOT_NULL(c);
+        if (inserted) ASSERT_EQ(0, *c);
+        (*c)++;
+    }
+
+    ASSERT_EQ(3, m.size);
+    ASSERT_EQ(3, *counter_map_get(&m, 3));
+    ASSERT_EQ(2, *counter_map_get(&m, 5));
+    ASSERT_EQ(1, *counter_map_get(&m, 9));
+
+    ASSERT_TRUE(counter_map_put(&m, 9, 100));
+    ASSERT_EQ(100, *counter_map_get(&m, 9));
+    ASSERT_EQ(3, m.size);
+
+    counter_map_destroy(&m);
+}
+
+TEST(hash_map_zero_initialized_is_usable) {
+    counter_map m = {0};
+    ASSERT_NULL(counter_map_get(&m, 1));
+    ASSERT_FALSE(counter_map_delete(&m, 1, NULL));
+    ASSERT_TRUE(counter_map_insert(&m, 1, 10));
+    ASSERT_EQ(10, *counter_map_get(&m, 1));
+    counter_map_destroy(&m);
+}
+
+/* =========================================================
+   Growth and Deletion Tests
+   ========================================================= */
+
+TEST(hash_map_grows) {
+    point_map m;
+    point_map_init(&m, 0);
+
+    for (uint64_t i = 0; i < 5000; i++) {
+        Point p = {(int)i, (int)(i * 2), 0.0};
+        ASSERT_TRUE(point_map_insert(&m, i * 7919, p));
+    }
+    ASSERT_EQ(5000, m.size);
+    ASSERT_TRUE(m.size * 4 <= m.capacity * 3);
+
+    for (uint64_t i = 0; i < 5000; i++) {
+        Point* p = point_map_get(&m, i * 7919);
+        ASSERT_NOT_NULL(p);
+        ASSERT_EQ((int)(i * 2), p->y);
+    }
+
+    point_map_destroy(&m);
+}
+
+TEST(hash_map_delete_backward_shift) {
+    ident_map m;
+    ident_map_init(&m, 64);
+
+    /* Clustered keys under the identity hash */
+    for (uint64_t i = 0; i < 40; i++) ASSERT_TRUE(ident_map_insert(&m, i, i * 10));
+
+    uint64_t out = 0;
+    for (uint64_t i = 0; i < 40; i += 3) {
+        ASSERT_TRUE(ident_map_delete(&m, i, &out));
+        ASSERT_EQ(i * 10, out);
+    }
+    ASSERT_FALSE(ident_map_delete(&m, 0, NULL));
+
+    for (uint64_t i = 0; i < 40; i++) {
+        uint64_t* v = ident_map_get(&m, i);
+        if (i % 3 == 0) {
+            ASSERT_NULL(v);
+        } else {
+            ASSERT_NOT_NULL(v);
+            ASSERT_EQ(i * 10, *v);
+        }
+    }
+
+    /* No tombstones: every non-empty control byte is a live entry */
+    size_t live = 0;
+    for (size_t i = 0; i < m.capacity; i++) live += (m.ctrl[i] != 0);
+    ASSERT_EQ(m.size, live);
+
+    ident_map_destroy(&m);
+}
+
+TEST(hash_map_delete_wraparound) {
+    ident_map m;
+    ident_map_init(&m, 8);
+
+    /* Stress random insert/delete against a shadow array */
+    uint64_t shadow[256] = {0};
+    uint64_t seed = 12345;
+    for (int step = 0; step < 20000; step++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint64_t key = (seed >> 33) % 256;
+        if ((seed >> 20) & 1) {
+            bool ok = ident_map_insert(&m, key, key + 1);
+            ASSERT_EQ(shadow[key] == 0, ok);
+            shadow[key] = key + 1;
+        } else {
+            bool ok = ident_map_delete(&m, key, NULL);
+            ASSERT_EQ(shadow[key] != 0, ok);
+            shadow[key] = 0;
+        }
+    }
+
+    size_t expected = 0;
+    for (uint64_t k = 0; k < 256; k++) {
+        uint64_t* v = ident_map_get(&m, k);
+        if (shadow[k] != 0) {
+            expected++;
+            ASSERT_NOT_NULL(v);
+            ASSERT_EQ(shadow[k], *v);
+        } else {
+            ASSERT_NULL(v);
+        }
+    }
+    ASSERT_EQ(expected, m.size);
+
+    ident_map_destroy(&m);
+}
+
+TEST(hash_map_clear_and_iterate) {
+    word_map m;
+    word_map_init(&m, 0);
+
+    const char* words[] = {"alpha", "beta", "gamma"};
+    for (int i = 0; i < 3; i++) word_map_insert(&m, words[i], i + 1);
+
+    char probe[] = "beta";
+    ASSERT_EQ(2, *word_map_get(&m, probe));
+
+    int sum = 0;
+    size_t it = 0;
+    const char** k;
+    int* v;
+    while (word_map_next(&m, &it, &k, &v)) {
+        ASSERT_NOT_NULL(*k);
+        sum += *v;
+    }
+    ASSERT_EQ(6, sum);
+
+    word_map_clear(&m);
+    ASSERT_EQ(0, m.size);
+    ASSERT_NULL(word_map_get(&m, "alpha"));
+    ASSERT_TRUE(word_map_insert(&m, "alpha", 1));
+
+    word_map_destroy(&m);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("Specialized Hash Map Tests");
+
+    TEST_SECTION("Basics");
+    RUN_TEST(hash_map_init_rounds_capacity);
+    RUN_TEST(hash_map_insert_get_by_value);
+    RUN_TEST(hash_map_upsert_zeroes_and_updates);
+    RUN_TEST(hash_map_zero_initialized_is_usable);
+
+    TEST_SECTION("Growth and Deletion");
+    RUN_TEST(hash_map_grows);
+    RUN_TEST(hash_map_delete_backward_shift);
+    RUN_TEST(hash_map_delete_wraparound);
+    RUN_TEST(hash_map_clear_and_iterate);
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}
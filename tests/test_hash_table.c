@@ -33,6 +33,17 @@ static uint64_t str_hash(const void* key, size_t len) {
 /* For string keys, we use a sentinel value for key_size to indicate variable length */
 #define STR_KEY_SIZE 0
 
+static int int_cmp(const void* key1, size_t len1, const void* key2, size_t len2) {
+    (void)len1;
+    (void)len2;
+    return *(const int*)key1 - *(const int*)key2;
+}
+
+static uint64_t int_hash(const void* key, size_t len) {
+    (void)len;
+    return (uint64_t)*(const int*)key * 2654435761u;
+}
+
 /* =========================================================
    Initialization Tests
    ========================================================= */
@@ -69,7 +80,8 @@ TEST(hash_table_init_null_cmpfunc) {
 TEST(hash_table_init_large_capacity) {
     dsc_hash_table ht;
     dsc_hash_table_init(&ht, 10000, STR_KEY_SIZE, str_hash, str_cmp);
-    ASSERT_EQ(10000, ht.capacity);
+    /* Rounded up to the next power of two */
+    ASSERT_EQ(16384, ht.capacity);
     dsc_hash_table_destroy(&ht, NULL);
 }
 
@@ -392,6 +404,665 @@ TEST(hash_table_stress_many_inserts) {
     dsc_hash_table_destroy(&ht, NULL);
 }
 
+/* =========================================================
+   Cached Hash Tests
+   ========================================================= */
+
+static int hash_call_count = 0;
+static int cmp_call_count  = 0;
+
+static uint64_t counting_hash(const void* key, size_t len) {
+    hash_call_count++;
+    return str_hash(key, len);
+}
+
+static int counting_cmp(const void* key1, size_t len1, const void* key2, size_t len2) {
+    cmp_call_count++;
+    return str_cmp(key1, len1, key2, len2);
+}
+
+TEST(hash_table_cached_hash_stored) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 16, STR_KEY_SIZE, str_hash, str_cmp);
+
+    int value = 1;
+    dsc_hash_table_insert(&ht, "cached", &value);
+
+    dsc_kvpair* kvp = NULL;
+    for (size_t i = 0; i < ht.capacity && kvp == NULL; i++) kvp = ht.kvpairs[i];
+    ASSERT_NOT_NULL(kvp);
+    ASSERT_TRUE(kvp->hash == str_hash("cached", 7));
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_resize_does_not_rehash) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 4, STR_KEY_SIZE, counting_hash, str_cmp);
+
+    int values[64];
+    char keys[64][16];
+    for (int i = 0; i < 64; i++) {
+        values[i] = i;
+        snprintf(keys[i], sizeof(keys[i]), "k%d", i);
+    }
+
+    hash_call_count = 0;
+    for (int i = 0; i < 64; i++) {
+        ASSERT_TRUE(dsc_hash_table_insert(&ht, keys[i], &values[i]));
+    }
+    /* Resizes happened, but hf ran at most twice per inserted key */
+    ASSERT_TRUE(ht.capacity > 4);
+    ASSERT_TRUE(hash_call_count <= 2 * 64);
+
+    for (int i = 0; i < 64; i++) {
+        ASSERT_EQ(i, *(int*)dsc_hash_table_get(&ht, keys[i]));
+    }
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_cmp_skipped_on_hash_mismatch) {
+    /* A single bucket forces every key into one chain */
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 1, STR_KEY_SIZE, str_hash, counting_cmp);
+
+    int v1 = 1, v2 = 2;
+    dsc_hash_table_insert(&ht, "first", &v1);
+    dsc_hash_table_insert(&ht, "second", &v2);
+
+    cmp_call_count = 0;
+    ASSERT_EQ(1, *(int*)dsc_hash_table_get(&ht, "first"));
+    ASSERT_EQ(1, cmp_call_count);
+
+    cmp_call_count = 0;
+    ASSERT_NULL(dsc_hash_table_get(&ht, "missing"));
+    ASSERT_EQ(0, cmp_call_count);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+/* =========================================================
+   Upsert Tests
+   ========================================================= */
+
+TEST(hash_table_insert_hashes_once) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 16, STR_KEY_SIZE, counting_hash, str_cmp);
+
+    int v = 1;
+    hash_call_count = 0;
+    ASSERT_TRUE(dsc_hash_table_insert(&ht, "once", &v));
+    ASSERT_EQ(1, hash_call_count);
+    ASSERT_FALSE(dsc_hash_table_insert(&ht, "once", &v));
+    ASSERT_EQ(2, hash_call_count);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_upsert_new_and_existing) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 16, STR_KEY_SIZE, counting_hash, str_cmp);
+
+    int v1 = 1, v2 = 2;
+    bool inserted = false;
+
+    hash_call_count = 0;
+    void** slot = dsc_hash_table_upsert(&ht, "key", &v1, &inserted);
+    ASSERT_NOT_NULL(slot);
+    ASSERT_TRUE(inserted);
+    ASSERT_TRUE(*slot == &v1);
+    ASSERT_EQ(1, hash_call_count);
+    ASSERT_EQ(1, ht.size);
+
+    /* Existing key: obj is ignored and the same slot comes back */
+    void** again = dsc_hash_table_upsert(&ht, "key", &v2, &inserted);
+    ASSERT_FALSE(inserted);
+    ASSERT_TRUE(again == slot);
+    ASSERT_TRUE(*again == &v1);
+    ASSERT_EQ(1, ht.size);
+
+    /* Replace the object in place */
+    *again = &v2;
+    ASSERT_TRUE(dsc_hash_table_get(&ht, "key") == &v2);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_upsert_counters_in_place) {
+    const char* words[] = {"a", "b", "a", "c", "a", "b"};
+    int counts[6] = {0};
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 2, STR_KEY_SIZE, str_hash, str_cmp);
+
+    for (int i = 0; i < 6; i++) {
+        int** counter = (int**)dsc_hash_table_upsert(&ht, words[i], &counts[i], NULL);
+        ASSERT_NOT_NULL(counter);
+        (**counter)++;
+    }
+
+    ASSERT_EQ(3, ht.size);
+    ASSERT_EQ(3, *(int*)dsc_hash_table_get(&ht, "a"));
+    ASSERT_EQ(2, *(int*)dsc_hash_table_get(&ht, "b"));
+    ASSERT_EQ(1, *(int*)dsc_hash_table_get(&ht, "c"));
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_upsert_invalid_args) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 16, STR_KEY_SIZE, str_hash, str_cmp);
+
+    int v = 1;
+    bool inserted = true;
+    ASSERT_NULL(dsc_hash_table_upsert(NULL, "k", &v, &inserted));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_FALSE(inserted);
+    ASSERT_NULL(dsc_hash_table_upsert(&ht, "k", NULL, NULL));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_EQ(0, ht.size);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+/* =========================================================
+   Incremental Rehash Tests
+   ========================================================= */
+
+TEST(hash_table_incremental_keeps_old_array) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 64, STR_KEY_SIZE, str_hash, str_cmp);
+    dsc_hash_table_set_incremental(&ht, true);
+
+    int values[100];
+    char keys[100][16];
+    bool saw_rehash = false;
+    for (int i = 0; i < 100; i++) {
+        values[i] = i;
+        snprintf(keys[i], sizeof(keys[i]), "inc%d", i);
+        ASSERT_TRUE(dsc_hash_table_insert(&ht, keys[i], &values[i]));
+        if (ht.old_kvpairs != NULL) saw_rehash = true;
+
+        /* Every key inserted so far stays reachable mid-migration */
+        for (int j = 0; j <= i; j++) {
+            int* val = (int*)dsc_hash_table_get(&ht, keys[j]);
+            ASSERT_NOT_NULL(val);
+            ASSERT_EQ(j, *val);
+        }
+    }
+    ASSERT_TRUE(saw_rehash);
+    ASSERT_EQ(100, ht.size);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_incremental_delete_during_rehash) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 64, STR_KEY_SIZE, str_hash, str_cmp);
+    dsc_hash_table_set_incremental(&ht, true);
+
+    int values[50];
+    char keys[50][16];
+    for (int i = 0; i < 50; i++) {
+        values[i] = i;
+        snprintf(keys[i], sizeof(keys[i]), "del%d", i);
+        dsc_hash_table_insert(&ht, keys[i], &values[i]);
+    }
+    /* The 50th insert crossed 0.75 and left a migration in progress */
+    ASSERT_NOT_NULL(ht.old_kvpairs);
+
+    for (int i = 0; i < 50; i++) {
+        ASSERT_EQ(i, *(int*)dsc_hash_table_delete(&ht, keys[i]));
+    }
+    ASSERT_EQ(0, ht.size);
+    ASSERT_NULL(dsc_hash_table_get(&ht, keys[0]));
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_incremental_explicit_step) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 64, STR_KEY_SIZE, str_hash, str_cmp);
+    dsc_hash_table_set_incremental(&ht, true);
+
+    int values[50];
+    char keys[50][16];
+    for (int i = 0; i < 50; i++) {
+        values[i] = i;
+        snprintf(keys[i], sizeof(keys[i]), "step%d", i);
+        dsc_hash_table_insert(&ht, keys[i], &values[i]);
+    }
+    ASSERT_TRUE(dsc_hash_table_rehash_step(&ht, 1));
+    ASSERT_FALSE(dsc_hash_table_rehash_step(&ht, (size_t)-1));
+    ASSERT_NULL(ht.old_kvpairs);
+    ASSERT_EQ(128, ht.capacity);
+
+    dsc_list keys_list = dsc_hash_table_keys(&ht);
+    ASSERT_EQ(50, keys_list.length);
+    dsc_list_destroy(&keys_list);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_incremental_clear_and_disable) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 64, STR_KEY_SIZE, str_hash, str_cmp);
+    dsc_hash_table_set_incremental(&ht, true);
+
+    int values[50];
+    char keys[50][16];
+    for (int i = 0; i < 50; i++) {
+        values[i] = i;
+        snprintf(keys[i], sizeof(keys[i]), "clr%d", i);
+        dsc_hash_table_insert(&ht, keys[i], &values[i]);
+    }
+
+    /* Values in both arrays are handed to the cleanup function */
+    cleanup_call_count = 0;
+    dsc_hash_table_clear(&ht, test_cleanup);
+    ASSERT_EQ(50, cleanup_call_count);
+    ASSERT_NULL(ht.old_kvpairs);
+
+    for (int i = 0; i < 50; i++) dsc_hash_table_insert(&ht, keys[i], &values[i]);
+    dsc_hash_table_set_incremental(&ht, false);
+    ASSERT_NULL(ht.old_kvpairs);
+    ASSERT_EQ(50, ht.size);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+/* =========================================================
+   Sizing Tests
+   ========================================================= */
+
+static int sizing_values[1000];
+
+static void sizing_fill(dsc_hash_table* ht, size_t capacity, int n) {
+    dsc_hash_table_init(ht, capacity, sizeof(int), int_hash, int_cmp);
+    for (int i = 0; i < n; i++) {
+        sizing_values[i] = i;
+        dsc_hash_table_insert(ht, &i, &sizing_values[i]);
+    }
+}
+
+TEST(hash_table_reserve_and_compact) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 16, sizeof(int), int_hash, int_cmp);
+
+    /* One step to the final size: 1000 entries fit 2048 buckets under 0.75 */
+    ASSERT_TRUE(dsc_hash_table_reserve(&ht, 1000));
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(2048, ht.capacity);
+    for (int i = 0; i < 1000; i++) {
+        sizing_values[i] = i;
+        dsc_hash_table_insert(&ht, &i, &sizing_values[i]);
+    }
+    ASSERT_EQ(2048, ht.capacity);
+
+    int key = 7;
+    void** slot = dsc_hash_table_upsert(&ht, &key, &sizing_values[7], NULL);
+    for (int i = 10; i < 1000; i++) dsc_hash_table_delete(&ht, &i);
+    ASSERT_EQ(2048, ht.capacity);   /* No watermark set: deletes never shrink */
+
+    /* Nodes stay put, so upsert slots survive the rebuild */
+    ASSERT_TRUE(dsc_hash_table_compact(&ht));
+    ASSERT_EQ(16, ht.capacity);
+    ASSERT_NULL(ht.old_kvpairs);
+    ASSERT_TRUE(slot == dsc_hash_table_upsert(&ht, &key, &sizing_values[7], NULL));
+    for (int i = 0; i < 10; i++) ASSERT_EQ(i, *(int*)dsc_hash_table_get(&ht, &i));
+
+    /* Smaller reservations are a no-op */
+    ASSERT_TRUE(dsc_hash_table_reserve(&ht, 4));
+    ASSERT_EQ(16, ht.capacity);
+
+    ASSERT_FALSE(dsc_hash_table_reserve(NULL, 10));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_FALSE(dsc_hash_table_compact(NULL));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_shrink_hysteresis) {
+    dsc_hash_table ht;
+    sizing_fill(&ht, 16, 1000);
+    ASSERT_EQ(2048, ht.capacity);
+
+    dsc_hash_table_set_shrink(&ht, 25);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    /* 511 / 2048 is under 25%: halve to the smallest array at most half full */
+    for (int i = 999; i >= 512; i--) dsc_hash_table_delete(&ht, &i);
+    ASSERT_EQ(2048, ht.capacity);
+    int key = 511;
+    dsc_hash_table_delete(&ht, &key);
+    ASSERT_EQ(511, ht.size);
+    ASSERT_EQ(1024, ht.capacity);
+
+    /* Churn at the boundary does not resize back and forth */
+    for (int r = 0; r < 100; r++) {
+        dsc_hash_table_insert(&ht, &key, &sizing_values[key]);
+        dsc_hash_table_delete(&ht, &key);
+    }
+    ASSERT_EQ(1024, ht.capacity);
+    for (int i = 0; i < 511; i++) ASSERT_EQ(i, *(int*)dsc_hash_table_get(&ht, &i));
+
+    /* clear drops straight to the init capacity */
+    dsc_hash_table_clear(&ht, NULL);
+    ASSERT_EQ(16, ht.capacity);
+
+    dsc_hash_table_set_shrink(&ht, 51);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_EQ(25, ht.shrink_percent);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_shrink_floor_and_iterators) {
+    dsc_hash_table ht;
+    sizing_fill(&ht, 16, 1000);
+    dsc_hash_table_set_shrink(&ht, 25);
+
+    /* iter_delete leaves the array alone so the iterator stays valid */
+    dsc_hash_table_iter it;
+    dsc_hash_table_iter_begin(&ht, &it);
+    while (dsc_hash_table_iter_next(&it)) {
+        if (*(int*)it.kvp->key >= 10) dsc_hash_table_iter_delete(&it);
+    }
+    ASSERT_EQ(10, ht.size);
+    ASSERT_EQ(2048, ht.capacity);
+
+    /* The next delete catches up: 9 entries, at most half full */
+    int key = 0;
+    dsc_hash_table_delete(&ht, &key);
+    ASSERT_EQ(32, ht.capacity);
+    dsc_hash_table_destroy(&ht, NULL);
+
+    /* Never below the init capacity, or below a reservation */
+    sizing_fill(&ht, 256, 0);
+    dsc_hash_table_set_shrink(&ht, 50);
+    ASSERT_TRUE(dsc_hash_table_reserve(&ht, 1000));
+    for (int i = 0; i < 100; i++) {
+        sizing_values[i] = i;
+        dsc_hash_table_insert(&ht, &i, &sizing_values[i]);
+    }
+    for (int i = 0; i < 100; i++) dsc_hash_table_delete(&ht, &i);
+    ASSERT_EQ(2048, ht.capacity);
+
+    ASSERT_TRUE(dsc_hash_table_compact(&ht));
+    ASSERT_EQ(1, ht.capacity);
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_shrink_incremental) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 16, sizeof(int), int_hash, int_cmp);
+    dsc_hash_table_set_incremental(&ht, true);
+    dsc_hash_table_set_shrink(&ht, 25);
+    for (int i = 0; i < 1000; i++) {
+        sizing_values[i] = i;
+        dsc_hash_table_insert(&ht, &i, &sizing_values[i]);
+    }
+    while (dsc_hash_table_rehash_step(&ht, 64)) {}
+
+    /* The shrink migrates a few buckets per call; lookups see both arrays */
+    for (int i = 999; i >= 100; i--) {
+        dsc_hash_table_delete(&ht, &i);
+        for (int j = 0; j < 100; j += 11) ASSERT_EQ(j, *(int*)dsc_hash_table_get(&ht, &j));
+    }
+    while (dsc_hash_table_rehash_step(&ht, 64)) {}
+    ASSERT_EQ(100, ht.size);
+    ASSERT_TRUE(ht.capacity <= 512);
+    for (int i = 0; i < 100; i++) ASSERT_EQ(i, *(int*)dsc_hash_table_get(&ht, &i));
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+/* =========================================================
+   Built-in Hash Function Tests
+   ========================================================= */
+
+TEST(hash_builtin_str) {
+    /* Containers pass strlen + 1; standalone callers may pass 0 */
+    ASSERT_TRUE(dsc_hash_str("hello", 6) == dsc_hash_str("hello", 0));
+    ASSERT_TRUE(dsc_hash_str("hello", 6) == dsc_hash_bytes("hello", 5));
+    ASSERT_TRUE(dsc_hash_str("hello", 0) != dsc_hash_str("hellp", 0));
+    ASSERT_TRUE(dsc_hash_str("", 1) != dsc_hash_str("a", 2));
+
+    ASSERT_EQ(0, dsc_cmp_str("abc", 4, "abc", 4));
+    ASSERT_TRUE(dsc_cmp_str("abc", 4, "abd", 4) < 0);
+    ASSERT_TRUE(dsc_cmp_str("abc", 4, "ab", 3) != 0);
+}
+
+TEST(hash_builtin_bytes_all_lengths) {
+    /* Every length must read only its own bytes and change with each byte */
+    unsigned char buf[200];
+    for (int i = 0; i < 200; i++) buf[i] = (unsigned char)(i * 7 + 1);
+
+    for (size_t len = 1; len < 120; len++) {
+        uint64_t h = dsc_hash_bytes(buf, len);
+        ASSERT_TRUE(h != dsc_hash_bytes(buf, len - 1));
+
+        buf[len - 1] ^= 0x80;
+        ASSERT_TRUE(h != dsc_hash_bytes(buf, len));
+        buf[len - 1] ^= 0x80;
+        ASSERT_TRUE(h == dsc_hash_bytes(buf, len));
+    }
+}
+
+TEST(hash_builtin_pod_and_ptr) {
+    int a = 1, b = 2;
+    ASSERT_TRUE(dsc_hash_pod(&a, sizeof(a)) != dsc_hash_pod(&b, sizeof(b)));
+    ASSERT_EQ(0, dsc_cmp_pod(&a, sizeof(a), &a, sizeof(a)));
+    ASSERT_TRUE(dsc_cmp_pod(&a, sizeof(a), &b, sizeof(b)) != 0);
+
+    uint64_t w1 = 42, w2 = 43;
+    ASSERT_TRUE(dsc_hash_pod(&w1, 8) != dsc_hash_pod(&w2, 8));
+    ASSERT_TRUE(dsc_cmp_pod(&w1, 8, &w2, 8) != 0);
+
+    struct { uint64_t x, y; } p1 = {1, 2}, p2 = {1, 3};
+    ASSERT_TRUE(dsc_hash_pod(&p1, sizeof(p1)) != dsc_hash_pod(&p2, sizeof(p2)));
+    ASSERT_TRUE(dsc_cmp_pod(&p1, sizeof(p1), &p2, sizeof(p2)) != 0);
+
+    char odd1[5] = "abcd", odd2[5] = "abce";
+    ASSERT_TRUE(dsc_hash_pod(odd1, 5) != dsc_hash_pod(odd2, 5));
+    ASSERT_TRUE(dsc_cmp_pod(odd1, 5, odd2, 5) != 0);
+
+    void* q1 = &a;
+    void* q2 = &b;
+    ASSERT_TRUE(dsc_hash_ptr(&q1, sizeof(q1)) != dsc_hash_ptr(&q2, sizeof(q2)));
+    ASSERT_EQ(0, dsc_cmp_ptr(&q1, sizeof(q1), &q1, sizeof(q1)));
+    ASSERT_TRUE(dsc_cmp_ptr(&q1, sizeof(q1), &q2, sizeof(q2)) != 0);
+}
+
+TEST(hash_builtin_tables) {
+    dsc_hash_table strs, ints, ptrs;
+    dsc_hash_table_init(&strs, 16, 0, dsc_hash_str, dsc_cmp_str);
+    dsc_hash_table_init(&ints, 16, sizeof(int), dsc_hash_pod, dsc_cmp_pod);
+    dsc_hash_table_init(&ptrs, 16, sizeof(void*), dsc_hash_ptr, dsc_cmp_ptr);
+
+    int values[300];
+    char keys[300][24];
+    for (int i = 0; i < 300; i++) {
+        values[i] = i;
+        snprintf(keys[i], sizeof(keys[i]), "builtin%d", i);
+        void* ptr = &values[i];
+        ASSERT_TRUE(dsc_hash_table_insert(&strs, keys[i], &values[i]));
+        ASSERT_TRUE(dsc_hash_table_insert(&ints, &i, &values[i]));
+        ASSERT_TRUE(dsc_hash_table_insert(&ptrs, &ptr, &values[i]));
+    }
+    for (int i = 0; i < 300; i++) {
+        void* ptr = &values[i];
+        ASSERT_EQ(i, *(int*)dsc_hash_table_get(&strs, keys[i]));
+        ASSERT_EQ(i, *(int*)dsc_hash_table_get(&ints, &i));
+        ASSERT_EQ(i, *(int*)dsc_hash_table_get(&ptrs, &ptr));
+    }
+
+    dsc_hash_table_destroy(&strs, NULL);
+    dsc_hash_table_destroy(&ints, NULL);
+    dsc_hash_table_destroy(&ptrs, NULL);
+}
+
+/* Identity hash: keys that are multiples of the capacity would all share
+   bucket 0 under a plain mask */
+static uint64_t identity_hash(const void* key, size_t len) {
+    (void)len;
+    return (uint64_t)*(const int*)key;
+}
+
+TEST(hash_table_mask_spreads_weak_hash) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 1024, sizeof(int), identity_hash, int_cmp);
+    ASSERT_EQ(1024, ht.capacity);
+
+    int keys[512];
+    for (int i = 0; i < 512; i++) {
+        keys[i] = i * 1024;
+        dsc_hash_table_insert(&ht, &keys[i], &keys[i]);
+    }
+
+    size_t longest = 0;
+    for (size_t b = 0; b < ht.capacity; b++) {
+        size_t len = 0;
+        for (dsc_kvpair* kvp = ht.kvpairs[b]; kvp != NULL; kvp = kvp->next) len++;
+        if (len > longest) longest = len;
+    }
+    ASSERT_TRUE(longest <= 8);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_capacity_power_of_two) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 100, STR_KEY_SIZE, str_hash, str_cmp);
+    ASSERT_EQ(128, ht.capacity);
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+/* =========================================================
+   Batch Tests
+   ========================================================= */
+
+TEST(hash_table_batch_insert_and_get) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 4, STR_KEY_SIZE, str_hash, str_cmp);
+
+    int values[100];
+    char bufs[100][24];
+    const char* keys[100];
+    void* objs[100];
+    for (int i = 0; i < 100; i++) {
+        values[i] = i;
+        snprintf(bufs[i], sizeof(bufs[i]), "batch%d", i);
+        keys[i] = bufs[i];
+        objs[i] = &values[i];
+    }
+
+    dsc_error_t status[100];
+    ASSERT_EQ(100, dsc_hash_table_insert_batch(&ht, keys, objs, 100, status));
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(100, ht.size);
+    for (int i = 0; i < 100; i++) ASSERT_EQ(DSC_EOK, status[i]);
+
+    void* out[100];
+    ASSERT_EQ(100, dsc_hash_table_get_batch(&ht, keys, out, 100, status));
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(DSC_EOK, status[i]);
+        ASSERT_EQ(i, *(int*)out[i]);
+    }
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_batch_per_key_status) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 16, sizeof(int), int_hash, int_cmp);
+
+    int v = 7;
+    int keys[4] = {1, 2, 1, 3};
+    void* objs[4] = {&v, &v, &v, NULL};
+    dsc_error_t status[4];
+
+    /* Repeated key inside the batch behaves like a second insert */
+    ASSERT_EQ(2, dsc_hash_table_insert_batch(&ht, keys, objs, 4, status));
+    ASSERT_EQ(DSC_EOK, status[0]);
+    ASSERT_EQ(DSC_EOK, status[1]);
+    ASSERT_EQ(DSC_EEXISTS, status[2]);
+    ASSERT_EQ(DSC_EINVAL, status[3]);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    int probe[3] = {2, 9, 1};
+    void* out[3];
+    ASSERT_EQ(2, dsc_hash_table_get_batch(&ht, probe, out, 3, status));
+    ASSERT_TRUE(out[0] == &v);
+    ASSERT_NULL(out[1]);
+    ASSERT_EQ(DSC_ENOTFOUND, status[1]);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_batch_delete) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 16, sizeof(int), int_hash, int_cmp);
+
+    int keys[40];
+    void* objs[40];
+    for (int i = 0; i < 40; i++) {
+        keys[i] = i;
+        objs[i] = &keys[i];
+    }
+    dsc_hash_table_insert_batch(&ht, keys, objs, 40, NULL);
+
+    void* out[40];
+    ASSERT_EQ(20, dsc_hash_table_delete_batch(&ht, keys, out, 20, NULL));
+    ASSERT_EQ(20, ht.size);
+    ASSERT_TRUE(out[5] == &keys[5]);
+
+    /* Deleting again finds nothing */
+    ASSERT_EQ(0, dsc_hash_table_delete_batch(&ht, keys, NULL, 20, NULL));
+    ASSERT_EQ(20, dsc_hash_table_get_batch(&ht, keys + 20, NULL, 20, NULL));
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_batch_during_incremental_rehash) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 64, STR_KEY_SIZE, str_hash, str_cmp);
+    dsc_hash_table_set_incremental(&ht, true);
+
+    int values[60];
+    char bufs[60][24];
+    const char* keys[60];
+    void* objs[60];
+    for (int i = 0; i < 60; i++) {
+        values[i] = i;
+        snprintf(bufs[i], sizeof(bufs[i]), "inc%d", i);
+        keys[i] = bufs[i];
+        objs[i] = &values[i];
+    }
+
+    ASSERT_EQ(60, dsc_hash_table_insert_batch(&ht, keys, objs, 60, NULL));
+    ASSERT_EQ(60, dsc_hash_table_get_batch(&ht, keys, NULL, 60, NULL));
+    ASSERT_EQ(60, dsc_hash_table_delete_batch(&ht, keys, NULL, 60, NULL));
+    ASSERT_EQ(0, ht.size);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_batch_invalid_args) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 16, STR_KEY_SIZE, str_hash, str_cmp);
+
+    const char* keys[1] = {"a"};
+    ASSERT_EQ(0, dsc_hash_table_insert_batch(NULL, keys, NULL, 1, NULL));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_EQ(0, dsc_hash_table_insert_batch(&ht, keys, NULL, 1, NULL));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_EQ(0, dsc_hash_table_get_batch(&ht, NULL, NULL, 0, NULL));
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
 /* =========================================================
    Error Handling Tests
    ========================================================= */
@@ -412,9 +1083,257 @@ TEST(hash_table_strerror) {
     ASSERT_STR_EQ("Invalid argument", dsc_strerror(DSC_EINVAL));
     ASSERT_STR_EQ("Key or element not found", dsc_strerror(DSC_ENOTFOUND));
     ASSERT_STR_EQ("Key already exists", dsc_strerror(DSC_EEXISTS));
+    ASSERT_STR_EQ("Another writer committed first", dsc_strerror(DSC_ECONFLICT));
     ASSERT_STR_EQ("Unknown error", dsc_strerror((dsc_error_t)999));
 }
 
+DSC_DEFINE_HASH_TABLE(int, int*, int)
+
+TEST(hash_table_get_unchecked) {
+    int_table t;
+    int_table_init(&t, 4, int_hash, int_cmp);
+
+    static int keys[200];
+    for (int i = 0; i < 200; i++) {
+        keys[i] = i;
+        int_table_insert(&t, &keys[i], &keys[i]);
+    }
+
+    int missing = 1000;
+    dsc_hash_table_get(&t.impl, &missing);
+    ASSERT_EQ(DSC_ENOTFOUND, dsc_get_error());
+
+    for (int i = 0; i < 200; i++) ASSERT_EQ(i, *int_table_get_unchecked(&t, &i));
+    ASSERT_NULL(int_table_get_unchecked(&t, &missing));
+    ASSERT_EQ(DSC_ENOTFOUND, dsc_get_error());
+
+    int_table_destroy(&t, NULL);
+}
+
+/* =========================================================
+   Explicit Length Tests
+   ========================================================= */
+
+TEST(hash_table_len_string_slices) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 8, 0, dsc_hash_str, dsc_cmp_str);
+
+    /* Keys are slices of one buffer; none of them is NUL-terminated */
+    const char* text = "alphabetagammadelta";
+    int a = 1, b = 2, g = 3;
+    ASSERT_TRUE(dsc_hash_table_insert_len(&ht, text, 5, &a));
+    ASSERT_TRUE(dsc_hash_table_insert_len(&ht, text + 5, 4, &b));
+    ASSERT_TRUE(dsc_hash_table_insert_len(&ht, text + 9, 5, &g));
+    ASSERT_FALSE(dsc_hash_table_insert_len(&ht, "alpha", 5, &b));
+    ASSERT_EQ(DSC_EEXISTS, dsc_get_error());
+    ASSERT_EQ(3, ht.size);
+
+    /* Same entries as plain C strings, in both directions */
+    ASSERT_EQ(&b, dsc_hash_table_get(&ht, "beta"));
+    ASSERT_EQ(&g, dsc_hash_table_get_len(&ht, "gamma!", 5));
+    ASSERT_NULL(dsc_hash_table_get_len(&ht, text, 4));
+    ASSERT_EQ(DSC_ENOTFOUND, dsc_get_error());
+
+    /* The stored copy is terminated */
+    dsc_hash_table_iter it;
+    dsc_hash_table_iter_begin(&ht, &it);
+    while (dsc_hash_table_iter_next(&it)) {
+        ASSERT_EQ(strlen((const char*)it.kvp->key) + 1, it.kvp->key_size);
+    }
+
+    ASSERT_EQ(&a, dsc_hash_table_delete_len(&ht, text, 5));
+    ASSERT_NULL(dsc_hash_table_get(&ht, "alpha"));
+    ASSERT_EQ(2, ht.size);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_len_fixed_size_and_errors) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 8, sizeof(int), int_hash, int_cmp);
+
+    int key = 7, val = 70;
+    ASSERT_FALSE(dsc_hash_table_insert_len(&ht, &key, 2, &val));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_TRUE(dsc_hash_table_insert_len(&ht, &key, sizeof(int), &val));
+    ASSERT_EQ(&val, dsc_hash_table_get(&ht, &key));
+    ASSERT_EQ(&val, dsc_hash_table_get_len(&ht, &key, sizeof(int)));
+    ASSERT_NULL(dsc_hash_table_get_len(&ht, &key, 8));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    ASSERT_NULL(dsc_hash_table_get_len(NULL, &key, sizeof(int)));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_NULL(dsc_hash_table_delete_len(&ht, NULL, sizeof(int)));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    ASSERT_EQ(&val, dsc_hash_table_delete_len(&ht, &key, sizeof(int)));
+    ASSERT_EQ(0, ht.size);
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+/* =========================================================
+   Iteration Tests
+   ========================================================= */
+
+TEST(hash_table_iter_visits_each_entry) {
+    int_table t;
+    int_table_init(&t, 8, int_hash, int_cmp);
+
+    static int keys[300];
+    unsigned char seen[300] = {0};
+    for (int i = 0; i < 300; i++) {
+        keys[i] = i;
+        int_table_insert(&t, &keys[i], &keys[i]);
+    }
+
+    dsc_hash_table_iter it;
+    int_table_iter_begin(&t, &it);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    int *k, *v;
+    size_t n = 0;
+    while (int_table_iter_next(&it, &k, &v)) {
+        ASSERT_EQ(*k, *v);
+        ASSERT_TRUE(it.kvp->hash == int_hash(k, sizeof(int)));
+        seen[*k]++;
+        n++;
+    }
+    ASSERT_EQ(300, n);
+    for (int i = 0; i < 300; i++) ASSERT_EQ(1, seen[i]);
+
+    /* An exhausted iterator stays exhausted */
+    ASSERT_FALSE(dsc_hash_table_iter_next(&it));
+
+    int_table_destroy(&t, NULL);
+}
+
+TEST(hash_table_iter_delete_during_rehash) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 64, STR_KEY_SIZE, str_hash, str_cmp);
+    dsc_hash_table_set_incremental(&ht, true);
+
+    int values[50];
+    char keys[50][16];
+    for (int i = 0; i < 50; i++) {
+        values[i] = i;
+        snprintf(keys[i], sizeof(keys[i]), "it%d", i);
+        dsc_hash_table_insert(&ht, keys[i], &values[i]);
+    }
+    ASSERT_NOT_NULL(ht.old_kvpairs);
+
+    /* Deleting the current entry, including consecutive chain members */
+    dsc_hash_table_iter it;
+    dsc_hash_table_iter_begin(&ht, &it);
+    size_t visited = 0;
+    while (dsc_hash_table_iter_next(&it)) {
+        visited++;
+        if (*(int*)it.kvp->obj % 2 == 0) {
+            int* obj = (int*)dsc_hash_table_iter_delete(&it);
+            ASSERT_EQ(0, *obj % 2);
+            ASSERT_NULL(it.kvp);
+        }
+    }
+    ASSERT_EQ(50, visited);
+    ASSERT_EQ(25, ht.size);
+
+    for (int i = 0; i < 50; i++) {
+        void* obj = dsc_hash_table_get(&ht, keys[i]);
+        if (i % 2 == 0) ASSERT_NULL(obj);
+        else ASSERT_EQ(i, *(int*)obj);
+    }
+
+    dsc_hash_table_iter_delete(&it);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+static void scan_mark(const void* key, size_t key_size, void* obj, uint64_t hash, void* ctx) {
+    (void)key_size;
+    (void)obj;
+    (void)hash;
+    unsigned char* seen = (unsigned char*)ctx;
+    if (*(const int*)key < 1000) seen[*(const int*)key] = 1;
+}
+
+TEST(hash_table_scan_survives_resize) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 16, sizeof(int), int_hash, int_cmp);
+    dsc_hash_table_set_incremental(&ht, true);
+
+    static int keys[2000];
+    for (int i = 0; i < 2000; i++) keys[i] = i;
+    for (int i = 0; i < 1000; i++) dsc_hash_table_insert(&ht, &keys[i], &keys[i]);
+
+    /* Writes between calls grow the table several times mid-scan */
+    unsigned char seen[1000] = {0};
+    size_t cursor = 0;
+    int next_insert = 1000;
+    int calls = 0;
+    do {
+        cursor = dsc_hash_table_scan(&ht, cursor, 16, scan_mark, seen);
+        ASSERT_EQ(DSC_EOK, dsc_get_error());
+        for (int j = 0; j < 8 && next_insert < 2000; j++, next_insert++) {
+            dsc_hash_table_insert(&ht, &keys[next_insert], &keys[next_insert]);
+        }
+        calls++;
+    } while (cursor != 0);
+
+    ASSERT_TRUE(calls > 1);
+    ASSERT_TRUE(ht.capacity >= 2048);
+    for (int i = 0; i < 1000; i++) ASSERT_EQ(1, seen[i]);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(hash_table_scan_invalid_args) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 8, sizeof(int), int_hash, int_cmp);
+
+    unsigned char seen[1] = {0};
+    ASSERT_EQ(0, dsc_hash_table_scan(&ht, 0, 10, scan_mark, seen));
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    ASSERT_EQ(0, dsc_hash_table_scan(&ht, 0, 10, NULL, NULL));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_EQ(0, dsc_hash_table_scan(NULL, 0, 10, scan_mark, seen));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_hash_table_iter it;
+    dsc_hash_table_iter_begin(NULL, &it);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_FALSE(dsc_hash_table_iter_next(&it));
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+/* =========================================================
+   Statistics Tests
+   ========================================================= */
+
+TEST(hash_table_stats_without_counters) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 8, sizeof(int), int_hash, int_cmp);
+    int vals[100];
+    for (int i = 0; i < 100; i++) {
+        vals[i] = i;
+        dsc_hash_table_insert(&ht, &i, &vals[i]);
+    }
+
+    /* Shape is measured from the table; the counters need DSC_STATS */
+    dsc_table_stats st = dsc_hash_table_stats(&ht);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(100, st.size);
+    ASSERT_TRUE(st.max_probe >= 1);
+    ASSERT_EQ(100 * sizeof(int), st.key_bytes);
+#ifndef DSC_STATS
+    ASSERT_EQ(0, st.resizes);
+    ASSERT_EQ(0, st.alloc.allocs);
+#endif
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
 /* =========================================================
    Main
    ========================================================= */
@@ -462,9 +1381,61 @@ int main(void) {
     TEST_SECTION("Stress Tests");
     RUN_TEST(hash_table_stress_many_inserts);
     
+    TEST_SECTION("Cached Hash");
+    RUN_TEST(hash_table_cached_hash_stored);
+    RUN_TEST(hash_table_resize_does_not_rehash);
+    RUN_TEST(hash_table_cmp_skipped_on_hash_mismatch);
+
+    TEST_SECTION("Upsert");
+    RUN_TEST(hash_table_insert_hashes_once);
+    RUN_TEST(hash_table_upsert_new_and_existing);
+    RUN_TEST(hash_table_upsert_counters_in_place);
+    RUN_TEST(hash_table_upsert_invalid_args);
+
+    TEST_SECTION("Incremental Rehash");
+    RUN_TEST(hash_table_incremental_keeps_old_array);
+    RUN_TEST(hash_table_incremental_delete_during_rehash);
+    RUN_TEST(hash_table_incremental_explicit_step);
+    RUN_TEST(hash_table_incremental_clear_and_disable);
+
+    TEST_SECTION("Sizing");
+    RUN_TEST(hash_table_reserve_and_compact);
+    RUN_TEST(hash_table_shrink_hysteresis);
+    RUN_TEST(hash_table_shrink_floor_and_iterators);
+    RUN_TEST(hash_table_shrink_incremental);
+
+    TEST_SECTION("Built-in Hash Functions");
+    RUN_TEST(hash_builtin_str);
+    RUN_TEST(hash_builtin_bytes_all_lengths);
+    RUN_TEST(hash_builtin_pod_and_ptr);
+    RUN_TEST(hash_builtin_tables);
+    RUN_TEST(hash_table_mask_spreads_weak_hash);
+    RUN_TEST(hash_table_capacity_power_of_two);
+
+    TEST_SECTION("Batch");
+    RUN_TEST(hash_table_batch_insert_and_get);
+    RUN_TEST(hash_table_batch_per_key_status);
+    RUN_TEST(hash_table_batch_delete);
+    RUN_TEST(hash_table_batch_during_incremental_rehash);
+    RUN_TEST(hash_table_batch_invalid_args);
+
     TEST_SECTION("Error Handling");
     RUN_TEST(hash_table_error_clear);
     RUN_TEST(hash_table_strerror);
+    RUN_TEST(hash_table_get_unchecked);
+
+    TEST_SECTION("Explicit Length");
+    RUN_TEST(hash_table_len_string_slices);
+    RUN_TEST(hash_table_len_fixed_size_and_errors);
+
+    TEST_SECTION("Iteration");
+    RUN_TEST(hash_table_iter_visits_each_entry);
+    RUN_TEST(hash_table_iter_delete_during_rehash);
+    RUN_TEST(hash_table_scan_survives_resize);
+    RUN_TEST(hash_table_scan_invalid_args);
+
+    TEST_SECTION("Statistics");
+    RUN_TEST(hash_table_stats_without_counters);
     
     TEST_SUMMARY();
     return TEST_EXIT_CODE();
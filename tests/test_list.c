@@ -30,7 +30,13 @@ TEST(list_init_zero_capacity) {
     dsc_list_init(&list, sizeof(int), 0);
     
     ASSERT_EQ(DSC_EOK, dsc_get_error());
-    ASSERT_EQ(256, list.capacity);  /* Default capacity */
+    ASSERT_EQ(0, list.capacity);    /* Nothing allocated until the first append */
+    ASSERT_NULL(list.items);
+
+    int v = 5;
+    dsc_list_append(&list, &v);
+    ASSERT_EQ(8, list.capacity);    /* Default policy minimum */
+    ASSERT_EQ(5, *(int*)dsc_list_get(&list, 0));
     
     dsc_list_destroy(&list);
 }
@@ -336,6 +342,9 @@ TEST(list_resize_grow) {
     ASSERT_EQ(0, *(int*)dsc_list_get(&list, 0));
     ASSERT_EQ(1, *(int*)dsc_list_get(&list, 1));
     ASSERT_EQ(2, *(int*)dsc_list_get(&list, 2));
+
+    /* New items are zeroed */
+    for (size_t i = 3; i < 10; i++) ASSERT_EQ(0, *(int*)dsc_list_get(&list, i));
     
     dsc_list_destroy(&list);
 }
@@ -351,6 +360,11 @@ TEST(list_resize_shrink) {
     dsc_list_resize(&list, 3);
     ASSERT_EQ(DSC_EOK, dsc_get_error());
     ASSERT_EQ(3, list.length);
+
+    /* Growing back does not expose the old values */
+    dsc_list_resize(&list, 10);
+    ASSERT_EQ(2, *(int*)dsc_list_get(&list, 2));
+    for (size_t i = 3; i < 10; i++) ASSERT_EQ(0, *(int*)dsc_list_get(&list, i));
     
     dsc_list_destroy(&list);
 }
@@ -360,6 +374,251 @@ TEST(list_resize_null_list) {
     ASSERT_EQ(DSC_EINVAL, dsc_get_error());
 }
 
+/* =========================================================
+   Bulk Operation Tests
+   ========================================================= */
+
+static int is_even_item(void* item) {
+    return *(int*)item % 2 == 0;
+}
+
+TEST(list_reserve_keeps_length) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 4);
+    int v = 7;
+    dsc_list_append(&list, &v);
+
+    dsc_list_reserve(&list, 1000);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(1000, list.capacity);
+    ASSERT_EQ(1, list.length);
+    ASSERT_EQ(7, *(int*)dsc_list_get(&list, 0));
+
+    /* Smaller request is a no-op */
+    dsc_list_reserve(&list, 10);
+    ASSERT_EQ(1000, list.capacity);
+
+    dsc_list_destroy(&list);
+}
+
+TEST(list_shrink_to_fit) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 256);
+    for (int i = 0; i < 10; i++) dsc_list_append(&list, &i);
+
+    dsc_list_shrink_to_fit(&list);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(10, list.capacity);
+    ASSERT_EQ(9, *(int*)dsc_list_get(&list, 9));
+
+    dsc_list_clear(&list);
+    dsc_list_shrink_to_fit(&list);
+    ASSERT_EQ(1, list.capacity);
+    ASSERT_NOT_NULL(list.items);
+
+    int v = 3;
+    dsc_list_append(&list, &v);
+    dsc_list_append(&list, &v);
+    ASSERT_EQ(2, list.length);
+
+    dsc_list_destroy(&list);
+}
+
+TEST(list_append_n_grows_once) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 4);
+
+    int block[100];
+    for (int i = 0; i < 100; i++) block[i] = i;
+    dsc_list_append_n(&list, block, 100);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(100, list.length);
+    ASSERT_EQ(100, list.capacity);  /* One growth straight to the block size */
+    ASSERT_EQ(99, *(int*)dsc_list_get(&list, 99));
+
+    dsc_list_append_n(&list, block, 0);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(100, list.length);
+
+    dsc_list_append_n(&list, NULL, 3);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_list_destroy(&list);
+}
+
+TEST(list_insert_range_middle_and_ends) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 2);
+    int base[] = {1, 2, 5, 6};
+    dsc_list_append_n(&list, base, 4);
+
+    int mid[] = {3, 4};
+    dsc_list_insert_range(&list, 2, mid, 2);
+    int front = 0;
+    dsc_list_insert_range(&list, 0, &front, 1);
+    int back = 7;
+    dsc_list_insert_range(&list, list.length, &back, 1);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    ASSERT_EQ(8, list.length);
+    for (int i = 0; i < 8; i++) ASSERT_EQ(i, *(int*)dsc_list_get(&list, (size_t)i));
+
+    dsc_list_insert_range(&list, 9, mid, 2);
+    ASSERT_EQ(DSC_ERANGE, dsc_get_error());
+    ASSERT_EQ(8, list.length);
+
+    dsc_list_destroy(&list);
+}
+
+TEST(list_erase_range) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 16);
+    for (int i = 0; i < 10; i++) dsc_list_append(&list, &i);
+
+    dsc_list_erase_range(&list, 2, 3);   /* removes 2, 3, 4 */
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(7, list.length);
+    ASSERT_EQ(1, *(int*)dsc_list_get(&list, 1));
+    ASSERT_EQ(5, *(int*)dsc_list_get(&list, 2));
+    ASSERT_EQ(9, *(int*)dsc_list_get(&list, 6));
+
+    dsc_list_erase_range(&list, 5, 5);
+    ASSERT_EQ(DSC_ERANGE, dsc_get_error());
+    dsc_list_erase_range(&list, 5, SIZE_MAX);
+    ASSERT_EQ(DSC_ERANGE, dsc_get_error());
+
+    dsc_list_erase_range(&list, 5, 2);   /* tail */
+    ASSERT_EQ(5, list.length);
+    dsc_list_erase_range(&list, 0, 5);
+    ASSERT_EQ(0, list.length);
+
+    dsc_list_destroy(&list);
+}
+
+TEST(list_append_after_destroy) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 4);
+    dsc_list_destroy(&list);
+
+    /* Zero capacity must still grow */
+    list.item_size = sizeof(int);
+    int v = 11;
+    dsc_list_append(&list, &v);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(11, *(int*)dsc_list_get(&list, 0));
+
+    dsc_list_destroy(&list);
+}
+
+/* =========================================================
+   Growth Policy Tests
+   ========================================================= */
+
+TEST(list_growth_policy_factor_and_min) {
+    dsc_list_growth policy = { 50, 4, 0, 0 };   /* 1.5x, start at 4 */
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 0);
+    dsc_list_set_growth(&list, &policy);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    int v = 1;
+    dsc_list_append(&list, &v);
+    ASSERT_EQ(4, list.capacity);
+    for (int i = 0; i < 4; i++) dsc_list_append(&list, &v);
+    ASSERT_EQ(6, list.capacity);
+    for (int i = 0; i < 2; i++) dsc_list_append(&list, &v);
+    ASSERT_EQ(9, list.capacity);
+
+    dsc_list_destroy(&list);
+}
+
+TEST(list_growth_policy_max_step) {
+    dsc_list_growth policy = { 100, 8, 64, 0 };
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 256);
+    dsc_list_set_growth(&list, &policy);
+
+    for (int i = 0; i < 257; i++) dsc_list_append(&list, &i);
+    ASSERT_EQ(320, list.capacity);   /* 256 + 64, not 512 */
+
+    /* A bulk insert larger than max_step still fits in one growth */
+    int block[500] = {0};
+    dsc_list_append_n(&list, block, 500);
+    ASSERT_EQ(757, list.capacity);
+
+    dsc_list filtered = dsc_list_filter(&list, is_even_item);
+    ASSERT_TRUE(filtered.growth == &policy);
+    dsc_list_destroy(&filtered);
+
+    dsc_list_destroy(&list);
+}
+
+TEST(list_capacity_overflow_is_rejected) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 4);
+    int v = 9;
+    dsc_list_append(&list, &v);
+
+    dsc_list_reserve(&list, SIZE_MAX / 2);
+    ASSERT_EQ(DSC_ENOMEM, dsc_get_error());
+    ASSERT_EQ(4, list.capacity);
+
+    dsc_list_append_n(&list, &v, SIZE_MAX);
+    ASSERT_EQ(DSC_ENOMEM, dsc_get_error());
+    ASSERT_EQ(1, list.length);
+
+    dsc_list_resize(&list, SIZE_MAX);
+    ASSERT_EQ(DSC_ENOMEM, dsc_get_error());
+    ASSERT_EQ(1, list.length);
+    ASSERT_EQ(9, *(int*)dsc_list_get(&list, 0));
+
+    dsc_list big;
+    dsc_list_init(&big, 64, SIZE_MAX / 8);
+    ASSERT_EQ(DSC_ENOMEM, dsc_get_error());
+
+    dsc_list_destroy(&list);
+}
+
+TEST(list_growth_policy_shrink) {
+    dsc_list_growth policy = { 100, 8, 0, 25 };   /* Shrink under a quarter full */
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 0);
+    dsc_list_set_growth(&list, &policy);
+    for (int i = 0; i < 1000; i++) dsc_list_append(&list, &i);
+    ASSERT_EQ(1024, list.capacity);
+
+    /* 255 < 1024 / 4: cut to twice the length */
+    while (list.length > 256) dsc_list_pop(&list);
+    ASSERT_EQ(1024, list.capacity);
+    dsc_list_pop(&list);
+    ASSERT_EQ(510, list.capacity);
+    ASSERT_EQ(254, *(int*)dsc_list_get(&list, 254));
+
+    /* Push/pop at the boundary does not reallocate */
+    int v = 0;
+    for (int r = 0; r < 100; r++) {
+        dsc_list_append(&list, &v);
+        dsc_list_pop(&list);
+    }
+    ASSERT_EQ(510, list.capacity);
+
+    dsc_list_erase_range(&list, 10, 240);
+    ASSERT_EQ(15, list.length);
+    ASSERT_EQ(30, list.capacity);
+    ASSERT_EQ(250, *(int*)dsc_list_get(&list, 10));
+
+    /* Never below min_capacity */
+    dsc_list_clear(&list);
+    ASSERT_EQ(8, list.capacity);
+
+    dsc_list_growth bad = { 100, 8, 0, 60 };
+    dsc_list_set_growth(&list, &bad);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_TRUE(list.growth == &policy);
+
+    dsc_list_destroy(&list);
+}
+
 /* =========================================================
    Map/Foreach Tests
    ========================================================= */
@@ -504,6 +763,108 @@ TEST(list_filter_null_predicate) {
     dsc_list_destroy(&list);
 }
 
+/* =========================================================
+   Span Callback Tests
+   ========================================================= */
+
+typedef struct {
+    size_t calls;
+    size_t items;
+    long   sum;
+} span_stats;
+
+static void scale_span(void* items, size_t count, size_t item_size, void* ctx) {
+    int* v = (int*)items;
+    (void)item_size;
+    for (size_t i = 0; i < count; i++) v[i] *= *(int*)ctx;
+}
+
+static void sum_span(void* items, size_t count, size_t item_size, void* ctx) {
+    span_stats* st = (span_stats*)ctx;
+    const int* v = (const int*)items;
+    (void)item_size;
+    st->calls++;
+    st->items += count;
+    for (size_t i = 0; i < count; i++) st->sum += v[i];
+}
+
+static void even_span(const void* items, size_t count, size_t item_size, unsigned char* keep, void* ctx) {
+    const int* v = (const int*)items;
+    (void)item_size;
+    (void)ctx;
+    for (size_t i = 0; i < count; i++) keep[i] = (unsigned char)(v[i] % 2 == 0);
+}
+
+TEST(list_map_span_whole_list) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 16);
+    for (int i = 0; i < 100; i++) dsc_list_append(&list, &i);
+
+    int factor = 3;
+    dsc_list_map_span(&list, 0, scale_span, &factor);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(297, *(int*)dsc_list_get(&list, 99));
+
+    span_stats st = {0, 0, 0};
+    dsc_list_foreach_span(&list, 0, sum_span, &st);
+    ASSERT_EQ(1, st.calls);
+    ASSERT_EQ(100, st.items);
+    ASSERT_EQ(3 * 4950, st.sum);
+
+    dsc_list_destroy(&list);
+}
+
+TEST(list_foreach_span_blocks) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 16);
+    for (int i = 0; i < 100; i++) dsc_list_append(&list, &i);
+
+    span_stats st = {0, 0, 0};
+    dsc_list_foreach_span(&list, 32, sum_span, &st);
+    ASSERT_EQ(4, st.calls);  /* 32 + 32 + 32 + 4 */
+    ASSERT_EQ(100, st.items);
+    ASSERT_EQ(4950, st.sum);
+
+    dsc_list_map_span(&list, 8, NULL, NULL);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_list_destroy(&list);
+}
+
+TEST(list_filter_span_basic) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 16);
+    for (int i = 0; i < 5000; i++) dsc_list_append(&list, &i);
+
+    dsc_list evens = dsc_list_filter_span(&list, 0, even_span, NULL);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(2500, evens.length);
+    for (size_t i = 0; i < evens.length; i++) {
+        ASSERT_EQ((int)(i * 2), *(int*)dsc_list_get(&evens, i));
+    }
+    dsc_list_destroy(&evens);
+
+    dsc_list small = dsc_list_filter_span(&list, 7, even_span, NULL);
+    ASSERT_EQ(2500, small.length);
+    ASSERT_EQ(4998, *(int*)dsc_list_get(&small, 2499));
+    dsc_list_destroy(&small);
+
+    dsc_list_destroy(&list);
+}
+
+TEST(list_map_span_parallel_no_pool) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 16);
+    for (int i = 0; i < 3000; i++) dsc_list_append(&list, &i);
+
+    int factor = 2;
+    dsc_list_map_span_parallel(&list, NULL, scale_span, &factor);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(5998, *(int*)dsc_list_get(&list, 2999));
+
+    dsc_list_destroy(&list);
+}
+
 /* =========================================================
    Destroy Tests
    ========================================================= */
@@ -569,6 +930,33 @@ TEST(typed_list_filter) {
     int_list_destroy(&list);
 }
 
+TEST(typed_list_expression_macros) {
+    int_list list;
+    int_list_init(&list, 16);
+    for (int i = 1; i <= 10; i++) int_list_append(&list, i);
+
+    DSC_LIST_MAP(int, &list, x, x * x);
+    ASSERT_EQ(100, int_list_get(&list, 9));
+
+    long sum = 0;
+    DSC_LIST_REDUCE(int, &list, sum, x, sum + x);
+    ASSERT_EQ(385, sum);
+
+    int_list odd;
+    int_list_init(&odd, 2);
+    DSC_LIST_FILTER(int, &list, &odd, x, x % 2 != 0);
+    ASSERT_EQ(5, int_list_length(&odd));
+    ASSERT_EQ(1, int_list_get(&odd, 0));
+    ASSERT_EQ(81, int_list_get(&odd, 4));
+
+    /* Refilter into the same output: previous contents are replaced */
+    DSC_LIST_FILTER(int, &list, &odd, x, x > 1000);
+    ASSERT_EQ(0, int_list_length(&odd));
+
+    int_list_destroy(&odd);
+    int_list_destroy(&list);
+}
+
 /* =========================================================
    Stress Tests
    ========================================================= */
@@ -591,6 +979,28 @@ TEST(list_stress_many_appends) {
     dsc_list_destroy(&list);
 }
 
+TEST(list_unchecked_tier) {
+    int_list list;
+    int_list_init(&list, 2);
+
+    /* A stale error survives: the fast path never writes the error slot */
+    dsc_list_get(&list.impl, 99);
+    ASSERT_EQ(DSC_ERANGE, dsc_get_error());
+
+    ASSERT_EQ(DSC_EOK, int_list_append_unchecked(&list, 10));
+    ASSERT_EQ(DSC_EOK, int_list_append_unchecked(&list, 20));
+    ASSERT_EQ(10, int_list_get_unchecked(&list, 0));
+    ASSERT_EQ(20, *(int*)dsc_list_get_unchecked(&list.impl, 1));
+    ASSERT_EQ(DSC_ERANGE, dsc_get_error());
+
+    /* Growing goes through the checked path */
+    for (int i = 0; i < 100; i++) ASSERT_EQ(DSC_EOK, int_list_append_unchecked(&list, i));
+    ASSERT_EQ(102, int_list_length(&list));
+    ASSERT_EQ(99, int_list_get_unchecked(&list, 101));
+
+    int_list_destroy(&list);
+}
+
 /* =========================================================
    Main
    ========================================================= */
@@ -636,6 +1046,20 @@ int main(void) {
     RUN_TEST(list_resize_grow);
     RUN_TEST(list_resize_shrink);
     RUN_TEST(list_resize_null_list);
+
+    TEST_SECTION("Bulk Operations");
+    RUN_TEST(list_reserve_keeps_length);
+    RUN_TEST(list_shrink_to_fit);
+    RUN_TEST(list_append_n_grows_once);
+    RUN_TEST(list_insert_range_middle_and_ends);
+    RUN_TEST(list_erase_range);
+    RUN_TEST(list_append_after_destroy);
+
+    TEST_SECTION("Growth Policy");
+    RUN_TEST(list_growth_policy_factor_and_min);
+    RUN_TEST(list_growth_policy_max_step);
+    RUN_TEST(list_growth_policy_shrink);
+    RUN_TEST(list_capacity_overflow_is_rejected);
     
     TEST_SECTION("Map/Foreach");
     RUN_TEST(list_foreach_basic);
@@ -649,6 +1073,12 @@ int main(void) {
     RUN_TEST(list_filter_no_matches);
     RUN_TEST(list_filter_null_list);
     RUN_TEST(list_filter_null_predicate);
+
+    TEST_SECTION("Span Callbacks");
+    RUN_TEST(list_map_span_whole_list);
+    RUN_TEST(list_foreach_span_blocks);
+    RUN_TEST(list_filter_span_basic);
+    RUN_TEST(list_map_span_parallel_no_pool);
     
     TEST_SECTION("Destroy");
     RUN_TEST(list_destroy_basic);
@@ -657,6 +1087,8 @@ int main(void) {
     TEST_SECTION("Type-Safe Wrappers");
     RUN_TEST(typed_list_basic);
     RUN_TEST(typed_list_filter);
+    RUN_TEST(typed_list_expression_macros);
+    RUN_TEST(list_unchecked_tier);
     
     TEST_SECTION("Stress Tests");
     RUN_TEST(list_stress_many_appends);
@@ -0,0 +1,285 @@
+/**
+ * Lock-Free Queue Tests
+ * Tests dsc_mpmc_queue and dsc_spsc_ring, single- and multi-threaded.
+ */
+
+#define TEST_THREADS
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <string.h>
+
+typedef struct {
+    int    id;
+    double payload;
+} Job;
+
+DSC_DEFINE_MPMC_QUEUE(Job, job)
+DSC_DEFINE_SPSC_RING(int, int)
+
+/* =========================================================
+   MPMC Queue Tests
+   ========================================================= */
+
+TEST(mpmc_init_rounds_capacity) {
+    dsc_mpmc_queue q;
+    dsc_mpmc_queue_init(&q, sizeof(int), 100);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(127, q.mask);
+    ASSERT_EQ(0, dsc_mpmc_queue_size(&q));
+    dsc_mpmc_queue_destroy(&q);
+    ASSERT_NULL(q.cells);
+
+    dsc_mpmc_queue_init(&q, 0, 16);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+}
+
+TEST(mpmc_fifo_full_and_empty) {
+    dsc_mpmc_queue q;
+    dsc_mpmc_queue_init(&q, sizeof(int), 4);
+
+    for (int i = 0; i < 4; i++) ASSERT_TRUE(dsc_mpmc_queue_push(&q, &i));
+    int extra = 99;
+    ASSERT_FALSE(dsc_mpmc_queue_push(&q, &extra));
+    ASSERT_EQ(DSC_EFULL, dsc_get_error());
+    ASSERT_EQ(4, dsc_mpmc_queue_size(&q));
+
+    int out;
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(dsc_mpmc_queue_pop(&q, &out));
+        ASSERT_EQ(i, out);
+    }
+    ASSERT_FALSE(dsc_mpmc_queue_pop(&q, &out));
+    ASSERT_EQ(DSC_EEMPTY, dsc_get_error());
+
+    dsc_mpmc_queue_destroy(&q);
+}
+
+TEST(mpmc_batch_wraps_and_partial) {
+    dsc_mpmc_queue q;
+    dsc_mpmc_queue_init(&q, sizeof(int), 8);
+
+    int in[12], out[12];
+    for (int i = 0; i < 12; i++) in[i] = i * 3;
+
+    /* Shift the positions so the batch wraps around the ring */
+    ASSERT_EQ(5, dsc_mpmc_queue_push_n(&q, in, 5));
+    ASSERT_EQ(5, dsc_mpmc_queue_pop_n(&q, out, 5));
+
+    /* Only 8 fit */
+    ASSERT_EQ(8, dsc_mpmc_queue_push_n(&q, in, 12));
+    ASSERT_EQ(0, dsc_mpmc_queue_push_n(&q, in, 1));
+    ASSERT_EQ(3, dsc_mpmc_queue_pop_n(&q, out, 3));
+    ASSERT_EQ(6, out[2]);
+    ASSERT_EQ(5, dsc_mpmc_queue_pop_n(&q, out, 12));
+    ASSERT_EQ(21, out[4]);
+    ASSERT_EQ(0, dsc_mpmc_queue_pop_n(&q, out, 12));
+
+    dsc_mpmc_queue_destroy(&q);
+}
+
+TEST(mpmc_typed_wrapper) {
+    job_mpmc_queue q;
+    job_mpmc_queue_init(&q, 16);
+
+    Job j = {7, 1.5};
+    ASSERT_TRUE(job_mpmc_queue_push(&q, j));
+    Job batch[3] = {{1, 0.1}, {2, 0.2}, {3, 0.3}};
+    ASSERT_EQ(3, job_mpmc_queue_push_n(&q, batch, 3));
+
+    Job out[4];
+    ASSERT_TRUE(job_mpmc_queue_pop(&q, &out[0]));
+    ASSERT_EQ(7, out[0].id);
+    ASSERT_EQ(3, job_mpmc_queue_pop_n(&q, out, 4));
+    ASSERT_EQ(3, out[2].id);
+
+    job_mpmc_queue_destroy(&q);
+}
+
+#define PRODUCERS      4
+#define CONSUMERS      4
+#define ITEMS_PER_PROD 50000
+
+typedef struct {
+    dsc_mpmc_queue* q;
+    int             id;
+    long long       sum;
+    int             count;
+} mpmc_arg;
+
+TEST_THREAD_FN(mpmc_producer) {
+    mpmc_arg* a = (mpmc_arg*)arg;
+    int batch[8];
+    int next = 0;
+    while (next < ITEMS_PER_PROD) {
+        int n = 0;
+        for (; n < 8 && next + n < ITEMS_PER_PROD; n++) batch[n] = a->id * ITEMS_PER_PROD + next + n + 1;
+        /* Alternate single and batch pushes */
+        if (next % 16 == 0) {
+            while (!dsc_mpmc_queue_push(a->q, &batch[0])) { }
+            next += 1;
+        } else {
+            size_t pushed = dsc_mpmc_queue_push_n(a->q, batch, (size_t)n);
+            next += (int)pushed;
+        }
+    }
+    TEST_THREAD_RETURN;
+}
+
+/* Items are >= 1; a 0 tells one consumer to stop */
+TEST_THREAD_FN(mpmc_consumer) {
+    mpmc_arg* a = (mpmc_arg*)arg;
+    int batch[8];
+    int stops = 0;
+    while (stops == 0) {
+        size_t n = dsc_mpmc_queue_pop_n(a->q, batch, 8);
+        for (size_t i = 0; i < n; i++) {
+            if (batch[i] == 0) {
+                stops++;
+            } else {
+                a->sum += batch[i];
+                a->count++;
+            }
+        }
+    }
+    /* Hand back stop markers meant for other consumers */
+    int zero = 0;
+    for (int i = 1; i < stops; i++) {
+        while (!dsc_mpmc_queue_push(a->q, &zero)) { }
+    }
+    TEST_THREAD_RETURN;
+}
+
+TEST(mpmc_many_producers_many_consumers) {
+    dsc_mpmc_queue q;
+    dsc_mpmc_queue_init(&q, sizeof(int), 1024);
+
+    test_thread threads[PRODUCERS + CONSUMERS];
+    mpmc_arg    args[PRODUCERS + CONSUMERS];
+    for (int t = 0; t < PRODUCERS + CONSUMERS; t++) {
+        args[t] = (mpmc_arg){&q, t, 0, 0};
+        test_thread_start(&threads[t], (t < PRODUCERS) ? mpmc_producer : mpmc_consumer, &args[t]);
+    }
+    for (int t = 0; t < PRODUCERS; t++) test_thread_join(threads[t]);
+
+    int zero = 0;
+    for (int c = 0; c < CONSUMERS; c++) {
+        while (!dsc_mpmc_queue_push(&q, &zero)) { }
+    }
+    for (int t = PRODUCERS; t < PRODUCERS + CONSUMERS; t++) test_thread_join(threads[t]);
+
+    long long sum = 0;
+    int count = 0;
+    for (int t = PRODUCERS; t < PRODUCERS + CONSUMERS; t++) {
+        sum += args[t].sum;
+        count += args[t].count;
+    }
+    long long n = (long long)PRODUCERS * ITEMS_PER_PROD;
+    ASSERT_EQ(n, count);
+    ASSERT_TRUE(sum == n * (n + 1) / 2);
+
+    dsc_mpmc_queue_destroy(&q);
+}
+
+/* =========================================================
+   SPSC Ring Tests
+   ========================================================= */
+
+TEST(spsc_fifo_full_and_empty) {
+    int_spsc_ring r;
+    int_spsc_ring_init(&r, 4);
+
+    for (int i = 0; i < 4; i++) ASSERT_TRUE(int_spsc_ring_push(&r, i));
+    ASSERT_FALSE(int_spsc_ring_push(&r, 99));
+    ASSERT_EQ(DSC_EFULL, dsc_get_error());
+    ASSERT_EQ(4, dsc_spsc_ring_size(&r.impl));
+
+    int out;
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(int_spsc_ring_pop(&r, &out));
+        ASSERT_EQ(i, out);
+    }
+    ASSERT_FALSE(int_spsc_ring_pop(&r, &out));
+    ASSERT_EQ(DSC_EEMPTY, dsc_get_error());
+
+    int_spsc_ring_destroy(&r);
+}
+
+TEST(spsc_batch_wraps) {
+    int_spsc_ring r;
+    int_spsc_ring_init(&r, 8);
+
+    int in[10], out[10];
+    for (int i = 0; i < 10; i++) in[i] = i + 100;
+
+    ASSERT_EQ(6, int_spsc_ring_push_n(&r, in, 6));
+    ASSERT_EQ(6, int_spsc_ring_pop_n(&r, out, 10));
+    ASSERT_EQ(8, int_spsc_ring_push_n(&r, in, 10));
+    ASSERT_EQ(8, int_spsc_ring_pop_n(&r, out, 10));
+    for (int i = 0; i < 8; i++) ASSERT_EQ(i + 100, out[i]);
+
+    int_spsc_ring_destroy(&r);
+}
+
+#define SPSC_ITEMS 200000
+
+TEST_THREAD_FN(spsc_producer) {
+    dsc_spsc_ring* r = (dsc_spsc_ring*)arg;
+    int batch[16];
+    int next = 0;
+    while (next < SPSC_ITEMS) {
+        int n = 0;
+        for (; n < 16 && next + n < SPSC_ITEMS; n++) batch[n] = next + n;
+        next += (int)dsc_spsc_ring_push_n(r, batch, (size_t)n);
+    }
+    TEST_THREAD_RETURN;
+}
+
+TEST(spsc_producer_consumer_in_order) {
+    dsc_spsc_ring r;
+    dsc_spsc_ring_init(&r, sizeof(int), 256);
+
+    test_thread producer;
+    test_thread_start(&producer, spsc_producer, &r);
+
+    int expected = 0;
+    int ordered  = 1;
+    int batch[32];
+    while (expected < SPSC_ITEMS) {
+        size_t n = dsc_spsc_ring_pop_n(&r, batch, 32);
+        for (size_t i = 0; i < n; i++) {
+            if (batch[i] != expected) ordered = 0;
+            expected++;
+        }
+    }
+    test_thread_join(producer);
+
+    ASSERT_TRUE(ordered);
+    ASSERT_EQ(0, dsc_spsc_ring_size(&r));
+    dsc_spsc_ring_destroy(&r);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("Lock-Free Queue Tests");
+
+    TEST_SECTION("MPMC Queue");
+    RUN_TEST(mpmc_init_rounds_capacity);
+    RUN_TEST(mpmc_fifo_full_and_empty);
+    RUN_TEST(mpmc_batch_wraps_and_partial);
+    RUN_TEST(mpmc_typed_wrapper);
+    RUN_TEST(mpmc_many_producers_many_consumers);
+
+    TEST_SECTION("SPSC Ring");
+    RUN_TEST(spsc_fifo_full_and_empty);
+    RUN_TEST(spsc_batch_wraps);
+    RUN_TEST(spsc_producer_consumer_in_order);
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}
@@ -50,6 +50,8 @@ static uint64_t int_hash(const void* key, size_t len) {
 
 #define STR_KEY_SIZE 0
 
+DSC_DEFINE_SET(const int*, int)
+
 /* =========================================================
    Initialization Tests
    ========================================================= */
@@ -58,16 +60,16 @@ TEST(set_init_basic) {
     dsc_set set;
     dsc_set_init(&set, 16, STR_KEY_SIZE, str_hash, str_cmp);
     ASSERT_EQ(DSC_EOK, dsc_get_error());
-    ASSERT_NOT_NULL(set.ht);
-    ASSERT_EQ(16, set.ht->capacity);
-    ASSERT_EQ(0, set.ht->size);
+    ASSERT_NOT_NULL(set.buckets);
+    ASSERT_EQ(16, set.capacity);
+    ASSERT_EQ(0, set.size);
     dsc_set_destroy(&set);
 }
 
 TEST(set_init_zero_capacity) {
     dsc_set set;
     dsc_set_init(&set, 0, STR_KEY_SIZE, str_hash, str_cmp);
-    ASSERT_EQ(1, set.ht->capacity);
+    ASSERT_EQ(1, set.capacity);
     dsc_set_destroy(&set);
 }
 
@@ -91,7 +93,8 @@ TEST(set_init_null_cmpfunc) {
 TEST(set_init_large_capacity) {
     dsc_set set;
     dsc_set_init(&set, 10000, STR_KEY_SIZE, str_hash, str_cmp);
-    ASSERT_EQ(10000, set.ht->capacity);
+    /* Rounded up to the next power of two */
+    ASSERT_EQ(16384, set.capacity);
     dsc_set_destroy(&set);
 }
 
@@ -106,7 +109,7 @@ TEST(set_add_basic) {
     bool result = dsc_set_add(&set, "item1");
     ASSERT_TRUE(result);
     ASSERT_EQ(DSC_EOK, dsc_get_error());
-    ASSERT_EQ(1, set.ht->size);
+    ASSERT_EQ(1, set.size);
     
     dsc_set_destroy(&set);
 }
@@ -118,7 +121,7 @@ TEST(set_add_multiple) {
     ASSERT_TRUE(dsc_set_add(&set, "apple"));
     ASSERT_TRUE(dsc_set_add(&set, "banana"));
     ASSERT_TRUE(dsc_set_add(&set, "cherry"));
-    ASSERT_EQ(3, set.ht->size);
+    ASSERT_EQ(3, set.size);
     
     dsc_set_destroy(&set);
 }
@@ -130,7 +133,7 @@ TEST(set_add_duplicate) {
     ASSERT_TRUE(dsc_set_add(&set, "duplicate"));
     ASSERT_FALSE(dsc_set_add(&set, "duplicate"));
     ASSERT_EQ(DSC_EEXISTS, dsc_get_error());
-    ASSERT_EQ(1, set.ht->size);
+    ASSERT_EQ(1, set.size);
     
     dsc_set_destroy(&set);
 }
@@ -168,7 +171,7 @@ TEST(set_add_empty_string) {
 TEST(set_add_triggers_resize) {
     dsc_set set;
     dsc_set_init(&set, 4, STR_KEY_SIZE, str_hash, str_cmp);
-    size_t initial_capacity = set.ht->capacity;
+    size_t initial_capacity = set.capacity;
     
     char keys[10][16];
     for (int i = 0; i < 10; i++) {
@@ -176,8 +179,8 @@ TEST(set_add_triggers_resize) {
         ASSERT_TRUE(dsc_set_add(&set, keys[i]));
     }
     
-    ASSERT_TRUE(set.ht->capacity > initial_capacity);
-    ASSERT_EQ(10, set.ht->size);
+    ASSERT_TRUE(set.capacity > initial_capacity);
+    ASSERT_EQ(10, set.size);
     
     // Verify all items still accessible
     for (int i = 0; i < 10; i++) {
@@ -258,11 +261,11 @@ TEST(set_remove_existing) {
     dsc_set_init(&set, 16, STR_KEY_SIZE, str_hash, str_cmp);
     
     dsc_set_add(&set, "remove_me");
-    ASSERT_EQ(1, set.ht->size);
+    ASSERT_EQ(1, set.size);
     
     dsc_set_remove(&set, "remove_me");
     ASSERT_EQ(DSC_EOK, dsc_get_error());
-    ASSERT_EQ(0, set.ht->size);
+    ASSERT_EQ(0, set.size);
     
     ASSERT_NULL(dsc_set_get(&set, "remove_me"));
     
@@ -307,7 +310,7 @@ TEST(set_remove_from_multiple) {
     ASSERT_NOT_NULL(dsc_set_get(&set, "a"));
     ASSERT_NULL(dsc_set_get(&set, "b"));
     ASSERT_NOT_NULL(dsc_set_get(&set, "c"));
-    ASSERT_EQ(2, set.ht->size);
+    ASSERT_EQ(2, set.size);
     
     dsc_set_destroy(&set);
 }
@@ -322,7 +325,7 @@ TEST(set_clear_empty) {
     
     dsc_set_clear(&set);
     ASSERT_EQ(DSC_EOK, dsc_get_error());
-    ASSERT_EQ(0, set.ht->size);
+    ASSERT_EQ(0, set.size);
     
     dsc_set_destroy(&set);
 }
@@ -336,7 +339,7 @@ TEST(set_clear_with_items) {
     dsc_set_add(&set, "item3");
     
     dsc_set_clear(&set);
-    ASSERT_EQ(0, set.ht->size);
+    ASSERT_EQ(0, set.size);
     
     ASSERT_NULL(dsc_set_get(&set, "item1"));
     ASSERT_NULL(dsc_set_get(&set, "item2"));
@@ -358,7 +361,7 @@ TEST(set_clear_then_reuse) {
     dsc_set_clear(&set);
     
     dsc_set_add(&set, "after");
-    ASSERT_EQ(1, set.ht->size);
+    ASSERT_EQ(1, set.size);
     ASSERT_NOT_NULL(dsc_set_get(&set, "after"));
     ASSERT_NULL(dsc_set_get(&set, "before"));
     
@@ -406,7 +409,7 @@ TEST(set_int_keys_basic) {
         ASSERT_TRUE(dsc_set_add(&set, &nums[i]));
     }
     
-    ASSERT_EQ(4, set.ht->size);
+    ASSERT_EQ(4, set.size);
     
     for (int i = 0; i < 4; i++) {
         int* found = (int*)dsc_set_get(&set, &nums[i]);
@@ -431,7 +434,7 @@ TEST(set_int_keys_duplicates) {
     }
     
     ASSERT_EQ(4, unique_count);
-    ASSERT_EQ(4, set.ht->size);
+    ASSERT_EQ(4, set.size);
     
     dsc_set_destroy(&set);
 }
@@ -448,7 +451,7 @@ TEST(set_int_keys_remove) {
     int remove = 3;
     dsc_set_remove(&set, &remove);
     
-    ASSERT_EQ(4, set.ht->size);
+    ASSERT_EQ(4, set.size);
     ASSERT_NULL(dsc_set_get(&set, &remove));
     
     dsc_set_destroy(&set);
@@ -469,7 +472,7 @@ TEST(set_unique_word_count) {
         dsc_set_add(&words, sentence[i]);
     }
     
-    ASSERT_EQ(8, words.ht->size);  // 8 unique words
+    ASSERT_EQ(8, words.size);  // 8 unique words
     
     dsc_set_destroy(&words);
 }
@@ -525,7 +528,7 @@ TEST(set_stress_many_adds) {
         ASSERT_TRUE(dsc_set_add(&set, &nums[i]));
     }
     
-    ASSERT_EQ(1000, set.ht->size);
+    ASSERT_EQ(1000, set.size);
     
     // Verify all can be retrieved
     for (int i = 0; i < 1000; i++) {
@@ -555,7 +558,7 @@ TEST(set_stress_add_remove_cycle) {
         }
     }
     
-    ASSERT_EQ(500, set.ht->size);  // 10 cycles * 50 remaining each
+    ASSERT_EQ(500, set.size);  // 10 cycles * 50 remaining each
     
     dsc_set_destroy(&set);
 }
@@ -580,7 +583,7 @@ TEST(set_stress_duplicates) {
     }
     
     ASSERT_EQ(10, successful_adds);  // Only first 10 succeed
-    ASSERT_EQ(10, set.ht->size);
+    ASSERT_EQ(10, set.size);
     
     dsc_set_destroy(&set);
 }
@@ -612,13 +615,13 @@ TEST(set_add_remove_add_same) {
     dsc_set_init(&set, 16, STR_KEY_SIZE, str_hash, str_cmp);
     
     ASSERT_TRUE(dsc_set_add(&set, "item"));
-    ASSERT_EQ(1, set.ht->size);
+    ASSERT_EQ(1, set.size);
     
     dsc_set_remove(&set, "item");
-    ASSERT_EQ(0, set.ht->size);
+    ASSERT_EQ(0, set.size);
     
     ASSERT_TRUE(dsc_set_add(&set, "item"));
-    ASSERT_EQ(1, set.ht->size);
+    ASSERT_EQ(1, set.size);
     
     dsc_set_destroy(&set);
 }
@@ -627,18 +630,374 @@ TEST(set_zero_then_grow) {
     dsc_set set;
     dsc_set_init(&set, 0, sizeof(int), int_hash, int_cmp);
     
-    ASSERT_EQ(1, set.ht->capacity);
+    ASSERT_EQ(1, set.capacity);
     
     for (int i = 0; i < 10; i++) {
         dsc_set_add(&set, &i);
     }
     
-    ASSERT_TRUE(set.ht->capacity > 1);
-    ASSERT_EQ(10, set.ht->size);
+    ASSERT_TRUE(set.capacity > 1);
+    ASSERT_EQ(10, set.size);
     
     dsc_set_destroy(&set);
 }
 
+TEST(set_stores_own_key_copy) {
+    dsc_set set;
+    dsc_set_init(&set, 4, STR_KEY_SIZE, str_hash, str_cmp);
+
+    char buf[16];
+    for (int i = 0; i < 20; i++) {
+        snprintf(buf, sizeof(buf), "tmp%d", i);
+        ASSERT_TRUE(dsc_set_add(&set, buf));
+    }
+    memset(buf, 0, sizeof(buf));
+
+    char* kept = (char*)dsc_set_get(&set, "tmp7");
+    ASSERT_NOT_NULL(kept);
+    ASSERT_STR_EQ("tmp7", kept);
+    ASSERT_TRUE(kept != buf);
+    ASSERT_EQ(20, set.size);
+
+    dsc_set_destroy(&set);
+    ASSERT_NULL(set.buckets);
+}
+
+/* =========================================================
+   Set Algebra Tests
+   ========================================================= */
+
+static int range_a[100];
+static int range_b[100];
+
+/* a = {0..n-1}, b = {off..off+m-1} */
+static void make_int_sets(dsc_set* a, int n, dsc_set* b, int off, int m) {
+    dsc_set_init(a, 8, sizeof(int), int_hash, int_cmp);
+    dsc_set_init(b, 8, sizeof(int), int_hash, int_cmp);
+    for (int i = 0; i < n; i++) { range_a[i] = i; dsc_set_add(a, &range_a[i]); }
+    for (int i = 0; i < m; i++) { range_b[i] = off + i; dsc_set_add(b, &range_b[i]); }
+}
+
+static bool has_int(dsc_set* set, int v) {
+    return dsc_set_get(set, &v) != NULL;
+}
+
+TEST(set_union_basic) {
+    dsc_set a, b, out;
+    make_int_sets(&a, 50, &b, 40, 20);
+
+    dsc_set_union(&out, &a, &b);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(60, out.size);
+    for (int i = 0; i < 60; i++) ASSERT_TRUE(has_int(&out, i));
+    ASSERT_FALSE(has_int(&out, 60));
+    ASSERT_EQ(50, a.size);
+
+    dsc_set_destroy(&out);
+    dsc_set_destroy(&a);
+    dsc_set_destroy(&b);
+}
+
+TEST(set_intersect_and_difference) {
+    dsc_set a, b, both, only_a, only_b;
+    make_int_sets(&a, 50, &b, 40, 20);
+
+    dsc_set_intersect(&both, &a, &b);
+    ASSERT_EQ(10, both.size);
+    for (int i = 40; i < 50; i++) ASSERT_TRUE(has_int(&both, i));
+
+    dsc_set_difference(&only_a, &a, &b);
+    ASSERT_EQ(40, only_a.size);
+    ASSERT_TRUE(has_int(&only_a, 0));
+    ASSERT_FALSE(has_int(&only_a, 45));
+
+    dsc_set_difference(&only_b, &b, &a);
+    ASSERT_EQ(10, only_b.size);
+    ASSERT_TRUE(has_int(&only_b, 59));
+
+    dsc_set_destroy(&both);
+    dsc_set_destroy(&only_a);
+    dsc_set_destroy(&only_b);
+    dsc_set_destroy(&a);
+    dsc_set_destroy(&b);
+}
+
+TEST(set_is_subset) {
+    dsc_set a, b;
+    make_int_sets(&a, 30, &b, 10, 5);
+
+    ASSERT_TRUE(dsc_set_is_subset(&b, &a));
+    ASSERT_FALSE(dsc_set_is_subset(&a, &b));
+    ASSERT_TRUE(dsc_set_is_subset(&a, &a));
+
+    int outside = 99;
+    dsc_set_add(&b, &outside);
+    ASSERT_FALSE(dsc_set_is_subset(&b, &a));
+
+    dsc_set_destroy(&a);
+    dsc_set_destroy(&b);
+}
+
+TEST(set_inplace_operations) {
+    dsc_set a, b;
+    make_int_sets(&a, 50, &b, 40, 20);
+    dsc_set_union_inplace(&a, &b);
+    ASSERT_EQ(60, a.size);
+    dsc_set_destroy(&a);
+    dsc_set_destroy(&b);
+
+    make_int_sets(&a, 50, &b, 40, 20);
+    dsc_set_intersect_inplace(&a, &b);
+    ASSERT_EQ(10, a.size);
+    ASSERT_TRUE(has_int(&a, 40));
+    ASSERT_FALSE(has_int(&a, 39));
+    dsc_set_destroy(&a);
+    dsc_set_destroy(&b);
+
+    /* Both difference strategies: smaller b, then larger b */
+    make_int_sets(&a, 50, &b, 40, 20);
+    dsc_set_difference_inplace(&a, &b);
+    ASSERT_EQ(40, a.size);
+    ASSERT_FALSE(has_int(&a, 40));
+    dsc_set_difference_inplace(&b, &a);
+    ASSERT_EQ(20, b.size);
+    dsc_set_destroy(&a);
+    dsc_set_destroy(&b);
+
+    make_int_sets(&a, 10, &b, 5, 60);
+    dsc_set_difference_inplace(&a, &b);
+    ASSERT_EQ(5, a.size);
+    ASSERT_TRUE(has_int(&a, 4));
+    ASSERT_FALSE(has_int(&a, 5));
+
+    dsc_set_difference_inplace(&a, &a);
+    ASSERT_EQ(0, a.size);
+    dsc_set_destroy(&a);
+    dsc_set_destroy(&b);
+}
+
+TEST(set_typed_inplace_operations) {
+    static const int nums[] = { 1, 2, 3, 4 };
+    int_set a, b;
+    int_set_init(&a, 8, sizeof(int), int_hash, int_cmp);
+    int_set_init(&b, 8, sizeof(int), int_hash, int_cmp);
+    for (int i = 0; i < 3; i++) int_set_add(&a, &nums[i]);      /* {1,2,3} */
+    for (int i = 1; i < 4; i++) int_set_add(&b, &nums[i]);      /* {2,3,4} */
+
+    int_set_intersect_inplace(&a, &b);
+    ASSERT_EQ(2, a.impl.size);
+    ASSERT_NULL(int_set_get(&a, &nums[0]));
+
+    int_set_difference_inplace(&b, &a);
+    ASSERT_EQ(1, b.impl.size);
+    ASSERT_TRUE(*int_set_get(&b, &nums[3]) == 4);
+
+    int_set_union_inplace(&a, &b);
+    ASSERT_EQ(3, a.impl.size);
+
+    int_set_set_shrink(&a, 25);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(25, a.impl.shrink_percent);
+
+    int_set_destroy(&a);
+    int_set_destroy(&b);
+}
+
+TEST(set_algebra_strings_mixed_hashes) {
+    dsc_set a, b, out;
+    dsc_set_init(&a, 4, 0, str_hash, str_cmp);
+    dsc_set_init(&b, 4, 0, dsc_hash_str, dsc_cmp_str);
+    dsc_set_add(&a, "read");
+    dsc_set_add(&a, "write");
+    dsc_set_add(&a, "admin");
+    dsc_set_add(&b, "write");
+    dsc_set_add(&b, "admin");
+    dsc_set_add(&b, "audit");
+
+    /* Different hash functions: keys are rehashed with the probed set's hf */
+    dsc_set_intersect(&out, &a, &b);
+    ASSERT_EQ(2, out.size);
+    ASSERT_NOT_NULL(dsc_set_get(&out, "admin"));
+    ASSERT_NULL(dsc_set_get(&out, "read"));
+    dsc_set_destroy(&out);
+
+    dsc_set_union(&out, &b, &a);
+    ASSERT_EQ(4, out.size);
+    ASSERT_NOT_NULL(dsc_set_get(&out, "read"));
+    dsc_set_destroy(&out);
+
+    dsc_set_destroy(&a);
+    dsc_set_destroy(&b);
+}
+
+TEST(set_algebra_invalid_args) {
+    dsc_set a, b, out;
+    make_int_sets(&a, 5, &b, 0, 5);
+
+    dsc_set_union(&a, &a, &b);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_EQ(5, a.size);
+
+    dsc_set_intersect(&out, NULL, &b);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_set strs;
+    dsc_set_init(&strs, 4, 0, str_hash, str_cmp);
+    ASSERT_FALSE(dsc_set_is_subset(&strs, &a));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_set_destroy(&strs);
+    dsc_set_destroy(&a);
+    dsc_set_destroy(&b);
+}
+
+TEST(set_contains_unchecked) {
+    dsc_set set;
+    dsc_set_init(&set, 8, 0, str_hash, str_cmp);
+    dsc_set_add(&set, "alpha");
+    dsc_set_add(&set, "beta");
+
+    dsc_set_add(&set, "alpha");
+    ASSERT_EQ(DSC_EEXISTS, dsc_get_error());
+
+    ASSERT_TRUE(dsc_set_contains_unchecked(&set, "beta"));
+    ASSERT_FALSE(dsc_set_contains_unchecked(&set, "gamma"));
+    ASSERT_EQ(DSC_EEXISTS, dsc_get_error());
+
+    dsc_set_destroy(&set);
+}
+
+/* =========================================================
+   Iteration Tests
+   ========================================================= */
+
+TEST(set_iter_and_remove) {
+    dsc_set set;
+    dsc_set_init(&set, 4, sizeof(int), int_hash, int_cmp);
+    for (int i = 0; i < 200; i++) dsc_set_add(&set, &i);
+
+    dsc_set_iter it;
+    dsc_set_iter_begin(&set, &it);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    size_t visited = 0;
+    long sum = 0;
+    while (dsc_set_iter_next(&it)) {
+        int v = *(const int*)it.key;
+        ASSERT_EQ(sizeof(int), it.key_size);
+        ASSERT_TRUE(it.hash == int_hash(&v, sizeof(int)));
+        sum += v;
+        visited++;
+        if (v % 3 == 0) dsc_set_iter_remove(&it);
+    }
+    ASSERT_EQ(200, visited);
+    ASSERT_EQ(199 * 200 / 2, sum);
+    ASSERT_EQ(200 - 67, set.size);
+
+    int zero = 0, one = 1;
+    ASSERT_NULL(dsc_set_get(&set, &zero));
+    ASSERT_NOT_NULL(dsc_set_get(&set, &one));
+
+    dsc_set_iter_remove(&it);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_set_destroy(&set);
+}
+
+/* ctx[0] counts reported keys, ctx[1] counts malformed reports */
+static void scan_count(const void* key, size_t key_size, void* obj, uint64_t hash, void* ctx) {
+    (void)hash;
+    int* counts = (int*)ctx;
+    counts[0]++;
+    if (obj != NULL || key_size != strlen((const char*)key) + 1) counts[1]++;
+}
+
+TEST(set_scan_strings_with_resize) {
+    dsc_set set;
+    dsc_set_init(&set, 8, 0, str_hash, str_cmp);
+
+    char buf[32];
+    for (int i = 0; i < 100; i++) {
+        snprintf(buf, sizeof(buf), "scan%d", i);
+        dsc_set_add(&set, buf);
+    }
+
+    /* Every original key is reported at least once despite the growth */
+    int counts[2] = {0, 0};
+    size_t cursor = 0;
+    int i = 100;
+    do {
+        cursor = dsc_set_scan(&set, cursor, 4, scan_count, counts);
+        for (int j = 0; j < 10; j++, i++) {
+            snprintf(buf, sizeof(buf), "scan%d", i);
+            dsc_set_add(&set, buf);
+        }
+    } while (cursor != 0);
+    ASSERT_TRUE(counts[0] >= 100);
+    ASSERT_EQ(0, counts[1]);
+
+    dsc_set_scan(&set, 0, 4, NULL, NULL);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_set_destroy(&set);
+}
+
+/* =========================================================
+   Sizing Tests
+   ========================================================= */
+
+TEST(set_reserve_and_compact) {
+    dsc_set set;
+    dsc_set_init(&set, 16, sizeof(int), int_hash, int_cmp);
+
+    ASSERT_TRUE(dsc_set_reserve(&set, 1000));
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(2048, set.capacity);
+    for (int i = 0; i < 1000; i++) dsc_set_add(&set, &i);
+    ASSERT_EQ(2048, set.capacity);
+
+    for (int i = 10; i < 1000; i++) dsc_set_remove(&set, &i);
+    ASSERT_EQ(2048, set.capacity);
+
+    ASSERT_TRUE(dsc_set_compact(&set));
+    ASSERT_EQ(16, set.capacity);
+    for (int i = 0; i < 10; i++) ASSERT_NOT_NULL(dsc_set_get(&set, &i));
+
+    ASSERT_FALSE(dsc_set_reserve(NULL, 1));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    dsc_set_destroy(&set);
+}
+
+TEST(set_shrink_watermark) {
+    dsc_set set;
+    dsc_set_init(&set, 16, sizeof(int), int_hash, int_cmp);
+    for (int i = 0; i < 1000; i++) dsc_set_add(&set, &i);
+    dsc_set_set_shrink(&set, 25);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    for (int i = 999; i >= 511; i--) dsc_set_remove(&set, &i);
+    ASSERT_EQ(511, set.size);
+    ASSERT_EQ(1024, set.capacity);
+    for (int i = 0; i < 511; i++) ASSERT_NOT_NULL(dsc_set_get(&set, &i));
+
+    /* In-place algebra shrinks once, after the pass */
+    dsc_set keep;
+    dsc_set_init(&keep, 16, sizeof(int), int_hash, int_cmp);
+    for (int i = 0; i < 20; i++) dsc_set_add(&keep, &i);
+    dsc_set_intersect_inplace(&set, &keep);
+    ASSERT_EQ(20, set.size);
+    ASSERT_EQ(64, set.capacity);
+
+    dsc_set_clear(&set);
+    ASSERT_EQ(16, set.capacity);
+
+    dsc_set_set_shrink(&set, 60);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_set_destroy(&keep);
+    dsc_set_destroy(&set);
+}
+
 /* =========================================================
    Main
    ========================================================= */
@@ -708,6 +1067,25 @@ int main(void) {
     RUN_TEST(set_collision_handling);
     RUN_TEST(set_add_remove_add_same);
     RUN_TEST(set_zero_then_grow);
+    RUN_TEST(set_stores_own_key_copy);
+    RUN_TEST(set_contains_unchecked);
+    
+    TEST_SECTION("Set Algebra");
+    RUN_TEST(set_union_basic);
+    RUN_TEST(set_intersect_and_difference);
+    RUN_TEST(set_is_subset);
+    RUN_TEST(set_inplace_operations);
+    RUN_TEST(set_typed_inplace_operations);
+    RUN_TEST(set_algebra_strings_mixed_hashes);
+    RUN_TEST(set_algebra_invalid_args);
+
+    TEST_SECTION("Iteration");
+    RUN_TEST(set_iter_and_remove);
+    RUN_TEST(set_scan_strings_with_resize);
+
+    TEST_SECTION("Sizing");
+    RUN_TEST(set_reserve_and_compact);
+    RUN_TEST(set_shrink_watermark);
     
     TEST_SUMMARY();
     return TEST_EXIT_CODE();
@@ -0,0 +1,289 @@
+/**
+ * Snapshot Tests
+ * Tests writing hash tables and sets to snapshot images and looking keys up
+ * in loaded, mapped and borrowed images.
+ */
+
+/* mmap-backed snapshot_map, even under a strict -std=c11 build */
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <string.h>
+
+#if defined(_WIN32)
+#define SNAPSHOT_TEST_FILE "dsc_snapshot_test.bin"
+#else
+#define SNAPSHOT_TEST_FILE "/tmp/dsc_snapshot_test.bin"
+#endif
+
+#define N_KEYS 20000
+
+static char keys[N_KEYS][16];
+static int  values[N_KEYS];
+
+static void build_string_table(dsc_hash_table* ht) {
+    dsc_hash_table_init(ht, 16, 0, dsc_hash_str, dsc_cmp_str);
+    for (int i = 0; i < N_KEYS; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        values[i] = i * 3;
+        dsc_hash_table_insert(ht, keys[i], &values[i]);
+    }
+}
+
+static void* write_image(dsc_hash_table* ht, size_t value_size, size_t* size) {
+    *size = dsc_hash_table_snapshot_size(ht, value_size);
+    void* image = malloc(*size);
+    if (image != NULL) dsc_hash_table_snapshot_write(ht, value_size, image, *size);
+    return image;
+}
+
+static uint64_t other_hash(const void* key, size_t len) {
+    return dsc_hash_bytes(key, len) + 1;
+}
+
+/* =========================================================
+   Image Tests
+   ========================================================= */
+
+TEST(snapshot_buffer_round_trip) {
+    dsc_hash_table ht;
+    build_string_table(&ht);
+
+    size_t size;
+    void* image = write_image(&ht, sizeof(int), &size);
+    ASSERT_NOT_NULL(image);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    dsc_hash_table_destroy(&ht, NULL);
+
+    dsc_snapshot snap;
+    dsc_snapshot_init(&snap, image, size, dsc_hash_str, dsc_cmp_str);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(N_KEYS, snap.count);
+
+    for (int i = 0; i < N_KEYS; i++) {
+        const int* v = (const int*)dsc_snapshot_get(&snap, keys[i]);
+        ASSERT_NOT_NULL(v);
+        ASSERT_EQ(i * 3, *v);
+    }
+    ASSERT_NULL(dsc_snapshot_get(&snap, "missing"));
+    ASSERT_EQ(DSC_ENOTFOUND, dsc_get_error());
+    ASSERT_FALSE(dsc_snapshot_contains(&snap, "key-1"));
+    ASSERT_TRUE(dsc_snapshot_contains(&snap, "key77"));
+
+    dsc_snapshot_destroy(&snap);
+    free(image);
+}
+
+TEST(snapshot_image_is_position_independent) {
+    dsc_hash_table ht;
+    build_string_table(&ht);
+
+    size_t size;
+    void* image = write_image(&ht, sizeof(int), &size);
+    dsc_hash_table_destroy(&ht, NULL);
+
+    void* moved = malloc(size);
+    ASSERT_NOT_NULL(moved);
+    memcpy(moved, image, size);
+    memset(image, 0xAB, size);
+    free(image);
+
+    dsc_snapshot snap;
+    dsc_snapshot_init(&snap, moved, size, dsc_hash_str, dsc_cmp_str);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(12345 * 3, *(const int*)dsc_snapshot_get(&snap, "key12345"));
+
+    dsc_snapshot_destroy(&snap);
+    free(moved);
+}
+
+TEST(snapshot_pod_keys) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 4, sizeof(uint64_t), dsc_hash_pod, dsc_cmp_pod);
+
+    double weights[100];
+    for (uint64_t i = 0; i < 100; i++) {
+        weights[i] = (double)i / 4;
+        dsc_hash_table_insert(&ht, &i, &weights[i]);
+    }
+
+    size_t size;
+    void* image = write_image(&ht, sizeof(double), &size);
+    dsc_hash_table_destroy(&ht, NULL);
+
+    dsc_snapshot snap;
+    dsc_snapshot_init(&snap, image, size, dsc_hash_pod, dsc_cmp_pod);
+    uint64_t k = 99;
+    ASSERT_TRUE(*(const double*)dsc_snapshot_get(&snap, &k) == 99.0 / 4);
+    ASSERT_EQ(0, ((uintptr_t)dsc_snapshot_get(&snap, &k)) % 16);
+
+    k = 100;
+    ASSERT_NULL(dsc_snapshot_get(&snap, &k));
+    ASSERT_EQ(DSC_ENOTFOUND, dsc_get_error());
+
+    dsc_snapshot_destroy(&snap);
+    free(image);
+}
+
+TEST(snapshot_during_incremental_rehash) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 4, 0, dsc_hash_str, dsc_cmp_str);
+    dsc_hash_table_set_incremental(&ht, true);
+    for (int i = 0; i < 1000; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        values[i] = i;
+        dsc_hash_table_insert(&ht, keys[i], &values[i]);
+    }
+
+    size_t size;
+    void* image = write_image(&ht, sizeof(int), &size);
+    dsc_hash_table_destroy(&ht, NULL);
+
+    dsc_snapshot snap;
+    dsc_snapshot_init(&snap, image, size, dsc_hash_str, dsc_cmp_str);
+    ASSERT_EQ(1000, snap.count);
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_EQ(i, *(const int*)dsc_snapshot_get(&snap, keys[i]));
+    }
+
+    dsc_snapshot_destroy(&snap);
+    free(image);
+}
+
+TEST(snapshot_empty_table) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 8, 0, dsc_hash_str, dsc_cmp_str);
+
+    size_t size;
+    void* image = write_image(&ht, 0, &size);
+    dsc_hash_table_destroy(&ht, NULL);
+
+    dsc_snapshot snap;
+    dsc_snapshot_init(&snap, image, size, dsc_hash_str, dsc_cmp_str);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(0, snap.count);
+    ASSERT_FALSE(dsc_snapshot_contains(&snap, "anything"));
+
+    dsc_snapshot_destroy(&snap);
+    free(image);
+}
+
+TEST(snapshot_rejects_bad_input) {
+    dsc_hash_table ht;
+    build_string_table(&ht);
+
+    size_t size;
+    void* image = write_image(&ht, sizeof(int), &size);
+
+    /* Too small a buffer */
+    ASSERT_EQ(0, dsc_hash_table_snapshot_write(&ht, sizeof(int), image, size - 1));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    dsc_hash_table_destroy(&ht, NULL);
+
+    dsc_snapshot snap;
+    dsc_snapshot_init(&snap, image, size, other_hash, dsc_cmp_str);
+    ASSERT_EQ(DSC_EHASHFUNC, dsc_get_error());
+    ASSERT_NULL(snap.image);
+
+    dsc_snapshot_init(&snap, image, size, NULL, dsc_cmp_str);
+    ASSERT_EQ(DSC_EHASHFUNC, dsc_get_error());
+
+    dsc_snapshot_init(&snap, image, 32, dsc_hash_str, dsc_cmp_str);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_snapshot_init(&snap, image, size - 8, dsc_hash_str, dsc_cmp_str);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    ((char*)image)[0] = 'X';
+    dsc_snapshot_init(&snap, image, size, dsc_hash_str, dsc_cmp_str);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    ASSERT_NULL(dsc_snapshot_get(&snap, "key1"));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    free(image);
+}
+
+/* =========================================================
+   File Tests
+   ========================================================= */
+
+TEST(snapshot_save_load_and_map) {
+    dsc_hash_table ht;
+    build_string_table(&ht);
+    ASSERT_TRUE(dsc_hash_table_save(&ht, SNAPSHOT_TEST_FILE, sizeof(int)));
+    dsc_hash_table_destroy(&ht, NULL);
+
+    dsc_snapshot loaded;
+    dsc_snapshot_load(&loaded, SNAPSHOT_TEST_FILE, dsc_hash_str, dsc_cmp_str);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    dsc_snapshot mapped;
+    dsc_snapshot_map(&mapped, SNAPSHOT_TEST_FILE, dsc_hash_str, dsc_cmp_str);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    for (int i = 0; i < N_KEYS; i += 7) {
+        ASSERT_EQ(i * 3, *(const int*)dsc_snapshot_get(&loaded, keys[i]));
+        ASSERT_EQ(i * 3, *(const int*)dsc_snapshot_get(&mapped, keys[i]));
+    }
+
+    dsc_snapshot_destroy(&loaded);
+    dsc_snapshot_destroy(&mapped);
+    ASSERT_NULL(mapped.image);
+    remove(SNAPSHOT_TEST_FILE);
+
+    dsc_snapshot_load(&loaded, SNAPSHOT_TEST_FILE, dsc_hash_str, dsc_cmp_str);
+    ASSERT_EQ(DSC_EIO, dsc_get_error());
+    dsc_snapshot_map(&mapped, SNAPSHOT_TEST_FILE, dsc_hash_str, dsc_cmp_str);
+    ASSERT_EQ(DSC_EIO, dsc_get_error());
+}
+
+TEST(snapshot_set_save_and_map) {
+    dsc_set set;
+    dsc_set_init(&set, 16, 0, dsc_hash_str, dsc_cmp_str);
+    dsc_set_add(&set, "apple");
+    dsc_set_add(&set, "banana");
+    dsc_set_add(&set, "cherry");
+    ASSERT_TRUE(dsc_set_save(&set, SNAPSHOT_TEST_FILE));
+    dsc_set_destroy(&set);
+
+    dsc_snapshot snap;
+    dsc_snapshot_map(&snap, SNAPSHOT_TEST_FILE, dsc_hash_str, dsc_cmp_str);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(3, snap.count);
+    ASSERT_TRUE(dsc_snapshot_contains(&snap, "banana"));
+    ASSERT_FALSE(dsc_snapshot_contains(&snap, "durian"));
+    ASSERT_STR_EQ("cherry", (const char*)dsc_snapshot_get(&snap, "cherry"));
+
+    dsc_snapshot_destroy(&snap);
+    remove(SNAPSHOT_TEST_FILE);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("Snapshot Tests");
+
+    TEST_SECTION("Images");
+    RUN_TEST(snapshot_buffer_round_trip);
+    RUN_TEST(snapshot_image_is_position_independent);
+    RUN_TEST(snapshot_pod_keys);
+    RUN_TEST(snapshot_during_incremental_rehash);
+    RUN_TEST(snapshot_empty_table);
+    RUN_TEST(snapshot_rejects_bad_input);
+
+    TEST_SECTION("Files");
+    RUN_TEST(snapshot_save_load_and_map);
+    RUN_TEST(snapshot_set_save_and_map);
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}
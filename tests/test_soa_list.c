@@ -0,0 +1,297 @@
+/**
+ * SoA List Tests
+ * Tests the columnar dsc_soa_list: scatter/gather, column passes, growth,
+ * filtering and dsc_list interop.
+ */
+
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <stdint.h>
+#include <string.h>
+
+typedef struct {
+    float  x, y;
+    int    id;
+    double mass;
+} particle;
+
+#define PARTICLE_FIELDS(X, C) X(C, float, x) X(C, float, y) X(C, int, id) X(C, double, mass)
+DSC_DEFINE_SOA_LIST(particle, particle, PARTICLE_FIELDS)
+
+static particle make_particle(int i) {
+    particle p = { (float)i, (float)(2 * i), i, i * 0.5 };
+    return p;
+}
+
+static void fill_particles(particle_soa* ps, int n) {
+    particle_soa_init(ps, 0);
+    for (int i = 0; i < n; i++) particle_soa_append(ps, make_particle(i));
+}
+
+/* Span callbacks work on one column at a time */
+static void scale_floats(void* items, size_t count, size_t item_size, void* ctx) {
+    (void)item_size;
+    float* f = (float*)items;
+    for (size_t i = 0; i < count; i++) f[i] *= *(float*)ctx;
+}
+
+static void sum_doubles(void* acc, const void* items, size_t count, size_t item_size, void* ctx) {
+    (void)item_size;
+    (void)ctx;
+    const double* d = (const double*)items;
+    for (size_t i = 0; i < count; i++) *(double*)acc += d[i];
+}
+
+static void count_spans(void* acc, const void* items, size_t count, size_t item_size, void* ctx) {
+    (void)items;
+    (void)count;
+    (void)item_size;
+    (void)ctx;
+    (*(int*)acc)++;
+}
+
+/* ctx is the threshold, so the same reducer works on any float column */
+static void count_floats_above(void* acc, const void* items, size_t count, size_t item_size, void* ctx) {
+    (void)item_size;
+    const float* f = (const float*)items;
+    float limit = *(const float*)ctx;
+    for (size_t i = 0; i < count; i++) *(size_t*)acc += f[i] > limit;
+}
+
+static void keep_even_ids(const void* items, size_t count, size_t item_size, unsigned char* keep, void* ctx) {
+    (void)item_size;
+    (void)ctx;
+    const int* ids = (const int*)items;
+    for (size_t i = 0; i < count; i++) keep[i] = (ids[i] % 2 == 0);
+}
+
+/* =========================================================
+   Basic Tests
+   ========================================================= */
+
+TEST(soa_typed_roundtrip) {
+    particle_soa ps;
+    fill_particles(&ps, 10);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(10, particle_soa_length(&ps));
+    ASSERT_EQ(4, ps.impl.ncolumns);
+
+    particle p = particle_soa_get(&ps, 7);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_TRUE(p.x == 7.0f && p.y == 14.0f && p.id == 7 && p.mass == 3.5);
+
+    /* Columns are dense arrays of one member each */
+    float* xs  = particle_soa_x(&ps);
+    int*   ids = particle_soa_id(&ps);
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(xs[i] == (float)i);
+        ASSERT_EQ(i, ids[i]);
+    }
+
+    particle q = { -1.0f, -2.0f, 99, 9.0 };
+    particle_soa_set(&ps, 3, q);
+    p = particle_soa_get(&ps, 3);
+    ASSERT_TRUE(p.x == -1.0f && p.id == 99 && p.mass == 9.0);
+    ASSERT_EQ(99, ids[3]);
+
+    particle_soa_destroy(&ps);
+    ASSERT_NULL(ps.impl.columns);
+}
+
+TEST(soa_errors) {
+    dsc_soa_list soa;
+    dsc_soa_field bad[] = { { 6, 4 } };
+    dsc_soa_list_init(&soa, 8, bad, 1, 0);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    dsc_soa_list_init(&soa, 8, NULL, 0, 0);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_soa_field ok[] = { { 0, 4 }, { 4, 4 } };
+    dsc_soa_list_init(&soa, 8, ok, 2, 0);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    unsigned char out[8];
+    ASSERT_NULL(dsc_soa_list_get(&soa, 0, out));
+    ASSERT_EQ(DSC_ERANGE, dsc_get_error());
+    dsc_soa_list_set(&soa, 0, out);
+    ASSERT_EQ(DSC_ERANGE, dsc_get_error());
+    dsc_soa_list_pop(&soa);
+    ASSERT_EQ(DSC_EEMPTY, dsc_get_error());
+    ASSERT_NULL(dsc_soa_list_column(&soa, 2));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    uint32_t rec[2] = { 1, 2 };
+    dsc_soa_list_append(&soa, rec);
+    dsc_soa_list_pop(&soa);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(0, soa.length);
+
+    dsc_soa_list_destroy(&soa);
+}
+
+TEST(soa_growth_keeps_data_and_alignment) {
+    particle_soa ps;
+    fill_particles(&ps, 5000);
+    ASSERT_TRUE(ps.impl.capacity >= 5000);
+
+    for (size_t c = 0; c < particle_soa_columns; c++) {
+        ASSERT_EQ(0, (uintptr_t)ps.impl.columns[c].data % 64);
+    }
+    double* mass = particle_soa_mass(&ps);
+    for (int i = 0; i < 5000; i++) {
+        ASSERT_TRUE(mass[i] == i * 0.5);
+        ASSERT_EQ(i, particle_soa_get(&ps, (size_t)i).id);
+    }
+
+    dsc_soa_list_reserve(&ps.impl, 20000);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(4999, particle_soa_id(&ps)[4999]);
+
+    dsc_soa_list_clear(&ps.impl);
+    ASSERT_EQ(0, particle_soa_length(&ps));
+    particle_soa_destroy(&ps);
+}
+
+/* =========================================================
+   Column Pass Tests
+   ========================================================= */
+
+TEST(soa_map_and_reduce_columns) {
+    particle_soa ps;
+    fill_particles(&ps, 3000);
+
+    float two = 2.0f;
+    dsc_soa_list_map_column(&ps.impl, particle_soa_col_y, 0, scale_floats, &two);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_TRUE(particle_soa_get(&ps, 100).y == 400.0f);
+    ASSERT_TRUE(particle_soa_get(&ps, 100).x == 100.0f);
+
+    double total = 0.0;
+    dsc_soa_list_reduce_column(&ps.impl, particle_soa_col_mass, 0, sum_doubles, &total, NULL);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_TRUE(total == 0.5 * (2999.0 * 3000.0 / 2.0));
+
+    int spans = 0;
+    dsc_soa_list_reduce_column(&ps.impl, particle_soa_col_id, 1024, count_spans, &spans, NULL);
+    ASSERT_EQ(3, spans);
+
+    /* x = i, y = 4i after the map above */
+    float limit = 2000.0f;
+    size_t above_x = 0, above_y = 0;
+    dsc_soa_list_reduce_column(&ps.impl, particle_soa_col_x, 256, count_floats_above, &above_x, &limit);
+    dsc_soa_list_reduce_column(&ps.impl, particle_soa_col_y, 256, count_floats_above, &above_y, &limit);
+    ASSERT_EQ(999, above_x);
+    ASSERT_EQ(2499, above_y);
+
+    dsc_soa_list_map_column(&ps.impl, particle_soa_columns, 0, scale_floats, &two);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    dsc_soa_list_reduce_column(&ps.impl, particle_soa_col_x, 0, count_floats_above, NULL, &limit);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    particle_soa_destroy(&ps);
+}
+
+TEST(soa_filter_by_column) {
+    particle_soa ps;
+    fill_particles(&ps, 2500);
+
+    particle_soa evens = particle_soa_filter(&ps, particle_soa_col_id, keep_even_ids, NULL);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(1250, particle_soa_length(&evens));
+    for (int i = 0; i < 1250; i++) {
+        particle p = particle_soa_get(&evens, (size_t)i);
+        ASSERT_EQ(2 * i, p.id);
+        ASSERT_TRUE(p.y == (float)(4 * i));
+    }
+    particle_soa_destroy(&evens);
+
+    /* An empty source filters to an empty list */
+    particle_soa empty;
+    particle_soa_init(&empty, 0);
+    particle_soa none = particle_soa_filter(&empty, particle_soa_col_id, keep_even_ids, NULL);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(0, particle_soa_length(&none));
+    particle_soa_destroy(&none);
+    particle_soa_destroy(&empty);
+
+    particle_soa_destroy(&ps);
+}
+
+/* =========================================================
+   Interop Tests
+   ========================================================= */
+
+TEST(soa_list_interop) {
+    particle_soa ps;
+    fill_particles(&ps, 300);
+
+    dsc_list rows = dsc_soa_list_to_list(&ps.impl);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(300, rows.length);
+    ASSERT_EQ(sizeof(particle), rows.item_size);
+    particle* p = (particle*)dsc_list_get(&rows, 42);
+    ASSERT_TRUE(p->x == 42.0f && p->id == 42 && p->mass == 21.0);
+
+    particle_soa back;
+    particle_soa_from_list(&back, &rows);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(300, particle_soa_length(&back));
+    for (int i = 0; i < 300; i++) {
+        ASSERT_EQ(i, particle_soa_id(&back)[i]);
+        ASSERT_TRUE(particle_soa_y(&back)[i] == (float)(2 * i));
+    }
+
+    dsc_list_destroy(&rows);
+    particle_soa_destroy(&back);
+    particle_soa_destroy(&ps);
+}
+
+TEST(soa_counting_allocator_balanced) {
+    counting_ctx ctx = {0};
+    dsc_allocator alloc = { counting_alloc, counting_realloc, counting_free, &ctx };
+
+    dsc_soa_field fields[] = { { 0, 4 }, { 8, 8 } };
+    dsc_soa_list soa;
+    dsc_soa_list_init_with_allocator(&soa, 16, fields, 2, 4, &alloc);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        uint64_t rec[2] = { i, i * 3 };
+        dsc_soa_list_append(&soa, rec);
+    }
+    ASSERT_TRUE(ctx.allocs > 2);
+
+    dsc_list rows = dsc_soa_list_to_list(&soa);
+    ASSERT_EQ(1000, rows.length);
+    dsc_list_destroy(&rows);
+
+    dsc_soa_list_destroy(&soa);
+    ASSERT_EQ(0, ctx.live);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("SoA List Tests");
+
+    TEST_SECTION("Basic Operations");
+    RUN_TEST(soa_typed_roundtrip);
+    RUN_TEST(soa_errors);
+    RUN_TEST(soa_growth_keeps_data_and_alignment);
+
+    TEST_SECTION("Column Passes");
+    RUN_TEST(soa_map_and_reduce_columns);
+    RUN_TEST(soa_filter_by_column);
+
+    TEST_SECTION("Interop");
+    RUN_TEST(soa_list_interop);
+    RUN_TEST(soa_counting_allocator_balanced);
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}
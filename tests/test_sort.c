@@ -0,0 +1,415 @@
+/**
+ * Sort Tests
+ * Tests dsc_list ordering: introsort, radix sort_keys, parallel merge sort,
+ * binary search, partial sort and the DSC_DEFINE_LIST_SORT typed kernels.
+ */
+
+/* POSIX threads, even under a strict -std=c11 build */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <string.h>
+
+#define BIG_N 100000
+
+static uint32_t rng_state = 12345;
+
+static uint32_t next_rand(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 8;
+}
+
+static int int_cmp(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static int int_cmp_desc(const void* a, const void* b) {
+    return int_cmp(b, a);
+}
+
+static void fill_random(dsc_list* list, size_t n, int range) {
+    dsc_list_init(list, sizeof(int), n);
+    for (size_t i = 0; i < n; i++) {
+        int v = (int)(next_rand() % (uint32_t)range) - range / 2;
+        dsc_list_append(list, &v);
+    }
+}
+
+/* Sorted, and holds the same items as a qsort of the input */
+static bool matches_qsort(const dsc_list* sorted, const int* original, size_t n) {
+    if (n == 0) return sorted->length == 0;
+    int* expect = (int*)malloc(n * sizeof(int) + 1);
+    memcpy(expect, original, n * sizeof(int));
+    qsort(expect, n, sizeof(int), int_cmp);
+    bool ok = sorted->length == n && memcmp(expect, sorted->items, n * sizeof(int)) == 0;
+    free(expect);
+    return ok;
+}
+
+typedef struct {
+    int     key;
+    int     seq;        /* Insertion order, to check stability */
+    char    pad[72];    /* Larger than the on-stack sort scratch */
+} big_item;
+
+static int big_cmp(const void* a, const void* b) {
+    return int_cmp(&((const big_item*)a)->key, &((const big_item*)b)->key);
+}
+
+/* =========================================================
+   Introsort Tests
+   ========================================================= */
+
+TEST(sort_random_and_patterns) {
+    size_t sizes[] = { 0, 1, 2, 15, 17, 100, 5000 };
+    for (size_t s = 0; s < 7; s++) {
+        dsc_list list;
+        fill_random(&list, sizes[s], 1000);
+        int* copy = (int*)malloc(sizes[s] * sizeof(int) + 1);
+        if (sizes[s] != 0) memcpy(copy, list.items, sizes[s] * sizeof(int));
+
+        dsc_list_sort(&list, int_cmp);
+        ASSERT_EQ(DSC_EOK, dsc_get_error());
+        ASSERT_TRUE(matches_qsort(&list, copy, sizes[s]));
+
+        /* Already sorted, then reversed */
+        dsc_list_sort(&list, int_cmp);
+        ASSERT_TRUE(matches_qsort(&list, copy, sizes[s]));
+        dsc_list_sort(&list, int_cmp_desc);
+        dsc_list_sort(&list, int_cmp);
+        ASSERT_TRUE(matches_qsort(&list, copy, sizes[s]));
+
+        free(copy);
+        dsc_list_destroy(&list);
+    }
+}
+
+TEST(sort_all_equal_and_few_distinct) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), BIG_N);
+    for (int i = 0; i < BIG_N; i++) {
+        int v = (i % 3 == 0) ? 7 : i % 2;
+        dsc_list_append(&list, &v);
+    }
+    dsc_list_sort(&list, int_cmp);
+    for (size_t i = 1; i < list.length; i++) {
+        ASSERT_TRUE(((int*)list.items)[i - 1] <= ((int*)list.items)[i]);
+    }
+    dsc_list_destroy(&list);
+}
+
+TEST(sort_large_items) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(big_item), 500);
+    for (int i = 0; i < 500; i++) {
+        big_item item = { (int)(next_rand() % 100), i, {0} };
+        item.pad[71] = (char)(item.key & 0x7f);
+        dsc_list_append(&list, &item);
+    }
+
+    dsc_list_sort(&list, big_cmp);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    const big_item* items = (const big_item*)list.items;
+    for (size_t i = 0; i < 500; i++) {
+        if (i > 0) ASSERT_TRUE(items[i - 1].key <= items[i].key);
+        ASSERT_EQ(items[i].key & 0x7f, items[i].pad[71]);
+    }
+    dsc_list_destroy(&list);
+}
+
+/* =========================================================
+   Radix Sort Tests
+   ========================================================= */
+
+TEST(sort_keys_signed_and_unsigned) {
+    dsc_list list;
+    fill_random(&list, BIG_N, 2000000);
+    int* copy = (int*)malloc(BIG_N * sizeof(int));
+    memcpy(copy, list.items, BIG_N * sizeof(int));
+
+    dsc_list_sort_keys(&list, DSC_SORT_I32, 0);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_TRUE(matches_qsort(&list, copy, BIG_N));
+    free(copy);
+    dsc_list_destroy(&list);
+
+    uint64_t vals[] = { UINT64_MAX, 0, 1ULL << 40, 3, 1ULL << 63, 3 };
+    dsc_list u;
+    dsc_list_init(&u, sizeof(uint64_t), 6);
+    dsc_list_append_n(&u, vals, 6);
+    dsc_list_sort_keys(&u, DSC_SORT_U64, 0);
+    const uint64_t* out = (const uint64_t*)u.items;
+    ASSERT_TRUE(out[0] == 0 && out[1] == 3 && out[2] == 3);
+    ASSERT_TRUE(out[3] == (1ULL << 40) && out[4] == (1ULL << 63) && out[5] == UINT64_MAX);
+    dsc_list_destroy(&u);
+}
+
+TEST(sort_keys_floats) {
+    double vals[200];
+    for (int i = 0; i < 200; i++) vals[i] = ((double)(int)(next_rand() % 2001) - 1000.0) / 8.0;
+    vals[0] = -0.0;
+    vals[1] = 0.0;
+    vals[2] = -1e300;
+    vals[3] = 1e300;
+
+    dsc_list list;
+    dsc_list_init(&list, sizeof(double), 200);
+    dsc_list_append_n(&list, vals, 200);
+    dsc_list_sort_keys(&list, DSC_SORT_F64, 0);
+
+    const double* d = (const double*)list.items;
+    ASSERT_TRUE(d[0] == -1e300);
+    ASSERT_TRUE(d[199] == 1e300);
+    for (size_t i = 1; i < 200; i++) ASSERT_TRUE(d[i - 1] <= d[i]);
+    dsc_list_destroy(&list);
+
+    float fv[] = { 2.5f, -0.5f, -3.0f, 0.0f, 1.0f };
+    dsc_list fl;
+    dsc_list_init(&fl, sizeof(float), 5);
+    dsc_list_append_n(&fl, fv, 5);
+    dsc_list_sort_keys(&fl, DSC_SORT_F32, 0);
+    const float* f = (const float*)fl.items;
+    ASSERT_TRUE(f[0] == -3.0f && f[1] == -0.5f && f[2] == 0.0f && f[3] == 1.0f && f[4] == 2.5f);
+    dsc_list_destroy(&fl);
+}
+
+TEST(sort_keys_struct_field_is_stable) {
+    size_t sizes[] = { 40, 3000 };   /* Insertion path and radix path */
+    for (size_t s = 0; s < 2; s++) {
+        dsc_list list;
+        dsc_list_init(&list, sizeof(big_item), sizes[s]);
+        for (int i = 0; i < (int)sizes[s]; i++) {
+            big_item item = { (int)(next_rand() % 50) - 25, i, {0} };
+            dsc_list_append(&list, &item);
+        }
+
+        dsc_list_sort_keys(&list, DSC_SORT_I32, offsetof(big_item, key));
+        const big_item* items = (const big_item*)list.items;
+        for (size_t i = 1; i < sizes[s]; i++) {
+            ASSERT_TRUE(items[i - 1].key <= items[i].key);
+            if (items[i - 1].key == items[i].key) ASSERT_TRUE(items[i - 1].seq < items[i].seq);
+        }
+        dsc_list_destroy(&list);
+    }
+}
+
+TEST(sort_keys_invalid_args) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 4);
+
+    dsc_list_sort_keys(&list, DSC_SORT_I64, 0);    /* 8-byte key in a 4-byte item */
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    dsc_list_sort_keys(&list, DSC_SORT_I32, 1);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    dsc_list_sort_keys(NULL, DSC_SORT_I32, 0);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    dsc_list_sort(&list, NULL);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_list_sort_keys(&list, DSC_SORT_I32, 0);    /* Empty list is fine */
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    dsc_list_destroy(&list);
+}
+
+/* =========================================================
+   Parallel Sort Tests
+   ========================================================= */
+
+TEST(sort_parallel_matches_sequential) {
+    dsc_thread_pool pool;
+    dsc_thread_pool_init(&pool, 4);
+
+    size_t sizes[] = { 10, 2 * DSC_POOL_MIN_CHUNK, 2 * DSC_POOL_MIN_CHUNK + 7, BIG_N };
+    for (size_t s = 0; s < 4; s++) {
+        dsc_list list;
+        fill_random(&list, sizes[s], 5000);
+        int* copy = (int*)malloc(sizes[s] * sizeof(int));
+        memcpy(copy, list.items, sizes[s] * sizeof(int));
+
+        dsc_list_sort_parallel(&list, &pool, int_cmp);
+        ASSERT_EQ(DSC_EOK, dsc_get_error());
+        ASSERT_TRUE(matches_qsort(&list, copy, sizes[s]));
+
+        free(copy);
+        dsc_list_destroy(&list);
+    }
+
+    /* No pool: sequential fallback */
+    dsc_list list;
+    fill_random(&list, 3000, 100);
+    dsc_list_sort_parallel(&list, NULL, int_cmp);
+    for (size_t i = 1; i < list.length; i++) ASSERT_TRUE(((int*)list.items)[i - 1] <= ((int*)list.items)[i]);
+    dsc_list_destroy(&list);
+
+    dsc_thread_pool_destroy(&pool);
+}
+
+/* =========================================================
+   Search and Partial Sort Tests
+   ========================================================= */
+
+TEST(lower_bound_and_binary_search) {
+    int vals[] = { 1, 3, 3, 3, 7, 9 };
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 6);
+    dsc_list_append_n(&list, vals, 6);
+
+    int k = 3;
+    ASSERT_EQ(1, dsc_list_lower_bound(&list, &k, int_cmp));
+    k = 0;
+    ASSERT_EQ(0, dsc_list_lower_bound(&list, &k, int_cmp));
+    k = 10;
+    ASSERT_EQ(6, dsc_list_lower_bound(&list, &k, int_cmp));
+    k = 8;
+    ASSERT_EQ(5, dsc_list_lower_bound(&list, &k, int_cmp));
+
+    k = 7;
+    int* found = (int*)dsc_list_binary_search(&list, &k, int_cmp);
+    ASSERT_NOT_NULL(found);
+    ASSERT_EQ(4, found - (int*)list.items);
+
+    k = 5;
+    ASSERT_NULL(dsc_list_binary_search(&list, &k, int_cmp));
+    ASSERT_EQ(DSC_ENOTFOUND, dsc_get_error());
+    k = 100;
+    ASSERT_NULL(dsc_list_binary_search(&list, &k, int_cmp));
+    ASSERT_EQ(DSC_ENOTFOUND, dsc_get_error());
+
+    ASSERT_NULL(dsc_list_binary_search(&list, NULL, int_cmp));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    dsc_list_destroy(&list);
+}
+
+TEST(partial_sort_top_k) {
+    dsc_list list;
+    fill_random(&list, 10000, 100000);
+    int* copy = (int*)malloc(10000 * sizeof(int));
+    memcpy(copy, list.items, 10000 * sizeof(int));
+    qsort(copy, 10000, sizeof(int), int_cmp);
+
+    dsc_list_partial_sort(&list, 25, int_cmp);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_TRUE(memcmp(copy, list.items, 25 * sizeof(int)) == 0);
+
+    /* The k largest, descending */
+    dsc_list_partial_sort(&list, 10, int_cmp_desc);
+    for (int i = 0; i < 10; i++) ASSERT_EQ(copy[9999 - i], ((int*)list.items)[i]);
+
+    /* k past the end sorts everything */
+    dsc_list_partial_sort(&list, 20000, int_cmp);
+    ASSERT_TRUE(memcmp(copy, list.items, 10000 * sizeof(int)) == 0);
+
+    free(copy);
+    dsc_list_destroy(&list);
+}
+
+/* =========================================================
+   Typed Kernel Tests
+   ========================================================= */
+
+DSC_DEFINE_LIST(int, int)
+DSC_DEFINE_LIST_SORT(int, DSC_LESS)
+
+typedef struct {
+    int     id;
+    double  score;
+} player;
+
+#define BY_SCORE_DESC(a, b) ((a).score > (b).score)
+
+DSC_DEFINE_LIST(player, player)
+DSC_DEFINE_LIST_SORT(player, BY_SCORE_DESC)
+
+TEST(typed_sort_and_search) {
+    int_list nums;
+    int_list_init(&nums, 16);
+    for (int i = 0; i < 5000; i++) int_list_append(&nums, (int)(next_rand() % 700));
+    int* copy = (int*)malloc(5000 * sizeof(int));
+    memcpy(copy, nums.impl.items, 5000 * sizeof(int));
+
+    int_list_sort(&nums);
+    ASSERT_TRUE(matches_qsort(&nums.impl, copy, 5000));
+
+    size_t i = int_list_lower_bound(&nums, 350);
+    ASSERT_TRUE(i == 0 || int_list_get(&nums, i - 1) < 350);
+    ASSERT_TRUE(i == 5000 || int_list_get(&nums, i) >= 350);
+    ASSERT_NULL(int_list_binary_search(&nums, 700));
+    int* hit = int_list_binary_search(&nums, int_list_get(&nums, 1234));
+    ASSERT_NOT_NULL(hit);
+    ASSERT_EQ(int_list_get(&nums, 1234), *hit);
+
+    /* Two distinct values: every partition is full of pivot ties */
+    for (size_t j = 0; j < 5000; j++) ((int*)nums.impl.items)[j] = (int)(j % 2);
+    int_list_sort(&nums);
+    ASSERT_EQ(0, int_list_get(&nums, 2499));
+    ASSERT_EQ(1, int_list_get(&nums, 2500));
+
+    free(copy);
+    int_list_destroy(&nums);
+}
+
+TEST(typed_struct_field_top_k) {
+    player_list players;
+    player_list_init(&players, 64);
+    for (int i = 0; i < 1000; i++) {
+        player p = { i, (double)((i * 37) % 1000) };
+        player_list_append(&players, p);
+    }
+
+    player_list_partial_sort(&players, 3);
+    ASSERT_TRUE(player_list_get(&players, 0).score == 999.0);
+    ASSERT_TRUE(player_list_get(&players, 1).score == 998.0);
+    ASSERT_TRUE(player_list_get(&players, 2).score == 997.0);
+
+    player_list_sort(&players);
+    for (size_t i = 1; i < 1000; i++) {
+        ASSERT_TRUE(player_list_get(&players, i - 1).score >= player_list_get(&players, i).score);
+    }
+
+    /* Radix on the field through the typed wrapper, ascending */
+    player_list_sort_keys(&players, DSC_SORT_F64, offsetof(player, score));
+    ASSERT_TRUE(player_list_get(&players, 0).score == 0.0);
+    ASSERT_TRUE(player_list_get(&players, 999).score == 999.0);
+
+    player_list_destroy(&players);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("Sort Tests");
+
+    TEST_SECTION("Introsort");
+    RUN_TEST(sort_random_and_patterns);
+    RUN_TEST(sort_all_equal_and_few_distinct);
+    RUN_TEST(sort_large_items);
+
+    TEST_SECTION("Radix Sort");
+    RUN_TEST(sort_keys_signed_and_unsigned);
+    RUN_TEST(sort_keys_floats);
+    RUN_TEST(sort_keys_struct_field_is_stable);
+    RUN_TEST(sort_keys_invalid_args);
+
+    TEST_SECTION("Parallel Sort");
+    RUN_TEST(sort_parallel_matches_sequential);
+
+    TEST_SECTION("Search and Partial Sort");
+    RUN_TEST(lower_bound_and_binary_search);
+    RUN_TEST(partial_sort_top_k);
+
+    TEST_SECTION("Typed Kernels");
+    RUN_TEST(typed_sort_and_search);
+    RUN_TEST(typed_struct_field_top_k);
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}
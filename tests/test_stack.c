@@ -50,7 +50,7 @@ TEST(test_stack_init_zero_capacity) {
     
     ASSERT_EQ(DSC_EOK, dsc_get_error());
     ASSERT_EQ(0, stack.list.length);
-    ASSERT_EQ(256, stack.list.capacity);  /* Default capacity */
+    ASSERT_EQ(0, stack.list.capacity);  /* Allocated on first push */
     
     dsc_stack_destroy(&stack);
 }
@@ -423,6 +423,32 @@ TEST(test_stack_clear_reuse) {
     dsc_stack_destroy(&stack);
 }
 
+TEST(test_stack_shrink_after_burst) {
+    dsc_stack stack;
+    dsc_stack_init(&stack, sizeof(int), 4);
+    for (int i = 0; i < 1000; i++) dsc_stack_push(&stack, &i);
+
+    /* clear keeps the buffer by default; shrink_to_fit gives it back */
+    dsc_stack_clear(&stack);
+    ASSERT_TRUE(stack.list.capacity >= 1000);
+    dsc_stack_shrink_to_fit(&stack);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(1, stack.list.capacity);
+
+    /* Or let pops release it through the list's growth policy */
+    static const dsc_list_growth policy = { 100, 4, 0, 25 };
+    dsc_list_set_growth(&stack.list, &policy);
+    for (int i = 0; i < 1000; i++) dsc_stack_push(&stack, &i);
+    int val = 0;
+    while (dsc_stack_size(&stack) > 10) dsc_stack_pop(&stack, &val);
+    ASSERT_TRUE(stack.list.capacity <= 40);
+    ASSERT_EQ(9, *(int*)dsc_stack_peek(&stack));
+
+    dsc_stack_shrink_to_fit(NULL);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    dsc_stack_destroy(&stack);
+}
+
 TEST(test_stack_destroy_basic) {
     dsc_stack stack;
     dsc_stack_init(&stack, sizeof(int), 4);
@@ -767,6 +793,35 @@ TEST(test_stack_edge_multiple_stacks) {
     int_stack_destroy(&stack3);
 }
 
+TEST(test_stack_unchecked_tier) {
+    int_stack stack;
+    int_stack_init(&stack, 1);
+
+    dsc_stack_peek(&stack.impl);
+    ASSERT_EQ(DSC_EEMPTY, dsc_get_error());
+
+    ASSERT_NULL(int_stack_peek_unchecked(&stack));
+    int out = -1;
+    ASSERT_EQ(DSC_EEMPTY, int_stack_pop_unchecked(&stack, &out));
+    ASSERT_EQ(-1, out);
+
+    for (int i = 0; i < 50; i++) ASSERT_EQ(DSC_EOK, int_stack_push_unchecked(&stack, i));
+    ASSERT_EQ(49, *int_stack_peek_unchecked(&stack));
+    ASSERT_EQ(DSC_EOK, int_stack_pop_unchecked(&stack, &out));
+    ASSERT_EQ(49, out);
+    ASSERT_EQ(DSC_EOK, dsc_stack_pop_unchecked(&stack.impl, NULL));
+    ASSERT_EQ(48, int_stack_size(&stack));
+
+    /* Only a checked call changes the error slot */
+    dsc_stack_pop(NULL, &out);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_EQ(47, *int_stack_peek_unchecked(&stack));
+    ASSERT_EQ(DSC_EOK, int_stack_pop_unchecked(&stack, &out));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    int_stack_destroy(&stack);
+}
+
 /* ================================================================
  * Main Test Runner
  * ================================================================ */
@@ -814,6 +869,7 @@ int main(void) {
     RUN_TEST(test_stack_clear_empty);
     RUN_TEST(test_stack_clear_null_stack);
     RUN_TEST(test_stack_clear_reuse);
+    RUN_TEST(test_stack_shrink_after_burst);
     RUN_TEST(test_stack_destroy_basic);
     RUN_TEST(test_stack_destroy_empty);
     RUN_TEST(test_stack_destroy_null_stack);
@@ -840,6 +896,9 @@ int main(void) {
     RUN_TEST(test_stack_edge_push_pop_cycle);
     RUN_TEST(test_stack_edge_peek_after_pop);
     RUN_TEST(test_stack_edge_multiple_stacks);
+
+    TEST_SECTION("Unchecked Tier");
+    RUN_TEST(test_stack_unchecked_tier);
     
     TEST_SUMMARY();
     return TEST_EXIT_CODE();
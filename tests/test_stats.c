@@ -0,0 +1,178 @@
+/**
+ * Statistics Tests
+ * Tests hash_table_stats, list_stats and stack_stats in a DSC_STATS build.
+ */
+
+#ifndef DSC_STATS
+#define DSC_STATS
+#endif
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <string.h>
+
+/* Every key collides: the whole table is one chain */
+static uint64_t constant_hash(const void* key, size_t len) {
+    (void)key;
+    (void)len;
+    return 42;
+}
+
+static int values[1000];
+
+static void fill_table(dsc_hash_table* ht, dsc_hashfunc* hf, int n) {
+    dsc_hash_table_init(ht, 16, sizeof(int), hf, dsc_cmp_pod);
+    for (int i = 0; i < n; i++) {
+        values[i] = i;
+        dsc_hash_table_insert(ht, &i, &values[i]);
+    }
+}
+
+/* =========================================================
+   Hash Table Tests
+   ========================================================= */
+
+TEST(table_stats_distribution) {
+    dsc_hash_table ht;
+    fill_table(&ht, dsc_hash_pod, 1000);
+
+    dsc_table_stats st = dsc_hash_table_stats(&ht);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(1000, st.size);
+    ASSERT_EQ(ht.capacity, st.capacity);
+    ASSERT_TRUE(st.load_factor > 0.0 && st.load_factor <= 0.75);
+    ASSERT_TRUE(st.max_probe >= 1 && st.max_probe < 16);
+    ASSERT_TRUE(st.mean_probe >= 1.0 && st.mean_probe < 2.0);
+
+    /* The histogram covers every bucket and every entry */
+    size_t buckets = 0, entries = 0;
+    for (size_t i = 0; i < DSC_STATS_HISTOGRAM; i++) {
+        buckets += st.histogram[i];
+        if (i < DSC_STATS_HISTOGRAM - 1) entries += i * st.histogram[i];
+    }
+    ASSERT_EQ(ht.capacity, buckets);
+    ASSERT_TRUE(entries <= 1000);
+
+    ASSERT_EQ(1000 * sizeof(dsc_kvpair), st.node_bytes);
+    ASSERT_EQ(1000 * sizeof(int), st.key_bytes);
+    ASSERT_EQ(ht.capacity * sizeof(dsc_kvpair*), st.bucket_bytes);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(table_stats_flags_bad_hash) {
+    dsc_hash_table ht;
+    fill_table(&ht, constant_hash, 100);
+
+    dsc_table_stats st = dsc_hash_table_stats(&ht);
+    ASSERT_EQ(100, st.max_probe);
+    ASSERT_TRUE(st.mean_probe == 50.5);
+    ASSERT_EQ(1, st.histogram[DSC_STATS_HISTOGRAM - 1]);
+    ASSERT_EQ(ht.capacity - 1, st.histogram[0]);
+
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+TEST(table_stats_counters) {
+    dsc_hash_table ht;
+    fill_table(&ht, dsc_hash_pod, 1000);
+
+    /* 16 buckets double to 2048 to keep 1000 entries under 0.75 */
+    dsc_table_stats st = dsc_hash_table_stats(&ht);
+    ASSERT_EQ(7, st.resizes);
+    ASSERT_EQ(1000 + 1 + 7, st.alloc.allocs);
+    ASSERT_EQ(7, st.alloc.frees);
+    ASSERT_EQ(st.node_bytes + st.key_bytes + st.bucket_bytes, st.alloc.bytes);
+    ASSERT_TRUE(st.alloc.peak_bytes >= st.alloc.bytes);
+
+    for (int i = 0; i < 500; i++) dsc_hash_table_delete(&ht, &i);
+    st = dsc_hash_table_stats(&ht);
+    ASSERT_EQ(7 + 500, st.alloc.frees);
+    ASSERT_EQ(st.node_bytes + st.key_bytes + st.bucket_bytes, st.alloc.bytes);
+
+    dsc_hash_table_destroy(&ht, NULL);
+    st = dsc_hash_table_stats(&ht);
+    ASSERT_EQ(0, st.alloc.bytes);
+    ASSERT_EQ(st.alloc.allocs, st.alloc.frees);
+}
+
+TEST(table_stats_incremental_rehash) {
+    dsc_hash_table ht;
+    dsc_hash_table_init(&ht, 16, sizeof(int), dsc_hash_pod, dsc_cmp_pod);
+    dsc_hash_table_set_incremental(&ht, true);
+    for (int i = 0; i < 1000; i++) {
+        values[i] = i;
+        dsc_hash_table_insert(&ht, &i, &values[i]);
+    }
+
+    /* Entries in both arrays are counted while buckets migrate */
+    dsc_table_stats st = dsc_hash_table_stats(&ht);
+    ASSERT_EQ(1000, st.size);
+    ASSERT_EQ(1000 * sizeof(int), st.key_bytes);
+    ASSERT_EQ(st.node_bytes + st.key_bytes + st.bucket_bytes, st.alloc.bytes);
+
+    while (dsc_hash_table_rehash_step(&ht, 64)) {}
+    st = dsc_hash_table_stats(&ht);
+    ASSERT_EQ(ht.capacity * sizeof(dsc_kvpair*), st.bucket_bytes);
+
+    dsc_hash_table_stats(NULL);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    dsc_hash_table_destroy(&ht, NULL);
+}
+
+/* =========================================================
+   List and Stack Tests
+   ========================================================= */
+
+TEST(list_and_stack_stats) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 0);
+    for (int i = 0; i < 100; i++) dsc_list_append(&list, &i);
+
+    /* Default growth: 8, 16, 32, 64, 128 */
+    dsc_alloc_stats st = dsc_list_stats(&list);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(5, st.allocs);
+    ASSERT_EQ(0, st.frees);
+    ASSERT_EQ(128 * sizeof(int), st.bytes);
+
+    dsc_list_shrink_to_fit(&list);
+    st = dsc_list_stats(&list);
+    ASSERT_EQ(100 * sizeof(int), st.bytes);
+    ASSERT_EQ(128 * sizeof(int), st.peak_bytes);
+
+    dsc_list_destroy(&list);
+    st = dsc_list_stats(&list);
+    ASSERT_EQ(1, st.frees);
+    ASSERT_EQ(0, st.bytes);
+
+    dsc_stack stack;
+    dsc_stack_init(&stack, sizeof(int), 4);
+    for (int i = 0; i < 10; i++) dsc_stack_push(&stack, &i);
+    st = dsc_stack_stats(&stack);
+    ASSERT_EQ(3, st.allocs);  /* 4, 8, 16 */
+    ASSERT_EQ(stack.list.capacity * sizeof(int), st.bytes);
+    dsc_stack_destroy(&stack);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("Statistics Tests");
+
+    TEST_SECTION("Hash Table");
+    RUN_TEST(table_stats_distribution);
+    RUN_TEST(table_stats_flags_bad_hash);
+    RUN_TEST(table_stats_counters);
+    RUN_TEST(table_stats_incremental_rehash);
+
+    TEST_SECTION("List and Stack");
+    RUN_TEST(list_and_stack_stats);
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}
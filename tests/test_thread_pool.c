@@ -0,0 +1,229 @@
+/**
+ * Thread Pool Tests
+ * Tests dsc_thread_pool and the parallel list map/foreach/filter variants.
+ */
+
+/* POSIX threads, even under a strict -std=c11 build */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <string.h>
+
+#define BIG_N 200000
+
+static void mark_range(void* ctx, size_t begin, size_t end) {
+    unsigned char* hits = (unsigned char*)ctx;
+    for (size_t i = begin; i < end; i++) hits[i]++;
+}
+
+static void double_item(void* item, void* ctx) {
+    (void)ctx;
+    *(int*)item *= 2;
+}
+
+static void record_visit(void* item, void* ctx) {
+    ((unsigned char*)ctx)[*(int*)item]++;
+}
+
+static int divisible_by(void* item, void* ctx) {
+    return *(int*)item % *(int*)ctx == 0;
+}
+
+static int is_multiple_of_3(void* item) {
+    return *(int*)item % 3 == 0;
+}
+
+static void fill_list(dsc_list* list, int n) {
+    dsc_list_init(list, sizeof(int), (size_t)n);
+    for (int i = 0; i < n; i++) dsc_list_append(list, &i);
+}
+
+/* =========================================================
+   Thread Pool Tests
+   ========================================================= */
+
+TEST(pool_init_destroy) {
+    dsc_thread_pool pool;
+    dsc_thread_pool_init(&pool, 3);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_TRUE(pool.thread_count <= 3);
+
+    dsc_thread_pool_destroy(&pool);
+    ASSERT_NULL(pool.state);
+    ASSERT_EQ(0, pool.thread_count);
+}
+
+TEST(pool_parallel_for_covers_every_index_once) {
+    dsc_thread_pool pool;
+    dsc_thread_pool_init(&pool, 4);
+
+    unsigned char* hits = (unsigned char*)calloc(BIG_N, 1);
+    ASSERT_NOT_NULL(hits);
+
+    /* Reuse the pool for several jobs with different chunk sizes */
+    size_t chunks[] = { 0, 1, 7, 4096 };
+    for (size_t c = 0; c < 4; c++) {
+        memset(hits, 0, BIG_N);
+        dsc_thread_pool_parallel_for(&pool, BIG_N, chunks[c], mark_range, hits);
+        for (size_t i = 0; i < BIG_N; i++) {
+            ASSERT_EQ(1, hits[i]);
+        }
+    }
+
+    free(hits);
+    dsc_thread_pool_destroy(&pool);
+}
+
+TEST(pool_null_runs_inline) {
+    unsigned char hits[100] = {0};
+    dsc_thread_pool_parallel_for(NULL, 100, 0, mark_range, hits);
+    for (int i = 0; i < 100; i++) ASSERT_EQ(1, hits[i]);
+
+    dsc_thread_pool_parallel_for(NULL, 100, 0, NULL, hits);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+}
+
+TEST(pool_default_thread_count) {
+    dsc_thread_pool pool;
+    dsc_thread_pool_init(&pool, 0);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    unsigned char hits[5000] = {0};
+    dsc_thread_pool_parallel_for(&pool, 5000, 16, mark_range, hits);
+    for (int i = 0; i < 5000; i++) ASSERT_EQ(1, hits[i]);
+
+    dsc_thread_pool_destroy(&pool);
+}
+
+/* =========================================================
+   Parallel List Tests
+   ========================================================= */
+
+TEST(list_map_parallel) {
+    dsc_thread_pool pool;
+    dsc_thread_pool_init(&pool, 4);
+
+    dsc_list list;
+    fill_list(&list, BIG_N);
+    dsc_list_map_parallel(&list, &pool, double_item, NULL);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    for (int i = 0; i < BIG_N; i++) {
+        ASSERT_EQ(i * 2, *(int*)dsc_list_get(&list, (size_t)i));
+    }
+
+    dsc_list_destroy(&list);
+    dsc_thread_pool_destroy(&pool);
+}
+
+TEST(list_foreach_parallel_visits_all) {
+    dsc_thread_pool pool;
+    dsc_thread_pool_init(&pool, 4);
+
+    dsc_list list;
+    fill_list(&list, BIG_N);
+    unsigned char* seen = (unsigned char*)calloc(BIG_N, 1);
+    ASSERT_NOT_NULL(seen);
+
+    dsc_list_foreach_parallel(&list, &pool, record_visit, seen);
+    for (int i = 0; i < BIG_N; i++) ASSERT_EQ(1, seen[i]);
+
+    free(seen);
+    dsc_list_destroy(&list);
+    dsc_thread_pool_destroy(&pool);
+}
+
+TEST(list_filter_parallel_preserves_order) {
+    dsc_thread_pool pool;
+    dsc_thread_pool_init(&pool, 4);
+
+    dsc_list list;
+    fill_list(&list, BIG_N);
+
+    int three = 3;
+    dsc_list par = dsc_list_filter_parallel(&list, &pool, divisible_by, &three);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    dsc_list seq = dsc_list_filter(&list, is_multiple_of_3);
+
+    ASSERT_EQ(seq.length, par.length);
+    ASSERT_TRUE(memcmp(seq.items, par.items, seq.length * sizeof(int)) == 0);
+
+    dsc_list_destroy(&seq);
+    dsc_list_destroy(&par);
+    dsc_list_destroy(&list);
+    dsc_thread_pool_destroy(&pool);
+}
+
+TEST(list_filter_parallel_edge_cases) {
+    dsc_list list;
+    dsc_list_init(&list, sizeof(int), 4);
+
+    int two = 2;
+    dsc_list empty = dsc_list_filter_parallel(&list, NULL, divisible_by, &two);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(0, empty.length);
+    dsc_list_destroy(&empty);
+
+    int none = 1000003;
+    for (int i = 1; i < 100; i++) dsc_list_append(&list, &i);
+    dsc_list out = dsc_list_filter_parallel(&list, NULL, divisible_by, &none);
+    ASSERT_EQ(0, out.length);
+    dsc_list_destroy(&out);
+
+    dsc_list bad = dsc_list_filter_parallel(&list, NULL, NULL, NULL);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_NULL(bad.items);
+
+    dsc_list_destroy(&list);
+}
+
+DSC_DEFINE_LIST(int, int)
+
+TEST(typed_list_parallel) {
+    dsc_thread_pool pool;
+    dsc_thread_pool_init(&pool, 2);
+
+    int_list nums;
+    int_list_init(&nums, 16);
+    for (int i = 0; i < 10000; i++) int_list_append(&nums, i);
+
+    int_list_map_parallel(&nums, &pool, double_item, NULL);
+    int four = 4;
+    int_list evens = int_list_filter_parallel(&nums, &pool, divisible_by, &four);
+    ASSERT_EQ(5000, evens.impl.length);
+    ASSERT_EQ(4, int_list_get(&evens, 1));
+    ASSERT_EQ(19996, int_list_get(&evens, 4999));
+
+    int_list_destroy(&evens);
+    int_list_destroy(&nums);
+    dsc_thread_pool_destroy(&pool);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("Thread Pool Tests");
+
+    TEST_SECTION("Thread Pool");
+    RUN_TEST(pool_init_destroy);
+    RUN_TEST(pool_parallel_for_covers_every_index_once);
+    RUN_TEST(pool_null_runs_inline);
+    RUN_TEST(pool_default_thread_count);
+
+    TEST_SECTION("Parallel List");
+    RUN_TEST(list_map_parallel);
+    RUN_TEST(list_foreach_parallel_visits_all);
+    RUN_TEST(list_filter_parallel_preserves_order);
+    RUN_TEST(list_filter_parallel_edge_cases);
+    RUN_TEST(typed_list_parallel);
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}
@@ -133,15 +133,37 @@ TEST(test_set_from_array_duplicates) {
     dsc_set_from_array(&set, arr, 5, sizeof(int), int_hash, int_cmp);
     
     // Set should only contain unique values: 1, 2, 3
-    ASSERT_EQ(set.ht->size, 3);
+    ASSERT_EQ(set.size, 3);
     
     dsc_set_destroy(&set);
 }
 
 TEST(test_set_from_array_strings) {
-    // Skip test for now - strings with sets need special handling
-    // This test is for fixed-size int keys, strings work differently
-    printf("[SKIP] test_set_from_array_strings - string handling needs review\n");
+    /* key_size 0: the array holds pointers to the strings */
+    const char* arr[] = {"apple", "pear", "apple", "plum"};
+    dsc_set set;
+
+    dsc_set_from_array(&set, arr, 4, 0, str_hash, str_cmp);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(set.size, 3);
+    ASSERT_TRUE(dsc_set_get(&set, "pear") != NULL);
+    ASSERT_TRUE(dsc_set_get(&set, "kiwi") == NULL);
+
+    dsc_set_destroy(&set);
+}
+
+TEST(test_set_from_array_spans_blocks) {
+    /* Keys are resolved in blocks of 16; duplicates straddle block edges */
+    int arr[100];
+    for (int i = 0; i < 100; i++) arr[i] = i % 37;
+    dsc_set set;
+
+    dsc_set_from_array(&set, arr, 100, sizeof(int), int_hash, int_cmp);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(set.size, 37);
+    for (int i = 0; i < 37; i++) ASSERT_TRUE(dsc_set_get(&set, &i) != NULL);
+
+    dsc_set_destroy(&set);
 }
 
 TEST(test_set_from_array_null_set) {
@@ -168,7 +190,7 @@ TEST(test_list_to_set_basic) {
     
     dsc_set set = dsc_list_to_set(&list, int_hash, int_cmp);
     
-    ASSERT_EQ(set.ht->size, 4);
+    ASSERT_EQ(set.size, 4);
     int key20 = 20;
     ASSERT_TRUE(dsc_set_get(&set, &key20) != NULL);
     
@@ -188,7 +210,7 @@ TEST(test_list_to_set_with_duplicates) {
     dsc_set set = dsc_list_to_set(&list, int_hash, int_cmp);
     
     // Set should only have 3 unique values
-    ASSERT_EQ(set.ht->size, 3);
+    ASSERT_EQ(set.size, 3);
     
     dsc_list_destroy(&list);
     dsc_set_destroy(&set);
@@ -200,7 +222,7 @@ TEST(test_list_to_set_empty) {
     
     dsc_set set = dsc_list_to_set(&list, int_hash, int_cmp);
     
-    ASSERT_EQ(set.ht->size, 0);
+    ASSERT_EQ(set.size, 0);
     
     dsc_list_destroy(&list);
     dsc_set_destroy(&set);
@@ -210,7 +232,7 @@ TEST(test_list_to_set_null_list) {
     dsc_set set = dsc_list_to_set(NULL, int_hash, int_cmp);
     
     ASSERT_EQ(dsc_get_error(), DSC_EINVAL);
-    ASSERT_TRUE(set.ht == NULL);
+    ASSERT_NULL(set.buckets);
     dsc_clear_error();
 }
 
@@ -259,6 +281,28 @@ TEST(test_set_to_list_empty) {
     dsc_list_destroy(&list);
 }
 
+TEST(test_set_to_list_strings) {
+    dsc_set set;
+    dsc_set_init(&set, 16, 0, str_hash, str_cmp);
+    dsc_set_add(&set, "a");
+    dsc_set_add(&set, "longer string key");
+
+    /* Variable-length keys come back as pointers to the stored strings */
+    dsc_list list = dsc_set_to_list(&set);
+    ASSERT_EQ(2, list.length);
+    ASSERT_EQ(sizeof(char*), list.item_size);
+    int seen = 0;
+    for (size_t i = 0; i < list.length; i++) {
+        const char* key = *(const char**)dsc_list_get(&list, i);
+        ASSERT_NOT_NULL(dsc_set_get(&set, key));
+        seen += (strcmp(key, "longer string key") == 0);
+    }
+    ASSERT_EQ(1, seen);
+
+    dsc_list_destroy(&list);
+    dsc_set_destroy(&set);
+}
+
 TEST(test_set_to_list_null_set) {
     dsc_list list = dsc_set_to_list(NULL);
     
@@ -506,6 +550,7 @@ int main(void) {
     RUN_TEST(test_set_from_array_basic);
     RUN_TEST(test_set_from_array_duplicates);
     RUN_TEST(test_set_from_array_strings);
+    RUN_TEST(test_set_from_array_spans_blocks);
     RUN_TEST(test_set_from_array_null_set);
     
     TEST_SECTION("List to Set Conversion");
@@ -517,6 +562,7 @@ int main(void) {
     TEST_SECTION("Set to List Conversion");
     RUN_TEST(test_set_to_list_basic);
     RUN_TEST(test_set_to_list_empty);
+    RUN_TEST(test_set_to_list_strings);
     RUN_TEST(test_set_to_list_null_set);
     
     TEST_SECTION("List Has Duplicates");
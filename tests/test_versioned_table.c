@@ -0,0 +1,454 @@
+/**
+ * Versioned Hash Table Tests
+ * Tests copy-on-write versions, batches, reclamation and lock-free readers.
+ */
+
+#define TEST_THREADS
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <string.h>
+
+static int values[2000];
+
+static size_t reclaim_calls = 0;
+static void count_reclaim(void* obj) {
+    (void)obj;
+    reclaim_calls++;
+}
+
+/* Commit keys [from, to) with values[key] as their objects */
+static void put_range(dsc_versioned_table* vt, int from, int to) {
+    dsc_vt_batch batch;
+    dsc_versioned_table_begin(vt, &batch);
+    for (int i = from; i < to; i++) {
+        values[i] = i;
+        dsc_versioned_table_put(&batch, &i, &values[i]);
+    }
+    dsc_versioned_table_commit(&batch);
+}
+
+/* Number of chunk pointers two versions do not share */
+static size_t chunks_differing(const dsc_vt_version* a, const dsc_vt_version* b) {
+    size_t n = 0;
+    for (size_t i = 0; i < a->table->chunk_count; i++) n += a->chunks[i] != b->chunks[i];
+    return n;
+}
+
+/* =========================================================
+   Single-Threaded Semantics
+   ========================================================= */
+
+TEST(vt_init_and_errors) {
+    dsc_versioned_table vt;
+    dsc_versioned_table_init(&vt, 0, sizeof(int), NULL, dsc_cmp_pod, NULL);
+    ASSERT_EQ(DSC_EHASHFUNC, dsc_get_error());
+    dsc_versioned_table_init(&vt, 0, sizeof(int), dsc_hash_pod, NULL, NULL);
+    ASSERT_EQ(DSC_ECMPFUNC, dsc_get_error());
+    ASSERT_NULL(dsc_versioned_table_acquire(&vt));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_versioned_table_init(&vt, 100, sizeof(int), dsc_hash_pod, dsc_cmp_pod, NULL);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(128, vt.chunk_count);
+
+    dsc_vt_version* v = dsc_versioned_table_acquire(&vt);
+    ASSERT_NOT_NULL(v);
+    ASSERT_EQ(0, dsc_versioned_table_size(v));
+    ASSERT_EQ(0, v->number);
+    int key = 1;
+    ASSERT_NULL(dsc_versioned_table_get(v, &key));
+    ASSERT_EQ(DSC_ENOTFOUND, dsc_get_error());
+    dsc_versioned_table_release(v);
+
+    dsc_vt_batch batch;
+    ASSERT_FALSE(dsc_versioned_table_begin(NULL, &batch));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_TRUE(dsc_versioned_table_begin(&vt, &batch));
+    ASSERT_FALSE(dsc_versioned_table_put(&batch, &key, NULL));
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_FALSE(dsc_versioned_table_delete(&batch, &key));
+    ASSERT_EQ(DSC_ENOTFOUND, dsc_get_error());
+    dsc_versioned_table_abort(&batch);
+    ASSERT_FALSE(dsc_versioned_table_commit(&batch));   /* Already ended */
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+
+    dsc_versioned_table_destroy(&vt);
+}
+
+TEST(vt_batch_commit_and_read_own_writes) {
+    dsc_versioned_table vt;
+    dsc_versioned_table_init(&vt, 64, sizeof(int), dsc_hash_pod, dsc_cmp_pod, NULL);
+
+    dsc_vt_batch batch;
+    ASSERT_TRUE(dsc_versioned_table_begin(&vt, &batch));
+    for (int i = 0; i < 1000; i++) {
+        values[i] = i;
+        ASSERT_TRUE(dsc_versioned_table_put(&batch, &i, &values[i]));
+    }
+    /* The draft sees the batch, readers do not until commit */
+    int key = 500;
+    ASSERT_EQ(500, *(int*)dsc_versioned_table_get(batch.draft, &key));
+    dsc_vt_version* before = dsc_versioned_table_acquire(&vt);
+    ASSERT_EQ(0, dsc_versioned_table_size(before));
+
+    ASSERT_TRUE(dsc_versioned_table_commit(&batch));
+    ASSERT_NULL(batch.draft);
+
+    dsc_vt_version* v = dsc_versioned_table_acquire(&vt);
+    ASSERT_EQ(1000, dsc_versioned_table_size(v));
+    ASSERT_EQ(1, v->number);
+    for (int i = 0; i < 1000; i++) ASSERT_EQ(i, *(int*)dsc_versioned_table_get(v, &i));
+    ASSERT_NULL(dsc_versioned_table_get(before, &key));
+
+    dsc_versioned_table_release(before);
+    dsc_versioned_table_release(v);
+    dsc_versioned_table_destroy(&vt);
+}
+
+TEST(vt_old_versions_are_frozen) {
+    dsc_versioned_table vt;
+    dsc_versioned_table_init(&vt, 64, sizeof(int), dsc_hash_pod, dsc_cmp_pod, NULL);
+    put_range(&vt, 0, 1000);
+    dsc_vt_version* v1 = dsc_versioned_table_acquire(&vt);
+
+    static int replaced = -5;
+    dsc_vt_batch batch;
+    dsc_versioned_table_begin(&vt, &batch);
+    int k5 = 5, k6 = 6, k_new = 1500;
+    values[k_new] = k_new;
+    ASSERT_TRUE(dsc_versioned_table_put(&batch, &k5, &replaced));
+    ASSERT_TRUE(dsc_versioned_table_delete(&batch, &k6));
+    ASSERT_TRUE(dsc_versioned_table_put(&batch, &k_new, &values[k_new]));
+    ASSERT_TRUE(dsc_versioned_table_commit(&batch));
+    dsc_vt_version* v2 = dsc_versioned_table_acquire(&vt);
+
+    ASSERT_EQ(5, *(int*)dsc_versioned_table_get(v1, &k5));
+    ASSERT_EQ(6, *(int*)dsc_versioned_table_get(v1, &k6));
+    ASSERT_NULL(dsc_versioned_table_get(v1, &k_new));
+    ASSERT_EQ(1000, dsc_versioned_table_size(v1));
+
+    ASSERT_EQ(-5, *(int*)dsc_versioned_table_get(v2, &k5));
+    ASSERT_NULL(dsc_versioned_table_get(v2, &k6));
+    ASSERT_EQ(1500, *(int*)dsc_versioned_table_get(v2, &k_new));
+    ASSERT_EQ(1000, dsc_versioned_table_size(v2));
+    for (int i = 7; i < 1000; i++) ASSERT_EQ(i, *(int*)dsc_versioned_table_get(v2, &i));
+
+    /* Only the touched chunks were copied */
+    ASSERT_TRUE(chunks_differing(v1, v2) <= 3);
+
+    dsc_versioned_table_release(v1);
+    dsc_versioned_table_release(v2);
+    dsc_versioned_table_destroy(&vt);
+}
+
+TEST(vt_delete_keeps_probe_runs) {
+    /* One chunk, so every key shares its probe sequence */
+    dsc_versioned_table vt;
+    dsc_versioned_table_init(&vt, 1, sizeof(int), dsc_hash_pod, dsc_cmp_pod, NULL);
+    put_range(&vt, 0, 1000);
+
+    dsc_vt_batch batch;
+    dsc_versioned_table_begin(&vt, &batch);
+    for (int i = 0; i < 1000; i += 3) ASSERT_TRUE(dsc_versioned_table_delete(&batch, &i));
+    dsc_versioned_table_commit(&batch);
+
+    dsc_vt_version* v = dsc_versioned_table_acquire(&vt);
+    ASSERT_EQ(666, dsc_versioned_table_size(v));
+    for (int i = 0; i < 1000; i++) {
+        void* obj = dsc_versioned_table_get(v, &i);
+        if (i % 3 == 0) ASSERT_NULL(obj);
+        else ASSERT_EQ(i, *(int*)obj);
+    }
+    dsc_versioned_table_release(v);
+    dsc_versioned_table_destroy(&vt);
+}
+
+TEST(vt_reclaim_on_last_release) {
+    static int a = 1, b = 2, c = 3;
+    dsc_versioned_table vt;
+    dsc_versioned_table_init(&vt, 16, sizeof(int), dsc_hash_pod, dsc_cmp_pod, count_reclaim);
+    reclaim_calls = 0;
+
+    int key = 1;
+    dsc_vt_batch batch;
+    dsc_versioned_table_begin(&vt, &batch);
+    dsc_versioned_table_put(&batch, &key, &a);
+    dsc_versioned_table_put(&batch, &key, &a);   /* Same object: no-op */
+    dsc_versioned_table_commit(&batch);
+    ASSERT_EQ(0, reclaim_calls);
+
+    dsc_vt_version* v1 = dsc_versioned_table_acquire(&vt);
+    dsc_versioned_table_begin(&vt, &batch);
+    dsc_versioned_table_put(&batch, &key, &b);
+    dsc_versioned_table_commit(&batch);
+
+    /* a is still reachable from v1 */
+    ASSERT_EQ(0, reclaim_calls);
+    ASSERT_TRUE(dsc_versioned_table_get(v1, &key) == &a);
+    dsc_versioned_table_release(v1);
+    ASSERT_EQ(1, reclaim_calls);
+
+    /* An aborted batch drops the objects only it referenced */
+    dsc_versioned_table_begin(&vt, &batch);
+    int other = 2;
+    dsc_versioned_table_put(&batch, &other, &c);
+    dsc_versioned_table_delete(&batch, &key);
+    dsc_versioned_table_abort(&batch);
+    ASSERT_EQ(2, reclaim_calls);
+
+    dsc_vt_version* v = dsc_versioned_table_acquire(&vt);
+    ASSERT_TRUE(dsc_versioned_table_get(v, &key) == &b);
+    ASSERT_NULL(dsc_versioned_table_get(v, &other));
+    dsc_versioned_table_release(v);
+
+    dsc_versioned_table_destroy(&vt);
+    ASSERT_EQ(3, reclaim_calls);
+}
+
+TEST(vt_reput_shares_the_entry) {
+    static int route = 1, other = 2;
+    dsc_versioned_table vt;
+    dsc_versioned_table_init(&vt, 16, sizeof(int), dsc_hash_pod, dsc_cmp_pod, count_reclaim);
+    reclaim_calls = 0;
+
+    int key = 7;
+    dsc_vt_batch batch;
+    dsc_versioned_table_begin(&vt, &batch);
+    dsc_versioned_table_put(&batch, &key, &route);
+    dsc_versioned_table_commit(&batch);
+
+    /* Delete then put back: route stays live, so releasing v1 must not reclaim it */
+    dsc_vt_version* v1 = dsc_versioned_table_acquire(&vt);
+    dsc_versioned_table_begin(&vt, &batch);
+    dsc_versioned_table_delete(&batch, &key);
+    ASSERT_TRUE(dsc_versioned_table_put(&batch, &key, &route));
+    ASSERT_TRUE(dsc_versioned_table_commit(&batch));
+    dsc_versioned_table_release(v1);
+    ASSERT_EQ(0, reclaim_calls);
+
+    /* A/B/A in one batch: only other, which no version kept, is reclaimed */
+    dsc_vt_version* v2 = dsc_versioned_table_acquire(&vt);
+    dsc_versioned_table_begin(&vt, &batch);
+    dsc_versioned_table_put(&batch, &key, &other);
+    dsc_versioned_table_put(&batch, &key, &route);
+    ASSERT_EQ(1, reclaim_calls);
+    ASSERT_TRUE(dsc_versioned_table_commit(&batch));
+    dsc_versioned_table_release(v2);
+    ASSERT_EQ(1, reclaim_calls);
+
+    dsc_vt_version* v = dsc_versioned_table_acquire(&vt);
+    ASSERT_TRUE(dsc_versioned_table_get(v, &key) == &route);
+    ASSERT_EQ(1, dsc_versioned_table_size(v));
+    dsc_versioned_table_release(v);
+
+    /* route goes once, with the last version holding it */
+    dsc_versioned_table_destroy(&vt);
+    ASSERT_EQ(2, reclaim_calls);
+}
+
+TEST(vt_conflicting_commit_fails) {
+    dsc_versioned_table vt;
+    dsc_versioned_table_init(&vt, 16, sizeof(int), dsc_hash_pod, dsc_cmp_pod, NULL);
+
+    int key = 1;
+    dsc_vt_batch first, second;
+    dsc_versioned_table_begin(&vt, &first);
+    dsc_versioned_table_begin(&vt, &second);
+    values[1] = 1;
+    dsc_versioned_table_put(&first, &key, &values[1]);
+    dsc_versioned_table_put(&second, &key, &values[2]);
+
+    ASSERT_TRUE(dsc_versioned_table_commit(&first));
+    ASSERT_FALSE(dsc_versioned_table_commit(&second));
+    ASSERT_EQ(DSC_ECONFLICT, dsc_get_error());
+
+    dsc_vt_version* v = dsc_versioned_table_acquire(&vt);
+    ASSERT_TRUE(dsc_versioned_table_get(v, &key) == &values[1]);
+    dsc_versioned_table_release(v);
+    dsc_versioned_table_destroy(&vt);
+}
+
+TEST(vt_commit_hands_in_flight_acquires_to_old_version) {
+    dsc_versioned_table vt;
+    dsc_versioned_table_init(&vt, 16, sizeof(int), dsc_hash_pod, dsc_cmp_pod, NULL);
+    put_range(&vt, 0, 10);
+
+    dsc_vt_version* v1 = dsc_versioned_table_acquire(&vt);
+    ASSERT_EQ(0, vt.current & DSC_VT_PENDING);
+    ASSERT_EQ(2, v1->refs);     /* Table and v1 */
+
+    /* A reader stopped between claiming its unit and taking a reference */
+    vt.current += 1;
+    put_range(&vt, 10, 20);
+    ASSERT_EQ(0, vt.current & DSC_VT_PENDING);
+    ASSERT_EQ(2, v1->refs);     /* v1 and the stalled reader */
+
+    /* The stalled reader resumes and drops the reference it was handed */
+    dsc_versioned_table_release(v1);
+    int key = 5;
+    ASSERT_TRUE(dsc_versioned_table_get(v1, &key) == &values[5]);
+    dsc_versioned_table_release(v1);
+
+    dsc_vt_version* v2 = dsc_versioned_table_acquire(&vt);
+    ASSERT_EQ(20, dsc_versioned_table_size(v2));
+    ASSERT_EQ(2, v2->refs);
+    dsc_versioned_table_release(v2);
+    dsc_versioned_table_destroy(&vt);
+}
+
+TEST(vt_allocator_balanced) {
+    counting_ctx ctx = {0};
+    dsc_allocator alloc = { counting_alloc, counting_realloc, counting_free, &ctx };
+
+    dsc_versioned_table vt;
+    dsc_versioned_table_init_with_allocator(&vt, 16, sizeof(int), dsc_hash_pod, dsc_cmp_pod, NULL, &alloc);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(1, ctx.live);     /* The empty initial version */
+
+    put_range(&vt, 0, 200);
+    dsc_vt_version* v1 = dsc_versioned_table_acquire(&vt);
+    put_range(&vt, 0, 10);      /* Same objects: nothing copied */
+    put_range(&vt, 300, 310);
+    ASSERT_TRUE(ctx.allocs > 200);
+
+    /* v1 keeps its chunks and entries alive */
+    int live = ctx.live;
+    dsc_versioned_table_release(v1);
+    ASSERT_TRUE(ctx.live < live);
+
+    dsc_versioned_table_destroy(&vt);
+    ASSERT_EQ(0, ctx.live);
+    ASSERT_EQ(ctx.allocs, ctx.frees);
+}
+
+static void count_entry(const void* key, size_t key_size, void* obj, uint64_t hash, void* ctx) {
+    (void)key;
+    (void)hash;
+    (void)obj;
+    *(size_t*)ctx += key_size;
+}
+
+TEST(vt_string_keys_and_foreach) {
+    dsc_versioned_table vt;
+    dsc_versioned_table_init(&vt, 8, 0, dsc_hash_str, dsc_cmp_str, NULL);
+
+    static const char* routes[] = { "/", "/api", "/api/users", "/static" };
+    dsc_vt_batch batch;
+    dsc_versioned_table_begin(&vt, &batch);
+    for (int i = 0; i < 4; i++) dsc_versioned_table_put(&batch, routes[i], &values[i]);
+    dsc_versioned_table_commit(&batch);
+
+    dsc_vt_version* v = dsc_versioned_table_acquire(&vt);
+    char key[16];
+    strcpy(key, "/api");
+    ASSERT_TRUE(dsc_versioned_table_get(v, key) == &values[1]);
+    ASSERT_NULL(dsc_versioned_table_get(v, "/ap"));
+
+    /* key_size includes the terminator */
+    size_t bytes = 0;
+    dsc_versioned_table_foreach(v, count_entry, &bytes);
+    ASSERT_EQ(2 + 5 + 11 + 8, bytes);
+
+    dsc_versioned_table_release(v);
+    dsc_versioned_table_destroy(&vt);
+}
+
+/* =========================================================
+   Multi-Threaded
+   ========================================================= */
+
+#define READERS  4
+#define COMMITS  200
+#define HOT_KEYS 10
+
+static int stamps[COMMITS + 1];
+
+typedef struct {
+    dsc_versioned_table* vt;
+    size_t*              done;
+    int                  errors;
+} reader_arg;
+
+TEST_THREAD_FN(reader_thread) {
+    reader_arg* r = (reader_arg*)arg;
+    while (!dsc_atomic_load_acquire(r->done)) {
+        dsc_vt_version* v = dsc_versioned_table_acquire(r->vt);
+
+        /* Every commit rewrites all hot keys, so a version never mixes two commits */
+        for (int k = 0; k < HOT_KEYS; k++) {
+            int* stamp = (int*)dsc_versioned_table_get(v, &k);
+            if (stamp == NULL || (uint64_t)*stamp != v->number) r->errors++;
+        }
+        for (int k = 100; k < 1100; k += 97) {
+            if (dsc_versioned_table_get(v, &k) != &values[k]) r->errors++;
+        }
+        dsc_versioned_table_release(v);
+    }
+    TEST_THREAD_RETURN;
+}
+
+TEST(vt_readers_during_commits) {
+    dsc_versioned_table vt;
+    dsc_versioned_table_init(&vt, 64, sizeof(int), dsc_hash_pod, dsc_cmp_pod, NULL);
+
+    /* Version 1: hot keys stamped 1, plus a stable range */
+    dsc_vt_batch batch;
+    dsc_versioned_table_begin(&vt, &batch);
+    stamps[1] = 1;
+    for (int k = 0; k < HOT_KEYS; k++) dsc_versioned_table_put(&batch, &k, &stamps[1]);
+    for (int k = 100; k < 1100; k++) dsc_versioned_table_put(&batch, &k, &values[k]);
+    dsc_versioned_table_commit(&batch);
+
+    size_t done = 0;
+    test_thread threads[READERS];
+    reader_arg  args[READERS];
+    for (int t = 0; t < READERS; t++) {
+        args[t] = (reader_arg){&vt, &done, 0};
+        test_thread_start(&threads[t], reader_thread, &args[t]);
+    }
+
+    for (int n = 2; n <= COMMITS; n++) {
+        stamps[n] = n;
+        ASSERT_TRUE(dsc_versioned_table_begin(&vt, &batch));
+        for (int k = 0; k < HOT_KEYS; k++) dsc_versioned_table_put(&batch, &k, &stamps[n]);
+        ASSERT_TRUE(dsc_versioned_table_commit(&batch));
+    }
+    dsc_atomic_store_release(&done, 1);
+    for (int t = 0; t < READERS; t++) test_thread_join(threads[t]);
+    for (int t = 0; t < READERS; t++) ASSERT_EQ(0, args[t].errors);
+
+    dsc_vt_version* v = dsc_versioned_table_acquire(&vt);
+    ASSERT_EQ(COMMITS, v->number);
+    ASSERT_EQ(HOT_KEYS + 1000, dsc_versioned_table_size(v));
+    dsc_versioned_table_release(v);
+    dsc_versioned_table_destroy(&vt);
+}
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("Versioned Hash Table Tests");
+
+    TEST_SECTION("Single-Threaded");
+    RUN_TEST(vt_init_and_errors);
+    RUN_TEST(vt_batch_commit_and_read_own_writes);
+    RUN_TEST(vt_old_versions_are_frozen);
+    RUN_TEST(vt_delete_keeps_probe_runs);
+    RUN_TEST(vt_reclaim_on_last_release);
+    RUN_TEST(vt_reput_shares_the_entry);
+    RUN_TEST(vt_conflicting_commit_fails);
+    RUN_TEST(vt_commit_hands_in_flight_acquires_to_old_version);
+    RUN_TEST(vt_allocator_balanced);
+    RUN_TEST(vt_string_keys_and_foreach);
+
+    TEST_SECTION("Multi-Threaded");
+    RUN_TEST(vt_readers_during_commits);
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}
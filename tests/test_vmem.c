@@ -0,0 +1,228 @@
+/**
+ * Virtual Memory Tests
+ * Tests dsc_vmem reservations, file-backed mappings and mapped lists.
+ */
+
+/* MAP_ANONYMOUS, even under a strict -std=c11 build */
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
+#include "test_framework.h"
+
+#define DSC_IMPLEMENTATION
+#include "../dsc.h"
+#include <string.h>
+
+#ifndef DSC_NO_VMEM
+
+#if defined(_WIN32)
+#define VMEM_TEST_FILE "dsc_vmem_test.bin"
+#else
+#define VMEM_TEST_FILE "/tmp/dsc_vmem_test.bin"
+#endif
+
+static int is_even(void* item) {
+    return *(int*)item % 2 == 0;
+}
+
+/* =========================================================
+   Anonymous Mapping Tests
+   ========================================================= */
+
+TEST(vmem_init_destroy) {
+    dsc_vmem vm;
+    dsc_vmem_init(&vm, 1 << 20, 0);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_NOT_NULL(vm.base);
+    ASSERT_EQ(0, vm.committed);
+    ASSERT_TRUE(vm.reserved >= (1 << 20));
+
+    dsc_vmem_destroy(&vm);
+    ASSERT_NULL(vm.base);
+
+    dsc_vmem_init(NULL, 0, 0);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+}
+
+TEST(mapped_list_grows_without_moving) {
+    dsc_vmem vm;
+    dsc_vmem_init(&vm, 0, 0);
+
+    dsc_list list;
+    dsc_list_init_mapped(&list, sizeof(int), &vm);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    int first = 0;
+    dsc_list_append(&list, &first);
+    void* items = list.items;
+    ASSERT_TRUE(items == dsc_vmem_data(&vm));
+
+    for (int i = 1; i < 1000000; i++) dsc_list_append(&list, &i);
+    ASSERT_EQ(1000000, list.length);
+    ASSERT_TRUE(list.items == items);
+    ASSERT_EQ(999999, *(int*)dsc_list_get(&list, 999999));
+
+    dsc_list_destroy(&list);
+    ASSERT_FALSE(vm.in_use);
+    dsc_vmem_destroy(&vm);
+}
+
+TEST(mapped_list_huge_pages) {
+    dsc_vmem vm;
+    dsc_vmem_init(&vm, 64 << 20, DSC_VMEM_HUGE_PAGES);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    dsc_list list;
+    dsc_list_init_mapped(&list, sizeof(double), &vm);
+    for (int i = 0; i < 100000; i++) {
+        double d = i * 0.5;
+        dsc_list_append(&list, &d);
+    }
+    ASSERT_TRUE(list.items == dsc_vmem_data(&vm));
+    ASSERT_TRUE(*(double*)dsc_list_get(&list, 99999) == 99999 * 0.5);
+
+    dsc_list_destroy(&list);
+    dsc_vmem_destroy(&vm);
+}
+
+TEST(mapped_list_second_buffer_uses_heap) {
+    dsc_vmem vm;
+    dsc_vmem_init(&vm, 1 << 20, 0);
+
+    dsc_list list;
+    dsc_list_init_mapped(&list, sizeof(int), &vm);
+    for (int i = 0; i < 100; i++) dsc_list_append(&list, &i);
+
+    dsc_list evens = dsc_list_filter(&list, is_even);
+    ASSERT_EQ(50, evens.length);
+    ASSERT_TRUE(evens.items != dsc_vmem_data(&vm));
+    ASSERT_EQ(98, *(int*)dsc_list_get(&evens, 49));
+
+    dsc_list_destroy(&evens);
+    ASSERT_TRUE(vm.in_use);
+    dsc_list_destroy(&list);
+    dsc_vmem_destroy(&vm);
+}
+
+TEST(mapped_list_reserve_exhausted) {
+    dsc_vmem vm;
+    dsc_vmem_init(&vm, 1 << 16, 0);
+
+    dsc_list list;
+    dsc_list_init_mapped(&list, sizeof(int), &vm);
+    dsc_list_reserve(&list, (1 << 16) / sizeof(int));
+    ASSERT_EQ(DSC_ENOMEM, dsc_get_error());
+
+    dsc_list_reserve(&list, 1000);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_TRUE(list.items == dsc_vmem_data(&vm));
+
+    dsc_list_destroy(&list);
+    dsc_vmem_destroy(&vm);
+}
+
+/* =========================================================
+   File-Backed Mapping Tests
+   ========================================================= */
+
+TEST(file_list_persists_and_reopens) {
+    remove(VMEM_TEST_FILE);
+
+    dsc_vmem vm;
+    dsc_vmem_open(&vm, VMEM_TEST_FILE, 0, 0);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+
+    dsc_list list;
+    dsc_list_init_mapped(&list, sizeof(int), &vm);
+    ASSERT_EQ(0, list.length);
+    for (int i = 0; i < 50000; i++) dsc_list_append(&list, &i);
+    dsc_list_sync(&list, &vm);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    dsc_list_destroy(&list);
+    dsc_vmem_destroy(&vm);
+
+    /* Reopen: the items are read straight from the mapping */
+    dsc_vmem_open(&vm, VMEM_TEST_FILE, 0, 0);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    dsc_list_init_mapped(&list, sizeof(int), &vm);
+    ASSERT_EQ(DSC_EOK, dsc_get_error());
+    ASSERT_EQ(50000, list.length);
+    ASSERT_EQ(12345, *(int*)dsc_list_get(&list, 12345));
+    ASSERT_EQ(49999, *(int*)dsc_list_get(&list, 49999));
+
+    int more = -1;
+    dsc_list_append(&list, &more);
+    dsc_list_sync(&list, &vm);
+    dsc_list_destroy(&list);
+    dsc_vmem_destroy(&vm);
+
+    dsc_vmem_open(&vm, VMEM_TEST_FILE, 0, 0);
+    dsc_list_init_mapped(&list, sizeof(int), &vm);
+    ASSERT_EQ(50001, list.length);
+    ASSERT_EQ(-1, *(int*)dsc_list_get(&list, 50000));
+    dsc_list_destroy(&list);
+    dsc_vmem_destroy(&vm);
+
+    remove(VMEM_TEST_FILE);
+}
+
+TEST(file_list_rejects_mismatch) {
+    remove(VMEM_TEST_FILE);
+
+    dsc_vmem vm;
+    dsc_vmem_open(&vm, VMEM_TEST_FILE, 0, 0);
+    dsc_list list;
+    dsc_list_init_mapped(&list, sizeof(int), &vm);
+    int v = 7;
+    dsc_list_append(&list, &v);
+    dsc_list_sync(&list, &vm);
+    dsc_list_destroy(&list);
+    dsc_vmem_destroy(&vm);
+
+    dsc_vmem_open(&vm, VMEM_TEST_FILE, 0, 0);
+    dsc_list_init_mapped(&list, sizeof(double), &vm);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    dsc_vmem_destroy(&vm);
+
+    /* Not a dsc_vmem file */
+    FILE* f = fopen(VMEM_TEST_FILE, "wb");
+    ASSERT_NOT_NULL(f);
+    char junk[128];
+    memset(junk, 'x', sizeof(junk));
+    fwrite(junk, 1, sizeof(junk), f);
+    fclose(f);
+
+    dsc_vmem_open(&vm, VMEM_TEST_FILE, 0, 0);
+    ASSERT_EQ(DSC_EINVAL, dsc_get_error());
+    ASSERT_NULL(vm.base);
+
+    remove(VMEM_TEST_FILE);
+}
+
+#endif /* DSC_NO_VMEM */
+
+/* =========================================================
+   Main
+   ========================================================= */
+
+int main(void) {
+    TEST_INIT();  /* Enable ANSI colors on Windows */
+    TEST_HEADER("Virtual Memory Tests");
+
+#ifndef DSC_NO_VMEM
+    TEST_SECTION("Anonymous Mapping");
+    RUN_TEST(vmem_init_destroy);
+    RUN_TEST(mapped_list_grows_without_moving);
+    RUN_TEST(mapped_list_huge_pages);
+    RUN_TEST(mapped_list_second_buffer_uses_heap);
+    RUN_TEST(mapped_list_reserve_exhausted);
+
+    TEST_SECTION("File-Backed Mapping");
+    RUN_TEST(file_list_persists_and_reopens);
+    RUN_TEST(file_list_rejects_mismatch);
+#endif
+
+    TEST_SUMMARY();
+    return TEST_EXIT_CODE();
+}